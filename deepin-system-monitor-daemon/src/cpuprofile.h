@@ -5,6 +5,8 @@
 #ifndef CPUPROFILE_H
 #define CPUPROFILE_H
 
+#include "metrics_snapshot.hpp"
+
 #include <QObject>
 #include <QMap>
 
@@ -32,9 +34,19 @@ public:
      */
     QMap<QString, int> cpuStat();
 
+private:
+    /*!
+     * 读取/proc/stat中总的CPU状态
+     */
+    bool readCpuStat(QMap<QString, int> &cpuStat);
+
 private:
     QMap<QString, int> mLastCpuStat;
     double mCpuUsage;
+    // 系统监视器运行时由其发布的采样数据
+    common::MetricsSnapshotReader mSnapshot;
+    // 上一次使用的采样序号
+    uint64_t mSnapshotGeneration;
 };
 
 #endif // CPUPROFILE_H
@@ -19,6 +19,14 @@ double MemoryProfile::updateSystemMemoryUsage()
     // 返回值，内存占用率
     double memUsage = 0;
 
+    // 系统监视器正在采样，直接使用其发布的数据，无需再读取/proc/meminfo
+    common::metrics_system_t system {};
+    if (mSnapshot.readSystem(system) && system.mem_total != 0) {
+        memUsage = (system.mem_total - system.mem_available) * 100.0 / system.mem_total;
+        mMemUsage = memUsage;
+        return memUsage;
+    }
+
     QFile file(PROC_MEM_INFOI_PATH);
     if (file.exists() && file.open(QFile::ReadOnly)) {
         // 计算总的内存占用率，只需要读取前3行数据
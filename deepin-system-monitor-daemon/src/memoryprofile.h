@@ -5,6 +5,8 @@
 #ifndef MEMORYPROFILE_H
 #define MEMORYPROFILE_H
 
+#include "metrics_snapshot.hpp"
+
 #include <QObject>
 
 class MemoryProfile : public QObject
@@ -29,6 +31,8 @@ public:
 
 private:
     double mMemUsage;
+    // 系统监视器运行时由其发布的采样数据
+    common::MetricsSnapshotReader mSnapshot;
 };
 
 #endif // MEMORYPROFILE_H
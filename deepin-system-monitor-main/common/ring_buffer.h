@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace common {
+namespace core {
+
+/**
+ * @brief Fixed capacity circular buffer, oldest element at index 0 (ref: boost/circular_buffer)
+ *
+ * Up to Prealloc elements are stored inline, larger capacities take one heap block.
+ * Only live slots hold constructed objects, pushing into a full buffer overwrites the oldest one.
+ */
+template<typename T, size_t Prealloc = 2>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(size_t capacity = Prealloc)
+        : m_heap(nullptr)
+        , m_capacity(0)
+        , m_head(0)
+        , m_size(0)
+    {
+        allocate(capacity);
+    }
+    RingBuffer(const RingBuffer &other)
+        : m_heap(nullptr)
+        , m_capacity(0)
+        , m_head(0)
+        , m_size(0)
+    {
+        allocate(other.m_capacity);
+        for (size_t i = 0; i < other.m_size; ++i)
+            emplace_back(other[i]);
+    }
+    RingBuffer &operator=(const RingBuffer &rhs)
+    {
+        if (this == &rhs)
+            return *this;
+
+        clear();
+        if (m_capacity != rhs.m_capacity) {
+            release();
+            allocate(rhs.m_capacity);
+        }
+        for (size_t i = 0; i < rhs.m_size; ++i)
+            emplace_back(rhs[i]);
+        return *this;
+    }
+    ~RingBuffer()
+    {
+        clear();
+        release();
+    }
+
+    inline size_t capacity() const { return m_capacity; }
+    inline size_t size() const { return m_size; }
+    inline bool empty() const { return m_size == 0; }
+    inline bool full() const { return m_size == m_capacity; }
+
+    inline T &operator[](size_t index) { return slots()[slot(index)]; }
+    inline const T &operator[](size_t index) const { return slots()[slot(index)]; }
+    inline T &front() { return (*this)[0]; }
+    inline const T &front() const { return (*this)[0]; }
+    inline T &back() { return (*this)[m_size - 1]; }
+    inline const T &back() const { return (*this)[m_size - 1]; }
+
+    /**
+     * @brief Construct a new element at the back, dropping the oldest one if the buffer is full
+     */
+    template<typename... Args>
+    T &emplace_back(Args &&... args)
+    {
+        if (full())
+            pop_front();
+
+        T *p = &slots()[slot(m_size)];
+        new (p) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *p;
+    }
+    inline void push_back(const T &value) { emplace_back(value); }
+
+    void pop_front()
+    {
+        if (m_size == 0)
+            return;
+
+        slots()[m_head].~T();
+        m_head = (m_head + 1) % m_capacity;
+        --m_size;
+    }
+
+    void clear()
+    {
+        while (m_size > 0)
+            pop_front();
+        m_head = 0;
+    }
+
+    /**
+     * @brief Change capacity, keeping the most recent min(size, capacity) elements
+     */
+    void setCapacity(size_t capacity)
+    {
+        if (capacity < 1)
+            capacity = 1;
+        if (capacity == m_capacity)
+            return;
+
+        while (m_size > capacity)
+            pop_front();
+
+        RingBuffer tmp(capacity);
+        for (size_t i = 0; i < m_size; ++i)
+            tmp.emplace_back(std::move((*this)[i]));
+        clear();
+        release();
+        allocate(capacity);
+        for (size_t i = 0; i < tmp.m_size; ++i)
+            emplace_back(std::move(tmp[i]));
+    }
+
+private:
+    inline size_t slot(size_t index) const
+    {
+        size_t pos = m_head + index;
+        return pos < m_capacity ? pos : pos - m_capacity;
+    }
+    inline T *slots() { return m_heap ? m_heap : reinterpret_cast<T *>(&m_inline); }
+    inline const T *slots() const { return m_heap ? m_heap : reinterpret_cast<const T *>(&m_inline); }
+
+    void allocate(size_t capacity)
+    {
+        if (capacity < 1)
+            capacity = 1;
+        m_capacity = capacity;
+        m_head = 0;
+        if (capacity > Prealloc)
+            m_heap = static_cast<T *>(::operator new(capacity * sizeof(T)));
+    }
+    void release()
+    {
+        ::operator delete(m_heap);
+        m_heap = nullptr;
+    }
+
+    typename std::aligned_storage<sizeof(T) * Prealloc, alignof(T)>::type m_inline;
+    T *m_heap;
+    size_t m_capacity;
+    size_t m_head; // slot of the oldest element
+    size_t m_size;
+};
+
+/**
+ * @brief Fixed ring of equally sized rows stored in one contiguous block, oldest row at index 0
+ *
+ * Rows are written in place, pushing into a full ring reuses the oldest row's storage;
+ * memory is only reallocated when the shape changes.
+ */
+template<typename T>
+class RingMatrix
+{
+public:
+    explicit RingMatrix(size_t rows = 2, size_t columns = 0)
+        : m_data(nullptr)
+        , m_rows(0)
+        , m_columns(0)
+        , m_head(0)
+        , m_size(0)
+    {
+        reshape(rows, columns);
+    }
+    RingMatrix(const RingMatrix &other)
+        : m_data(nullptr)
+        , m_rows(0)
+        , m_columns(0)
+        , m_head(0)
+        , m_size(0)
+    {
+        *this = other;
+    }
+    RingMatrix &operator=(const RingMatrix &rhs)
+    {
+        if (this == &rhs)
+            return *this;
+
+        clear();
+        reshape(rhs.m_rows, rhs.m_columns);
+        for (size_t i = 0; i < rhs.m_size; ++i)
+            std::copy(rhs.row(i), rhs.row(i) + m_columns, push_back());
+        return *this;
+    }
+    ~RingMatrix()
+    {
+        delete[] m_data;
+    }
+
+    inline size_t capacity() const { return m_rows; }
+    inline size_t columns() const { return m_columns; }
+    inline size_t size() const { return m_size; }
+    inline bool empty() const { return m_size == 0; }
+
+    inline T *row(size_t index) { return m_data + slot(index) * m_columns; }
+    inline const T *row(size_t index) const { return m_data + slot(index) * m_columns; }
+    inline const T *back() const { return m_size > 0 ? row(m_size - 1) : nullptr; }
+
+    /**
+     * @brief Append a row, dropping the oldest one if the ring is full
+     * @return Return the new row, its values are left from the row it replaces
+     */
+    T *push_back()
+    {
+        if (m_size == m_rows) {
+            m_head = (m_head + 1) % m_rows;
+            --m_size;
+        }
+        ++m_size;
+        return row(m_size - 1);
+    }
+
+    inline void clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    /**
+     * @brief Change shape, keeping the most recent min(size, rows) rows, new columns are value initialized
+     */
+    void reshape(size_t rows, size_t columns)
+    {
+        if (rows < 1)
+            rows = 1;
+        if (rows == m_rows && columns == m_columns)
+            return;
+
+        T *data = new T[rows * columns]();
+        size_t keep = m_size < rows ? m_size : rows;
+        size_t width = m_columns < columns ? m_columns : columns;
+        for (size_t i = 0; i < keep; ++i) {
+            const T *src = row(m_size - keep + i);
+            std::copy(src, src + width, data + i * columns);
+        }
+
+        delete[] m_data;
+        m_data = data;
+        m_rows = rows;
+        m_columns = columns;
+        m_head = 0;
+        m_size = keep;
+    }
+
+private:
+    inline size_t slot(size_t index) const
+    {
+        size_t pos = m_head + index;
+        return pos < m_rows ? pos : pos - m_rows;
+    }
+
+    T *m_data;
+    size_t m_rows;
+    size_t m_columns;
+    size_t m_head; // row of the oldest entry
+    size_t m_size;
+};
+
+} // namespace core
+} // namespace common
+
+#endif // RING_BUFFER_H
@@ -8,9 +8,11 @@
 
 #include "time_period.h"
 #include "common/common.h"
+#include "common/ring_buffer.h"
 
-#include <memory>
 #include <list>
+#include <memory>
+#include <utility>
 
 #include <sys/time.h>
 
@@ -276,44 +278,47 @@ public:
     qulonglong data;
 };
 
-template<typename T>
+/**
+ * @brief Time series of the last TimePeriod::ticks() frames, frames are stored by value in a ring buffer
+ *
+ * Up to Prealloc frames live inline in the object, so short series (e.g. the 2 frames kept per process)
+ * never touch the heap after construction.
+ */
+template<typename T, size_t Prealloc = 2>
 class Sample
 {
 public:
     explicit Sample()
-        : m_samples {}
-        , m_period {}
-        , m_maxSamples {}
+        : m_period {}
+        , m_samples(m_period.ticks())
     {
-        m_maxSamples = m_period.ticks();
     }
     explicit Sample(const TimePeriod &period)
-        : m_samples {}
-        , m_period {period}
-        , m_maxSamples {}
+        : m_period {period}
+        , m_samples(m_period.ticks())
     {
-        m_maxSamples = m_period.ticks();
     }
     Sample(const Sample &other)
         : m_period(other.m_period)
-        , m_maxSamples(other.m_maxSamples)
+        , m_samples(other.m_samples)
     {
-        for (auto &item : other.m_samples) {
-            m_samples.push_back(std::make_shared<SampleFrame<T>>(*item));
-        }
-        m_maxSamples = m_period.ticks();
+    }
+    Sample &operator=(const Sample &rhs)
+    {
+        m_period = rhs.m_period;
+        m_samples = rhs.m_samples;
+        return *this;
     }
 
-    inline void addSample(SampleFrame<T> *frame)
+    inline void addSample(const SampleFrame<T> &frame)
     {
-        if (frame) {
-            if (m_samples.size() >= m_maxSamples)
-                m_samples.pop_front();
+        m_samples.push_back(frame);
+    }
 
-            std::shared_ptr<SampleFrame<T>> framePtr;
-            framePtr.reset(frame);
-            m_samples.push_back(framePtr);
-        }
+    template<typename... Args>
+    inline void emplaceSample(Args &&... args)
+    {
+        m_samples.emplace_back(std::forward<Args>(args)...);
     }
 
     inline const TimePeriod &timePeriod() const
@@ -323,25 +328,17 @@ public:
 
     inline const SampleFrame<T> *recentSample() const
     {
-        if (m_samples.size() > 0)
-            return m_samples.last().get();
+        if (!m_samples.empty())
+            return &m_samples.back();
         else
             return nullptr;
     }
 
     inline void updateTimePeriod(const TimePeriod &newPeriod)
     {
-        auto ticks = newPeriod.ticks();
-        auto old = m_period.ticks();
-
-        if (timercmp(&newPeriod.interval(), &m_period.interval(), !=)) {
+        if (timercmp(&newPeriod.interval(), &m_period.interval(), !=))
             m_samples.clear();
-        } else if (ticks < old) {
-            while (m_samples.size() > ticks) {
-                m_samples.pop_front();
-            }
-        }
-        m_maxSamples = ticks;
+        m_samples.setCapacity(newPeriod.ticks());
         m_period = newPeriod;
     }
 
@@ -349,31 +346,29 @@ public:
     {
         QPair<const SampleFrame<T> *, const SampleFrame<T> *> pair {};
         if (m_samples.size() > 0)
-            pair.first = m_samples[0].get();
+            pair.first = &m_samples[0];
         if (m_samples.size() > 1)
-            pair.second = m_samples[1].get();
+            pair.second = &m_samples[1];
         return pair;
     }
 
     inline int count() const
     {
-        return m_samples.size();
+        return int(m_samples.size());
     }
 
     inline const SampleFrame<T> *sample(int index) const
     {
-        if (index >= 0 && index < m_samples.size()) {
-            return m_samples[index].get();
+        if (index >= 0 && size_t(index) < m_samples.size()) {
+            return &m_samples[size_t(index)];
         }
 
         return nullptr;
     }
 
 private:
-    // TODO: replace with circular buffer impl. (ref: boost/circular_buffer)
-    QList<std::shared_ptr<SampleFrame<T>>> m_samples;
     TimePeriod m_period;
-    size_t m_maxSamples;
+    RingBuffer<SampleFrame<T>, Prealloc> m_samples;
 };
 
 using IOSampleFrame = SampleFrame<IO>;
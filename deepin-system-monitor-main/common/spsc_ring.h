@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace common {
+namespace core {
+
+/**
+ * @brief Bounded lock-free single producer single consumer queue of trivially copyable records
+ *
+ * Slots are preallocated once, push & pop never allocate or lock. Head & tail live on separate
+ * cache lines, each side keeps a private copy of the other side's index and only reloads it
+ * when the ring looks full (producer) or empty (consumer).
+ * Exactly one thread may push and exactly one (other) thread may pop.
+ */
+template<typename T>
+class SpscRing
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing records must be trivially copyable");
+
+public:
+    /**
+     * @param capacity Minimum number of records, rounded up to a power of 2
+     */
+    explicit SpscRing(size_t capacity)
+    {
+        size_t n = 2;
+        while (n < capacity)
+            n <<= 1;
+        m_slots.reset(new T[n]);
+        m_mask = n - 1;
+    }
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * @brief Append one record (producer thread only)
+     * @return false if the ring is full, record is dropped
+     */
+    inline bool push(const T &value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask)
+                return false;
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move up to max records into out (consumer thread only)
+     * @return Number of records popped
+     */
+    inline size_t pop(T *out, size_t max)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_cachedTail - head < max) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+        size_t n = m_cachedTail - head;
+        if (n > max)
+            n = max;
+        for (size_t i = 0; i < n; ++i)
+            out[i] = m_slots[(head + i) & m_mask];
+        if (n > 0)
+            m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Check if no records are pending, may be called from either side
+     */
+    inline bool empty() const
+    {
+        return size() == 0;
+    }
+    inline size_t size() const
+    {
+        // head first, tail can only be ahead of any head loaded before it
+        size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+    inline size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+private:
+    std::unique_ptr<T[]> m_slots;
+    size_t m_mask {};
+
+    // consumer side
+    alignas(64) std::atomic<size_t> m_head {0};
+    size_t m_cachedTail {0};
+
+    // producer side
+    alignas(64) std::atomic<size_t> m_tail {0};
+    size_t m_cachedHead {0};
+};
+
+} // namespace core
+} // namespace common
+
+#endif // SPSC_RING_H
@@ -5,7 +5,6 @@
 
 #include "compact_cpu_monitor.h"
 
-#include "smooth_curve_generator.h"
 #include "common/common.h"
 #include "process/process_db.h"
 #include "system/device_db.h"
@@ -53,17 +52,6 @@ CompactCpuMonitor::CompactCpuMonitor(QWidget *parent)
 
     numCPU = int(sysconf(_SC_NPROCESSORS_ONLN));
 
-    // 使用 cpuPercents[numCPU] 位置存储总的CPU占用率曲线数据
-    // [0, numCPU-1] 存储各独立子CPU曲线数据
-    for (int i = 0; i <= numCPU; i++) {
-        QList<qreal> cpuPercent;
-        for (int j = 0; j < pointsNumber; j++) {
-            cpuPercent.append(0);
-        }
-
-        cpuPercents.append(cpuPercent);
-    }
-
     cpuColors << "#1094D8"
               << "#F7B300"
               << "#55D500"
@@ -81,6 +69,10 @@ CompactCpuMonitor::CompactCpuMonitor(QWidget *parent)
               << "#2CA7F8"
               << "#A005CE";
 
+    m_curves.setPointCount(pointsNumber);
+    m_curves.addCurve(QPen(cpuColors[numCPU % cpuColors.size()], 1.2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    m_curves.series(0).fill(0);
+
     m_cpuInfomodel = CPUInfoModel::instance();
     connect(m_cpuInfomodel, &CPUInfoModel::modelUpdated, this, &CompactCpuMonitor::updateStatus);
 
@@ -111,56 +103,21 @@ void CompactCpuMonitor::updateStatus()
     if (std::isnan(totalCpuPercent))
         return;
 
-    // 将cpuPercents 和传过来最新的cPercents做对比，arm开核关核时，对应的系统监视器会出现飞线或波形图不动的情况
-    QList<int> appendIndex;
+#if !UseTotalCpuCurve
+    // 各个独立CPU占用曲线, arm开核关核时补齐新增CPU的曲线, 已关闭的CPU追加0, 避免出现飞线或波形图不动的情况
     const auto &cpulist = m_cpuInfomodel->cpuPercentList();
-
-    // 更新追加，各个独立CPU占用曲线数据
-    if(cpulist.size() < cpuPercents.size() - 1) {
-        for(int i = cpulist.size(); i < cpuPercents.size() - 1; i++) {
-            cpuPercents[i].append(0.0);
-            appendIndex.append(i);
-        }
-    } else if (cpulist.size() > cpuPercents.size() - 1){
-        QList<qreal> addPointList;
-        for (int j = 0; j < pointsNumber; j++) {
-            addPointList.append(0);
-        }
-        for(int i = cpuPercents.size() - 1; i < cpulist.size(); i++) {
-            cpuPercents.append(addPointList);
-            appendIndex.append(i);
-        }
-    } else {
-        appendIndex.append(-1);
+    for (int i = m_curves.curveCount() - 1; i < cpulist.size(); i++) {
+        int curve = m_curves.addCurve(QPen(cpuColors[i % cpuColors.size()], 1.2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        m_curves.series(curve).fill(0);
     }
-
-    for (int i = 0; i < cpulist.size(); i++) {
-        //防止QList内存溢出
-        if (!cpuPercents[i].isEmpty()) {
-            QList<qreal> cpuPercent = cpuPercents[i];
-            if (!appendIndex.contains(i)) {
-                if (!std::isnan(cpulist[i]))
-                    cpuPercent.append(cpulist[i] / 100.0);
-            }
-
-            if (cpuPercent.size() > pointsNumber) {
-                cpuPercent.pop_front();
-            }
-
-            cpuPercents[i] = cpuPercent;
-        }
+    for (int i = 0; i < m_curves.curveCount() - 1; i++) {
+        bool online = i < cpulist.size() && !std::isnan(cpulist[i]);
+        m_curves.series(i + 1).append(online ? float(cpulist[i] / 100.0) : 0);
     }
+#endif
 
     // 更新追加，总的CPU占用率数据
-    QList<qreal> calcTotalCpuPercent = cpuPercents[numCPU];
-
-    calcTotalCpuPercent.append(totalCpuPercent / 100.0);
-
-    if (calcTotalCpuPercent.size() > pointsNumber) {
-        calcTotalCpuPercent.pop_front();
-    }
-
-    cpuPercents[numCPU] = calcTotalCpuPercent;
+    m_curves.series(0).append(float(totalCpuPercent / 100.0));
 
     update();
 }
@@ -255,97 +212,23 @@ void CompactCpuMonitor::paintEvent(QPaintEvent *)
     painter.drawText(statRect, Qt::AlignLeft | Qt::AlignVCenter, cpuStatText);
 
     // draw grid
-    QPen framePen;
     int penSize = 1;
-    framePen.setColor(frameColor);
-    framePen.setWidth(penSize);
-    painter.setPen(framePen);
-
     int gridX = rect().x() + penSize;
     int gridY = cpuRect.y() + cpuRect.height() + 10;
     int gridWidth =
         rect().width() - 3 - ((rect().width() - 3 - penSize) % (gridSize + penSize)) - penSize;
     int gridHeight = cpuRenderMaxHeight + 8 * penSize;
 
-    painter.setRenderHint(QPainter::Antialiasing, false);
-    QPainterPath framePath;
     QRect gridFrame(gridX, gridY, gridWidth, gridHeight);
-    framePath.addRect(gridFrame);
-    painter.drawPath(framePath);
-
-    // Draw grid.
-    QPen gridPen;
-    QVector<qreal> dashes;
-    qreal space = 2;
-    dashes << 2 << space;
-    gridPen.setDashPattern(dashes);
-    gridPen.setColor(frameColor);
-    //set to 0 lead to line with always 1px
-    gridPen.setWidth(0);
-    painter.setPen(gridPen);
-
-    int gridLineX = gridX;
-    while (gridLineX + gridSize + penSize < gridX + gridWidth) {
-        gridLineX += gridSize + penSize;
-        painter.drawLine(gridLineX, gridY + 1, gridLineX, gridY + gridHeight - 1);
-    }
-    int gridLineY = gridY;
-    while (gridLineY + gridSize + penSize < gridY + gridHeight) {
-        gridLineY += gridSize + penSize;
-        painter.drawLine(gridX + 1, gridLineY, gridX + gridWidth - 1, gridLineY);
-    }
-
-    painter.setRenderHint(QPainter::Antialiasing, true);
-
-    // clip internal area of the region
-    QPainterPath clip;
-    clip.addRect(gridFrame);
-    painter.setClipPath(clip);
+    m_grid.draw(painter, gridFrame, frameColor);
 
-    painter.translate(gridFrame.x(), gridFrame.y());
-
-    qreal strokeWidth = 1.2;                            // for now, set as 1.2 temporarily
+    // draw curves, clipped to internal area of the region
     int drawWidth = gridFrame.width() - penSize * 2;    // exclude left/right most border
     int drawHeight = gridFrame.height() - penSize * 2;  // exclude top/bottom most border
-    qreal offsetX = drawWidth + penSize;
-    qreal deltaX = drawWidth * 1.0 / (pointsNumber - 3);
-
-// 通过 UseTotalCpuCurve 宏控制绘制哪些CPU曲线
-// 通过 statrpos 和 endpos 实现曲线的选择
-#if UseTotalCpuCurve
-    int statrpos = numCPU;
-    int endpos = statrpos;
-#else
-    int statrpos = cpuPercents.size() - 2;
-    int endpos = 0;
-#endif
-
-    // enum cpu
-    for (int i = statrpos; i >= endpos && i >= 0; i--) {
-        // set stroke color
-        QColor c = cpuColors[i % cpuColors.size()];
-        painter.setPen(QPen(c, strokeWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-
-        QPainterPath Painterpath;
-        // move to the first point (from right to left)
-        qreal y = (1.0 - cpuPercents[i].at(pointsNumber - 1)) * drawHeight + penSize;
-        Painterpath.moveTo(offsetX, y);
-
-        for (int j = pointsNumber - 2; j >= 0; j--) {
-            // method#1: draw Bezier curve
-            Painterpath.cubicTo(offsetX - (pointsNumber - j - 1 - 0.5) * deltaX,
-                                (1.0 - cpuPercents[i][j + 1]) * drawHeight + penSize + 0.5,
-                                offsetX - (pointsNumber - j - 1 - 0.5) * deltaX,
-                                (1.0 - cpuPercents[i][j]) * drawHeight + penSize + 0.5,
-                                offsetX - ((pointsNumber - j - 1) * deltaX),
-                                (1.0 - cpuPercents[i][j]) * drawHeight + penSize + 0.5);
-
-            // method#2: draw line instead
-            // path.lineTo(offsetX - ((pointsNumber - j - 1) * deltaX),
-            //            (1.0 - cpuPercents[i][j]) * drawHeight + penSize + 0.5);
-        }
-        painter.drawPath(Painterpath);
-    }
+    m_curves.setGeometry(gridFrame, gridFrame.x() + drawWidth + penSize, drawWidth * 1.0 / (pointsNumber - 3));
+    for (int i = 0; i < m_curves.curveCount(); i++)
+        m_curves.setBaseline(i, gridFrame.y() + penSize + 0.5 + drawHeight, -drawHeight);
+    m_curves.draw(painter);
 
     setFixedHeight(gridFrame.y() + gridFrame.height() + penSize);
 }
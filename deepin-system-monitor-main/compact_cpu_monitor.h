@@ -6,8 +6,9 @@
 #ifndef COMPACTCPUMONITOR_H
 #define COMPACTCPUMONITOR_H
 
+#include "gui/chart_curve_layer.h"
+
 #include <QWidget>
-#include <QPainterPath>
 
 class CPUInfoModel;
 class BaseCommandLinkButton;
@@ -50,8 +51,9 @@ private:
     void resizeItemRect();
 
 private:
-    QList<QList<qreal>> cpuPercents;
-    QList<QPainterPath> cpuPaths;
+    // curve 0: total cpu usage, curve i + 1: cpu i
+    ChartCurveLayer m_curves;
+    ChartGrid m_grid;
     QList<QColor> cpuColors;
     int cpuRenderMaxHeight = 80;
     int cpuWaveformsRenderOffsetY = 112;
@@ -30,7 +30,6 @@ using namespace core::system;
 using namespace common;
 using namespace common::format;
 
-const int gridSize = 10;
 const int pointsNumber = 30;
 CompactDiskMonitor::CompactDiskMonitor(QWidget *parent)
     : QWidget(parent)
@@ -40,15 +39,11 @@ CompactDiskMonitor::CompactDiskMonitor(QWidget *parent)
     setFixedWidth(statusBarMaxWidth);
     setFixedHeight(160);
 
-    readSpeeds = new QList<qreal>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        readSpeeds->append(0);
-    }
-
-    writeSpeeds = new QList<qreal>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        writeSpeeds->append(0);
-    }
+    m_curves.setPointCount(pointsNumber + 1);
+    m_curves.addCurve(QPen(m_diskReadColor, 1.2));
+    m_curves.addCurve(QPen(m_diskWriteColor, 1.2));
+    m_curves.series(0).fill(0);
+    m_curves.series(1).fill(0);
 
     connect(SystemMonitor::instance(), &SystemMonitor::statInfoUpdated, this, &CompactDiskMonitor::updateStatus);
 
@@ -59,8 +54,6 @@ CompactDiskMonitor::CompactDiskMonitor(QWidget *parent)
 
 CompactDiskMonitor::~CompactDiskMonitor()
 {
-    delete readSpeeds;
-    delete writeSpeeds;
 }
 
 void CompactDiskMonitor::updateStatus()
@@ -68,52 +61,17 @@ void CompactDiskMonitor::updateStatus()
     m_readBps = DeviceDB::instance()->diskIoInfo()->diskIoReadBps();
     m_writeBps = DeviceDB::instance()->diskIoInfo()->diskIoWriteBps();
 
-    // Init read path.
-    readSpeeds->append(m_readBps);
-
-    if (readSpeeds->size() > pointsNumber + 1) {
-        readSpeeds->pop_front();
-    }
-    double readMaxHeight = *std::max_element(readSpeeds->begin(), readSpeeds->end()) * 1.1;
-
-    writeSpeeds->append(m_writeBps);
-
-    if (writeSpeeds->size() > pointsNumber + 1) {
-        writeSpeeds->pop_front();
-    }
-    double writeMaxHeight = *std::max_element(writeSpeeds->begin(), writeSpeeds->end()) * 1.1;
-
-    double maxHeight = qMax(readMaxHeight, writeMaxHeight);
-
-    QPainterPath tmpReadpath;
-    getPainterPathByData(readSpeeds, tmpReadpath, maxHeight);
-    readPath = tmpReadpath;
+    auto &readSpeeds = m_curves.series(0);
+    auto &writeSpeeds = m_curves.series(1);
+    readSpeeds.append(float(m_readBps));
+    writeSpeeds.append(float(m_writeBps));
 
-    QPainterPath tmpWritepath;
-    getPainterPathByData(writeSpeeds, tmpWritepath, maxHeight);
-    writePath = tmpWritepath;
+    // both curves share one scale
+    m_curves.setScale(qMax(readSpeeds.max(), writeSpeeds.max()) * 1.1);
 
     update();
 }
 
-void CompactDiskMonitor::getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue)
-{
-    qreal offsetX = 0;
-    qreal distance = (this->width() - 2) * 1.0 / pointsNumber;
-    int dataCount = listData->size();
-
-    for (int i = 0;  i < dataCount - 1; i++) {
-        QPointF sp = QPointF(offsetX, renderMaxHeight * listData->at(i) / maxVlaue);;
-        QPointF ep = QPointF(offsetX + distance, renderMaxHeight * listData->at(i + 1) / maxVlaue);;
-
-        offsetX += distance;
-
-        QPointF c1 = QPointF((sp.x() + ep.x()) / 2.0, sp.y());
-        QPointF c2 = QPointF((sp.x() + ep.x()) / 2.0, ep.y());
-        path.cubicTo(c1, c2, ep);
-    }
-}
-
 void CompactDiskMonitor::paintEvent(QPaintEvent *)
 {
     QPainter painter(this);
@@ -178,63 +136,22 @@ void CompactDiskMonitor::paintEvent(QPaintEvent *)
     painter.drawText(wcol2, Qt::AlignLeft | Qt::AlignVCenter, wstat);
 
     // Draw background grid.
-    painter.setRenderHint(QPainter::Antialiasing, false);
-
-    QPen framePen;
     int penSize = 1;
-    framePen.setColor(frameColor);
-    framePen.setWidth(penSize);
-    painter.setPen(framePen);
-
     int gridX = rect().x() + penSize;
     int gridY = rect().y() + wcol1.y() + wcol1.height() + margin;
     int gridWidth = this->width() - 2 * penSize;
     int gridHeight = renderMaxHeight + renderMaxHeight + 4 * penSize;
 
-    QPainterPath framePath;
     QRect gridFrame(gridX, gridY, gridWidth, gridHeight);
-    framePath.addRect(gridFrame);
-    painter.drawPath(framePath);
+    m_grid.draw(painter, gridFrame, frameColor);
 
-    // Draw grid.
-    QPen gridPen;
-    QVector<qreal> dashes;
-    qreal space = 2;
-    dashes << 2 << space;
-    gridPen.setColor(frameColor);
-    //set to 0 lead to line with always 1px
-    gridPen.setWidth(0);
-    gridPen.setDashPattern(dashes);
-    painter.setPen(gridPen);
-
-    int gridLineX = gridX;
-    while (gridLineX + gridSize + penSize < gridX + gridWidth) {
-        gridLineX += gridSize + penSize;
-        painter.drawLine(gridLineX, gridY + 1, gridLineX, gridY + gridHeight - 1);
-    }
-    int gridLineY = gridY;
-    while (gridLineY + gridSize + penSize < gridY + gridHeight) {
-        gridLineY += gridSize + penSize;
-        painter.drawLine(gridX + 1, gridLineY, gridX + gridWidth - 1, gridLineY);
-    }
-
-    painter.setRenderHint(QPainter::Antialiasing, true);
-
-    QPainterPath clip;
-    clip.addRect(gridFrame);
-    painter.setClipPath(clip);
-
-    qreal diskCurveWidth = 1.2;
-
-    painter.translate(gridFrame.x() + 2, gridFrame.y() + gridFrame.height() / 2 - 2);
-    painter.scale(1, -1);
-    painter.setPen(QPen(m_diskReadColor, diskCurveWidth));
-    painter.drawPath(readPath);
-
-    painter.translate(0, -5);
-    painter.scale(1, -1);
-    painter.setPen(QPen(m_diskWriteColor, diskCurveWidth));
-    painter.drawPath(writePath);
+    // read above the middle line, write below it
+    qreal distance = (this->width() - 2) * 1.0 / pointsNumber;
+    int middle = gridFrame.y() + gridFrame.height() / 2;
+    m_curves.setGeometry(gridFrame, gridFrame.x() + 2 + pointsNumber * distance, distance);
+    m_curves.setBaseline(0, middle - 2, -renderMaxHeight);
+    m_curves.setBaseline(1, middle + 3, renderMaxHeight);
+    m_curves.draw(painter);
 
     setFixedHeight(gridFrame.bottom() + 2 * penSize);
 }
@@ -6,8 +6,9 @@
 #ifndef COMPACTDISKMONITOR_H
 #define COMPACTDISKMONITOR_H
 
+#include "gui/chart_curve_layer.h"
+
 #include <QWidget>
-#include <QPainterPath>
 
 class CompactDiskMonitor : public QWidget
 {
@@ -36,11 +37,11 @@ protected:
 
 private:
     void changeFont(const QFont &font);
-    void getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue);
 
 private:
-    QList<qreal> *readSpeeds;
-    QList<qreal> *writeSpeeds;
+    // curve 0: read speeds, curve 1: write speeds
+    ChartCurveLayer m_curves;
+    ChartGrid m_grid;
     qreal m_readBps {};
     qreal m_writeBps {};
 
@@ -49,9 +50,6 @@ private:
     QColor m_diskReadColor {"#8F88FF"};
     QColor m_diskWriteColor {"#6AD787"};
 
-    QPainterPath readPath;
-    QPainterPath writePath;
-
     int renderMaxHeight = 30;
 
     QFont m_tagFont;
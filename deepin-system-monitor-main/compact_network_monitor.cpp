@@ -5,7 +5,6 @@
 
 #include "compact_network_monitor.h"
 
-#include "smooth_curve_generator.h"
 #include "common/common.h"
 #include "system/device_db.h"
 #include "system/net_info.h"
@@ -32,7 +31,6 @@ using namespace core::system;
 using namespace common;
 using namespace common::format;
 
-const int gridSize = 10;
 const int pointsNumber = 30;
 CompactNetworkMonitor::CompactNetworkMonitor(QWidget *parent)
     : QWidget(parent)
@@ -47,15 +45,11 @@ CompactNetworkMonitor::CompactNetworkMonitor(QWidget *parent)
     setFixedWidth(statusBarMaxWidth);
     setFixedHeight(150);
 
-    downloadSpeeds = new QList<double>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        downloadSpeeds->append(0);
-    }
-
-    uploadSpeeds = new QList<double>();
-    for (int i = 0; i <= pointsNumber; i++) {
-        uploadSpeeds->append(0);
-    }
+    m_curves.setPointCount(pointsNumber + 1);
+    m_curves.addCurve(QPen(recvColor, 1.2));
+    m_curves.addCurve(QPen(sentColor, 1.2));
+    m_curves.series(0).fill(0);
+    m_curves.series(1).fill(0);
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     connect(dAppHelper, &DApplicationHelper::themeTypeChanged, this,
             &CompactNetworkMonitor::changeTheme);
@@ -76,26 +70,6 @@ CompactNetworkMonitor::CompactNetworkMonitor(QWidget *parent)
 
 CompactNetworkMonitor::~CompactNetworkMonitor()
 {
-    delete downloadSpeeds;
-    delete uploadSpeeds;
-}
-
-void CompactNetworkMonitor::getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue)
-{
-    qreal offsetX = 0;
-    qreal distance = (this->width() - 2) * 1.0 / pointsNumber;
-    int dataCount = listData->size();
-
-    for (int i = 0;  i < dataCount - 1; i++) {
-        QPointF sp = QPointF(offsetX, renderMaxHeight * listData->at(i) / maxVlaue);;
-        QPointF ep = QPointF(offsetX + distance, renderMaxHeight * listData->at(i + 1) / maxVlaue);;
-
-        offsetX += distance;
-
-        QPointF c1 = QPointF((sp.x() + ep.x()) / 2.0, sp.y());
-        QPointF c2 = QPointF((sp.x() + ep.x()) / 2.0, ep.y());
-        path.cubicTo(c1, c2, ep);
-    }
 }
 
 void CompactNetworkMonitor::updateStatus()
@@ -107,31 +81,13 @@ void CompactNetworkMonitor::updateStatus()
     m_recvBps = netInfo->recvBps();
     m_sentBps = netInfo->sentBps();
 
-    // Init download path.
-    downloadSpeeds->append(m_recvBps);
-
-    if (downloadSpeeds->size() > pointsNumber + 1) {
-        downloadSpeeds->pop_front();
-    }
-    double downloadMaxHeight = *std::max_element(downloadSpeeds->begin(), downloadSpeeds->end()) * 1.1;
-
-    // Init upload path.
-    uploadSpeeds->append(m_sentBps);
-
-    if (uploadSpeeds->size() > pointsNumber + 1) {
-        uploadSpeeds->pop_front();
-    }
-    double uploadMaxHeight = *std::max_element(uploadSpeeds->begin(), uploadSpeeds->end()) * 1.1;
+    auto &downloadSpeeds = m_curves.series(0);
+    auto &uploadSpeeds = m_curves.series(1);
+    downloadSpeeds.append(float(m_recvBps));
+    uploadSpeeds.append(float(m_sentBps));
 
-    double maxHeight = qMax(downloadMaxHeight, uploadMaxHeight);
-
-    QPainterPath tmpDownloadpath;
-    getPainterPathByData(downloadSpeeds, tmpDownloadpath, maxHeight);
-    downloadPath = tmpDownloadpath;
-
-    QPainterPath tmpUploadpath;
-    getPainterPathByData(uploadSpeeds, tmpUploadpath, maxHeight);
-    uploadPath = tmpUploadpath;
+    // both curves share one scale
+    m_curves.setScale(qMax(downloadSpeeds.max(), uploadSpeeds.max()) * 1.1);
 
     update();
 }
@@ -209,64 +165,22 @@ void CompactNetworkMonitor::paintEvent(QPaintEvent *)
     painter.fillPath(path2, m_sentIndicatorColor);
 
     // Draw background grid.
-    painter.setRenderHint(QPainter::Antialiasing, false);
-    QPen framePen;
     int penSize = 1;
-    framePen.setColor(m_frameColor);
-    framePen.setWidth(penSize);
-    painter.setPen(framePen);
-
     int gridX = rect().x() + penSize;
     int gridY = rect().y() + crect42.bottom() + margin;
     int gridWidth = this->width() - 2 * penSize;
     int gridHeight = renderMaxHeight + renderMaxHeight + 4 * penSize;
 
-    QPainterPath framePath;
     QRect chartRect(gridX, gridY, gridWidth, gridHeight);
-    framePath.addRect(chartRect);
-    painter.drawPath(framePath);
-
-    // Draw grid.
-    QPen gridPen;
-    QVector<qreal> dashes;
-    qreal space = 2;
-    dashes << 2 << space;
-    gridPen.setColor(m_frameColor);
-    //set to 0 lead to line with always 1px
-    gridPen.setWidth(0);
-    gridPen.setDashPattern(dashes);
-    painter.setPen(gridPen);
-
-    int gridLineX = gridX;
-    while (gridLineX + gridSize + penSize < gridX + gridWidth) {
-        gridLineX += gridSize + penSize;
-        painter.drawLine(gridLineX, gridY + 1, gridLineX, gridY + gridHeight - 1);
-    }
-    int gridLineY = gridY;
-    while (gridLineY + gridSize + penSize < gridY + gridHeight) {
-        gridLineY += gridSize + penSize;
-        painter.drawLine(gridX + 1, gridLineY, gridX + gridWidth - 1, gridLineY);
-    }
-
-    painter.setRenderHint(QPainter::Antialiasing, true);
+    m_grid.draw(painter, chartRect, m_frameColor);
 
-    QPainterPath clip;
-    clip.addRect(chartRect);
-    painter.setClipPath(clip);
-
-    qreal networkCurveWidth = 1.2;
-
-    QBrush recvBrush(recvColor), sentBrush(sentColor);
-
-    painter.translate(chartRect.x() + 2, chartRect.y() + chartRect.height() / 2 - 2);
-    painter.scale(1, -1);
-    painter.setPen(QPen(recvBrush, networkCurveWidth));
-    painter.drawPath(downloadPath);
-
-    painter.translate(0, -5);
-    painter.scale(1, -1);
-    painter.setPen(QPen(sentBrush, networkCurveWidth));
-    painter.drawPath(uploadPath);
+    // download above the middle line, upload below it
+    qreal distance = (this->width() - 2) * 1.0 / pointsNumber;
+    int middle = chartRect.y() + chartRect.height() / 2;
+    m_curves.setGeometry(chartRect, chartRect.x() + 2 + pointsNumber * distance, distance);
+    m_curves.setBaseline(0, middle - 2, -renderMaxHeight);
+    m_curves.setBaseline(1, middle + 3, renderMaxHeight);
+    m_curves.draw(painter);
 
     setFixedHeight(chartRect.bottom() + 2 * penSize);
 }
@@ -6,8 +6,9 @@
 #ifndef COMPACTNETWORKMONITOR_H
 #define COMPACTNETWORKMONITOR_H
 
+#include "gui/chart_curve_layer.h"
+
 #include <QWidget>
-#include <QPainterPath>
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 #include <DApplicationHelper>
@@ -49,13 +50,11 @@ private:
     void changeTheme(DGuiApplicationHelper::ColorType themeType);
 #endif
     void changeFont(const QFont &font);
-    void getPainterPathByData(QList<double> *listData, QPainterPath &path, qreal maxVlaue);
 
 private:
-    QList<double> *downloadSpeeds;
-    QList<double> *uploadSpeeds;
-    QPainterPath downloadPath;
-    QPainterPath uploadPath;
+    // curve 0: download speeds, curve 1: upload speeds
+    ChartCurveLayer m_curves;
+    ChartGrid m_grid;
 
     QColor recvColor {"#E14300"};
     QColor sentColor {"#004EEF"};
@@ -107,6 +107,102 @@ public Q_SLOTS:  // METHODS
         return {ec, list};
     }
 
+    /**
+     * @brief ListUnitsByPatterns List units matching states & name patterns, filtered by systemd
+     * @param states Unit states (load, active or sub state), empty list matches any state
+     * @param patterns Unit name glob patterns, empty list matches any name
+     * @return Error context & units list pair
+     */
+    inline QPair<ErrorContext, UnitInfoList> ListUnitsByPatterns(const QStringList &states,
+                                                                 const QStringList &patterns)
+    {
+        // units list
+        UnitInfoList list;
+        // argument list
+        QList<QVariant> args;
+        args << states << patterns;
+        // error context
+        ErrorContext ec;
+
+        // call dbus interface method: ListUnitsByPatterns
+        QDBusMessage reply = callWithArgumentList(QDBus::BlockWithGui, "ListUnitsByPatterns", args);
+        // check dbus reply
+        if (reply.type() == QDBusMessage::ErrorMessage) {
+            ec.setCode(ErrorContext::kErrorTypeDBus);
+            ec.setSubCode(lastError().type());
+            ec.setErrorName(reply.errorName());
+            ec.setErrorMessage(reply.errorMessage());
+        } else {
+            Q_ASSERT(reply.type() == QDBusMessage::ReplyMessage);
+            // check signature
+            if (reply.signature() == "a(ssssssouso)") {
+                qvariant_cast<QDBusArgument>(reply.arguments()[0]) >> list;
+            }
+        }
+
+        return {ec, list};
+    }
+
+    /**
+     * @brief ListUnitFilesByPatterns List installed unit files matching states & name patterns
+     * @param states Unit file states, empty list matches any state
+     * @param patterns Unit file name glob patterns, empty list matches any name
+     * @return Error context & installed unit files list pair
+     */
+    inline QPair<ErrorContext, UnitFileInfoList> ListUnitFilesByPatterns(const QStringList &states,
+                                                                         const QStringList &patterns)
+    {
+        // installed unit files list
+        UnitFileInfoList list;
+        // argument list
+        QList<QVariant> args;
+        args << states << patterns;
+        // error context
+        ErrorContext ec {};
+
+        // call dbus interface method: ListUnitFilesByPatterns
+        QDBusMessage reply = callWithArgumentList(QDBus::BlockWithGui, "ListUnitFilesByPatterns", args);
+        // check dbus reply
+        if (reply.type() == QDBusMessage::ErrorMessage) {
+            ec.setCode(ErrorContext::kErrorTypeDBus);
+            ec.setSubCode(lastError().type());
+            ec.setErrorName(reply.errorName());
+            ec.setErrorMessage(reply.errorMessage());
+        } else {
+            Q_ASSERT(reply.type() == QDBusMessage::ReplyMessage);
+            // check signature
+            if (reply.signature() == "a(ss)") {
+                qvariant_cast<QDBusArgument>(reply.arguments()[0]) >> list;
+            }
+        }
+
+        return {ec, list};
+    }
+
+    /**
+     * @brief Subscribe Ask systemd to send UnitNew, UnitRemoved & PropertiesChanged signals to us
+     * @return Error context
+     */
+    inline ErrorContext Subscribe()
+    {
+        // error context
+        ErrorContext ec {};
+        // argument list
+        QList<QVariant> args;
+
+        // dbus interface method call: Subscribe
+        QDBusMessage reply = callWithArgumentList(QDBus::Block, "Subscribe", args);
+        // check dbus reply
+        if (reply.type() == QDBusMessage::ErrorMessage) {
+            ec.setCode(ErrorContext::kErrorTypeDBus);
+            ec.setSubCode(lastError().type());
+            ec.setErrorName(reply.errorName());
+            ec.setErrorMessage(reply.errorMessage());
+        }
+
+        return ec;
+    }
+
     /**
      * @brief GetUnit Get unit object path by path
      * @param path Object path
@@ -197,30 +197,22 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
         iconRect.adjust(0, diff, 0, -diff);
 
         // Qt的QIcon::pixmap()接口返回QPixmap对象的内存不会回收，此处使用QPixmapCache类来管理进程图标内存资源
-        // 原有QPixmapCache::find接口返回的pixmap指针为空，改为返回pixmap引用对象，保证能根据进程名从缓存中获取到图标资源
         // https://pms.uniontech.com/bug-view-239575.html
-        const QString &procName = index.data(Qt::UserRole + 4).toString();
+        // pixmaps are keyed by icon & size: processes share their icon, so they share the rendered pixmap too
+        const QString &pixmapKey = QString("%1-%2x%3").arg(icon.cacheKey()).arg(iconRect.width()).arg(iconRect.height());
 
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
         QPixmap iconPixmap;
-        core::process::ProcessIconCache::instance()->iconPixmapCache.find(procName, iconPixmap);
-        if (!iconPixmap.isNull()) {
-            painter->drawPixmap(iconRect, iconPixmap);
-        } else {
-            const QPixmap &iconPix = icon.pixmap(iconRect.size());
-            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(procName, iconPix);
-            painter->drawPixmap(iconRect, iconPix);
-        }
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(pixmapKey, iconPixmap)) {
 #else
-        QPixmap iconPixmap;
-        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(procName, &iconPixmap)) {
+        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(pixmapKey, &iconPixmap)) {
+#endif
             painter->drawPixmap(iconRect, iconPixmap);
         } else {
             const QPixmap &iconPix = icon.pixmap(iconRect.size());
-            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(procName, iconPix);
+            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(pixmapKey, iconPix);
             painter->drawPixmap(iconRect, iconPix);
         }
-#endif
     }
     // draw content text
     painter->setPen(forground);
@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "chart_curve_layer.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QPaintDevice>
+
+namespace {
+// more samples than this since the last draw, redraw instead of scrolling
+const int kMaxScrollSamples = 4;
+} // namespace
+
+ChartSeries::ChartSeries(int capacity)
+    : m_samples(size_t(qMax(capacity, 1)))
+{
+}
+
+void ChartSeries::append(float value)
+{
+    // max leaves with the oldest sample, rescan
+    bool rescan = m_samples.full() && m_samples.front() >= m_max;
+    m_samples.push_back(value);
+    ++m_appended;
+
+    if (rescan)
+        updateMax();
+    else if (m_samples.size() == 1 || value > m_max)
+        m_max = value;
+}
+
+void ChartSeries::fill(float value)
+{
+    while (!m_samples.full())
+        append(value);
+}
+
+void ChartSeries::setCapacity(int capacity)
+{
+    m_samples.setCapacity(size_t(qMax(capacity, 1)));
+    updateMax();
+}
+
+void ChartSeries::updateMax()
+{
+    m_max = m_samples.empty() ? 0 : m_samples[0];
+    for (size_t i = 1; i < m_samples.size(); ++i)
+        m_max = qMax(m_max, m_samples[i]);
+}
+
+void ChartGrid::draw(QPainter &painter, const QRect &frame, const QColor &color, const QBrush &background)
+{
+    qreal ratio = painter.device()->devicePixelRatioF();
+    if (m_pixmap.isNull() || frame.size() != m_frame.size() || color != m_color || background != m_background
+            || !qFuzzyCompare(ratio, m_pixmap.devicePixelRatioF())) {
+        // the frame's pen covers one more pixel right & below
+        m_pixmap = QPixmap((frame.size() + QSize(1, 1)) * ratio);
+        m_pixmap.setDevicePixelRatio(ratio);
+        m_pixmap.fill(Qt::transparent);
+
+        QPainter gridPainter(&m_pixmap);
+        drawGrid(gridPainter, QRect(QPoint(0, 0), frame.size()), color, background);
+
+        m_color = color;
+        m_background = background;
+    }
+    m_frame = frame;
+
+    painter.drawPixmap(frame.topLeft(), m_pixmap);
+}
+
+void ChartGrid::invalidate()
+{
+    m_pixmap = QPixmap();
+}
+
+void ChartGrid::drawGrid(QPainter &painter, const QRect &frame, const QColor &color, const QBrush &background, int gridSize)
+{
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    int penSize = 1;
+    painter.setPen(QPen(color, penSize));
+    painter.setBrush(background);
+    painter.drawRect(frame);
+
+    // Draw grid.
+    QPen gridPen;
+    QVector<qreal> dashes;
+    qreal space = 2;
+    dashes << space << space;
+    gridPen.setDashPattern(dashes);
+    gridPen.setColor(color);
+    //set to 0 lead to line with always 1px
+    gridPen.setWidth(0);
+    painter.setPen(gridPen);
+
+    int gridX = frame.x();
+    int gridY = frame.y();
+    int gridWidth = frame.width();
+    int gridHeight = frame.height();
+
+    int gridLineX = gridX;
+    while (gridLineX + gridSize + penSize < gridX + gridWidth) {
+        gridLineX += gridSize + penSize;
+        painter.drawLine(gridLineX, gridY + 1, gridLineX, gridY + gridHeight - 1);
+    }
+    int gridLineY = gridY;
+    while (gridLineY + gridSize + penSize < gridY + gridHeight) {
+        gridLineY += gridSize + penSize;
+        painter.drawLine(gridX + 1, gridLineY, gridX + gridWidth - 1, gridLineY);
+    }
+
+    painter.restore();
+}
+
+ChartCurveLayer::ChartCurveLayer(int points)
+    : m_points(qMax(points, 1))
+{
+}
+
+int ChartCurveLayer::addCurve(const QPen &pen)
+{
+    curve_t curve {ChartSeries(m_points), pen};
+    m_curves.push_back(curve);
+    m_valid = false;
+    return int(m_curves.size()) - 1;
+}
+
+void ChartCurveLayer::setPen(int curve, const QPen &pen)
+{
+    if (m_curves[size_t(curve)].pen == pen)
+        return;
+
+    m_curves[size_t(curve)].pen = pen;
+    m_valid = false;
+}
+
+void ChartCurveLayer::setBaseline(int curve, qreal baseline, qreal amplitude)
+{
+    auto &c = m_curves[size_t(curve)];
+    if (qFuzzyCompare(c.baseline, baseline) && qFuzzyCompare(c.amplitude, amplitude))
+        return;
+
+    c.baseline = baseline;
+    c.amplitude = amplitude;
+    m_valid = false;
+}
+
+void ChartCurveLayer::setPointCount(int points)
+{
+    m_points = qMax(points, 1);
+    for (auto &curve : m_curves)
+        curve.series.setCapacity(m_points);
+    m_valid = false;
+}
+
+void ChartCurveLayer::setGeometry(const QRect &rect, qreal right, qreal step)
+{
+    if (rect == m_rect && qFuzzyCompare(right, m_right) && qFuzzyCompare(step, m_step))
+        return;
+
+    m_rect = rect;
+    m_right = right;
+    m_step = step;
+    m_valid = false;
+}
+
+void ChartCurveLayer::setScale(qreal scale)
+{
+    if (qFuzzyCompare(scale, m_scale))
+        return;
+
+    m_scale = scale;
+    m_valid = false;
+}
+
+void ChartCurveLayer::invalidate()
+{
+    m_valid = false;
+}
+
+void ChartCurveLayer::draw(QPainter &painter)
+{
+    if (m_rect.isEmpty())
+        return;
+
+    qreal ratio = painter.device()->devicePixelRatioF();
+    if (!qFuzzyCompare(ratio, m_ratio)) {
+        m_ratio = ratio;
+        m_valid = false;
+    }
+
+    int samples = m_valid ? pendingSamples() : -1;
+    if (samples < 0 || samples > kMaxScrollSamples)
+        render();
+    else if (samples > 0)
+        scroll(samples);
+
+    painter.drawPixmap(m_rect.topLeft(), m_pixmap);
+}
+
+int ChartCurveLayer::pendingSamples() const
+{
+    int samples = 0;
+    bool moved = false;
+    for (auto &curve : m_curves) {
+        if (curve.series.isEmpty())
+            continue;
+
+        quint64 count = curve.series.appended() - curve.drawn;
+        // segments are appended to the last drawn sample, it must still be there
+        if (count >= quint64(curve.series.size()))
+            return -1;
+        if (moved && int(count) != samples)
+            return -1;
+        samples = int(count);
+        moved = true;
+    }
+    return samples;
+}
+
+void ChartCurveLayer::render()
+{
+    m_pixmap = QPixmap(m_rect.size() * m_ratio);
+    m_pixmap.setDevicePixelRatio(m_ratio);
+    m_pixmap.fill(Qt::transparent);
+
+    QPainter painter(&m_pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(-m_rect.topLeft());
+
+    for (auto &curve : m_curves) {
+        int size = curve.series.size();
+        drawCurve(painter, curve, 0, m_right - (size - 1) * m_step);
+    }
+
+    m_pending = 0;
+    m_valid = true;
+}
+
+void ChartCurveLayer::scroll(int samples)
+{
+    // whole device pixels to scroll, the remainder is carried over to the next tick
+    m_pending += samples * m_step * m_ratio;
+    int dx = qRound(m_pending);
+    if (dx <= 0 || dx >= m_pixmap.width()) {
+        render();
+        return;
+    }
+    m_pending -= dx;
+
+    m_pixmap.scroll(-dx, 0, m_pixmap.rect());
+
+    QPainter painter(&m_pixmap);
+    // scroll leaves the old pixels in the exposed strip
+    qreal shift = dx / m_ratio;
+    qreal width = m_pixmap.width() / m_ratio;
+    painter.setCompositionMode(QPainter::CompositionMode_Clear);
+    painter.fillRect(QRectF(width - shift, 0, shift, m_rect.height()), Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(-m_rect.topLeft());
+    for (auto &curve : m_curves) {
+        // last drawn sample moved to m_right - shift, new samples share the exposed strip
+        drawCurve(painter, curve, curve.series.size() - 1 - samples, m_right - shift);
+    }
+}
+
+void ChartCurveLayer::drawCurve(QPainter &painter, curve_t &curve, int first, qreal left)
+{
+    const auto &series = curve.series;
+    int size = series.size();
+    curve.drawn = series.appended();
+    if (size - first < 2)
+        return;
+
+    qreal step = (m_right - left) / (size - 1 - first);
+    qreal x = left;
+    qreal y = valueY(curve, series.at(first));
+
+    QPainterPath path;
+    path.moveTo(x, y);
+    for (int i = first + 1; i < size; ++i) {
+        qreal nx = (i == size - 1) ? m_right : x + step;
+        qreal ny = valueY(curve, series.at(i));
+        qreal mx = (x + nx) / 2.0;
+        path.cubicTo(mx, y, mx, ny, nx, ny);
+        x = nx;
+        y = ny;
+    }
+
+    painter.setPen(curve.pen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPath(path);
+}
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CHART_CURVE_LAYER_H
+#define CHART_CURVE_LAYER_H
+
+#include "common/ring_buffer.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QPen>
+#include <QPixmap>
+#include <QRect>
+
+#include <vector>
+
+class QPainter;
+
+/**
+ * @brief Samples of one chart curve, oldest at index 0
+ */
+class ChartSeries
+{
+public:
+    explicit ChartSeries(int capacity = 31);
+
+    inline int capacity() const { return int(m_samples.capacity()); }
+    inline int size() const { return int(m_samples.size()); }
+    inline bool isEmpty() const { return m_samples.empty(); }
+    inline float at(int index) const { return m_samples[size_t(index)]; }
+    inline float last() const { return m_samples.back(); }
+    // largest sample kept, 0 if empty
+    inline float max() const { return m_max; }
+    // samples appended since construction, tells drawers how far the series moved
+    inline quint64 appended() const { return m_appended; }
+
+    void append(float value);
+    // append value until the series is full
+    void fill(float value);
+    // keeps the newest samples, drawers of the series must be invalidated
+    void setCapacity(int capacity);
+
+private:
+    void updateMax();
+
+private:
+    common::core::RingBuffer<float> m_samples;
+    float m_max {0};
+    quint64 m_appended {0};
+};
+
+/**
+ * @brief Chart frame & dash grid, rendered once & blitted until frame size or colors change
+ */
+class ChartGrid
+{
+public:
+    void draw(QPainter &painter, const QRect &frame, const QColor &color, const QBrush &background = Qt::NoBrush);
+    void invalidate();
+
+    /**
+     * @brief Draw frame & a dash line every gridSize pixels inside it
+     */
+    static void drawGrid(QPainter &painter, const QRect &frame, const QColor &color, const QBrush &background, int gridSize = 10);
+
+private:
+    QPixmap m_pixmap;
+    QRect m_frame;
+    QColor m_color;
+    QBrush m_background;
+};
+
+/**
+ * @brief Scrolling chart curves rendered into a cached layer
+ *
+ * Samples are spaced step pixels apart, the newest one at x right; value v of a curve is drawn at
+ * baseline + amplitude * v / scale. Segments are cubics with both control points at the middle of
+ * the segment. When every curve moved by the same few samples since the last draw & nothing else
+ * changed, the layer is scrolled left & only the newest segments are drawn, otherwise it's redrawn.
+ */
+class ChartCurveLayer
+{
+public:
+    explicit ChartCurveLayer(int points = 31);
+
+    int addCurve(const QPen &pen);
+    inline int curveCount() const { return int(m_curves.size()); }
+    inline ChartSeries &series(int curve) { return m_curves[size_t(curve)].series; }
+    inline const ChartSeries &series(int curve) const { return m_curves[size_t(curve)].series; }
+
+    void setPen(int curve, const QPen &pen);
+    void setBaseline(int curve, qreal baseline, qreal amplitude);
+    // samples kept per curve
+    void setPointCount(int points);
+
+    /**
+     * @brief Set layer area & x positions
+     * @param rect Layer area, curves are clipped to it
+     * @param right X of the newest sample
+     * @param step Distance between two samples
+     */
+    void setGeometry(const QRect &rect, qreal right, qreal step);
+    inline const QRect &rect() const { return m_rect; }
+    // value drawn at baseline + amplitude
+    void setScale(qreal scale);
+
+    void invalidate();
+    void draw(QPainter &painter);
+
+private:
+    struct curve_t {
+        ChartSeries series;
+        QPen pen;
+        qreal baseline {0};
+        qreal amplitude {0};
+        quint64 drawn {0};      // series.appended() when last drawn
+    };
+
+    // samples every curve moved since the last draw, -1 if they moved apart
+    int pendingSamples() const;
+    void render();
+    void scroll(int samples);
+    // path from sample first at x left to the newest sample at x right
+    void drawCurve(QPainter &painter, curve_t &curve, int first, qreal left);
+    inline qreal valueY(const curve_t &curve, float value) const
+    {
+        return curve.baseline + (m_scale > 0 ? curve.amplitude * value / m_scale : 0);
+    }
+
+private:
+    std::vector<curve_t> m_curves;
+    int m_points;
+
+    QPixmap m_pixmap;
+    bool m_valid {false};
+    QRect m_rect;
+    qreal m_right {0};
+    qreal m_step {0};
+    qreal m_scale {1};
+    qreal m_ratio {1};
+    // scrolled distance not yet applied, pixmap only scrolls by whole device pixels
+    qreal m_pending {0};
+};
+
+#endif // CHART_CURVE_LAYER_H
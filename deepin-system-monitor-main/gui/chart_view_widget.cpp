@@ -19,8 +19,15 @@ using namespace common::format;
 
 DWIDGET_USE_NAMESPACE
 const int allDatacount = 30;
-ChartViewWidget::ChartViewWidget(ChartViewTypes types, QWidget *parent) : QWidget(parent), m_viewType(types)
+ChartViewWidget::ChartViewWidget(ChartViewTypes types, QWidget *parent)
+    : QWidget(parent)
+    , m_curves(allDatacount + 1)
+    , m_viewType(types)
 {
+    m_data1Curve = m_curves.addCurve(QPen(m_data1Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    m_data2Curve = m_curves.addCurve(QPen(m_data2Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    m_curves.setScale(m_maxData);
+
     changeFont(DApplication::font());
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged,
             this, &ChartViewWidget::changeFont);
@@ -41,89 +48,64 @@ void ChartViewWidget::changeTheme()
 void ChartViewWidget::setSpeedAxis(bool speed)
 {
     m_speedAxis = speed;
-    if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-        setAxisTitle(formatUnit_memory_disk(qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong()), B, 1, true));
-    else
-        setAxisTitle(formatUnit_net(qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong()), B, 1, true));
+    setAxisTitle(axisText(qMax(m_maxData1, m_maxData2)));
 }
 
 void ChartViewWidget::setData1Color(const QColor &color)
 {
     m_data1Color = color;
+    m_curves.setPen(m_data1Curve, QPen(m_data1Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
 }
 
 void ChartViewWidget::addData1(const QVariant &data)
 {
-    m_listData1 << data;
-    if (m_listData1.size() > allDatacount + 1) {
-        m_listData1.pop_front();
-    }
+    auto &series = m_curves.series(m_data1Curve);
+    series.append(float(data.toDouble()));
 
-    auto maxElement = std::max_element(m_listData1.begin(), m_listData1.end(),
-        [](const QVariant &a, const QVariant &b) {
-            return a.toLongLong() < b.toLongLong();
-        });
-    const QVariant &maxdata = *maxElement;
-    if (maxdata.toLongLong() > 0 && maxdata != m_maxData1) {
-        m_maxData1 = QVariant(maxdata.toLongLong() * 1.1);
-        m_maxData = qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong());
-
-        // 这边需要通过当前的图标界面类型去区分, 内存和磁盘统一处理
-        if (m_speedAxis) {
-            if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                setAxisTitle(formatUnit_memory_disk(m_maxData, B, 1, true));
-            else
-                setAxisTitle(formatUnit_net(m_maxData, B, 1, true));
-        }
-
-    } else {
+    qlonglong maxdata = qRound64(series.max());
+    if (maxdata > 0) {
+        m_maxData1 = qRound64(maxdata * 1.1);
+        updateScale();
+    } else if (m_speedAxis) {
         // when the data hold the zero num,we should set the chart max value as 0
-        if (m_speedAxis) {
-            if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                setAxisTitle(formatUnit_memory_disk(0, B, 1, true));
-            else
-                setAxisTitle(formatUnit_net(0, B, 1, true));
-        }
+        setAxisTitle(axisText(0));
     }
 }
 
 void ChartViewWidget::setData2Color(const QColor &color)
 {
     m_data2Color = color;
+    m_curves.setPen(m_data2Curve, QPen(m_data2Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
 }
 
 void ChartViewWidget::addData2(const QVariant &data)
 {
-    m_listData2 << data;
-    if (m_listData2.size() > allDatacount + 1) {
-        m_listData2.pop_front();
+    auto &series = m_curves.series(m_data2Curve);
+    series.append(float(data.toDouble()));
+
+    qlonglong maxdata = qRound64(series.max());
+    if (maxdata > 0) {
+        m_maxData2 = qRound64(maxdata * 1.1);
+        updateScale();
     }
+}
 
-    auto maxElement = std::max_element(m_listData2.begin(), m_listData2.end(),
-        [](const QVariant &a, const QVariant &b) {
-            return a.toDouble() < b.toDouble();
-        });
-    const QVariant &maxdata = *maxElement;
-    if (maxdata.toLongLong() > 0 && maxdata != m_maxData2) {
-        m_maxData2 = QVariant(maxdata.toLongLong() * 1.1);
-        m_maxData = qMax(m_maxData1.toLongLong(), m_maxData2.toLongLong());
-
-        if (m_speedAxis) {
-            if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                setAxisTitle(formatUnit_memory_disk(m_maxData, B, 1, true));
-            else
-                setAxisTitle(formatUnit_net(m_maxData, B, 1, true));
-        } else {
-            // when the data hold the zero num,we should set the chart max value as 0
-            if (m_speedAxis) {
-                if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
-                    setAxisTitle(formatUnit_memory_disk(0, B, 1, true));
-                else
-                    setAxisTitle(formatUnit_net(0, B, 1, true));
-            }
-        }
+void ChartViewWidget::updateScale()
+{
+    m_maxData = qMax(m_maxData1, m_maxData2);
+    // a new scale redraws the curves, an unchanged one keeps scrolling them
+    m_curves.setScale(m_maxData);
 
-    }
+    // 这边需要通过当前的图标界面类型去区分, 内存和磁盘统一处理
+    if (m_speedAxis)
+        setAxisTitle(axisText(m_maxData));
+}
+
+QString ChartViewWidget::axisText(qlonglong value) const
+{
+    if (m_viewType == BLOCK_CHART || m_viewType == MEM_CHART)
+        return formatUnit_memory_disk(value, B, 1, true);
+    return formatUnit_net(value, B, 1, true);
 }
 
 void ChartViewWidget::setAxisTitle(const QString &text)
@@ -136,6 +118,9 @@ void ChartViewWidget::changeFont(const QFont &font)
 {
     Q_UNUSED(font)
     m_textfont = DFontSizeManager::instance()->get(DFontSizeManager::T8);
+    // chart area depends on the label height
+    drawBackPixmap();
+    update();
 }
 
 void ChartViewWidget::resizeEvent(QResizeEvent *event)
@@ -144,74 +129,10 @@ void ChartViewWidget::resizeEvent(QResizeEvent *event)
     drawBackPixmap();
 }
 
-void ChartViewWidget::getPainterPathByData(const QList<QVariant> &listData, QPainterPath &path, QVariant maxYvalue)
+void ChartViewWidget::drawData(QPainter *painter)
 {
-    qreal offsetX = 0;
-    qreal distance = m_chartRect.width() * 1.0 / allDatacount;
-    int dataCount = listData.size();
-    int startIndex = qMax(0, dataCount - allDatacount - 1);
-
-    qlonglong maxL = maxYvalue.toLongLong();
-    const QVariant &lastData = listData.last();
-    if (lastData.canConvert(QMetaType::Double))
-        path.moveTo(offsetX, -m_chartRect.height() * lastData.toDouble() * 1.0 / maxL);
-    else
-        path.moveTo(offsetX, -m_chartRect.height() * lastData.toLongLong() * 1.0 / maxL);
-
-    for (int i = dataCount - 1;  i > startIndex; i--) {
-        QPointF sp;
-        QPointF ep;
-
-        if (listData[i].canConvert(QMetaType::Double)) {
-            sp = QPointF(offsetX, -m_chartRect.height() * listData[i].toDouble() / maxL);
-            ep = QPointF(offsetX - distance, -m_chartRect.height() * listData[i - 1].toDouble() / maxL);
-        } else {
-            sp = QPointF(offsetX, -m_chartRect.height() * listData[i].toLongLong() / maxL);
-            ep = QPointF(offsetX - distance, -m_chartRect.height() * listData[i - 1].toLongLong() / maxL);
-        }
-
-        offsetX -= distance;
-
-        QPointF c1 = QPointF((sp.x() + ep.x()) / 2.0, sp.y());
-        QPointF c2 = QPointF((sp.x() + ep.x()) / 2.0, ep.y());
-        path.cubicTo(c1, c2, ep);
-    }
-
-}
-
-void ChartViewWidget::drawData1(QPainter *painter)
-{
-    if (m_listData1.size() <= 0)
-        return;
-
-    painter->save();
-    painter->setClipRect(m_chartRect.adjusted(1, -1, 1, 1));
-
-    QPainterPath path;
-    painter->setBrush(Qt::NoBrush);
-    painter->setPen(QPen(m_data1Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-    painter->translate(m_chartRect.bottomRight() + QPoint(1, 1));
-
-    getPainterPathByData(m_listData1, path, m_maxData);
-    painter->drawPath(path);
-    painter->restore();
-}
-
-void ChartViewWidget::drawData2(QPainter *painter)
-{
-    if (m_listData2.size() <= 0)
-        return;
-
     painter->save();
-    painter->setClipRect(m_chartRect.adjusted(1, -1, 1, 1));
-
-    QPainterPath path;
-    painter->setBrush(Qt::NoBrush);
-    painter->setPen(QPen(m_data2Color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-    painter->translate(m_chartRect.bottomRight() + QPoint(1, 1));
-
-    getPainterPathByData(m_listData2, path, m_maxData);
-    painter->drawPath(path);
+    m_curves.draw(*painter);
     painter->restore();
 }
 
@@ -220,7 +141,9 @@ void ChartViewWidget::drawBackPixmap()
     if (this->width() == 0 || this->height() == 0)
         return;
 
-    m_backPixmap = QPixmap(this->size());
+    qreal ratio = devicePixelRatioF();
+    m_backPixmap = QPixmap(this->size() * ratio);
+    m_backPixmap.setDevicePixelRatio(ratio);
     m_backPixmap.fill(Qt::transparent);
 
     QPainter painter(&m_backPixmap);
@@ -236,42 +159,31 @@ void ChartViewWidget::drawBackPixmap()
     frameColor.setAlphaF(0.3);
 
     int penSize = 1;
-    painter.setPen(QPen(frameColor, penSize));
-    painter.setBrush(palette.color(QPalette::Base));
     painter.setFont(m_textfont);
+    int textHeight = painter.fontMetrics().height();
 
     int gridX = penSize;
-    int gridY = penSize + painter.fontMetrics().height();
+    int gridY = penSize + textHeight;
     int gridWidth = this->width() - 2 * penSize;
     int gridHeight = this->height() - 2 * gridY;
 
-    QPainterPath framePath;
     m_chartRect = QRect(gridX, gridY, gridWidth, gridHeight);
+    ChartGrid::drawGrid(painter, m_chartRect, frameColor, palette.color(QPalette::Base), gridSize);
 
-    framePath.addRect(m_chartRect);
-    painter.drawPath(framePath);
-
-    // Draw grid.
-    QPen gridPen;
-    QVector<qreal> dashes;
-    qreal space = 2;
-    dashes << space << space;
-    gridPen.setDashPattern(dashes);
-    gridPen.setColor(frameColor);
-    //set to 0 lead to line with always 1px
-    gridPen.setWidth(0);
-    painter.setPen(gridPen);
-
-    int gridLineX = gridX;
-    while (gridLineX + gridSize + penSize < gridX + gridWidth) {
-        gridLineX += gridSize + penSize;
-        painter.drawLine(gridLineX, gridY + 1, gridLineX, gridY + gridHeight - 1);
-    }
-    int gridLineY = gridY;
-    while (gridLineY + gridSize + penSize < gridY + gridHeight) {
-        gridLineY += gridSize + penSize;
-        painter.drawLine(gridX + 1, gridLineY, gridX + gridWidth - 1, gridLineY);
-    }
+    // fixed labels, the scale title changes with the data & is drawn on paint
+    QColor color = palette.color(DPalette::ToolTipText);
+    color.setAlphaF(0.3);
+    painter.setPen(color);
+    QRect bottomTextRect(0, this->height() - textHeight, this->width(), textHeight);
+    painter.drawText(bottomTextRect, Qt::AlignRight | Qt::AlignVCenter, "0");
+    painter.drawText(bottomTextRect, Qt::AlignLeft | Qt::AlignVCenter, tr("60 seconds"));
+
+    // newest sample on the right edge, the chart spans allDatacount intervals
+    m_curves.setGeometry(m_chartRect.adjusted(1, -1, 1, 1), m_chartRect.right() + 1, m_chartRect.width() * 1.0 / allDatacount);
+    m_curves.setBaseline(m_data1Curve, m_chartRect.bottom() + 1, -m_chartRect.height());
+    m_curves.setBaseline(m_data2Curve, m_chartRect.bottom() + 1, -m_chartRect.height());
+    // palette may have changed
+    m_curves.invalidate();
 }
 
 void ChartViewWidget::drawAxisText(QPainter *painter)
@@ -287,10 +199,6 @@ void ChartViewWidget::drawAxisText(QPainter *painter)
     painter->setPen(color);
     painter->setFont(m_textfont);
     painter->drawText(0, 0, this->width(), painter->fontMetrics().height(), Qt::AlignRight | Qt::AlignVCenter, m_axisTitle);
-
-    QRect bottomTextRect(0, this->height() - painter->fontMetrics().height(), this->width(), painter->fontMetrics().height());
-    painter->drawText(bottomTextRect, Qt::AlignRight | Qt::AlignVCenter, "0");
-    painter->drawText(bottomTextRect, Qt::AlignLeft | Qt::AlignVCenter, tr("60 seconds"));
 }
 
 void ChartViewWidget::paintEvent(QPaintEvent *event)
@@ -298,10 +206,8 @@ void ChartViewWidget::paintEvent(QPaintEvent *event)
     QWidget::paintEvent(event);
 
     QPainter painter(this);
-    painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform, true);
     painter.drawPixmap(0, 0, m_backPixmap);
 
-    drawData1(&painter);
-    drawData2(&painter);
+    drawData(&painter);
     drawAxisText(&painter);
 }
@@ -6,9 +6,10 @@
 #ifndef CHART_VIEW_WIDGET_H
 #define CHART_VIEW_WIDGET_H
 
+#include "chart_curve_layer.h"
+
 #include <QWidget>
 #include <QVariant>
-#include <QPainterPath>
 
 class ChartViewWidget : public QWidget
 {
@@ -42,13 +43,12 @@ private slots:
 
 private:
     void drawBackPixmap();
-    void drawData1(QPainter *painter);
-    void drawData2(QPainter *painter);
-    void drawData3(QPainter *painter);
+    void drawData(QPainter *painter);
     void drawAxisText(QPainter *painter);
 
     void setAxisTitle(const QString &text);
-    void getPainterPathByData(const QList<QVariant> &listData, QPainterPath &path,  QVariant maxYvalue);
+    QString axisText(qlonglong value) const;
+    void updateScale();
 
 private:
     int gridSize = 10;
@@ -64,12 +64,14 @@ private:
 
     bool  m_speedAxis = false;
 
-    QVariant m_maxData  = 1;
-    QVariant m_maxData1 = 1;
-    QVariant m_maxData2 = 1;
+    qlonglong m_maxData  = 1;
+    qlonglong m_maxData1 = 1;
+    qlonglong m_maxData2 = 1;
 
-    QList<QVariant> m_listData1;
-    QList<QVariant> m_listData2;
+    // curves of data1 & data2, redrawn only when the scale or size changes
+    ChartCurveLayer m_curves;
+    int m_data1Curve = -1;
+    int m_data2Curve = -1;
 
     ChartViewTypes m_viewType = ChartViewTypes::MEM_CHART;  // 图表界面类型
 };
@@ -5,7 +5,6 @@
 
 #include "cpu_detail_widget.h"
 #include "model/cpu_info_model.h"
-#include "smooth_curve_generator.h"
 #include "common/common.h"
 #include "process/process_db.h"
 #include "system/device_db.h"
@@ -36,264 +35,356 @@
 #include <QHeaderView>
 #include <QScrollArea>
 #include <QPaintEvent>
+#include <QRegion>
+#include <QHelpEvent>
+#include <QToolTip>
+
+#include <cmath>
 
 DWIDGET_USE_NAMESPACE
 
 using namespace common;
 
-CPUDetailGrapTableItem::CPUDetailGrapTableItem(CPUInfoModel *model, int index, QWidget *parent): QWidget(parent), m_cpuInfomodel(model), m_index(index)
+namespace {
+// samples per curve, 30 update intervals across the graph (60 seconds)
+const int kHistorySize = 31;
+// dash grid spacing of the graphs
+const int kGridSection = 10;
+// heatmap shades, a cell is repainted when its shade changes
+const int kHeatLevels = 100;
+
+QList<QColor> cpuColors()
 {
-    m_cpuInfomodel = CPUInfoModel::instance();
-    connect(m_cpuInfomodel, &CPUInfoModel::modelUpdated, this, &CPUDetailGrapTableItem::updateStat);
+    QList<QColor> colors;
+    colors << "#1094D8"
+           << "#F7B300"
+           << "#55D500"
+           << "#C362FF"
+           << "#FF2997"
+           << "#00B4C7"
+           << "#F8E71C"
+           << "#FB1818"
+           << "#8544FF"
+           << "#00D7AB"
+           << "#00D7AB"
+           << "#FF00FF"
+           << "#30BF03"
+           << "#7E41F1"
+           << "#2CA7F8"
+           << "#A005CE";
+    return colors;
 }
+} // namespace
 
-CPUDetailGrapTableItem::~CPUDetailGrapTableItem()
+CPUDetailGrapGrid::CPUDetailGrapGrid(CPUInfoModel *model, QWidget *parent)
+    : QWidget(parent)
+    , m_cpuInfomodel(model ? model : CPUInfoModel::instance())
+    , m_history(kHistorySize, 1)
 {
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    connect(m_cpuInfomodel, &CPUInfoModel::modelUpdated, this, &CPUDetailGrapGrid::updateStat);
+
+    changeFont(DApplication::font());
+    connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged,
+            this, &CPUDetailGrapGrid::changeFont);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    connect(DApplicationHelper::instance(), &DApplicationHelper::themeTypeChanged, this, &CPUDetailGrapGrid::changeTheme);
+#else
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, &CPUDetailGrapGrid::changeTheme);
+#endif
 
+    setCores(0, 1, kNormalMode, 10);
 }
 
-void CPUDetailGrapTableItem::setMode(int mode)
+void CPUDetailGrapGrid::setCores(int count, int columns, DrawMode mode, int spacing)
 {
+    m_count = qMax(count, 0);
+    // like a grid layout, there are no empty columns
+    m_columns = qBound(1, columns, qMax(m_count, 1));
     m_mode = mode;
-    setToolTip(3 == m_mode ? ("CPU" + QString::number(m_index)) : "");
+    m_spacing = spacing;
+
+    size_t cells = size_t(qMax(m_count, 1));
+    m_history.reshape(kHistorySize, cells);
+    m_history.clear();
+    m_unchanged.assign(cells, 0);
+
+    layoutCells();
     update();
 }
 
-void CPUDetailGrapTableItem::sethorizontal(bool isHorizontalLast)
+void CPUDetailGrapGrid::setColors(const QList<QColor> &colors)
 {
-    m_isHorizontalLast = isHorizontalLast;
+    m_colors = colors;
+    m_backPixmap = QPixmap();
+    update();
 }
 
-void CPUDetailGrapTableItem::setVerticalLast(bool isVerticalLast)
+QRect CPUDetailGrapGrid::cellRect(int index) const
 {
-    m_isVerticalLast = isVerticalLast;
+    return m_cells.value(index);
 }
 
-void CPUDetailGrapTableItem::setColor(QColor color)
+void CPUDetailGrapGrid::updateStat()
 {
-    m_color = color;
-    update();
-}
+    const int cells = m_cells.size();
+    const qreal *last = m_history.back();
+    qreal *row = m_history.push_back();
+
+    QRegion dirty;
+    int ndirty = 0;
+    for (int i = 0; i < cells; ++i) {
+        qreal value = corePercent(i);
+        row[i] = value;
+
+        bool changed = true;
+        if (m_mode == kTextMode) {
+            changed = !last || qRound(last[i] * 1000) != qRound(value * 1000);
+        } else if (m_mode == kHeatmapMode) {
+            changed = !last || qRound(last[i] * kHeatLevels) != qRound(value * kHeatLevels);
+        } else {
+            // curves scroll every update, unless the whole history is flat
+            m_unchanged[size_t(i)] = (last && qFuzzyCompare(1. + last[i], 1. + value)) ? m_unchanged[size_t(i)] + 1 : 0;
+            changed = m_unchanged[size_t(i)] < kHistorySize;
+        }
 
-void CPUDetailGrapTableItem::updateStat()
-{
-    // 多核模式时保留原来逻辑
-    if (m_isMutliCoreMode) {
-        if (std::isnan(m_cpuInfomodel->cpuPercentList().value(m_index)))
-            m_cpuPercents.insert(0, 0);
-        else
-            m_cpuPercents.insert(0, m_cpuInfomodel->cpuPercentList().value(m_index) / 100.0);
-    } else {
-        if (std::isnan(m_cpuInfomodel->cpuAllPercent()))
-            m_cpuPercents.insert(0, 0);
-        else
-            m_cpuPercents.insert(0, m_cpuInfomodel->cpuAllPercent() / 100.0);
+        if (changed) {
+            dirty += (m_mode == kNormalMode || m_mode == kSimpleMode) ? graphRect(i) : m_cells[i];
+            ++ndirty;
+        }
     }
-    while (m_cpuPercents.count() > 31)
-        m_cpuPercents.pop_back();
 
-    update();
+    if (ndirty == cells)
+        update();
+    else if (ndirty > 0)
+        update(dirty);
 }
 
-void CPUDetailGrapTableItem::paintEvent(QPaintEvent *event)
+void CPUDetailGrapGrid::changeTheme()
 {
-    Q_UNUSED(event)
-
-    QPainter painter(this);
-
-    if (1 == m_mode)
-        drawNormalMode(painter);
-    else if (2 == m_mode)
-        drawSimpleMode(painter);
-    else if (3 == m_mode)
-        drawTextMode(painter);
+    m_backPixmap = QPixmap();
+    update();
 }
 
-void CPUDetailGrapTableItem::drawNormalMode(QPainter &painter)
+void CPUDetailGrapGrid::changeFont(const QFont &font)
 {
-    const int pensize = 1;
-    QFont font = DApplication::font();
-    font.setPointSizeF(font.pointSizeF() - 1);
-    painter.setFont(font);
-
-    QFont midFont = font;
-    midFont.setPointSizeF(font.pointSizeF() - 1);
-
-    int textHeight = painter.fontMetrics().height();
-    //draw background
-    QRect graphicRect = QRect(pensize, textHeight, this->width() - 2 * pensize, this->height() - textHeight - QFontMetrics(midFont).height());
-    drawBackground(painter, graphicRect);
-
-    //draw text
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    auto *dAppHelper = DApplicationHelper::instance();
-#else
-    auto *dAppHelper = DGuiApplicationHelper::instance();
-#endif
-    auto palette = dAppHelper->applicationPalette();
-    painter.setPen(palette.color(DPalette::TextTips));
-    painter.setRenderHints(QPainter::Antialiasing);
-
-    if (m_isMutliCoreMode) {
-        painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignLeft | Qt::AlignTop, "CPU" + QString::number(m_index));
-    } else {
-        painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignLeft | Qt::AlignTop, "CPU");
-    }
-
-
-    painter.setFont(midFont);
-    int midTextHeight = painter.fontMetrics().height();
-
-    painter.save();
-    QColor midTextColor(palette.color(DPalette::ToolTipText));
-    midTextColor.setAlphaF(0.3);
-    QPen midTextPen = painter.pen();
-    midTextPen.setColor(midTextColor);
-    painter.setPen(midTextPen);
-    painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignRight | Qt::AlignBottom, "100%");
-    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignLeft | Qt::AlignVCenter, tr("60 seconds"));
-    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignRight | Qt::AlignVCenter, "0");
-    painter.restore();
-
-    // draw cpu
-    painter.setClipRect(graphicRect);
-    if (m_cpuPercents.count() > 0) {
-        painter.setPen(QPen(m_color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-        painter.setBrush(Qt::NoBrush);
-
-        QPainterPath Painterpath;
+    m_font = font;
+    m_font.setPointSizeF(font.pointSizeF() - 1);
+    m_midFont = m_font;
+    m_midFont.setPointSizeF(m_font.pointSizeF() - 1);
+    m_textHeight = QFontMetrics(m_font).height();
+    m_midTextHeight = QFontMetrics(m_midFont).height();
+
+    m_backPixmap = QPixmap();
+    update();
+}
 
-        QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
-        Painterpath.moveTo(sp);
+void CPUDetailGrapGrid::paintEvent(QPaintEvent *event)
+{
+    if (m_backPixmap.isNull())
+        drawBackPixmap();
 
-        for (int i = 0; i < 30; ++i) {
-            if (m_cpuPercents.count() > i) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
-                QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
-                QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
-                Painterpath.cubicTo(c1, c2, ep);
-                sp = ep;
-            }
+    // painter is clipped to the update region, only dirty cells are blitted & drawn
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_backPixmap);
+
+    const QRect &exposed = event->rect();
+    const qreal *values = m_history.back();
+    if (m_mode == kNormalMode || m_mode == kSimpleMode)
+        painter.setRenderHint(QPainter::Antialiasing);
+    else if (m_mode == kTextMode)
+        painter.setFont(DApplication::font());
+
+    for (int i = 0; i < m_cells.size(); ++i) {
+        if (!exposed.intersects(m_cells[i]))
+            continue;
+
+        qreal value = values ? values[i] : 0;
+        if (m_mode == kTextMode) {
+            painter.setPen(coreColor(i));
+            painter.drawText(m_cells[i], Qt::AlignCenter, QString::number(value * 100, 'f', 1) + "%");
+        } else if (m_mode == kHeatmapMode) {
+            QColor color = coreColor(0);
+            color.setAlphaF(0.1 + 0.9 * qBound(0., value, 1.));
+            painter.fillRect(m_cells[i].adjusted(1, 1, -1, -1), color);
+        } else {
+            drawCurve(painter, i);
         }
-
-        painter.drawPath(Painterpath);
     }
 }
 
-void CPUDetailGrapTableItem::drawSimpleMode(QPainter &painter)
+void CPUDetailGrapGrid::resizeEvent(QResizeEvent *event)
 {
-    //draw background
-    const int pensize = 1;
-    QRect graphicRect = QRect(pensize, pensize, this->width() - 2 * pensize, this->height() - 2 * pensize);
-    drawBackground(painter, graphicRect);
-
-    // draw cpu
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.setClipRect(graphicRect);
-
-    if (m_cpuPercents.count() > 0) {
-        painter.setPen(QPen(m_color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-        painter.setBrush(Qt::NoBrush);
-
-        QPainterPath Painterpath;
-
-        QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
-        Painterpath.moveTo(sp);
+    QWidget::resizeEvent(event);
+    layoutCells();
+}
 
-        for (int i = 0; i < 30; ++i) {
-            if (m_cpuPercents.count() > i) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(i + 1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(i + 1)) * graphicRect.height() + graphicRect.y());
-                QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
-                QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
-                Painterpath.cubicTo(c1, c2, ep);
-                sp = ep;
-            }
+bool CPUDetailGrapGrid::event(QEvent *event)
+{
+    // cells without a title tell their cpu on hover
+    if (event->type() == QEvent::ToolTip && m_count > 0 && (m_mode == kTextMode || m_mode == kHeatmapMode)) {
+        auto *helpEvent = static_cast<QHelpEvent *>(event);
+        int index = cellAt(helpEvent->pos());
+        if (index < 0) {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
         }
 
-        painter.drawPath(Painterpath);
+        QString text = "CPU" + QString::number(index);
+        if (m_mode == kHeatmapMode && m_history.back())
+            text += QString(": %1%").arg(m_history.back()[index] * 100, 0, 'f', 1);
+        QToolTip::showText(helpEvent->globalPos(), text, this, m_cells[index]);
+        return true;
     }
+
+    return QWidget::event(event);
 }
 
-void CPUDetailGrapTableItem::drawTextMode(QPainter &painter)
+qreal CPUDetailGrapGrid::corePercent(int index) const
 {
-    QRect rect = QRect(0, 0, this->width() - (m_isHorizontalLast ? 1 : 0), this->height() - (m_isVerticalLast ? 1 : 0));
+    qreal percent = m_count > 0 ? m_cpuInfomodel->cpuPercent(index) : m_cpuInfomodel->cpuAllPercent();
+    return std::isnan(percent) ? 0 : percent / 100.0;
+}
 
-    // draw frame
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    auto *dAppHelper = DApplicationHelper::instance();
-#else
-    auto *dAppHelper = DGuiApplicationHelper::instance();
-#endif
-    auto palette = dAppHelper->applicationPalette();
-    QColor frameColor = palette.color(DPalette::FrameBorder);
-    painter.setPen(frameColor);
-    painter.setBrush(Qt::NoBrush);
-    painter.drawRect(rect);
+void CPUDetailGrapGrid::layoutCells()
+{
+    const int cells = qMax(m_count, 1);
+    const int rows = (cells + m_columns - 1) / m_columns;
+    // cells share one size, so they share one grid pixmap too
+    const int cellWidth = qMax(0, (width() - (m_columns - 1) * m_spacing) / m_columns);
+    const int cellHeight = qMax(0, (height() - (rows - 1) * m_spacing) / rows);
+
+    m_cells.resize(cells);
+    for (int i = 0; i < cells; ++i) {
+        int column = i % m_columns;
+        int row = i / m_columns;
+        m_cells[i] = QRect(column * (cellWidth + m_spacing), row * (cellHeight + m_spacing), cellWidth, cellHeight);
+    }
 
-    painter.setPen(m_color);
-    painter.drawText(rect, Qt::AlignCenter, QString::number(m_cpuPercents.value(m_index) * 100, 'f', 1) + "%");
+    m_backPixmap = QPixmap();
 }
 
-void CPUDetailGrapTableItem::drawSingleCoreMode(QPainter &painter)
+void CPUDetailGrapGrid::drawBackPixmap()
 {
-    const int pensize = 1;
-    QFont font = DApplication::font();
-    font.setPointSizeF(font.pointSizeF() - 1);
-    painter.setFont(font);
-
-    QFont midFont = font;
-    midFont.setPointSizeF(font.pointSizeF() - 1);
+    if (this->width() == 0 || this->height() == 0 || m_cells.isEmpty())
+        return;
+
+    const qreal ratio = devicePixelRatioF();
+    m_backPixmap = QPixmap(this->size() * ratio);
+    m_backPixmap.setDevicePixelRatio(ratio);
+    m_backPixmap.fill(Qt::transparent);
+
+    QPixmap gridPixmap;
+    if (m_mode == kNormalMode || m_mode == kSimpleMode) {
+        // frame & dash grid of one graph, the frame's pen covers one more pixel right & below
+        QRect graph = graphRect(0);
+        gridPixmap = QPixmap((graph.size() + QSize(1, 1)) * ratio);
+        gridPixmap.setDevicePixelRatio(ratio);
+        gridPixmap.fill(Qt::transparent);
+
+        QPainter gridPainter(&gridPixmap);
+        drawBackground(gridPainter, QRect(QPoint(0, 0), graph.size()));
+    }
 
-    int textHeight = painter.fontMetrics().height();
-    //draw background
-    QRect graphicRect = QRect(pensize, textHeight, this->width() - 2 * pensize, this->height() - textHeight - QFontMetrics(midFont).height());
-    drawBackground(painter, graphicRect);
+    QPainter painter(&m_backPixmap);
+    for (int i = 0; i < m_cells.size(); ++i)
+        drawCellBackground(painter, i, gridPixmap);
+}
 
-    //draw text
+void CPUDetailGrapGrid::drawCellBackground(QPainter &painter, int index, const QPixmap &gridPixmap)
+{
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     auto *dAppHelper = DApplicationHelper::instance();
 #else
     auto *dAppHelper = DGuiApplicationHelper::instance();
 #endif
     auto palette = dAppHelper->applicationPalette();
-    painter.setPen(palette.color(DPalette::TextTips));
-    painter.setRenderHints(QPainter::Antialiasing);
+    const QRect &cell = m_cells[index];
 
-    painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignLeft | Qt::AlignTop, "CPU" + QString::number(m_index));
+    if (m_mode == kTextMode || m_mode == kHeatmapMode) {
+        // neighbours share a border, the last column & row keep theirs inside
+        bool lastColumn = (index % m_columns) == m_columns - 1;
+        bool lastRow = index / m_columns == (m_cells.size() - 1) / m_columns;
+        painter.setPen(palette.color(DPalette::FrameBorder));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(cell.adjusted(0, 0, lastColumn ? -1 : 0, lastRow ? -1 : 0));
+        return;
+    }
 
-    painter.setFont(midFont);
-    int midTextHeight = painter.fontMetrics().height();
+    QRect graph = graphRect(index);
+    painter.drawPixmap(graph.topLeft(), gridPixmap);
+    if (m_mode != kNormalMode)
+        return;
 
-    painter.drawText(QRect(pensize, 0, this->width() - 2 * pensize, textHeight), Qt::AlignRight | Qt::AlignBottom, "100%");
-    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignLeft | Qt::AlignVCenter, tr("60 seconds"));
-    painter.drawText(QRect(pensize, graphicRect.bottom() + pensize, this->width() - 2 * pensize, midTextHeight), Qt::AlignRight | Qt::AlignVCenter, "0");
+    // title & axis labels
+    const int pensize = 1;
+    QRect title(cell.x() + pensize, cell.y(), cell.width() - 2 * pensize, m_textHeight);
+    painter.setFont(m_font);
+    painter.setPen(palette.color(DPalette::TextTips));
+    painter.drawText(title, Qt::AlignLeft | Qt::AlignTop, m_count > 0 ? "CPU" + QString::number(index) : "CPU");
 
-    // draw cpu
-    painter.setClipRect(graphicRect);
-    if (m_cpuPercents.count() > 0) {
-        painter.setPen(QPen(m_color, 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-        painter.setBrush(Qt::NoBrush);
+    QColor midTextColor(palette.color(DPalette::ToolTipText));
+    midTextColor.setAlphaF(0.3);
+    painter.setFont(m_midFont);
+    painter.setPen(midTextColor);
+    QRect axis(cell.x() + pensize, graph.bottom() + pensize, cell.width() - 2 * pensize, m_midTextHeight);
+    painter.drawText(title, Qt::AlignRight | Qt::AlignBottom, "100%");
+    painter.drawText(axis, Qt::AlignLeft | Qt::AlignVCenter, QCoreApplication::translate("CPUDetailGrapTableItem", "60 seconds"));
+    painter.drawText(axis, Qt::AlignRight | Qt::AlignVCenter, "0");
+}
 
-        QPainterPath Painterpath;
+void CPUDetailGrapGrid::drawCurve(QPainter &painter, int index)
+{
+    const int count = int(m_history.size());
+    if (count == 0)
+        return;
+
+    // newest sample on the right edge, one interval to the left per update
+    const QRect graph = graphRect(index);
+    const qreal step = qreal(graph.width()) / (kHistorySize - 1);
+    m_points.resize(count);
+    for (int i = 0; i < count; ++i) {
+        qreal value = m_history.row(size_t(count - 1 - i))[index];
+        m_points[i] = QPointF(graph.x() + graph.width() - step * i, (1.0 - value) * graph.height() + graph.y());
+    }
 
-        QPointF sp = QPointF(graphicRect.width() + graphicRect.x(), (1.0 - m_cpuPercents.value(0)) * graphicRect.height() + graphicRect.y());
-        Painterpath.moveTo(sp);
+    painter.save();
+    painter.setClipRect(graph);
+    painter.setPen(QPen(coreColor(index), 1.5, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPolyline(m_points);
+    painter.restore();
+}
 
-        for (int i = 0; i < 30; ++i) {
-            if (m_cpuPercents.count() > 0) {
-                QPointF ep = QPointF((graphicRect.width() - static_cast<double>(graphicRect.width()) / (30.0 / static_cast<double>(1))) + graphicRect.x(), (1.0 - m_cpuPercents.value(1)) * graphicRect.height() + graphicRect.y());
-                QPointF c1 = QPointF((sp.x() + ep.x()) / 2, sp.y());
-                QPointF c2 = QPointF((sp.x() + ep.x()) / 2, ep.y());
-                Painterpath.cubicTo(c1, c2, ep);
-                sp = ep;
-            }
-        }
+QRect CPUDetailGrapGrid::graphRect(int index) const
+{
+    const QRect &cell = m_cells[index];
+    const int pensize = 1;
+    if (m_mode == kNormalMode)
+        return QRect(cell.x() + pensize, cell.y() + m_textHeight, cell.width() - 2 * pensize, cell.height() - m_textHeight - m_midTextHeight);
+    if (m_mode == kSimpleMode)
+        return cell.adjusted(pensize, pensize, -pensize, -pensize);
+    return cell;
+}
+
+QColor CPUDetailGrapGrid::coreColor(int index) const
+{
+    if (m_colors.isEmpty())
+        return QColor("#1094D8");
+    return m_colors[index % m_colors.size()];
+}
 
-        painter.drawPath(Painterpath);
+int CPUDetailGrapGrid::cellAt(const QPoint &pos) const
+{
+    for (int i = 0; i < m_cells.size(); ++i) {
+        if (m_cells[i].contains(pos))
+            return i;
     }
+    return -1;
 }
 
-void CPUDetailGrapTableItem::drawBackground(QPainter &painter, const QRect &graphicRect)
+void CPUDetailGrapGrid::drawBackground(QPainter &painter, const QRect &graphicRect)
 {
     // draw frame
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -319,20 +410,19 @@ void CPUDetailGrapTableItem::drawBackground(QPainter &painter, const QRect &grap
     //set to 0 lead to line with always 1px
     gridPen.setWidth(0);
     painter.setPen(gridPen);
-    int section = 10;
 
     int totalHeight = graphicRect.height() - 2;
-    int currentHeight = graphicRect.y() + section;
+    int currentHeight = graphicRect.y() + kGridSection;
     while (currentHeight < totalHeight + graphicRect.y()) {
         painter.drawLine(graphicRect.x() + 1, currentHeight, graphicRect.x() + graphicRect.width() - 1, currentHeight);
-        currentHeight += section;
+        currentHeight += kGridSection;
     }
 
     int totalWidth = graphicRect.width() - 2;
-    int currentWidth = graphicRect.x() + section;
+    int currentWidth = graphicRect.x() + kGridSection;
     while (currentWidth < totalWidth + graphicRect.x()) {
         painter.drawLine(currentWidth, graphicRect.y() + 1, currentWidth, graphicRect.y() + graphicRect.height() - 1);
-        currentWidth += section;
+        currentWidth += kGridSection;
     }
 }
 
@@ -370,27 +460,33 @@ void CPUDetailWidget::detailFontChanged(const QFont &font)
 
 CPUDetailGrapTable::CPUDetailGrapTable(CPUInfoModel *model, QWidget *parent): QWidget(parent)
 {
+    m_cpuInfoModel = model;
+
+    QGridLayout  *graphicsLayout = new QGridLayout(this);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    graphicsLayout->setMargin(0);
+#else
+    graphicsLayout->setContentsMargins(0, 0, 0, 0);
+#endif
+    graphicsLayout->setHorizontalSpacing(10);
+    graphicsLayout->setVerticalSpacing(10);
+
+    // one widget draws every core
+    m_grid = new CPUDetailGrapGrid(model, this);
+    m_grid->setColors(cpuColors());
+    graphicsLayout->addWidget(m_grid, 0, 0);
+    setLayout(graphicsLayout);
+
     if (m_isMutliCoreMode) {
         setMultiModeLayout(model);
     } else {
         setSingleModeLayout(model);
     }
-    m_cpuInfoModel = model;
 }
 
 void CPUDetailGrapTable::setMutliCoreMode(bool isMutliCoreMode)
 {
     m_isMutliCoreMode = isMutliCoreMode;
-    // 获取当前布局所有的子控件，删除子控件
-    QLayout *p = this->layout();
-    while (p->count()) {
-        QWidget *pWidget = p->itemAt(0)->widget();
-        pWidget->setParent(nullptr);
-        p->removeWidget(pWidget);
-        delete pWidget;
-    }
-    this->layout()->removeItem(this->layout()->itemAt(0));
-    delete this->layout();
     if (m_isMutliCoreMode) {
         setMultiModeLayout(m_cpuInfoModel);
     } else {
@@ -400,139 +496,32 @@ void CPUDetailGrapTable::setMutliCoreMode(bool isMutliCoreMode)
 
 void CPUDetailGrapTable::setSingleModeLayout(CPUInfoModel *model)
 {
-    QGridLayout  *graphicsLayout = new QGridLayout(this);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    graphicsLayout->setMargin(0);
-#else
-    graphicsLayout->setContentsMargins(0, 0, 0, 0);
-#endif
-    graphicsLayout->setHorizontalSpacing(10);
-    graphicsLayout->setVerticalSpacing(10);
-
-    QColor cpuColor("#1094D8");
-
-    CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, 0, this);
-    item->setMode(1);
-    item->setMultiCoreMode(false);
-    item->setColor(cpuColor);
-    graphicsLayout->addWidget(item, 0, 0);
-
-    setLayout(graphicsLayout);
+    Q_UNUSED(model)
+    m_grid->setCores(0, 1, CPUDetailGrapGrid::kNormalMode, 10);
 }
 
 void CPUDetailGrapTable::setMultiModeLayout(CPUInfoModel *model)
 {
-    QGridLayout  *graphicsLayout = new QGridLayout(this);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    graphicsLayout->setMargin(0);
-#else
-    graphicsLayout->setContentsMargins(0, 0, 0, 0);
-#endif
-    graphicsLayout->setHorizontalSpacing(10);
-    graphicsLayout->setVerticalSpacing(10);
-
+    Q_UNUSED(model)
     int cpuCount = int(sysconf(_SC_NPROCESSORS_ONLN));
 
-    QList<QColor> cpuColors;
-    cpuColors << "#1094D8"
-              << "#F7B300"
-              << "#55D500"
-              << "#C362FF"
-              << "#FF2997"
-              << "#00B4C7"
-              << "#F8E71C"
-              << "#FB1818"
-              << "#8544FF"
-              << "#00D7AB"
-              << "#00D7AB"
-              << "#FF00FF"
-              << "#30BF03"
-              << "#7E41F1"
-              << "#2CA7F8"
-              << "#A005CE";
-
     if (1 == cpuCount) {
-        CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, 0, this);
-        item->setMode(1);
-        item->setMultiCoreMode(false);
-        item->setColor(cpuColors[0]);
-        graphicsLayout->addWidget(item, 0, 0);
-    } else if (2 == cpuCount) {
-        for (int i = 0; i < cpuCount; ++i) {
-            CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, i, this);
-            item->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            item->setMode(1);
-            item->setMultiCoreMode(true);
-            item->setColor(cpuColors[i % cpuColors.size()]);
-            graphicsLayout->addWidget(item, i / 2, i % 2);
-        }
-    } else if (4 == cpuCount) {
-        for (int i = 0; i < cpuCount; ++i) {
-            CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, i, this);
-            item->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            item->setMode(1);
-            item->setMultiCoreMode(true);
-            item->setColor(cpuColors[i % cpuColors.size()]);
-            graphicsLayout->addWidget(item, i / 2, i % 2);
-        }
-
+        m_grid->setCores(0, 1, CPUDetailGrapGrid::kNormalMode, 10);
+    } else if (2 == cpuCount || 4 == cpuCount) {
+        m_grid->setCores(cpuCount, 2, CPUDetailGrapGrid::kNormalMode, 10);
     } else if (8 == cpuCount) {
-        for (int i = 0; i < cpuCount; ++i) {
-            CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, i, this);
-            item->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            item->setMode(1);
-            item->setMultiCoreMode(true);
-            item->setColor(cpuColors[i % cpuColors.size()]);
-            graphicsLayout->addWidget(item, i / 4, i % 4);
-        }
+        m_grid->setCores(cpuCount, 4, CPUDetailGrapGrid::kNormalMode, 10);
     } else if (16 == cpuCount) {
-        for (int i = 0; i < cpuCount; ++i) {
-            CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, i, this);
-            item->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            item->setMode(2);
-            item->setMultiCoreMode(true);
-            item->setColor(cpuColors[i % cpuColors.size()]);
-            graphicsLayout->addWidget(item, i / 4, i % 4);
-        }
+        m_grid->setCores(cpuCount, 4, CPUDetailGrapGrid::kSimpleMode, 10);
     } else if (32 == cpuCount) {//8*4
-        for (int i = 0; i < cpuCount; ++i) {
-            CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, i, this);
-            item->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            item->setMode(2);
-            item->setMultiCoreMode(true);
-            item->setColor(cpuColors[i % cpuColors.size()]);
-            graphicsLayout->addWidget(item, i / 8, i % 8);
-        }
-
-        graphicsLayout->setHorizontalSpacing(6);
-        graphicsLayout->setVerticalSpacing(6);
+        m_grid->setCores(cpuCount, 8, CPUDetailGrapGrid::kSimpleMode, 6);
+    } else if (128 < cpuCount) {
+        // text cells get too small, show a heatmap instead
+        m_grid->setCores(cpuCount, cpuCount > 256 ? 32 : 16, CPUDetailGrapGrid::kHeatmapMode, 0);
     } else if (32 < cpuCount) {
-        for (int i = 0; i < cpuCount; ++i) {
-            CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, i, this);
-            item->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            item->setMode(3);
-            item->setMultiCoreMode(true);
-            item->setColor(cpuColors[i % cpuColors.size()]);
-            if ((i % 8) == 7)
-                item->sethorizontal(true);
-            if ((i / 8) == (cpuCount / 8 - 1))
-                item->setVerticalLast(true);
-            graphicsLayout->addWidget(item, i / 8, i % 8);
-        }
-
-        graphicsLayout->setHorizontalSpacing(0);
-        graphicsLayout->setVerticalSpacing(0);
+        m_grid->setCores(cpuCount, 8, CPUDetailGrapGrid::kTextMode, 0);
     } else {
         //模式2
-        for (int i = 0; i < cpuCount; ++i) {
-            CPUDetailGrapTableItem *item = new CPUDetailGrapTableItem(model, i, this);
-            item->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            item->setMode(2);
-            item->setMultiCoreMode(true);
-            item->setColor(cpuColors[i % cpuColors.size()]);
-            graphicsLayout->addWidget(item, i / 16, i % 16);
-        }
+        m_grid->setCores(cpuCount, 16, CPUDetailGrapGrid::kSimpleMode, 10);
     }
-
-    setLayout(graphicsLayout);
 }
@@ -9,65 +9,92 @@
 #include <QWidget>
 #include <DPushButton>
 #include <QScrollArea>
+#include <QPolygonF>
 
 #include "base/base_detail_view_widget.h"
+#include "common/ring_buffer.h"
+
+#include <vector>
 
 class CPUInfoModel;
 class QScrollArea;
-class CPUDetailGrapTableItem : public QWidget
+
+/**
+ * @brief Usage graphs of all cores drawn by one widget
+ *
+ * Frames, grids & labels are rendered once into a cached pixmap, each update repaints only the
+ * cells whose graph or value changed. Per core history lives in one RingMatrix, column per core.
+ */
+class CPUDetailGrapGrid : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit CPUDetailGrapTableItem(CPUInfoModel *model, int index, QWidget *parent = nullptr);
-
-    ~CPUDetailGrapTableItem();
-
-    void setMode(int mode);
+    enum DrawMode {
+        kNormalMode = 1,    // curve with title & axis labels
+        kSimpleMode,        // curve only
+        kTextMode,          // usage as text
+        kHeatmapMode        // usage as cell color, for many cores
+    };
 
-    inline void setMultiCoreMode(bool isMutilCoreMode) { m_isMutliCoreMode = isMutilCoreMode; }
+    explicit CPUDetailGrapGrid(CPUInfoModel *model, QWidget *parent = nullptr);
 
-    void sethorizontal(bool isHorizontalLast);
+    /**
+     * @brief setCores 设置显示的CPU及布局
+     * @param count CPU个数, 0表示在一个单元格中显示总体占用
+     * @param columns 每行单元格数
+     * @param mode 绘制模式
+     * @param spacing 单元格间距
+     */
+    void setCores(int count, int columns, DrawMode mode, int spacing);
 
-    void setVerticalLast(bool isVerticalLast);
+    void setColors(const QList<QColor> &colors);
 
-    void setColor(QColor color);
+    QRect cellRect(int index) const;
 
 public slots:
     void updateStat();
+    void changeTheme();
+    void changeFont(const QFont &font);
 
 protected:
-    void paintEvent(QPaintEvent *event);
-
-    void drawNormalMode(QPainter &painter);
-
-    void drawSimpleMode(QPainter &painter);
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    bool event(QEvent *event) override;
 
-    void drawTextMode(QPainter &painter);
-
-    //!
-    //! \brief drawSingleCoreMode 绘制单核模式的视图
-    //! \param painter 绘图工具类
-    //!
-    void drawSingleCoreMode(QPainter &painter);
-
-    /**
-     * @brief drawBackground
-     * 绘制边框和表格线
-     * @param painter
-     * @param graphicRect
-     */
+private:
+    // usage of core index (0 ~ 1), overall usage if no core is shown
+    qreal corePercent(int index) const;
+    void layoutCells();
+    void drawBackPixmap();
+    void drawCellBackground(QPainter &painter, int index, const QPixmap &gridPixmap);
+    void drawCurve(QPainter &painter, int index);
     void drawBackground(QPainter &painter, const QRect &graphicRect);
+    QRect graphRect(int index) const;
+    QColor coreColor(int index) const;
+    int cellAt(const QPoint &pos) const;
 
 private:
-    QList<qreal>  m_cpuPercents;
     CPUInfoModel *m_cpuInfomodel = nullptr;
-    QColor m_color;
-    int m_mode  = 1;        //1:normal 2:simple 3:text
-    int m_index = -1;
-    bool m_isHorizontalLast = false;
-    bool m_isVerticalLast = false;
-    bool m_isMutliCoreMode = false; // 是否多核显示
+    int m_count = 0;
+    int m_columns = 1;
+    DrawMode m_mode = kNormalMode;
+    int m_spacing = 10;
+    QList<QColor> m_colors;
+
+    // usage (0 ~ 1) of the last kHistorySize updates, column per core
+    common::core::RingMatrix<qreal> m_history;
+    // updates a core kept the same value, its curve stops moving once the whole history is flat
+    std::vector<int> m_unchanged;
+
+    QVector<QRect> m_cells;
+    QPixmap m_backPixmap;
+    QFont m_font;
+    QFont m_midFont;
+    int m_textHeight = 0;
+    int m_midTextHeight = 0;
+    // reused point buffer of the curve being drawn
+    QPolygonF m_points;
 };
 
 class CPUDetailGrapTable : public QWidget
@@ -97,6 +124,7 @@ private:
     bool m_isMutliCoreMode = false;
 
     CPUInfoModel *m_cpuInfoModel {};
+    CPUDetailGrapGrid *m_grid {};
 };
 
 class CPUDetailSummaryTable;
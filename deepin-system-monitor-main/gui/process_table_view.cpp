@@ -120,7 +120,8 @@ void ProcessTableView::onThemeTypeChanged()
 
 QString ProcessTableView::getProcessName(int pid)
 {
-    return m_model->getProcess(qvariant_cast<pid_t>(pid)).name();
+    int index = m_model->snapshotIndex(qvariant_cast<pid_t>(pid));
+    return index >= 0 ? m_model->snapshot()->name(index) : QString();
 }
 
 // event filter
@@ -173,11 +174,10 @@ void ProcessTableView::endProcess()
                      DDialog::ButtonWarning);
     dialog.exec();
     if (dialog.result() == QMessageBox::Ok) {
-        Process proc = m_model->getProcess(qvariant_cast<pid_t>(m_selectedPID));
         QJsonObject obj {
             { "tid", EventLogUtils::ProcessKilled },
             { "version", QCoreApplication::applicationVersion() },
-            { "process_name", proc.name() }
+            { "process_name", getProcessName(qvariant_cast<pid_t>(m_selectedPID)) }
         };
         EventLogUtils::get().writeLogs(obj);
 
@@ -216,19 +216,23 @@ void ProcessTableView::openExecDirWithFM()
     // selection check needed
     if (m_selectedPID.isValid()) {
         pid_t pid = qvariant_cast<pid_t>(m_selectedPID);
-        const Process &proc = ProcessDB::instance()->processSet()->getProcessById(pid);
-        QString cmdline = proc.cmdlineString();
+        // latest scan, parents of the selected process may not be shown by the model
+        ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+        int index = snapshot->indexOf(pid);
+        if (index < 0)
+            return;
+        QString cmdline = snapshot->cmdlineString(index);
 
         if (cmdline.size() > 0) {
             // Found wine program location if cmdline starts with c://.
             if (cmdline.startsWith("c:")) {
-                QString winePrefix = proc.environ().value("WINEPREFIX");
+                QString winePrefix = snapshot->environ(index).value("WINEPREFIX");
                 cmdline = cmdline.replace("\\", "/").replace("c:/", "/drive_c/");
 
                 const QString &path = QString(winePrefix + cmdline).trimmed();
                 common::openFilePathItem(path);
             } else {
-                QString flatpakAppidEnv = proc.environ().value("FLATPAK_APPID");
+                QString flatpakAppidEnv = snapshot->environ(index).value("FLATPAK_APPID");
                 // Else find program location through 'which' command.
                 if (flatpakAppidEnv == "") {
                     QProcess whichProcess;
@@ -250,16 +254,16 @@ void ProcessTableView::openExecDirWithFM()
                             if (nsSize > 0 && nsSelfSize > 0) {
                                 QString nsPathStr(nsPath), nsSelfPathStr(nsSelfPath);
                                 if (nsPathStr != nsSelfPathStr) {
-                                    Process preProc = proc, curProc = proc;
+                                    int preIndex = index, curIndex = index;
                                     int count = 0;
                                     // 100次循环
-                                    while (curProc.name() != "ll-box" && curProc.pid() != 0 && count != 100) {
-                                        preProc = curProc;
-                                        curProc = ProcessDB::instance()->processSet()->getProcessById(preProc.ppid());
+                                    while (curIndex >= 0 && snapshot->name(curIndex) != "ll-box" && count != 100) {
+                                        preIndex = curIndex;
+                                        curIndex = snapshot->indexOf(snapshot->ppid(preIndex));
                                         count++;
                                     }
-                                    if (curProc.pid() != 0 || count != 100) {
-                                        pid = preProc.pid();
+                                    if (curIndex >= 0 || count != 100) {
+                                        pid = snapshot->pid(preIndex);
                                     }
                                     char exePath[PATH_MAX] = { 0 };
                                     auto exeSize = readlink(QString("/proc/%1/exe").arg(pid).toStdString().c_str(), exePath, PATH_MAX);
@@ -324,13 +328,16 @@ void ProcessTableView::showProperties()
     if (m_selectedPID.isValid()) {
         pid_t pid = qvariant_cast<pid_t>(m_selectedPID);
         // get process entry item from model
-        auto proc = m_model->getProcess(pid);
+        ProcessSnapshotPtr snapshot = m_model->snapshot();
+        int index = m_model->snapshotIndex(pid);
+        if (index < 0)
+            return;
         auto *attr = new ProcessAttributeDialog(pid,
-                                                proc.name(),
-                                                proc.displayName(),
-                                                proc.cmdlineString(),
-                                                proc.icon(),
-                                                proc.startTime(),
+                                                snapshot->name(index),
+                                                snapshot->displayName(index),
+                                                snapshot->cmdlineString(index),
+                                                snapshot->icon(index),
+                                                snapshot->startTime(index),
                                                 this);
         attr->show();
     }
@@ -358,11 +365,10 @@ void ProcessTableView::killProcess()
                      DDialog::ButtonWarning);
     dialog.exec();
     if (dialog.result() == QMessageBox::Ok) {
-        Process proc = m_model->getProcess(qvariant_cast<pid_t>(m_selectedPID));
         QJsonObject obj {
             { "tid", EventLogUtils::ProcessKilled },
             { "version", QCoreApplication::applicationVersion() },
-            { "process_name", proc.name() }
+            { "process_name", getProcessName(qvariant_cast<pid_t>(m_selectedPID)) }
         };
         EventLogUtils::get().writeLogs(obj);
         ProcessDB::instance()->killProcess(qvariant_cast<pid_t>(m_selectedPID));
@@ -1012,12 +1018,6 @@ void ProcessTableView::customizeProcessPriority()
     if (m_selectedPID.isValid()) {
         pid_t pid = qvariant_cast<pid_t>(m_selectedPID);
         slider->setValue(m_model->getProcessPriorityValue(pid));
-        Process selectedProcess = m_model->getProcess(pid);
-        int selectedPriority = kNormalPriority;
-        if (selectedProcess.isValid()) {
-            selectedPriority = ProcessDB::instance()->processSet()->getProcessById(pid).priority();
-        }
-        slider->setValue(selectedPriority);
         prio = QString("%1").arg(slider->value());
         slider->setTipValue(prio);
     }
@@ -13,6 +13,8 @@
 
 #include <QApplication>
 
+#include <algorithm>
+
 Q_GLOBAL_STATIC(CPUInfoModel, theInstance)
 CPUInfoModel::CPUInfoModel() : QObject(nullptr)
 {
@@ -20,6 +22,9 @@ CPUInfoModel::CPUInfoModel() : QObject(nullptr)
     m_overallStatSample.reset(new CPUStatSample(m_period));
     m_overallUsageSample.reset(new CPUUsageSample(m_period));
     m_loadAvgSampleDB.reset(new LoadAvgSample(m_period));
+    // two rows at least, the new row must not replace the one it is compared to
+    m_cpuTotalHistory.reshape(std::max(m_period.ticks(), size_t(2)), 0);
+    m_cpuIdleHistory.reshape(m_cpuTotalHistory.capacity(), 0);
 
     m_sysInfo = SysInfo::instance();
     m_cpuSet = DeviceDB::instance()->cpuSet();
@@ -59,30 +64,27 @@ CPUSet *CPUInfoModel::cpuSet()
 
 void CPUInfoModel::updateModel()
 {
-    m_overallStatSample->addSample(new CPUStatSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*m_cpuSet->stat())));
-
-    m_overallUsageSample->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usage())));
+    m_overallStatSample->emplaceSample(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*m_cpuSet->stat()));
 
-    m_loadAvgSampleDB->addSample(new LoadAvgSampleFrame(m_sysInfo->uptime(), std::make_shared<struct load_avg_t>(*m_sysInfo->loadAvg())));
+    m_overallUsageSample->emplaceSample(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usage()));
 
-    for (auto &cpuname : m_cpuSet->cpuLogicName()) {
-        if (m_singleUsageSample.contains(cpuname)) {
-            m_singleUsageSample[cpuname]->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
-        } else {
-            auto smaple = std::make_shared<Sample<cpu_usage_t>>(m_period);
-            smaple->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
-            m_singleUsageSample.insert(cpuname, smaple);
-        }
+    m_loadAvgSampleDB->emplaceSample(m_sysInfo->uptime(), std::make_shared<struct load_avg_t>(*m_sysInfo->loadAvg()));
 
-//        auto model = std::make_shared<CPUStatModel>(m_period, this);
-//        if (model && model->m_statSampleDB)
-//            model->m_statSampleDB->addSample(new CPUStatSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_stat_t>(*m_cpuSet->statDB(cpuname))));
-
-//        if (model && model->m_usageSampleDB)
-//            model->m_usageSampleDB->addSample(new CPUUsageSampleFrame(m_sysInfo->uptime(), std::make_shared<struct cpu_usage_t>(*m_cpuSet->usageDB(cpuname))));
+    // columns only grow when a cpu with a higher number shows up
+    size_t ncpus = size_t(m_cpuSet->cpuStatCount());
+    if (ncpus != m_cpuTotalHistory.columns()) {
+        m_cpuTotalHistory.reshape(m_cpuTotalHistory.capacity(), ncpus);
+        m_cpuIdleHistory.reshape(m_cpuIdleHistory.capacity(), ncpus);
+        m_cpuPercents.resize(ncpus);
+    }
 
-//        m_cpuListModel->m_statModelDB[info.logicalName()] = model;
-    } // ::for
+    const unsigned long long *lastTotal = m_cpuTotalHistory.back();
+    const unsigned long long *lastIdle = m_cpuIdleHistory.back();
+    unsigned long long *total = m_cpuTotalHistory.push_back();
+    unsigned long long *idle = m_cpuIdleHistory.push_back();
+    std::copy(m_cpuSet->cpuUsageTotals(), m_cpuSet->cpuUsageTotals() + ncpus, total);
+    std::copy(m_cpuSet->cpuUsageIdles(), m_cpuSet->cpuUsageIdles() + ncpus, idle);
+    cpu_usage_percent(lastTotal, lastIdle, total, idle, m_cpuPercents.data(), int(ncpus));
 
     emit modelUpdated();
 } // ::updateModel
@@ -90,14 +92,19 @@ void CPUInfoModel::updateModel()
 QList<qreal> CPUInfoModel::cpuPercentList() const
 {
     QList<qreal> percentList;
-    const auto &usageSampleList = m_singleUsageSample.values();
-    for (const auto &sample : usageSampleList) {
-        const auto &pair = sample->recentSamplePair();
-        percentList << CPUUsageSampleFrame::cpupc(pair.first, pair.second);
-    }
+    percentList.reserve(int(m_cpuPercents.size()));
+    for (qreal percent : m_cpuPercents)
+        percentList << percent;
     return percentList;
 }
 
+qreal CPUInfoModel::cpuPercent(int index) const
+{
+    if (index < 0 || size_t(index) >= m_cpuPercents.size())
+        return 0;
+    return m_cpuPercents[size_t(index)];
+}
+
 qreal CPUInfoModel::cpuAllPercent() const
 {
     auto pair = m_overallUsageSample->recentSamplePair();
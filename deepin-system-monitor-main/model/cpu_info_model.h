@@ -15,6 +15,7 @@
 #include <QMap>
 
 #include <memory>
+#include <vector>
 
 using namespace common::core;
 using namespace common::format;
@@ -61,6 +62,10 @@ public:
     std::weak_ptr<CPUListModel> cpuListModel() const;
 
     QList<qreal> cpuPercentList() const;
+    /**
+     * @brief Usage (percent) of logical cpu index since the last update, NaN if it is offline
+     */
+    qreal cpuPercent(int index) const;
     qreal cpuAllPercent() const;
 
     QString loadavg() const;
@@ -87,7 +92,11 @@ private:
     std::unique_ptr<Sample<cpu_usage_t>> m_overallUsageSample;
     std::unique_ptr<Sample<load_avg_t>> m_loadAvgSampleDB; // for loadavg monitoring extends
 
-    QMap<QByteArray, std::shared_ptr<Sample<cpu_usage_t>>> m_singleUsageSample;
+    // per cpu total & idle jiffies of the last m_period.ticks() updates, cpu N in column N
+    RingMatrix<unsigned long long> m_cpuTotalHistory;
+    RingMatrix<unsigned long long> m_cpuIdleHistory;
+    // per cpu usage between the two most recent updates
+    std::vector<qreal> m_cpuPercents;
 
     SysInfo *m_sysInfo;
     CPUSet *m_cpuSet;
@@ -13,9 +13,12 @@
 #include <QDebug>
 #include <QLocale>
 
+#include <algorithm>
+
 // proxy model constructor
 ProcessSortFilterProxyModel::ProcessSortFilterProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent)
+    , m_chinese(QLocale::system().language() == QLocale::Chinese)
 {
 }
 
@@ -25,10 +28,15 @@ void ProcessSortFilterProxyModel::setSortFilterString(const QString &search)
     m_search = search;
 
     // in chinese locale, we convert hanzi to pinyin words to help filter out processes named with pinyin
-    if (QLocale::system().language() == QLocale::Chinese) {
+    if (m_chinese) {
         m_hanwords = util::common::convHanToLatin(search);
     }
 
+    // plain text is matched against the search index, anything else goes through the regular expression
+    static const QString kRegExpChars = QStringLiteral("\\^$.|?*+()[]{}");
+    m_isLiteral = std::none_of(search.cbegin(), search.cend(), [](QChar c) { return kRegExpChars.contains(c); });
+    m_literal = m_isLiteral ? search.toLower() : QString();
+
     // set search pattern & do the filter
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     setFilterRegExp(QRegExp(search, Qt::CaseInsensitive));
@@ -47,8 +55,179 @@ void ProcessSortFilterProxyModel::setFilterType(int type)
 #endif
 }
 
+void ProcessSortFilterProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    for (const auto &connection : m_sourceConnections)
+        disconnect(connection);
+    m_sourceConnections.clear();
+
+    // connected ahead of the base class, keys are up to date before it sorts & filters the change
+    if (model) {
+        m_sourceConnections << connect(model, &QAbstractItemModel::rowsInserted, this, &ProcessSortFilterProxyModel::onSourceRowsInserted)
+                            << connect(model, &QAbstractItemModel::rowsRemoved, this, &ProcessSortFilterProxyModel::onSourceRowsRemoved)
+                            << connect(model, &QAbstractItemModel::dataChanged, this, &ProcessSortFilterProxyModel::onSourceDataChanged)
+                            << connect(model, &QAbstractItemModel::rowsMoved, this, &ProcessSortFilterProxyModel::rebuildKeys)
+                            << connect(model, &QAbstractItemModel::layoutChanged, this, &ProcessSortFilterProxyModel::rebuildKeys)
+                            << connect(model, &QAbstractItemModel::modelReset, this, &ProcessSortFilterProxyModel::rebuildKeys);
+    }
+
+    QSortFilterProxyModel::setSourceModel(model);
+    rebuildKeys();
+}
+
+void ProcessSortFilterProxyModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid() || first < 0 || first > int(m_keys.size())) {
+        rebuildKeys();
+        return;
+    }
+
+    m_keys.insert(m_keys.begin() + first, size_t(last - first + 1), ProcessSortKeys(m_collator));
+    for (int row = first; row <= last; ++row)
+        updateKeys(row, 0, ProcessTableModel::kProcessColumnCount - 1);
+}
+
+void ProcessSortFilterProxyModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid() || first < 0 || last >= int(m_keys.size())) {
+        rebuildKeys();
+        return;
+    }
+
+    m_keys.erase(m_keys.begin() + first, m_keys.begin() + last + 1);
+}
+
+void ProcessSortFilterProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid())
+        return;
+
+    int last = qMin(bottomRight.row(), int(m_keys.size()) - 1);
+    for (int row = topLeft.row(); row <= last; ++row)
+        updateKeys(row, topLeft.column(), bottomRight.column());
+}
+
+void ProcessSortFilterProxyModel::rebuildKeys()
+{
+    m_keys.clear();
+    if (!sourceModel())
+        return;
+
+    int rows = sourceModel()->rowCount();
+    m_keys.reserve(size_t(rows));
+    for (int row = 0; row < rows; ++row) {
+        m_keys.emplace_back(m_collator);
+        updateKeys(row, 0, ProcessTableModel::kProcessColumnCount - 1);
+    }
+}
+
+void ProcessSortFilterProxyModel::updateKeys(int row, int first, int last)
+{
+    auto *model = sourceModel();
+    auto &rowKeys = m_keys[size_t(row)];
+    auto changed = [first, last](int column) { return column >= first && column <= last; };
+    auto value = [model, row](int column, int role) { return model->index(row, column).data(role); };
+
+    // never built yet
+    bool searchChanged = rowKeys.search.isEmpty();
+    if (changed(ProcessTableModel::kProcessNameColumn)) {
+        const QString &name = value(ProcessTableModel::kProcessNameColumn, Qt::DisplayRole).toString();
+        if (name != rowKeys.name) {
+            rowKeys.name = name;
+            rowKeys.nameKey = m_collator.sortKey(name);
+            rowKeys.hanzi = common::startWithHanzi(name);
+            searchChanged = true;
+        }
+        const QString &rawName = value(ProcessTableModel::kProcessNameColumn, Qt::UserRole).toString();
+        if (rawName != rowKeys.rawName) {
+            rowKeys.rawName = rawName;
+            searchChanged = true;
+        }
+    }
+    if (changed(ProcessTableModel::kProcessUserColumn)) {
+        const QString &user = value(ProcessTableModel::kProcessUserColumn, Qt::DisplayRole).toString();
+        if (user != rowKeys.user) {
+            rowKeys.user = user;
+            rowKeys.userKey = m_collator.sortKey(user);
+            searchChanged = true;
+        }
+    }
+    if (changed(ProcessTableModel::kProcessPIDColumn)) {
+        int pid = value(ProcessTableModel::kProcessPIDColumn, Qt::UserRole).toInt();
+        searchChanged |= pid != rowKeys.pid;
+        rowKeys.pid = pid;
+    }
+    // app type changes come along with a name column change
+    if (changed(ProcessTableModel::kProcessNameColumn) || changed(ProcessTableModel::kProcessPIDColumn))
+        rowKeys.appType = value(ProcessTableModel::kProcessPIDColumn, Qt::UserRole + 3).toInt();
+    if (changed(ProcessTableModel::kProcessCPUColumn))
+        rowKeys.cpu = value(ProcessTableModel::kProcessCPUColumn, Qt::UserRole).toReal();
+    if (changed(ProcessTableModel::kProcessMemoryColumn))
+        rowKeys.memory = value(ProcessTableModel::kProcessMemoryColumn, Qt::UserRole).toULongLong();
+    if (changed(ProcessTableModel::kProcessShareMemoryColumn))
+        rowKeys.shareMemory = value(ProcessTableModel::kProcessShareMemoryColumn, Qt::UserRole).toULongLong();
+    if (changed(ProcessTableModel::kProcessVTRMemoryColumn))
+        rowKeys.vtrMemory = value(ProcessTableModel::kProcessVTRMemoryColumn, Qt::UserRole).toULongLong();
+    if (changed(ProcessTableModel::kProcessUploadColumn)) {
+        rowKeys.upload = value(ProcessTableModel::kProcessUploadColumn, Qt::UserRole).toReal();
+        rowKeys.sentBytes = value(ProcessTableModel::kProcessUploadColumn, Qt::UserRole + 1).toULongLong();
+    }
+    if (changed(ProcessTableModel::kProcessDownloadColumn)) {
+        rowKeys.download = value(ProcessTableModel::kProcessDownloadColumn, Qt::UserRole).toReal();
+        rowKeys.recvBytes = value(ProcessTableModel::kProcessDownloadColumn, Qt::UserRole + 1).toULongLong();
+    }
+    if (changed(ProcessTableModel::kProcessDiskReadColumn))
+        rowKeys.diskRead = value(ProcessTableModel::kProcessDiskReadColumn, Qt::UserRole).toReal();
+    if (changed(ProcessTableModel::kProcessDiskWriteColumn))
+        rowKeys.diskWrite = value(ProcessTableModel::kProcessDiskWriteColumn, Qt::UserRole).toReal();
+    if (changed(ProcessTableModel::kProcessNiceColumn) || changed(ProcessTableModel::kProcessPriorityColumn))
+        rowKeys.nice = value(ProcessTableModel::kProcessNiceColumn, Qt::UserRole).toInt();
+
+    if (searchChanged) {
+        // fields are separated, a literal pattern never matches across two of them
+        rowKeys.search = QString("%1\n%2\n%3\n%4").arg(rowKeys.name, rowKeys.rawName, QString::number(rowKeys.pid), rowKeys.user).toLower();
+        if (m_chinese) {
+            const QString &pinyin = util::common::convHanToLatin(rowKeys.name);
+            if (pinyin != rowKeys.name)
+                rowKeys.search += "\n" + pinyin.toLower();
+        }
+    }
+}
+
+const ProcessSortFilterProxyModel::ProcessSortKeys *ProcessSortFilterProxyModel::keys(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.model() != sourceModel() || index.row() >= int(m_keys.size()))
+        return nullptr;
+    return &m_keys[size_t(index.row())];
+}
+
 // filters the row of specified parent with given pattern
 bool ProcessSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
+{
+    const ProcessSortKeys *rowKeys = keys(sourceModel()->index(row, ProcessTableModel::kProcessPIDColumn, parent));
+    if (!rowKeys || !m_isLiteral)
+        return filterAcceptsRowByData(row, parent);
+
+    bool filter = false;
+    int apptype = rowKeys->appType;
+    if (m_fileterType == kNoFilter)
+        filter = true;
+    else if (m_fileterType == kFilterCurrentUser && (apptype == kFilterApps || apptype == kFilterCurrentUser))
+        filter = true;
+    else if (m_fileterType == kFilterApps && apptype == kFilterApps)
+        filter = true;
+
+    if (!filter) return false;
+
+    // display name, name, pid or user name matches pattern
+    if (rowKeys->search.contains(m_literal))
+        return true;
+
+    // pinyin matches pattern
+    return m_chinese && !m_hanwords.isEmpty() && rowKeys->rawName.contains(m_hanwords);
+}
+
+bool ProcessSortFilterProxyModel::filterAcceptsRowByData(int row, const QModelIndex &parent) const
 {
     bool filter = false;
     const QModelIndex &pid = sourceModel()->index(row, ProcessTableModel::kProcessPIDColumn, parent);
@@ -112,6 +291,58 @@ bool ProcessSortFilterProxyModel::filterAcceptsRow(int row, const QModelIndex &p
 
 // compare two items with the specified index
 bool ProcessSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const ProcessSortKeys *lkeys = keys(left);
+    const ProcessSortKeys *rkeys = keys(right);
+    if (!lkeys || !rkeys)
+        return lessThanByData(left, right);
+
+    const ProcessSortKeys &lhs = *lkeys;
+    const ProcessSortKeys &rhs = *rkeys;
+    switch (sortColumn()) {
+    case ProcessTableModel::kProcessNameColumn: {
+        if (lhs.hanzi != rhs.hanzi)
+            return rhs.hanzi;
+
+        int rc = lhs.nameKey.compare(rhs.nameKey);
+        return rc == 0 ? lhs.cpu < rhs.cpu : rc < 0;
+    }
+    case ProcessTableModel::kProcessUserColumn:
+        return lhs.userKey.compare(rhs.userKey) < 0;
+    case ProcessTableModel::kProcessMemoryColumn:
+        // compare memory usage first, then by cpu time
+        return lhs.memory == rhs.memory ? lhs.cpu < rhs.cpu : lhs.memory < rhs.memory;
+    case ProcessTableModel::kProcessShareMemoryColumn:
+        return lhs.shareMemory == rhs.shareMemory ? lhs.cpu < rhs.cpu : lhs.shareMemory < rhs.shareMemory;
+    case ProcessTableModel::kProcessVTRMemoryColumn:
+        return lhs.vtrMemory == rhs.vtrMemory ? lhs.cpu < rhs.cpu : lhs.vtrMemory < rhs.vtrMemory;
+    case ProcessTableModel::kProcessCPUColumn:
+        // compare cpu time first, then by memory usage
+        return qFuzzyCompare(lhs.cpu, rhs.cpu) ? lhs.memory < rhs.memory : lhs.cpu < rhs.cpu;
+    case ProcessTableModel::kProcessUploadColumn:
+        // compare upload speed first, then by total send bytes
+        return qFuzzyCompare(lhs.upload, rhs.upload) ? lhs.sentBytes < rhs.sentBytes : lhs.upload < rhs.upload;
+    case ProcessTableModel::kProcessDownloadColumn:
+        // compare download speed first, then by total download bytes
+        return qFuzzyCompare(lhs.download, rhs.download) ? lhs.recvBytes < rhs.recvBytes : lhs.download < rhs.download;
+    case ProcessTableModel::kProcessPIDColumn:
+        return lhs.pid < rhs.pid;
+    case ProcessTableModel::kProcessDiskReadColumn:
+        return lhs.diskRead < rhs.diskRead;
+    case ProcessTableModel::kProcessDiskWriteColumn:
+        return lhs.diskWrite < rhs.diskWrite;
+    case ProcessTableModel::kProcessNiceColumn:
+    case ProcessTableModel::kProcessPriorityColumn:
+        // higher priority has negative number
+        return !(lhs.nice < rhs.nice);
+    default:
+        break;
+    }
+
+    return QSortFilterProxyModel::lessThan(left, right);
+}
+
+bool ProcessSortFilterProxyModel::lessThanByData(const QModelIndex &left, const QModelIndex &right) const
 {
     int sortcolumn = sortColumn();
     switch (sortcolumn) {
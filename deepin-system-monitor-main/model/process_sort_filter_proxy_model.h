@@ -6,8 +6,11 @@
 #ifndef PROCESS_SORT_FILTER_PROXY_MODEL_H
 #define PROCESS_SORT_FILTER_PROXY_MODEL_H
 
+#include <QCollator>
 #include <QSortFilterProxyModel>
 
+#include <vector>
+
 /**
  * @brief Sort filter proxy model for process model
  */
@@ -30,6 +33,12 @@ public:
 
     void setFilterType(int type);
 
+    /**
+     * @brief Set source model, sort & filter keys are kept in sync with its rows
+     * @param sourceModel Process table model
+     */
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 protected:
     /**
      * @brief Filters the row of specified parent with given pattern
@@ -47,13 +56,84 @@ protected:
      */
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
 
+private Q_SLOTS:
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void rebuildKeys();
+
+private:
+    /**
+     * @brief Sort & filter keys of one source row
+     *
+     * Built from the source model once per row change, so comparisons & filtering never go
+     * through data() or the locale collation again.
+     */
+    struct ProcessSortKeys {
+        explicit ProcessSortKeys(const QCollator &collator)
+            : nameKey(collator.sortKey({}))
+            , userKey(collator.sortKey({}))
+        {
+        }
+
+        QString name;               // name column display text, nameKey is built from it
+        QString rawName;            // process name
+        QString user;               // user name, userKey is built from it
+        QCollatorSortKey nameKey;
+        QCollatorSortKey userKey;
+        bool hanzi {false};         // name starts with hanzi, sorted after the others
+        int appType {0};
+        int pid {0};
+        int nice {0};
+        qreal cpu {0};
+        qulonglong memory {0};
+        qulonglong shareMemory {0};
+        qulonglong vtrMemory {0};
+        qreal upload {0};
+        qreal download {0};
+        qulonglong sentBytes {0};   // total bytes, breaks upload ties
+        qulonglong recvBytes {0};   // total bytes, breaks download ties
+        qreal diskRead {0};
+        qreal diskWrite {0};
+        QString search;             // lowered name, process name, pid, user & pinyin of the name
+    };
+
+    /**
+     * @brief Refresh keys of a source row
+     * @param row Source row
+     * @param first First changed column
+     * @param last Last changed column
+     */
+    void updateKeys(int row, int first, int last);
+    /**
+     * @brief Keys of the row referred to by a source index, nullptr if the keys are not in sync
+     */
+    const ProcessSortKeys *keys(const QModelIndex &index) const;
+    /**
+     * @brief Filter with the source model's data, used for non literal search patterns
+     */
+    bool filterAcceptsRowByData(int row, const QModelIndex &parent) const;
+    /**
+     * @brief Compare with the source model's data, used for indexes without keys
+     */
+    bool lessThanByData(const QModelIndex &left, const QModelIndex &right) const;
+
 private:
     // Search pattern
     QString m_search {};
+    // Lowered search pattern, empty if the pattern is a regular expression
+    QString m_literal {};
+    bool m_isLiteral {true};
     // Pinyin represented as ascii string converted from chinese hanzi
     QString m_hanwords {};
 
     int m_fileterType = 0;
+
+    bool m_chinese {false};
+    QCollator m_collator {};
+    // keys per source row
+    std::vector<ProcessSortKeys> m_keys {};
+    QList<QMetaObject::Connection> m_sourceConnections {};
 };
 
 #endif  // PROCESS_SORT_FILTER_PROXY_MODEL_H
@@ -9,10 +9,13 @@
 
 #include <QDebug>
 #include <QTimer>
+#include <QtAlgorithms>
 #include <DApplication>
 #include <DGuiApplicationHelper>
 #include <DPlatformTheme>
 #include <QPointer>
+
+#include <algorithm>
 using namespace common;
 using namespace common::format;
 using namespace DDLog;
@@ -51,26 +54,28 @@ ProcessTableModel::ProcessTableModel(QObject *parent, const QString &username)
         theme = DGuiApplicationHelper::instance()->applicationTheme();
         connect(theme, &DPlatformTheme::iconThemeNameChanged, this, [=]() {
             updateProcessList();
+            // icons are not compared on refresh
+            if (rowCount() > 0)
+                Q_EMIT dataChanged(index(0, kProcessNameColumn), index(rowCount() - 1, kProcessNameColumn));
         });
     }
 }
 
 char ProcessTableModel::getProcessState(pid_t pid) const
 {
-    if (m_procIdList.contains(pid)) {
-        return ProcessDB::instance()->processSet()->getProcessById(pid).state();
-    }
-
-    return 0;
+    int row = m_pidRows.value(pid, -1);
+    return row >= 0 ? m_rowValues[row].state : 0;
 }
 
-Process ProcessTableModel::getProcess(pid_t pid) const
+ProcessSnapshotPtr ProcessTableModel::snapshot() const
 {
-    if (m_procIdList.contains(pid)) {
-        return ProcessDB::instance()->processSet()->getProcessById(pid);
-    }
+    return m_snapshot;
+}
 
-    return Process();
+int ProcessTableModel::snapshotIndex(pid_t pid) const
+{
+    int row = m_pidRows.value(pid, -1);
+    return row >= 0 ? m_snapshotIndexes[row] : -1;
 }
 
 // update process model with the data provided by list
@@ -85,62 +90,176 @@ void ProcessTableModel::updateProcessList()
 
 void ProcessTableModel::updateProcessListWithUserSpecified()
 {
+    // user filter is applied by syncSnapshot
+    updateProcessListDelay();
+}
 
-    ProcessSet *processSet = ProcessDB::instance()->processSet();
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    beginRemoveRows({}, 0, m_procIdList.size());
-    endRemoveRows();
-    m_procIdList.clear();
-    m_processList.clear();
-    int raw;
-    for (const auto &pid : newpidlst) {
-        Process changedProc = processSet->getProcessById(pid);
-        if (changedProc.userName() == m_userModeName) {
-            raw = m_procIdList.size();
-            beginInsertRows({}, raw, raw);
-            m_procIdList << pid;
-            m_processList << changedProc;
-            endInsertRows();
-        }
-    }
+void ProcessTableModel::updateProcessListDelay()
+{
+    ProcessSnapshotPtr snapshot = ProcessDB::instance()->processSet()->snapshot();
+    // no scan since the last refresh
+    if (snapshot->version() == m_snapshot->version())
+        return;
+
+    syncSnapshot(snapshot);
 
     Q_EMIT modelUpdated();
 }
 
-void ProcessTableModel::updateProcessListDelay()
+void ProcessTableModel::syncSnapshot(const ProcessSnapshotPtr &snapshot)
 {
-    ProcessSet *processSet = ProcessDB::instance()->processSet();
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
-    QList<pid_t> oldpidlst = m_procIdList;
-
-    for (const auto &pid : newpidlst) {
-        int row = m_procIdList.indexOf(pid);
-        if (row >= 0) {
-            // update
-            m_processList[row] = processSet->getProcessById(pid);
-            Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
-        } else {
-            // insert
-            row = m_procIdList.size();
-            beginInsertRows({}, row, row);
-            m_procIdList << pid;
-            m_processList << processSet->getProcessById(pid);
-            endInsertRows();
-        }
+    QVector<int> indexes;
+    indexes.reserve(snapshot->size());
+    for (int i = 0; i < snapshot->size(); ++i) {
+        if (m_userModeName.isNull() || snapshot->userName(i) == m_userModeName)
+            indexes << i;
     }
+    syncProcessList(snapshot, indexes);
+}
 
-    // remove
-    for (const auto &pid : oldpidlst) {
-        if (!newpidlst.contains(pid)) {
-            int row = m_procIdList.indexOf(pid);
-            beginRemoveRows({}, row, row);
-            m_procIdList.removeAt(row);
-            m_processList.removeAt(row);
+void ProcessTableModel::syncProcessList(const ProcessSnapshotPtr &snapshot, const QVector<int> &indexes)
+{
+    QList<pid_t> pidlst;
+    pidlst.reserve(indexes.size());
+    for (int index : indexes)
+        pidlst << snapshot->pid(index);
+
+    // rows edited behind our back, start over
+    if (m_snapshotIndexes.size() != m_procIdList.size() || m_rowValues.size() != m_procIdList.size()
+            || !std::is_sorted(m_procIdList.cbegin(), m_procIdList.cend())) {
+        beginResetModel();
+        m_snapshot = snapshot;
+        m_procIdList = pidlst;
+        m_snapshotIndexes = indexes;
+        m_rowValues.clear();
+        m_rowValues.reserve(indexes.size());
+        for (int index : indexes)
+            m_rowValues << rowValues(*snapshot, index);
+        endResetModel();
+        rebuildRowIndex();
+        return;
+    }
+
+    // point current rows at the new snapshot before any signal, views may read them while rows
+    // move; rows of died processes are left without data until they're removed
+    for (int row = 0; row < m_procIdList.size(); ++row)
+        m_snapshotIndexes[row] = snapshot->indexOf(m_procIdList[row]);
+    m_snapshot = snapshot;
+
+    const QList<pid_t> oldpidlst = m_procIdList;
+    int i = 0; // oldpidlst
+    int j = 0; // pidlst
+    int row = 0; // current row of oldpidlst[i]
+    bool moved = false;
+    int firstChanged = -1;
+    int lastChanged = -1;
+    quint32 changed = 0;
+
+    while (i < oldpidlst.size() || j < pidlst.size()) {
+        if (j == pidlst.size() || (i < oldpidlst.size() && oldpidlst[i] < pidlst[j])) {
+            // remove died pids
+            int count = 0;
+            while (i < oldpidlst.size() && (j == pidlst.size() || oldpidlst[i] < pidlst[j])) {
+                ++i;
+                ++count;
+            }
+            beginRemoveRows({}, row, row + count - 1);
+            m_procIdList.erase(m_procIdList.begin() + row, m_procIdList.begin() + row + count);
+            m_snapshotIndexes.erase(m_snapshotIndexes.begin() + row, m_snapshotIndexes.begin() + row + count);
+            m_rowValues.erase(m_rowValues.begin() + row, m_rowValues.begin() + row + count);
             endRemoveRows();
+            moved = true;
+        } else if (i == oldpidlst.size() || pidlst[j] < oldpidlst[i]) {
+            // insert born pids
+            int first = j;
+            while (j < pidlst.size() && (i == oldpidlst.size() || pidlst[j] < oldpidlst[i]))
+                ++j;
+            beginInsertRows({}, row, row + j - first - 1);
+            for (int k = first; k < j; ++k, ++row) {
+                m_procIdList.insert(row, pidlst[k]);
+                m_snapshotIndexes.insert(row, indexes[k]);
+                m_rowValues.insert(row, rowValues(*snapshot, indexes[k]));
+            }
+            endInsertRows();
+            moved = true;
+        } else {
+            // update, rows before the current one keep their index while walking
+            ProcessRowValues values = rowValues(*snapshot, indexes[j]);
+            quint32 columns = changedColumns(m_rowValues[row], values);
+            if (columns) {
+                m_rowValues[row] = values;
+                changed |= columns;
+                if (firstChanged < 0)
+                    firstChanged = row;
+                lastChanged = row;
+            }
+            ++i;
+            ++j;
+            ++row;
         }
     }
 
-    Q_EMIT modelUpdated();
+    if (moved)
+        rebuildRowIndex();
+    if (changed) {
+        int firstColumn = int(qCountTrailingZeroBits(changed));
+        int lastColumn = 31 - int(qCountLeadingZeroBits(changed));
+        Q_EMIT dataChanged(index(firstChanged, firstColumn), index(lastChanged, lastColumn));
+    }
+}
+
+void ProcessTableModel::rebuildRowIndex()
+{
+    m_pidRows.clear();
+    m_pidRows.reserve(m_procIdList.size());
+    for (int row = 0; row < m_procIdList.size(); ++row)
+        m_pidRows.insert(m_procIdList[row], row);
+}
+
+ProcessTableModel::ProcessRowValues ProcessTableModel::rowValues(const ProcessSnapshot &snapshot, int index)
+{
+    ProcessRowValues values;
+    values.displayName = snapshot.displayName(index);
+    values.userName = snapshot.userName(index);
+    values.appType = snapshot.appType(index);
+    values.state = snapshot.state(index);
+    values.cpu = snapshot.cpu(index);
+    values.memory = snapshot.memory(index);
+    values.shareMemory = snapshot.sharememory(index);
+    values.vtrMemory = snapshot.vtrmemory(index);
+    values.sentBps = snapshot.sentBps(index);
+    values.recvBps = snapshot.recvBps(index);
+    values.sentBytes = snapshot.sentBytes(index);
+    values.recvBytes = snapshot.recvBytes(index);
+    values.readBps = snapshot.readBps(index);
+    values.writeBps = snapshot.writeBps(index);
+    values.priority = snapshot.priority(index);
+    return values;
+}
+
+quint32 ProcessTableModel::changedColumns(const ProcessRowValues &lhs, const ProcessRowValues &rhs)
+{
+    quint32 columns = 0;
+    auto mark = [&columns](bool diff, int column) {
+        if (diff)
+            columns |= 1u << column;
+    };
+
+    // name column shows state tag, color & app type too
+    mark(lhs.displayName != rhs.displayName || lhs.state != rhs.state || lhs.appType != rhs.appType,
+         kProcessNameColumn);
+    mark(lhs.cpu != rhs.cpu, kProcessCPUColumn);
+    mark(lhs.userName != rhs.userName, kProcessUserColumn);
+    mark(lhs.memory != rhs.memory, kProcessMemoryColumn);
+    mark(lhs.shareMemory != rhs.shareMemory, kProcessShareMemoryColumn);
+    mark(lhs.vtrMemory != rhs.vtrMemory, kProcessVTRMemoryColumn);
+    mark(lhs.sentBps != rhs.sentBps || lhs.sentBytes != rhs.sentBytes, kProcessUploadColumn);
+    mark(lhs.recvBps != rhs.recvBps || lhs.recvBytes != rhs.recvBytes, kProcessDownloadColumn);
+    mark(lhs.readBps != rhs.readBps, kProcessDiskReadColumn);
+    mark(lhs.writeBps != rhs.writeBps, kProcessDiskWriteColumn);
+    mark(lhs.priority != rhs.priority, kProcessNiceColumn);
+    mark(lhs.priority != rhs.priority, kProcessPriorityColumn);
+    return columns;
 }
 
 // returns the number of rows under the given parent
@@ -221,21 +340,22 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         return {};
 
     // validate index
-    if (index.row() < 0 || index.row() >= m_processList.size())
+    if (index.row() < 0 || index.row() >= m_rowValues.size() || index.row() >= m_snapshotIndexes.size())
         return {};
 
     int row = index.row();
-    const Process &proc = m_processList[row];
-    if (!proc.isValid())
+    int i = m_snapshotIndexes[row];
+    if (i < 0)
         return {};
+    const ProcessRowValues &values = m_rowValues[row];
 
     if (role == Qt::DisplayRole || role == Qt::AccessibleTextRole) {
         QString name;
         switch (index.column()) {
         case kProcessNameColumn: {
             // prepended tag based on process state
-            name = proc.displayName();
-            switch (proc.state()) {
+            name = values.displayName;
+            switch (values.state) {
             case 'Z':
                 name = QString("(%1) %2")
                                .arg(QApplication::translate("Process.Table", "No response"))
@@ -251,42 +371,42 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         }
         case kProcessCPUColumn:
             // formated cpu percent utilization
-            return QString("%1%").arg(proc.cpu(), 0, 'f', 1);
+            return QString("%1%").arg(values.cpu, 0, 'f', 1);
         case kProcessUserColumn:
             // process's user name
-            return proc.userName();
+            return values.userName;
         case kProcessMemoryColumn:
             // formatted memory usage
-            return formatUnit_memory_disk(proc.memory(), KB);
+            return formatUnit_memory_disk(values.memory, KB);
         case kProcessShareMemoryColumn:
             // formatted memory usage
-            return formatUnit_memory_disk(proc.sharememory(), KB);
+            return formatUnit_memory_disk(values.shareMemory, KB);
         case kProcessVTRMemoryColumn:
             // formatted memory usage
-            return formatUnit_memory_disk(proc.vtrmemory(), KB);
+            return formatUnit_memory_disk(values.vtrMemory, KB);
         case kProcessUploadColumn:
             // formatted upload speed text
-            return formatUnit_net(8 * proc.sentBps(), B, 1, true);
+            return formatUnit_net(8 * values.sentBps, B, 1, true);
         case kProcessDownloadColumn:
             // formated download speed text
-            return formatUnit_net(8 * proc.recvBps(), B, 1, true);
+            return formatUnit_net(8 * values.recvBps, B, 1, true);
         case kProcessDiskReadColumn:
             // formatted disk read speed text
-            return formatUnit_memory_disk(proc.readBps(), B, 1, true);
+            return formatUnit_memory_disk(values.readBps, B, 1, true);
         case kProcessDiskWriteColumn:
             // formatted disk write speed text
-            return formatUnit_memory_disk(proc.writeBps(), B, 1, true);
+            return formatUnit_memory_disk(values.writeBps, B, 1, true);
         case kProcessPIDColumn: {
             // process pid text
-            return QString("%1").arg(proc.pid());
+            return QString("%1").arg(m_procIdList[row]);
         }
         case kProcessNiceColumn: {
             // process priority text
-            return QString("%1").arg(proc.priority());
+            return QString("%1").arg(values.priority);
         }
         case kProcessPriorityColumn: {
             // process priority enum text representation
-            return getPriorityName(proc.priority());
+            return getPriorityName(values.priority);
         }
         default:
             break;
@@ -295,7 +415,7 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         switch (index.column()) {
         case kProcessNameColumn:
             // process icon
-            return proc.icon();
+            return m_snapshot->icon(i);
         default:
             return {};
         }
@@ -303,27 +423,27 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         // get process's raw data
         switch (index.column()) {
         case kProcessNameColumn:
-            return proc.name();
+            return m_snapshot->name(i);
         case kProcessMemoryColumn:
-            return proc.memory();
+            return values.memory;
         case kProcessShareMemoryColumn:
-            return proc.sharememory();
+            return values.shareMemory;
         case kProcessVTRMemoryColumn:
-            return proc.vtrmemory();
+            return values.vtrMemory;
         case kProcessCPUColumn:
-            return proc.cpu();
+            return values.cpu;
         case kProcessUploadColumn:
-            return proc.sentBps();
+            return values.sentBps;
         case kProcessDownloadColumn:
-            return proc.recvBps();
+            return values.recvBps;
         case kProcessPIDColumn:
-            return proc.pid();
+            return m_procIdList[row];
         case kProcessDiskReadColumn:
-            return proc.readBps();
+            return values.readBps;
         case kProcessDiskWriteColumn:
-            return proc.writeBps();
+            return values.writeBps;
         case kProcessNiceColumn:
-            return proc.priority();
+            return values.priority;
         default:
             return {};
         }
@@ -331,9 +451,9 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
         // get process's extra data
         switch (index.column()) {
         case kProcessUploadColumn:
-            return proc.sentBps();
+            return values.sentBytes;
         case kProcessDownloadColumn:
-            return proc.recvBps();
+            return values.recvBytes;
         default:
             return {};
         }
@@ -343,20 +463,20 @@ QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
     } else if (role == Qt::UserRole + 2) {
         // text color role based on process's state
         if (index.column() == kProcessNameColumn) {
-            char state = proc.state();
+            char state = values.state;
             if (state == 'Z' || state == 'T') {
                 return QVariant(int(Dtk::Gui::DPalette::TextWarning));
             }
         }
         return {};
     } else if (role == Qt::UserRole + 3) {
-        return proc.appType();
+        return values.appType;
     } else if (role == Qt::UserRole + 4) {
-        QString cmdlineStr = proc.cmdlineString();
+        QString cmdlineStr = m_snapshot->cmdlineString(i);
         if (!cmdlineStr.isEmpty())
             return cmdlineStr;
         else
-            return QString("%1").arg(proc.name());
+            return QString("%1").arg(m_snapshot->name(i));
     }
     return {};
 }
@@ -373,51 +493,51 @@ Qt::ItemFlags ProcessTableModel::flags(const QModelIndex &index) const
 // get process priority enum type
 ProcessPriority ProcessTableModel::getProcessPriority(pid_t pid) const
 {
-    int row = m_procIdList.indexOf(pid);
-    if (row >= 0) {
-        int prio = ProcessDB::instance()->processSet()->getProcessById(pid).priority();
-        return getProcessPriorityStub(prio);
-    }
+    int row = m_pidRows.value(pid, -1);
+    if (row >= 0)
+        return getProcessPriorityStub(m_rowValues[row].priority);
 
     return kInvalidPriority;
 }
 
 int ProcessTableModel::getProcessPriorityValue(pid_t pid) const
 {
-    int row = m_procIdList.indexOf(pid);
-    return row >= 0 ? ProcessDB::instance()->processSet()->getProcessById(pid).priority() : kNormalPriority;
+    int row = m_pidRows.value(pid, -1);
+    return row >= 0 ? m_rowValues[row].priority : kNormalPriority;
 }
 
 // remove process entry from model with specified pid
 void ProcessTableModel::removeProcess(pid_t pid)
 {
     qCWarning(app) << m_procIdList.count() << "1";
-    int row = m_procIdList.indexOf(pid);
+    int row = m_pidRows.value(pid, -1);
     if (row >= 0) {
         beginRemoveRows(QModelIndex(), row, row);
         m_procIdList.removeAt(row);
-        m_processList.removeAt(row);
+        m_snapshotIndexes.removeAt(row);
+        m_rowValues.removeAt(row);
         endRemoveRows();
+        rebuildRowIndex();
     }
 }
 
 // update the state of the process entry with specified pid
 void ProcessTableModel::updateProcessState(pid_t pid, char state)
 {
-    int row = m_procIdList.indexOf(pid);
+    int row = m_pidRows.value(pid, -1);
     if (row >= 0) {
-        m_processList[row].setState(state);
-        Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
+        m_rowValues[row].state = state;
+        Q_EMIT dataChanged(index(row, kProcessNameColumn), index(row, kProcessNameColumn));
     }
 }
 
 // update priority of the process entry with specified pid
 void ProcessTableModel::updateProcessPriority(pid_t pid, int priority)
 {
-    int row = m_procIdList.indexOf(pid);
+    int row = m_pidRows.value(pid, -1);
     if (row >= 0) {
-        m_processList[row].setPriority(priority);
-        Q_EMIT dataChanged(index(row, 0), index(row, columnCount() - 1));
+        m_rowValues[row].priority = priority;
+        Q_EMIT dataChanged(index(row, kProcessNiceColumn), index(row, kProcessPriorityColumn));
     }
 }
 
@@ -425,39 +545,41 @@ void ProcessTableModel::setUserModeName(const QString &userName)
 {
     if (userName != m_userModeName) {
         m_userModeName = userName;
-        updateProcessListWithUserSpecified();
+        // filter changed, not the process list
+        syncSnapshot(ProcessDB::instance()->processSet()->snapshot());
+        Q_EMIT modelUpdated();
     }
 }
 
 qreal ProcessTableModel::getTotalCPUUsage()
 {
     qreal cpuUsage = 0;
-    for (const auto &proc : m_processList) {
-        cpuUsage += proc.cpu();
+    for (const auto &values : m_rowValues) {
+        cpuUsage += values.cpu;
     }
     return cpuUsage;
 }
 qreal ProcessTableModel::getTotalMemoryUsage()
 {
     qreal memUsage = 0;
-    for (const auto &proc : m_processList) {
-        memUsage += proc.memory();
+    for (const auto &values : m_rowValues) {
+        memUsage += values.memory;
     }
     return memUsage;
 }
 qreal ProcessTableModel::getTotalDownload()
 {
     qreal download = 0;
-    for (const auto &proc : m_processList) {
-        download += proc.recvBps();
+    for (const auto &values : m_rowValues) {
+        download += values.recvBps;
     }
     return download;
 }
 qreal ProcessTableModel::getTotalUpload()
 {
     qlonglong upload = 0;
-    for (const auto &proc : m_processList) {
-        upload += proc.sentBps();
+    for (const auto &values : m_rowValues) {
+        upload += values.sentBps;
     }
     return upload;
 }
@@ -465,32 +587,32 @@ qreal ProcessTableModel::getTotalUpload()
 qreal ProcessTableModel::getTotalVirtualMemoryUsage()
 {
     qlonglong vtmem = 0;
-    for (const auto &proc : m_processList) {
-        vtmem += proc.vtrmemory();
+    for (const auto &values : m_rowValues) {
+        vtmem += values.vtrMemory;
     }
     return vtmem;
 }
 qreal ProcessTableModel::getTotalSharedMemoryUsage()
 {
     qlonglong smem = 0;
-    for (const auto &proc : m_processList) {
-        smem += proc.sharememory();
+    for (const auto &values : m_rowValues) {
+        smem += values.shareMemory;
     }
     return smem;
 }
 qreal ProcessTableModel::getTotalDiskRead()
 {
     qlonglong diskread = 0;
-    for (const auto &proc : m_processList) {
-        diskread += proc.readBps();
+    for (const auto &values : m_rowValues) {
+        diskread += values.readBps;
     }
     return diskread;
 }
 qreal ProcessTableModel::getTotalDiskWrite()
 {
     qlonglong diskwrite = 0;
-    for (const auto &proc : m_processList) {
-        diskwrite += proc.writeBps();
+    for (const auto &values : m_rowValues) {
+        diskwrite += values.writeBps;
     }
     return diskwrite;
 }
@@ -9,8 +9,10 @@
 #include "process/process_set.h"
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QVector>
 
 // name column display
 constexpr const char *kProcessName = QT_TRANSLATE_NOOP("Process.Table.Header", "Name");
@@ -136,11 +138,15 @@ public:
     int getProcessPriorityValue(pid_t pid) const;
 
     /**
-     * @brief Get process entry from list with specified pid
+     * @brief Process list snapshot the rows were last synced with
+     */
+    ProcessSnapshotPtr snapshot() const;
+    /**
+     * @brief Index of the process in snapshot()
      * @param pid Process id
-     * @return Process entry item
+     * @return -1 if the process is not shown by the model
      */
-    Process getProcess(pid_t pid) const;
+    int snapshotIndex(pid_t pid) const;
    void setUserModeName(const QString &userName);
     qreal getTotalCPUUsage();
     qreal getTotalMemoryUsage();
@@ -180,8 +186,61 @@ private Q_SLOTS:
 
     void updateProcessListWithUserSpecified();
 private:
-    QList<pid_t> m_procIdList; // pid list
-    QList<Process> m_processList; // pid list
+    /**
+     * @brief Values shown by a row
+     *
+     * Copied from the snapshot on refresh & edited by state/priority change signals until the next
+     * one, changed columns are found by comparing against the values seen on the previous refresh.
+     */
+    struct ProcessRowValues {
+        QString displayName;
+        QString userName;
+        int appType {0};
+        char state {0};
+        qreal cpu {0};
+        qulonglong memory {0};
+        qulonglong shareMemory {0};
+        qulonglong vtrMemory {0};
+        qreal sentBps {0};
+        qreal recvBps {0};
+        qulonglong sentBytes {0};
+        qulonglong recvBytes {0};
+        qreal readBps {0};
+        qreal writeBps {0};
+        int priority {0};
+    };
+
+    /**
+     * @brief Show the processes of snapshot passing the user filter
+     */
+    void syncSnapshot(const ProcessSnapshotPtr &snapshot);
+    /**
+     * @brief Merge the new process list into the rows
+     *
+     * Rows are kept in pid order, so one pass over both lists finds died, born & kept processes.
+     * Contiguous born/died pids are inserted/removed as one range, changed rows are reported by a
+     * single dataChanged spanning the changed rows & columns.
+     * @param snapshot Process list to show
+     * @param indexes Indexes of the shown processes in snapshot, ascending
+     */
+    void syncProcessList(const ProcessSnapshotPtr &snapshot, const QVector<int> &indexes);
+    /**
+     * @brief Rebuild pid - row index after rows were inserted or removed
+     */
+    void rebuildRowIndex();
+    static ProcessRowValues rowValues(const ProcessSnapshot &snapshot, int index);
+    /**
+     * @brief Columns whose contents differ between two value sets
+     * @return Bit mask of columns, bit n set for column n
+     */
+    static quint32 changedColumns(const ProcessRowValues &lhs, const ProcessRowValues &rhs);
+
+private:
+    QList<pid_t> m_procIdList; // pid list (ascending)
+    ProcessSnapshotPtr m_snapshot {std::make_shared<const ProcessSnapshot>()}; // process list the rows were synced with
+    QVector<int> m_snapshotIndexes; // index of each row in m_snapshot
+    QVector<ProcessRowValues> m_rowValues; // values shown by each row on the last refresh
+    QHash<pid_t, int> m_pidRows; // pid - row index
 
     QString m_userModeName {};
 };
@@ -28,6 +28,8 @@ SystemServiceTableModel::SystemServiceTableModel(QObject *parent)
     // conenct service list & status update slots
     connect(mgr, &ServiceManager::serviceListUpdated, this, &SystemServiceTableModel::updateServiceList);
     connect(mgr, &ServiceManager::serviceStatusUpdated, this, &SystemServiceTableModel::updateServiceEntry);
+    connect(mgr, &ServiceManager::serviceEntriesUpdated, this, &SystemServiceTableModel::updateServiceEntries);
+    connect(mgr, &ServiceManager::serviceRemoved, this, &SystemServiceTableModel::removeServiceEntry);
 }
 
 // update the model with the data provided by entry
@@ -205,6 +207,9 @@ void SystemServiceTableModel::fetchMore(const QModelIndex &parent)
     beginInsertRows(QModelIndex(), m_nr, m_nr + more - 1);
     m_nr += more;
     endInsertRows();
+
+    // rows come from the cheap list data, details are only fetched for rows shown
+    ServiceManager::instance()->fetchServiceDetails(m_svcList.mid(m_nr - more, more));
 }
 
 // Check if more data can be fetched for parent index
@@ -234,3 +239,49 @@ void SystemServiceTableModel::updateServiceList(const QList<SystemServiceEntry>
     }
     endResetModel();
 }
+
+// Update the model with entries changed by systemd or filled in with details
+void SystemServiceTableModel::updateServiceEntries(const QList<SystemServiceEntry> &list)
+{
+    bool changed = false;
+    for (auto &ent : list) {
+        auto sname = ent.getSName();
+        if (m_svcMap.contains(sname)) {
+            m_svcMap[sname] = ent;
+            changed = true;
+        } else if (!sname.isEmpty()) {
+            // new service, shown right away if all rows are loaded, otherwise with the next fetchMore
+            auto row = m_svcList.size();
+            m_svcList << sname;
+            m_svcMap[sname] = ent;
+            if (m_nr == row) {
+                beginInsertRows({}, row, row);
+                ++m_nr;
+                endInsertRows();
+            }
+        }
+    }
+
+    // one notification for the whole batch
+    if (changed && m_nr > 0)
+        Q_EMIT dataChanged(index(0, 0), index(m_nr - 1, columnCount() - 1));
+}
+
+// Remove service no longer known by systemd
+void SystemServiceTableModel::removeServiceEntry(const QString &sname)
+{
+    auto row = m_svcList.indexOf(sname);
+    if (row < 0)
+        return;
+
+    if (row < m_nr) {
+        beginRemoveRows({}, row, row);
+        m_svcList.removeAt(row);
+        m_svcMap.remove(sname);
+        --m_nr;
+        endRemoveRows();
+    } else {
+        m_svcList.removeAt(row);
+        m_svcMap.remove(sname);
+    }
+}
@@ -155,6 +155,16 @@ private Q_SLOTS:
      * @param list Updated service's list
      */
     void updateServiceList(const QList<SystemServiceEntry> &list);
+    /**
+     * @brief Update the model with a batch of changed entries, unknown entries are appended
+     * @param list Changed service's list
+     */
+    void updateServiceEntries(const QList<SystemServiceEntry> &list);
+    /**
+     * @brief Remove service from the model
+     * @param sname Service name
+     */
+    void removeServiceEntry(const QString &sname);
 
 private:
     // Service name list
@@ -4,37 +4,115 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "desktop_entry_cache.h"
+#include "ddlog.h"
 
 #include "desktop_entry_cache_updater.h"
 
 #include <QFileInfo>
 #include <QDir>
-#include <DDesktopEntry>
+#include <QDataStream>
+#include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QDebug>
 
-DCORE_USE_NAMESPACE
+#include <algorithm>
+
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace DDLog;
 
 namespace core {
 namespace process {
 
 #define DESKTOP_ENTRY_PATH "/usr/share/applications"
 #define DESKTOP_ENTRY_SUFFIX ".desktop"
+#define DESKTOP_ENTRY_INDEX_MAGIC 0x44454958   // "DEIX"
+#define DESKTOP_ENTRY_INDEX_VERSION 1
+// fallback when inotify is not available (150 ticks, about 5 minutes)
+#define DESKTOP_ENTRY_RESCAN_COUNT 150
+
+namespace {
+
+// application directories, later directories override earlier ones
+QStringList applicationDirs()
+{
+    QString xdgDataDirPath(getenv("XDG_DATA_DIRS"));
+    if (xdgDataDirPath.isEmpty())
+        return {DESKTOP_ENTRY_PATH};
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QStringList xdgDataDirPaths = xdgDataDirPath.split(":", QString::SkipEmptyParts);
+#else
+    QStringList xdgDataDirPaths = xdgDataDirPath.split(":", Qt::SkipEmptyParts);
+#endif
+    QStringList dirs;
+    for (auto &path : xdgDataDirPaths) {
+        dirs << QDir::cleanPath(path.trimmed() + "/applications");
+    }
+    dirs.removeDuplicates();
+    return dirs;
+}
+
+// mtime (ns) of a regular file, -1 if there is none
+qint64 fileMtime(const QString &path)
+{
+    struct stat st {};
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0 || !S_ISREG(st.st_mode))
+        return -1;
+    return qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
 
-DesktopEntryCache::DesktopEntryCache()
+inline QString fileName(const QString &path)
 {
+    return path.mid(path.lastIndexOf('/') + 1);
+}
+
+} // namespace
 
+DesktopEntryCache::DesktopEntryCache(const QString &indexPath)
+    : m_indexPath(indexPath.isEmpty() ? defaultIndexPath() : indexPath)
+{
+}
+
+DesktopEntryCache::~DesktopEntryCache()
+{
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
+}
+
+QString DesktopEntryCache::defaultIndexPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+           + "/deepin-system-monitor/desktop-entry-index";
 }
 
 const DesktopEntry DesktopEntryCache::entryWithDesktopFile(const QString &desktopFile)
 {
-    QFileInfo fileInfo(desktopFile);
-    if (!fileInfo.exists())
+    QString path = QFileInfo(desktopFile).absoluteFilePath();
+    auto it = m_files.constFind(path);
+    // files of the application directories are kept current by inotify
+    if (it != m_files.constEnd() && it->dir >= 0 && m_watchValid)
+        return it->entry;
+
+    DesktopEntry before = it != m_files.constEnd() ? it->entry : DesktopEntry();
+    if (!refreshFile(path, it != m_files.constEnd() ? it->dir : -1)) {
+        // file is gone, drop its keys too
+        if (before)
+            rebuildCache();
         return {};
+    }
 
-    auto entry = DesktopEntryCacheUpdater::createEntry(fileInfo);
-    if (entry) {
-        m_cache[fileInfo.fileName()] = entry;
-        m_cache[entry->name] = entry;
+    auto entry = m_files[path].entry;
+    if (entry && entry != before) {
+        m_cache[fileName(path).toLower()] = entry;
+        m_cache[entry->name.toLower()] = entry;
     }
     return entry;
 }
@@ -44,29 +122,276 @@ QHash<QString, DesktopEntry> DesktopEntryCache::getCache()
     return m_cache;
 }
 
+void DesktopEntryCache::update()
+{
+    if (!m_loaded) {
+        updateCache();
+        return;
+    }
+
+    if (m_inotifyFd < 0) {
+        if (++m_rescanCount >= DESKTOP_ENTRY_RESCAN_COUNT) {
+            m_rescanCount = 0;
+            updateCache();
+        }
+    } else if (!readEvents()) {
+        // events lost or a directory went away, check everything & watch again
+        updateCache();
+    }
+
+    if (m_dirty)
+        saveIndex();
+}
+
 void DesktopEntryCache::updateCache()
 {
-    m_cache.clear();
+    if (!m_loaded) {
+        loadIndex();
+        m_loaded = true;
+    }
 
-    QString xdgDataDirPath(getenv("XDG_DATA_DIRS"));
-    if (xdgDataDirPath.isEmpty()) {
-        auto fileInfoList = QDir(DESKTOP_ENTRY_PATH).entryInfoList(QDir::Files);
-        for (auto &fileInfo : fileInfoList) {
-            entryWithDesktopFile(fileInfo.filePath());
+    m_dirs = applicationDirs();
+    // watch before scanning, so changes made during the scan are not missed
+    watchDirs();
+
+    QSet<QString> seen;
+    for (int i = 0; i < m_dirs.size(); ++i) {
+        DIR *dir = opendir(QFile::encodeName(m_dirs[i]).constData());
+        if (!dir)
+            continue;
+
+        struct dirent *ent;
+        while ((ent = readdir(dir))) {
+            QString name = QFile::decodeName(ent->d_name);
+            if (!name.endsWith(DESKTOP_ENTRY_SUFFIX))
+                continue;
+
+            QString path = m_dirs[i] + '/' + name;
+            if (refreshFile(path, i))
+                seen.insert(path);
         }
-    } else {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QStringList xdgDataDirPaths = xdgDataDirPath.split(":", QString::SkipEmptyParts);
-#else
-        QStringList xdgDataDirPaths = xdgDataDirPath.split(":", Qt::SkipEmptyParts);
-#endif
-        for (auto path : xdgDataDirPaths) {
-            auto fileInfoList = QDir(path.trimmed() + "/applications").entryInfoList(QDir::Files);
-            for (auto &fileInfo : fileInfoList) {
-                entryWithDesktopFile(fileInfo.filePath());
+        closedir(dir);
+    }
+
+    // drop files removed since the last scan, files outside the application directories are checked on lookup
+    for (auto it = m_files.begin(); it != m_files.end();) {
+        if (!seen.contains(it.key()) && (it->dir >= 0 || m_dirs.contains(QFileInfo(it.key()).path()))) {
+            it = m_files.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+
+    rebuildCache();
+    if (m_dirty)
+        saveIndex();
+}
+
+void DesktopEntryCache::loadIndex()
+{
+    QFile file(m_indexPath);
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+        return;
+
+    uchar *data = file.map(0, file.size());
+    if (!data)
+        return;
+
+    QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(file.size()));
+    QDataStream in(buffer);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0, version = 0;
+    QString locale;
+    quint32 count = 0;
+    in >> magic >> version >> locale >> count;
+    // display names are localized, an index written under another locale is useless
+    if (magic == DESKTOP_ENTRY_INDEX_MAGIC && version == DESKTOP_ENTRY_INDEX_VERSION && locale == QLocale::system().name()) {
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            QString path;
+            desktop_file_t record;
+            bool hasEntry = false;
+            in >> path >> record.mtime >> hasEntry;
+            if (hasEntry) {
+                record.entry = std::make_shared<struct desktop_entry_t>();
+                in >> record.entry->name >> record.entry->displayName >> record.entry->exec
+                   >> record.entry->icon >> record.entry->startup_wm_class;
+            }
+            if (in.status() == QDataStream::Ok)
+                m_files.insert(path, record);
+        }
+        if (in.status() != QDataStream::Ok) {
+            qCWarning(app) << "Corrupted desktop entry index:" << m_indexPath;
+            m_files.clear();
+        }
+    }
+
+    // every string was copied out of the mapping
+    file.unmap(data);
+}
+
+void DesktopEntryCache::saveIndex()
+{
+    m_dirty = false;
+
+    QDir().mkpath(QFileInfo(m_indexPath).path());
+    QSaveFile file(m_indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(app) << "Failed to write desktop entry index:" << m_indexPath << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << quint32(DESKTOP_ENTRY_INDEX_MAGIC) << quint32(DESKTOP_ENTRY_INDEX_VERSION)
+        << QLocale::system().name() << quint32(m_files.size());
+    for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it) {
+        const auto &entry = it->entry;
+        out << it.key() << it->mtime << bool(entry);
+        if (entry)
+            out << entry->name << entry->displayName << entry->exec << entry->icon << entry->startup_wm_class;
+    }
+    file.commit();
+}
+
+void DesktopEntryCache::watchDirs()
+{
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
+    m_watches.clear();
+    m_parentWatches.clear();
+    m_watchValid = false;
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        qCWarning(app) << "inotify unavailable, desktop entries are rescanned periodically:" << strerror(errno);
+        return;
+    }
+
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+    QStringList missing;
+    for (int i = 0; i < m_dirs.size(); ++i) {
+        int wd = inotify_add_watch(m_inotifyFd, QFile::encodeName(m_dirs[i]).constData(), mask);
+        if (wd >= 0)
+            m_watches.insert(wd, i);
+        else if (errno == ENOENT)
+            missing << m_dirs[i];
+    }
+
+    // directories created later (~/.local/share/applications on a fresh account) are caught on their
+    // nearest existing parent, added to a directory watched above without replacing its mask
+    const uint32_t parentMask = IN_CREATE | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_MASK_ADD;
+    for (const QString &dir : missing) {
+        QString child = dir;
+        QString parent = QFileInfo(child).path();
+        while (parent != child && !QFileInfo(parent).isDir()) {
+            child = parent;
+            parent = QFileInfo(child).path();
+        }
+        int wd = inotify_add_watch(m_inotifyFd, QFile::encodeName(parent).constData(), parentMask);
+        if (wd >= 0)
+            m_parentWatches[wd].insert(fileName(child));
+    }
+    m_watchValid = true;
+}
+
+bool DesktopEntryCache::readEvents()
+{
+    alignas(struct inotify_event) char buf[4096];
+    bool changed = false;
+
+    for (;;) {
+        ssize_t n = read(m_inotifyFd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR)
+            continue;
+        // EAGAIN: queue drained
+        if (n <= 0)
+            break;
+
+        for (char *p = buf; p < buf + n;) {
+            auto *ev = reinterpret_cast<struct inotify_event *>(p);
+            p += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & (IN_Q_OVERFLOW | IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                m_watchValid = false;
+                continue;
             }
+
+            if (ev->len == 0)
+                continue;
+            QString name = QFile::decodeName(ev->name);
+
+            // next path component of a missing directory showed up, watch & scan it
+            auto parent = m_parentWatches.constFind(ev->wd);
+            if (parent != m_parentWatches.constEnd() && (ev->mask & IN_ISDIR) && parent->contains(name)) {
+                m_watchValid = false;
+                continue;
+            }
+
+            auto dir = m_watches.constFind(ev->wd);
+            if (dir == m_watches.constEnd())
+                continue;
+            if (!name.endsWith(DESKTOP_ENTRY_SUFFIX))
+                continue;
+
+            // deleted or moved away files are dropped by refreshFile
+            refreshFile(m_dirs[dir.value()] + '/' + name, dir.value());
+            changed = true;
         }
     }
+
+    if (!m_watchValid)
+        return false;
+    if (changed)
+        rebuildCache();
+    return true;
+}
+
+bool DesktopEntryCache::refreshFile(const QString &path, int dir)
+{
+    qint64 mtime = fileMtime(path);
+    if (mtime < 0) {
+        if (m_files.remove(path))
+            m_dirty = true;
+        return false;
+    }
+
+    auto it = m_files.find(path);
+    if (it != m_files.end() && it->mtime == mtime) {
+        it->dir = dir;
+        return true;
+    }
+
+    desktop_file_t record;
+    record.mtime = mtime;
+    record.dir = dir;
+    record.entry = DesktopEntryCacheUpdater::createEntry(QFileInfo(path));
+    m_files.insert(path, record);
+    m_dirty = true;
+    return true;
+}
+
+void DesktopEntryCache::rebuildCache()
+{
+    // same precedence as a full parse: directories in XDG order, files by name, later ones win
+    QList<QString> paths = m_files.keys();
+    std::sort(paths.begin(), paths.end(), [this](const QString &a, const QString &b) {
+        int da = m_files.value(a).dir;
+        int db = m_files.value(b).dir;
+        da = da < 0 ? INT_MAX : da;
+        db = db < 0 ? INT_MAX : db;
+        return da != db ? da < db : a < b;
+    });
+
+    m_cache.clear();
+    for (auto &path : paths) {
+        const auto &entry = m_files[path].entry;
+        if (!entry)
+            continue;
+        m_cache[fileName(path).toLower()] = entry;
+        m_cache[entry->name.toLower()] = entry;
+    }
 }
 
 } // namespace process
@@ -7,6 +7,8 @@
 #define DESKTOP_ENTRY_CACHE_H
 
 #include <QHash>
+#include <QSet>
+#include <QStringList>
 
 #include <memory>
 
@@ -22,11 +24,22 @@ struct desktop_entry_t {
 };
 using DesktopEntry = std::shared_ptr<struct desktop_entry_t>;
 
+/**
+ * @brief Desktop entries of the XDG application directories
+ *
+ * Entries are indexed by lower case desktop file name & entry name (exec base name or StartupWMClass),
+ * so lookups by name are hash lookups. Parsed files are kept in an on-disk index keyed by path & mtime,
+ * which is mmapped at startup so only files changed since the last run get parsed again. While running,
+ * inotify watches on the application directories report changed files, there are no periodic rescans.
+ */
 class DesktopEntryCache
 {
 public:
-    explicit DesktopEntryCache();
-    virtual ~DesktopEntryCache() = default;
+    /**
+     * @param indexPath On-disk index file, defaultIndexPath() if empty
+     */
+    explicit DesktopEntryCache(const QString &indexPath = {});
+    virtual ~DesktopEntryCache();
 
     bool contains(const QString &name) const;
     const DesktopEntry entry(const QString &name) const;
@@ -34,40 +47,74 @@ public:
     const DesktopEntry entryWithSubName(const QString &subName) const;
     QHash<QString, DesktopEntry> getCache();
 
+    /**
+     * @brief Apply pending inotify events, rebuilds the cache on first call or when events got lost
+     */
+    void update();
+    /**
+     * @brief Check every file of the application directories against the index, parse new & changed ones
+     */
     void updateCache();
 
+    static QString defaultIndexPath();
 
 private:
+    struct desktop_file_t {
+        qint64 mtime {0};       // ns since epoch
+        int dir {-1};           // index into m_dirs, -1 if outside the application directories
+        DesktopEntry entry {};  // null if the file is filtered out
+    };
+
+    void loadIndex();
+    void saveIndex();
+    void watchDirs();
+    bool readEvents();
+    // parse path unless its mtime matches the record, drop the record if the file is gone
+    bool refreshFile(const QString &path, int dir);
+    void rebuildCache();
+
+private:
+    // lower case file name & entry name => entry
     QHash<QString, DesktopEntry> m_cache;
+    // absolute path => parsed file
+    QHash<QString, desktop_file_t> m_files;
+    QStringList m_dirs;
+
+    QString m_indexPath;
+    bool m_loaded {false};
+    bool m_dirty {false};
+
+    int m_inotifyFd {-1};
+    // watch descriptor => index into m_dirs
+    QHash<int, int> m_watches;
+    // watch descriptor of the nearest existing parent of missing directories => names leading to them
+    QHash<int, QSet<QString>> m_parentWatches;
+    bool m_watchValid {false};
+    // ticks since the last full check, only used without inotify
+    int m_rescanCount {0};
 };
 
 inline bool DesktopEntryCache::contains(const QString &name) const
 {
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower() == name.toLower())
-            return true;
-    }
-    return false;
+    return m_cache.contains(name.toLower());
 }
 
 inline const DesktopEntry DesktopEntryCache::entry(const QString &name) const
 {
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower() == name.toLower())
-            return m_cache[key];
-    }
+    auto it = m_cache.constFind(name.toLower());
+    if (it != m_cache.constEnd())
+        return it.value();
     return std::make_shared<struct desktop_entry_t>();
 }
 
 inline const DesktopEntry DesktopEntryCache::entryWithSubName(const QString &subName) const
 {
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower().compare(subName) == 0)
-            return m_cache[key];
-    }
-    for (auto &key : m_cache.keys()) {
-        if (key.toLower().contains(subName))
-            return m_cache[key];
+    auto it = m_cache.constFind(subName);
+    if (it != m_cache.constEnd())
+        return it.value();
+    for (auto iter = m_cache.constBegin(); iter != m_cache.constEnd(); ++iter) {
+        if (iter.key().contains(subName))
+            return iter.value();
     }
     return {};
 }
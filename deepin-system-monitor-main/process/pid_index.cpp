@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pid_index.h"
+
+#include <algorithm>
+
+namespace core {
+namespace process {
+
+// smallest table we ever allocate
+static const size_t kMinCapacity = 16;
+
+PidIndex::PidIndex(size_t capacity)
+{
+    rehash(capacity);
+}
+
+void PidIndex::beginScan()
+{
+    ++m_generation;
+    // 0 is reserved for "never stamped"
+    if (m_generation == 0)
+        m_generation = 1;
+}
+
+bool PidIndex::mark(pid_t pid)
+{
+    if (pid <= 0)
+        return false;
+
+    // keep load factor under 1/2, probe chains stay short
+    if ((m_size + 1) * 2 > m_slots.size())
+        rehash(m_slots.size() * 2);
+
+    size_t pos = slotOf(pid);
+    while (m_slots[pos].pid != 0) {
+        if (m_slots[pos].pid == pid) {
+            m_slots[pos].generation = m_generation;
+            return false;
+        }
+        pos = (pos + 1) & m_mask;
+    }
+
+    m_slots[pos].pid = pid;
+    m_slots[pos].generation = m_generation;
+    ++m_size;
+    return true;
+}
+
+void PidIndex::endScan(QList<pid_t> *died)
+{
+    // backward shift deletion may move a not yet visited slot into an already visited
+    // position, so restart the probe at the same position after each erase
+    size_t pos = 0;
+    while (pos < m_slots.size()) {
+        const Slot &slot = m_slots[pos];
+        if (slot.pid != 0 && slot.generation != m_generation) {
+            if (died)
+                died->append(slot.pid);
+            erase(pos);
+            continue;
+        }
+        ++pos;
+    }
+}
+
+bool PidIndex::contains(pid_t pid) const
+{
+    if (pid <= 0)
+        return false;
+
+    size_t pos = slotOf(pid);
+    while (m_slots[pos].pid != 0) {
+        if (m_slots[pos].pid == pid)
+            return true;
+        pos = (pos + 1) & m_mask;
+    }
+    return false;
+}
+
+void PidIndex::clear()
+{
+    std::fill(m_slots.begin(), m_slots.end(), Slot {0, 0});
+    m_size = 0;
+}
+
+void PidIndex::rehash(size_t capacity)
+{
+    size_t cap = kMinCapacity;
+    int bits = 4;
+    while (cap < capacity) {
+        cap <<= 1;
+        ++bits;
+    }
+
+    std::vector<Slot> old;
+    old.swap(m_slots);
+    m_slots.assign(cap, Slot {0, 0});
+    m_mask = cap - 1;
+    m_shift = 32 - bits;
+    m_size = 0;
+    ++m_allocations;
+
+    for (const Slot &slot : old) {
+        if (slot.pid == 0)
+            continue;
+        size_t pos = slotOf(slot.pid);
+        while (m_slots[pos].pid != 0)
+            pos = (pos + 1) & m_mask;
+        m_slots[pos] = slot;
+        ++m_size;
+    }
+}
+
+void PidIndex::erase(size_t pos)
+{
+    size_t hole = pos;
+    size_t i = (pos + 1) & m_mask;
+    while (m_slots[i].pid != 0) {
+        size_t home = slotOf(m_slots[i].pid);
+        // move the entry into the hole unless its home slot lies in (hole, i]
+        if (((i - home) & m_mask) >= ((i - hole) & m_mask)) {
+            m_slots[hole] = m_slots[i];
+            hole = i;
+        }
+        i = (i + 1) & m_mask;
+    }
+    m_slots[hole] = Slot {0, 0};
+    --m_size;
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PID_INDEX_H
+#define PID_INDEX_H
+
+#include <QList>
+
+#include <vector>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Open-addressed pid index used to diff consecutive /proc scans
+ *
+ * Every scan bumps a generation counter, each pid seen during the scan is stamped with
+ * the current generation, and entries left with an older stamp at the end of the scan
+ * are the processes that died since the previous one. Born/died/survived sets are thus
+ * computed in a single linear pass over readdir(/proc), without any per-pid allocation.
+ */
+class PidIndex
+{
+public:
+    explicit PidIndex(size_t capacity = 1024);
+
+    /**
+     * @brief Start a new scan generation
+     */
+    void beginScan();
+    /**
+     * @brief Stamp pid with the current generation
+     * @param pid Process id seen during the scan
+     * @return true if pid was not present in the previous generation (born)
+     */
+    bool mark(pid_t pid);
+    /**
+     * @brief Finish the scan and drop every pid not stamped in this generation
+     * @param died Receives the dropped pids if not null
+     */
+    void endScan(QList<pid_t> *died = nullptr);
+
+    bool contains(pid_t pid) const;
+    void clear();
+
+    inline size_t size() const
+    {
+        return m_size;
+    }
+    inline quint32 generation() const
+    {
+        return m_generation;
+    }
+    /**
+     * @brief Number of slot table (re)allocations done so far
+     */
+    inline size_t allocations() const
+    {
+        return m_allocations;
+    }
+
+private:
+    struct Slot {
+        pid_t pid; // 0 marks an empty slot
+        quint32 generation;
+    };
+
+    inline size_t slotOf(pid_t pid) const
+    {
+        // fibonacci hashing, table size is always a power of two
+        return size_t((quint32(pid) * 0x9E3779B1u) >> m_shift);
+    }
+    void rehash(size_t capacity);
+    void erase(size_t pos);
+
+    std::vector<Slot> m_slots;
+    size_t m_mask {0};
+    int m_shift {32};
+    size_t m_size {0};
+    quint32 m_generation {0};
+    size_t m_allocations {0};
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PID_INDEX_H
@@ -9,6 +9,7 @@
 #include "common/sample.h"
 #include "process/process_icon.h"
 #include "process/process_name.h"
+#include "process/proc_reader.h"
 
 #include <QSharedData>
 
@@ -79,12 +80,12 @@ public:
         , environ {}
         , uptime {timeval {0, 0}}
         , sockInodes {}
-        , cpuTimeSample(new CPUTimeSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , cpuUsageSample(new CPUUsageSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , networkIOSample(new IOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , networkBandwidthSample(new IOPSSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , diskIOSample(new DISKIOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
-        , diskIOSpeedSample(new IOPSSample(TimePeriod(TimePeriod::kNoPeriod, default_interval())))
+        , cpuTimeSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , cpuUsageSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , networkIOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , networkBandwidthSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , diskIOSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
+        , diskIOSpeedSample(TimePeriod(TimePeriod::kNoPeriod, default_interval()))
     {
     }
     ProcessPrivate(const ProcessPrivate &other)
@@ -131,12 +132,12 @@ public:
         , environ(other.environ)
         , uptime {other.uptime}
         , sockInodes(other.sockInodes)
-        , cpuTimeSample(std::unique_ptr<CPUTimeSample>(new CPUTimeSample(*(other.cpuTimeSample))))
-        , cpuUsageSample(std::unique_ptr<CPUUsageSample>(new CPUUsageSample(*(other.cpuUsageSample))))
-        , networkIOSample(std::unique_ptr<IOSample>(new IOSample(*(other.networkIOSample))))
-        , networkBandwidthSample(std::unique_ptr<IOPSSample>(new IOPSSample(*(other.networkBandwidthSample))))
-        , diskIOSample(std::unique_ptr<DISKIOSample>(new DISKIOSample(*(other.diskIOSample))))
-        , diskIOSpeedSample(std::unique_ptr<IOPSSample>(new IOPSSample(*(other.diskIOSpeedSample))))
+        , cpuTimeSample(other.cpuTimeSample)
+        , cpuUsageSample(other.cpuUsageSample)
+        , networkIOSample(other.networkIOSample)
+        , networkBandwidthSample(other.networkBandwidthSample)
+        , diskIOSample(other.diskIOSample)
+        , diskIOSpeedSample(other.diskIOSpeedSample)
     {
     }
     ~ProcessPrivate() {}
@@ -189,6 +190,7 @@ private:
 
     QString usrerName;
 
+    QByteArray statName; // name field of /proc/[pid]/stat
     QString name; // raw name
     ProcessName proc_name; // process name object
     ProcessIcon proc_icon; // process icon object
@@ -200,13 +202,17 @@ private:
     QList<ino_t> sockInodes; // socket inodes opened by this process
 
     // only 2 samples are kept here for each process, to avoid too much memory
-    // consumption if there're too many processes
-    std::unique_ptr<CPUTimeSample> cpuTimeSample;
-    std::unique_ptr<CPUUsageSample> cpuUsageSample;
-    std::unique_ptr<IOSample> networkIOSample;
-    std::unique_ptr<IOPSSample> networkBandwidthSample;
-    std::unique_ptr<DISKIOSample> diskIOSample;
-    std::unique_ptr<IOPSSample> diskIOSpeedSample;
+    // consumption if there're too many processes; frames are stored inline,
+    // adding one never allocates
+    CPUTimeSample cpuTimeSample;
+    CPUUsageSample cpuUsageSample;
+    IOSample networkIOSample;
+    IOPSSample networkBandwidthSample;
+    DISKIOSample diskIOSample;
+    IOPSSample diskIOSpeedSample;
+
+    // cached /proc/[pid] dir, never shared between copies
+    ProcReader reader;
 
     friend class Process;
 };
@@ -0,0 +1,323 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "proc_reader.h"
+
+#include <mutex>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+namespace core {
+namespace process {
+
+namespace {
+
+// cached /proc/[pid] dir fd
+struct dir_slot_t {
+    const ProcReader *owner;
+    pid_t pid;
+    int fd;
+    int pins; // reads in flight, pinned slots are never evicted
+    int prev; // lru links, head is the most recently used slot
+    int next; // also links the free slots
+};
+
+/**
+ * @brief Dir fds of all readers in one fixed size table, least recently used ones are closed
+ * when the table is full. Slots are allocated once, lookups & evictions never touch the heap.
+ */
+class DirCache
+{
+public:
+    explicit DirCache(int capacity)
+        : m_slots(size_t(capacity))
+    {
+        for (int i = 0; i < capacity; ++i)
+            m_slots[size_t(i)].next = (i + 1 < capacity) ? i + 1 : -1;
+        m_free = capacity > 0 ? 0 : -1;
+    }
+
+    inline bool owns(int i, const ProcReader *owner, pid_t pid) const
+    {
+        const auto &slot = m_slots[size_t(i)];
+        return slot.owner == owner && slot.pid == pid;
+    }
+    inline bool owns(int i, const ProcReader *owner) const
+    {
+        return m_slots[size_t(i)].owner == owner;
+    }
+
+    int pin(int i)
+    {
+        auto &slot = m_slots[size_t(i)];
+        ++slot.pins;
+        unlink(i);
+        pushFront(i);
+        return slot.fd;
+    }
+    inline void unpin(int i)
+    {
+        --m_slots[size_t(i)].pins;
+    }
+
+    /**
+     * @brief Cache fd for owner, pinned once
+     * @param evicted Fd of the evicted slot the caller has to close, -1 if none
+     * @return Slot index, -1 if every slot is pinned
+     */
+    int insert(const ProcReader *owner, pid_t pid, int fd, int *evicted)
+    {
+        *evicted = -1;
+        int i = m_free;
+        if (i >= 0) {
+            m_free = m_slots[size_t(i)].next;
+            ++m_used;
+        } else {
+            // walk from the least recently used end, skip slots being read right now
+            for (i = m_tail; i >= 0 && m_slots[size_t(i)].pins > 0; i = m_slots[size_t(i)].prev) {}
+            if (i < 0)
+                return -1;
+            *evicted = m_slots[size_t(i)].fd;
+            unlink(i);
+        }
+
+        auto &slot = m_slots[size_t(i)];
+        slot.owner = owner;
+        slot.pid = pid;
+        slot.fd = fd;
+        slot.pins = 1;
+        pushFront(i);
+        return i;
+    }
+
+    /**
+     * @brief Free slot i
+     * @return Fd of the slot the caller has to close
+     */
+    int remove(int i)
+    {
+        auto &slot = m_slots[size_t(i)];
+        int fd = slot.fd;
+        unlink(i);
+        slot = {};
+        slot.next = m_free;
+        m_free = i;
+        --m_used;
+        return fd;
+    }
+
+    inline int size() const
+    {
+        return m_used;
+    }
+
+    std::mutex lock;
+
+private:
+    void unlink(int i)
+    {
+        auto &slot = m_slots[size_t(i)];
+        if (slot.prev >= 0)
+            m_slots[size_t(slot.prev)].next = slot.next;
+        else
+            m_head = slot.next;
+        if (slot.next >= 0)
+            m_slots[size_t(slot.next)].prev = slot.prev;
+        else
+            m_tail = slot.prev;
+        slot.prev = slot.next = -1;
+    }
+    void pushFront(int i)
+    {
+        auto &slot = m_slots[size_t(i)];
+        slot.prev = -1;
+        slot.next = m_head;
+        if (m_head >= 0)
+            m_slots[size_t(m_head)].prev = i;
+        m_head = i;
+        if (m_tail < 0)
+            m_tail = i;
+    }
+
+    std::vector<dir_slot_t> m_slots;
+    int m_head {-1};
+    int m_tail {-1};
+    int m_free {-1};
+    int m_used {0};
+};
+
+// never destroyed, readers of static processes may outlive any static cache object
+DirCache &dirCache()
+{
+    static DirCache *cache = new DirCache(ProcReader::maxCachedDirs());
+    return *cache;
+}
+
+} // namespace
+
+// keep half of the soft fd limit for everything else (sockets, pipes, icons, ...)
+int ProcReader::maxCachedDirs()
+{
+    static const int maxDirs = []() -> int {
+        struct rlimit rl {};
+        if (getrlimit(RLIMIT_NOFILE, &rl) != 0)
+            return 512;
+        if (rl.rlim_cur == RLIM_INFINITY || rl.rlim_cur > 2 * kMaxCachedDirs)
+            return kMaxCachedDirs;
+        return int(rl.rlim_cur / 2);
+    }();
+    return maxDirs;
+}
+
+ProcReader::~ProcReader()
+{
+    close();
+}
+
+void ProcReader::close()
+{
+    int fd = -1;
+    if (m_slot >= 0) {
+        DirCache &cache = dirCache();
+        std::lock_guard<std::mutex> guard(cache.lock);
+        if (cache.owns(m_slot, this))
+            fd = cache.remove(m_slot);
+    }
+    if (fd >= 0)
+        ::close(fd);
+    m_slot = -1;
+    m_pid = 0;
+}
+
+int ProcReader::cachedDirCount()
+{
+    DirCache &cache = dirCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    return cache.size();
+}
+
+int ProcReader::acquireDir(pid_t pid, int *slot)
+{
+    DirCache &cache = dirCache();
+    *slot = -1;
+    if (m_slot >= 0) {
+        std::lock_guard<std::mutex> guard(cache.lock);
+        if (cache.owns(m_slot, this, pid)) {
+            *slot = m_slot;
+            return cache.pin(m_slot);
+        }
+    }
+
+    // first read, evicted since the last one or pid changed (should not happen)
+    close();
+
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d", pid);
+    int fd = ::open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    int evicted = -1;
+    {
+        std::lock_guard<std::mutex> guard(cache.lock);
+        *slot = cache.insert(this, pid, fd, &evicted);
+    }
+    if (evicted >= 0)
+        ::close(evicted);
+    if (*slot >= 0) {
+        m_slot = *slot;
+        m_pid = pid;
+    }
+    return fd;
+}
+
+void ProcReader::releaseDir(int fd, int slot)
+{
+    int err = errno;
+    if (slot >= 0) {
+        DirCache &cache = dirCache();
+        std::lock_guard<std::mutex> guard(cache.lock);
+        cache.unpin(slot);
+    } else {
+        // every slot pinned by other readers, the fd was not cached
+        ::close(fd);
+    }
+    errno = err;
+}
+
+const char *ProcReader::read(pid_t pid, const char *name, size_t *len)
+{
+    // one buffer per sampling thread, reused for every file of every process
+    static thread_local char buf[kBufferSize + 1];
+
+    *len = 0;
+    int slot = -1;
+    int dfd = acquireDir(pid, &slot);
+    if (dfd < 0)
+        return nullptr;
+
+    int fd = openat(dfd, name, O_RDONLY | O_CLOEXEC);
+    releaseDir(dfd, slot);
+    if (fd < 0)
+        return nullptr;
+
+    size_t total = 0;
+    while (total < kBufferSize) {
+        ssize_t n = pread(fd, buf + total, kBufferSize - total, off_t(total));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            return nullptr;
+        }
+        if (n == 0)
+            break;
+        total += size_t(n);
+    }
+    ::close(fd);
+
+    buf[total] = '\0';
+    *len = total;
+    return buf;
+}
+
+int ProcReader::openDir(pid_t pid, const char *name)
+{
+    int slot = -1;
+    int dfd = acquireDir(pid, &slot);
+    if (dfd < 0)
+        return -1;
+
+    int fd = openat(dfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    releaseDir(dfd, slot);
+    return fd;
+}
+
+namespace scan {
+
+const char *findKey(const char *buf, const char *end, const char *key, size_t keylen)
+{
+    const char *p = buf;
+    while (p && p < end) {
+        if (size_t(end - p) >= keylen && memcmp(p, key, keylen) == 0)
+            return p + keylen;
+        p = static_cast<const char *>(memchr(p, '\n', size_t(end - p)));
+        if (p)
+            ++p;
+    }
+    return nullptr;
+}
+
+} // namespace scan
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Allocation free reader of /proc/[pid]/* files
+ *
+ * Keeps the /proc/[pid] directory open between ticks, files are opened relative to it with
+ * openat and read with pread into a per-thread buffer, so sampling a process every tick
+ * neither formats path strings nor touches the heap. Directory fds of all readers share one
+ * fixed size LRU table sized below the soft fd limit, a reader whose fd got evicted opens
+ * the directory again on its next read.
+ */
+class ProcReader
+{
+public:
+    // size of the per-thread read buffer, large enough for stat/statm/io/status/cmdline
+    static const size_t kBufferSize = 4096;
+    // upper bound of cached directory fds when the fd limit is high or unlimited
+    static const int kMaxCachedDirs = 4096;
+
+    ProcReader() = default;
+    ~ProcReader();
+
+    ProcReader(const ProcReader &) = delete;
+    ProcReader &operator=(const ProcReader &) = delete;
+
+    /**
+     * @brief Read /proc/[pid]/[name] into the calling thread's buffer
+     * @param pid Process id
+     * @param name File name relative to /proc/[pid]
+     * @param len Number of bytes read (buffer is always null terminated)
+     * @return Buffer pointer, or nullptr on failure (errno is kept)
+     */
+    const char *read(pid_t pid, const char *name, size_t *len);
+    /**
+     * @brief Open a directory below /proc/[pid], e.g. "fd"
+     * @return Directory fd owned by the caller, or -1 on failure
+     */
+    int openDir(pid_t pid, const char *name);
+
+    /**
+     * @brief Close the cached /proc/[pid] directory fd
+     */
+    void close();
+
+    /**
+     * @brief Number of /proc/[pid] directory fds currently cached by all readers
+     */
+    static int cachedDirCount();
+    /**
+     * @brief Max number of cached directory fds, half of the soft fd limit
+     */
+    static int maxCachedDirs();
+
+private:
+    /**
+     * @brief Get the /proc/[pid] dir fd, pinned in the cache until releaseDir
+     * @param slot Cache slot to release, -1 if the fd is not cached & owned by the caller
+     */
+    int acquireDir(pid_t pid, int *slot);
+    void releaseDir(int fd, int slot);
+
+    pid_t m_pid {0};
+    // slot in the shared dir fd table, only valid while the slot's owner is still this reader
+    int m_slot {-1};
+};
+
+namespace scan {
+
+/**
+ * @brief Hand written, locale independent field scanners for /proc text
+ *
+ * All scanners take the current position and the end of the buffer, store the parsed value
+ * and return the position right after the consumed characters (or nullptr on failure).
+ */
+
+inline const char *skipSpaces(const char *p, const char *end)
+{
+    while (p && p < end && (*p == ' ' || *p == '\t' || *p == '\n'))
+        ++p;
+    return p;
+}
+
+inline const char *skipField(const char *p, const char *end)
+{
+    p = skipSpaces(p, end);
+    if (!p || p >= end)
+        return nullptr;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n')
+        ++p;
+    return p;
+}
+
+inline const char *skipFields(const char *p, const char *end, int n)
+{
+    while (p && n-- > 0)
+        p = skipField(p, end);
+    return p;
+}
+
+template<typename T>
+inline const char *parseUnsigned(const char *p, const char *end, T *out)
+{
+    p = skipSpaces(p, end);
+    if (!p || p >= end || *p < '0' || *p > '9')
+        return nullptr;
+
+    T v = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        v = T(v * 10 + T(*p++ - '0'));
+    *out = v;
+    return p;
+}
+
+template<typename T>
+inline const char *parseSigned(const char *p, const char *end, T *out)
+{
+    p = skipSpaces(p, end);
+    if (!p || p >= end)
+        return nullptr;
+
+    bool neg = false;
+    if (*p == '-' || *p == '+') {
+        neg = (*p == '-');
+        ++p;
+    }
+    if (p >= end || *p < '0' || *p > '9')
+        return nullptr;
+
+    T v = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        v = T(v * 10 + T(*p++ - '0'));
+    *out = neg ? T(-v) : v;
+    return p;
+}
+
+/**
+ * @brief Find the value of a "Key:<spaces>value" line, e.g. in /proc/[pid]/status
+ * @return Position after the key (and its separator), or nullptr if key not found
+ */
+const char *findKey(const char *buf, const char *end, const char *key, size_t keylen);
+
+} // namespace scan
+
+} // namespace process
+} // namespace core
+
+#endif // PROC_READER_H
@@ -5,6 +5,7 @@
 
 #include "process.h"
 #include "private/process_p.h"
+#include "proc_reader.h"
 #include "system/device_db.h"
 #include "process/process_db.h"
 #include "system/sys_info.h"
@@ -26,16 +27,7 @@
 #include <string.h>
 #include <fcntl.h>
 
-#define PROC_PATH "/proc"
-#define PROC_STAT_PATH "/proc/%u/stat"
-#define PROC_STATUS_PATH "/proc/%u/status"
-#define PROC_STATM_PATH "/proc/%u/statm"
-#define PROC_CMDLINE_PATH "/proc/%u/cmdline"
 #define PROC_ENVIRON_PATH "/proc/%u/environ"
-#define PROC_IO_PATH "/proc/%u/io"
-#define PROC_FD_PATH "/proc/%u/fd"
-#define PROC_FD_NAME_PATH "/proc/%u/fd/%s"
-#define PROC_SCHEDSTAT_PATH "/proc/%u/schedstat"
 
 using namespace common::alloc;
 using namespace common::init;
@@ -119,7 +111,28 @@ timeval Process::procuptime() const
     return d->uptime;
 }
 
+ProcessSampleContext ProcessSampleContext::current()
+{
+    ProcessSampleContext ctx {};
+    ctx.uptime = SysInfo::instance()->uptime();
+    ctx.cpuUsageTotalDelta = DeviceDB::instance()->cpuSet()->getUsageTotalDelta();
+    ctx.procset = ProcessDB::instance()->processSet();
+    ctx.netifMonitor = NetifMonitor::instance();
+    return ctx;
+}
+
 void Process::readProcessVariableInfo()
+{
+    readProcessVariableInfo(ProcessSampleContext::current());
+}
+
+void Process::readProcessVariableInfo(const ProcessSampleContext &ctx)
+{
+    readProcessVariableFiles(ctx);
+    mergeProcessVariableInfo(ctx);
+}
+
+void Process::readProcessVariableFiles(const ProcessSampleContext &ctx)
 {
     d->valid = true;
 
@@ -132,49 +145,54 @@ void Process::readProcessVariableInfo()
     readIO();
     readSockInodes();
 
-    d->proc_name.refreashProcessName(this);
-    d->uptime = SysInfo::instance()->uptime();
-
-    CPUSet *cpuset = DeviceDB::instance()->cpuSet();
-    ProcessSet *procset =  ProcessDB::instance()->processSet();
+    d->uptime = ctx.uptime;
 
-    auto recentProcptr = procset->getRecentProcStage(d->pid);
+    auto recentProcptr = ctx.procset->getRecentProcStage(d->pid);
     auto validrecentPtr = recentProcptr.lock();
     qreal timedelta = d->stime + d->utime;
     if (validrecentPtr) {
         timedelta = timedelta - validrecentPtr->ptime;
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
+        d->diskIOSample.addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
 
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        d->networkIOSample.addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
     }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+    d->cpuUsageSample.addSample(CPUUsageSampleFrame(qMax(0., timedelta) / ctx.cpuUsageTotalDelta * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    d->diskIOSample.addSample(DISKIOSampleFrame(d->uptime, io));
 
-    auto pair = d->diskIOSample->recentSamplePair();
+    auto pair = d->diskIOSample.recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    d->diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
+
+    d->valid = d->valid && ok;
+}
+
+void Process::mergeProcessVariableInfo(const ProcessSampleContext &ctx)
+{
+    // name lookup goes through the window list & desktop entry cache
+    d->proc_name.refreashProcessName(this);
+    // window icons arrive with a later window list update, pick them up once received
+    d->proc_icon.refreashPendingIcon(this);
 
     qulonglong sum_recv = 0;
     qulonglong sum_send = 0;
 
+    // stats are consumed once read, first process asking for a shared inode wins
     for (int i = 0; i < d->sockInodes.size(); ++i) {
-        SockIOStat sockIOStat;
-        bool result = NetifMonitor::instance()->getSockIOStatByInode(d->sockInodes[i], sockIOStat);
+        struct sock_io_stat_t sockIOStat;
+        bool result = ctx.netifMonitor->getSockIOStatByInode(d->sockInodes[i], sockIOStat);
         if (result) {
-            sum_recv += sockIOStat->rx_bytes;
-            sum_send += sockIOStat->tx_bytes;
+            sum_recv += sockIOStat.rx_bytes;
+            sum_send += sockIOStat.tx_bytes;
         }
     }
-    d->networkIOSample->addSample(new IOSampleFrame(d->uptime, {sum_recv, sum_send}));
+    d->networkIOSample.addSample(IOSampleFrame(d->uptime, {sum_recv, sum_send}));
 
-    auto netpair = d->networkIOSample->recentSamplePair();
+    auto netpair = d->networkIOSample.recentSamplePair();
     struct IOPS netiops = IOSampleFrame::iops(netpair.first, netpair.second);
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netiops));
-
-    d->valid = d->valid && ok;
+    d->networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
 }
 
 void Process::readProcessSimpleInfo()
@@ -234,18 +252,18 @@ void Process::readProcessInfo()
     if (validrecentPtr) {
         timedelta = timedelta - validrecentPtr->ptime;
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
+        d->diskIOSample.addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
 
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        d->networkIOSample.addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
     }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+    d->cpuUsageSample.addSample(CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    d->diskIOSample.addSample(DISKIOSampleFrame(d->uptime, io));
 
-    auto pair = d->diskIOSample->recentSamplePair();
+    auto pair = d->diskIOSample.recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    d->diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
 
     d->apptype = kNoFilter;
     const QVariant &euid = ProcessDB::instance()->processEuid();
@@ -263,18 +281,18 @@ void Process::readProcessInfo()
     qulonglong sum_send = 0;
 
     for (int i = 0; i < d->sockInodes.size(); ++i) {
-        SockIOStat sockIOStat;
+        struct sock_io_stat_t sockIOStat;
         bool result = NetifMonitor::instance()->getSockIOStatByInode(d->sockInodes[i], sockIOStat);
         if (result) {
-            sum_recv += sockIOStat->rx_bytes;
-            sum_send += sockIOStat->tx_bytes;
+            sum_recv += sockIOStat.rx_bytes;
+            sum_send += sockIOStat.tx_bytes;
         }
     }
-    d->networkIOSample->addSample(new IOSampleFrame(d->uptime, {sum_recv, sum_send}));
+    d->networkIOSample.addSample(IOSampleFrame(d->uptime, {sum_recv, sum_send}));
 
-    auto netpair = d->networkIOSample->recentSamplePair();
+    auto netpair = d->networkIOSample.recentSamplePair();
     struct IOPS netiops = IOSampleFrame::iops(netpair.first, netpair.second);
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netiops));
+    d->networkBandwidthSample.addSample(IOPSSampleFrame(netiops));
 
     d->valid = d->valid && ok;
 }
@@ -282,128 +300,108 @@ void Process::readProcessInfo()
 // read /proc/[pid]/stat
 bool Process::readStat()
 {
-    bool ok {true};
-    char path[256];
-    QByteArray buf;
-    int fd, rc;
-    ssize_t sz;
-    char *pos, *begin;
-
-    buf.reserve(1025);
-
-    errno = 0;
-    sprintf(path, PROC_STAT_PATH, d->pid);
-    if(access(path, R_OK) != 0)    return !ok;     /* no such dirent (anymore) */
-        
-    // open /proc/[pid]/stat
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
-    }
-
-    // read data
-    sz = read(fd, buf.data(), 1024);
-    close(fd);
-    if (sz < 0) {
-        print_errno(errno, QString("read %1 failed").arg(path));
-        return !ok;
-    }
-    buf.data()[sz] = '\0';
+    size_t len = 0;
+    const char *buf = readProcFile("stat", &len);
+    if (!buf)
+        return false;
+    const char *end = buf + len;
 
     // get process name between (...)
-    begin = strchr(buf.data(), '(');
+    const char *begin = strchr(buf, '(');
+    const char *pos = strrchr(buf, ')');
+    if (!begin || !pos || pos < begin) {
+        return false;
+    }
     begin += 1;
 
-    pos = strrchr(buf.data(), ')');
-    if (!pos) {
-        return !ok;
+    // process name (may be truncated by kernel if it's too long), only changes on exec
+    int nlen = int(pos - begin);
+    if (d->statName.size() != nlen || memcmp(d->statName.constData(), begin, size_t(nlen)) != 0) {
+        d->statName = QByteArray(begin, nlen);
+        d->name = d->statName;
     }
 
-    *pos = '\0';
-    // process name (may be truncated by kernel if it's too long)
-    d->name = QByteArray(begin);
-
-    pos += 2;
-
-    //****************3**4**5***********************************14***15**
-    rc = sscanf(pos, "%c %d %d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu"
-                //*16***17******19*20******22************************************
-                " %lld %lld %*d %d %u %*u %llu %*u %*u %*u %*u %*u %*u %*u %*u"
-                //********************************39*40*41******43***44**********
-                " %*u %*u %*u %*u %*u %*u %*u %*u %u %u %u %*u %llu %lld\n",
-                &d->state, // 3
-                &d->ppid, // 4
-                &d->pgid, // 5
-                &d->utime, // 14
-                &d->stime, // 15
-                &d->cutime, // 16
-                &d->cstime, // 17
-                &d->nice, // 19
-                &d->nthreads, // 20
-                &d->start_time, // 22
-                &d->processor, // 39
-                &d->rt_prio, // 40
-                &d->policy, // 41
-                &d->guest_time, // 43
-                &d->cguest_time); // 44
-    if (rc < 15) {
-        return !ok;
+    const char *p = scan::skipSpaces(pos + 1, end);
+    if (!p || p >= end) {
+        return false;
+    }
+    d->state = *p++; // 3
+    p = scan::parseSigned(p, end, &d->ppid); // 4
+    p = scan::parseSigned(p, end, &d->pgid); // 5
+    p = scan::skipFields(p, end, 8); // 6 ~ 13
+    p = scan::parseUnsigned(p, end, &d->utime); // 14
+    p = scan::parseUnsigned(p, end, &d->stime); // 15
+    p = scan::parseSigned(p, end, &d->cutime); // 16
+    p = scan::parseSigned(p, end, &d->cstime); // 17
+    p = scan::skipFields(p, end, 1); // 18
+    p = scan::parseSigned(p, end, &d->nice); // 19
+    p = scan::parseUnsigned(p, end, &d->nthreads); // 20
+    p = scan::skipFields(p, end, 1); // 21
+    p = scan::parseUnsigned(p, end, &d->start_time); // 22
+    p = scan::skipFields(p, end, 16); // 23 ~ 38
+    p = scan::parseUnsigned(p, end, &d->processor); // 39
+    p = scan::parseUnsigned(p, end, &d->rt_prio); // 40
+    p = scan::parseUnsigned(p, end, &d->policy); // 41
+    if (!p) {
+        return false;
     }
+
     // have guest & cguest time
-    if (rc < 17) {
+    p = scan::skipFields(p, end, 1); // 42
+    p = scan::parseUnsigned(p, end, &d->guest_time); // 43
+    p = scan::parseSigned(p, end, &d->cguest_time); // 44
+    if (!p) {
         d->guest_time = d->cguest_time = 0;
     }
 
-    return ok;
+    return true;
 }
 
-// read /proc/[pid]/cmdline
-bool Process::readCmdline()
+// true if buf holds the same null separated arguments as args
+static bool sameCmdline(const QByteArrayList &args, const char *buf, size_t len)
 {
-    bool ok = true;
-    char path[128] {};
-    const size_t bsiz = 4096;
-    QByteArray cmd;
-    cmd.reserve(bsiz);
-    size_t nb;
-    char *begin, *cur, *end;
-
-    sprintf(path, PROC_CMDLINE_PATH, d->pid);
-    if(access(path, R_OK) != 0)    return !ok;     /* no such dirent (anymore) */
-
-    errno = 0;
-    // open /proc/[pid]/cmdline
-    uFile fp(fopen(path, "r"));
-    if (!fp) {
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
+    const char *p = buf;
+    const char *end = buf + len;
+    for (const QByteArray &arg : args) {
+        if (p >= end)
+            return false;
+        size_t n = strnlen(p, size_t(end - p));
+        if (n != size_t(arg.size()) || memcmp(p, arg.constData(), n) != 0)
+            return false;
+        p += n + 1;
     }
+    return p >= end;
+}
 
-    nb = fread(cmd.data(), 1, bsiz - 1, fp.get());
-    if (ferror(fp.get())) {
-        print_errno(errno, QString("read %1 failed").arg(path));
-        return !ok;
-    }
+// read /proc/[pid]/cmdline
+bool Process::readCmdline()
+{
+    size_t nb = 0;
+    const char *buf = readProcFile("cmdline", &nb);
+    if (!buf)
+        return false;
 
-    cmd.data()[nb] = '\0';
+    // only changes on exec, keep the parsed arguments instead of allocating them again
+    if (sameCmdline(d->cmdline, buf, nb))
+        return true;
+    d->cmdline.clear();
 
-    begin = cur = cmd.data();
-    end = cmd.data() + nb;
+    const char *begin, *cur, *end;
+    begin = cur = buf;
+    end = buf + nb;
     while (cur < end) {
         // cmdline may sperarted by null character
         if (*cur == '\0') {
-            QByteArray buf(begin);
-            d->cmdline << buf;
+            d->cmdline << QByteArray(begin);
             begin = cur + 1;
         }
         ++cur;
     }
     if (begin < end) {
-        QByteArray buf(begin);
-        d->cmdline << buf;
+        d->cmdline << QByteArray(begin);
     }
 
-    return ok;
+    return true;
 }
 
 // read /proc/[pid]/environ
@@ -453,35 +451,14 @@ void Process::readEnviron()
 // read /proc/[pid]/schedstat
 void Process::readSchedStat()
 {
-    const size_t bsiz = 1024;
-    QByteArray buf;
-    char path[128];
-    int fd, rc;
-    ssize_t n;
-    unsigned long long wtime = 0;
-
-    buf.reserve(bsiz);
-    sprintf(path, PROC_SCHEDSTAT_PATH, d->pid);
-    if(access(path, R_OK) != 0)    return;     /* no such dirent (anymore) */
-
-    errno = 0;
-    // open /proc/[pid]/schedstat
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        print_errno(errno, QString("open %1 failed").arg(path));
+    size_t len = 0;
+    const char *buf = readProcFile("schedstat", &len);
+    if (!buf)
         return;
-    }
 
-    n = read(fd, buf.data(), bsiz - 1);
-    close(fd);
-
-    if (n < 0) {
-        print_errno(errno, QString("read %1 failed").arg(path));
-        return;
-    }
-
-    buf.data()[n] = '\0';
-    rc = sscanf(buf.data(), "%*u %llu %*d", &wtime);
-    if (rc == 1) {
+    unsigned long long wtime = 0;
+    const char *p = scan::skipFields(buf, buf + len, 1);
+    if (scan::parseUnsigned(p, buf + len, &wtime)) {
         d->wtime = wtime * HZ / 1000000000;
     }
 }
@@ -489,142 +466,96 @@ void Process::readSchedStat()
 // read /proc/[pid]/status
 bool Process::readStatus()
 {
-    bool ok {true};
-    const size_t bsiz = 256;
-    QByteArray buf;
-    char path[128];
+    size_t len = 0;
+    const char *buf = readProcFile("status", &len);
+    if (!buf)
+        return false;
+    const char *end = buf + len;
+    const char *p;
 
-    buf.reserve(bsiz);
-    sprintf(path, PROC_STATUS_PATH, d->pid);
-    if(access(path, R_OK) != 0)    return !ok;     /* no such dirent (anymore) */
-
-    errno = 0;
-    uFile fp(fopen(path, "r"));
-    // open /proc/[pid]/status
-    if (!fp) {
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
+    if ((p = scan::findKey(buf, end, "Umask:", 6))) {
+        scan::parseUnsigned(p, end, &d->mask);
     }
-
-    // scan each line
-    while (fgets(buf.data(), bsiz, fp.get())) {
-        if (!strncmp(buf.data(), "Umask:", 6)) {
-            sscanf(buf.data() + 7, "%u", &d->mask);
-        } else if (!strncmp(buf.data(), "State:", 6)) {
-            sscanf(buf.data() + 7, "%c %*s", &d->state);
-        } else if (!strncmp(buf.data(), "Uid:", 4)) {
-            sscanf(buf.data() + 5, "%u %u %u %u",
-                   &d->uid,
-                   &d->euid,
-                   &d->suid,
-                   &d->fuid);
-        } else if (!strncmp(buf.data(), "Gid:", 4)) {
-            sscanf(buf.data() + 5, "%u %u %u %u",
-                   &d->gid,
-                   &d->egid,
-                   &d->sgid,
-                   &d->fgid);
-        }
-    } // ::while(fgets)
-
-    if (ferror(fp.get())) {
-        print_errno(errno, QString("read %1 failed").arg(path));
-        return !ok;
+    if ((p = scan::findKey(buf, end, "State:", 6))) {
+        p = scan::skipSpaces(p, end);
+        if (p < end)
+            d->state = *p;
+    }
+    if ((p = scan::findKey(buf, end, "Uid:", 4))) {
+        p = scan::parseUnsigned(p, end, &d->uid);
+        p = scan::parseUnsigned(p, end, &d->euid);
+        p = scan::parseUnsigned(p, end, &d->suid);
+        scan::parseUnsigned(p, end, &d->fuid);
+    }
+    if ((p = scan::findKey(buf, end, "Gid:", 4))) {
+        p = scan::parseUnsigned(p, end, &d->gid);
+        p = scan::parseUnsigned(p, end, &d->egid);
+        p = scan::parseUnsigned(p, end, &d->sgid);
+        scan::parseUnsigned(p, end, &d->fgid);
     }
 
-    return ok;
+    return true;
 }
 
 // read /proc/[pid]/statm
 bool Process::readStatm()
 {
-    bool ok {true};
-    int fd;
-    const size_t bsiz = 1024;
-    char path[128] {}, buf[bsiz + 1] {};
-    ssize_t nr;
+    size_t len = 0;
+    const char *buf = readProcFile("statm", &len);
+    if (!buf)
+        return false;
+    const char *end = buf + len;
 
-    sprintf(path, PROC_STATM_PATH, d->pid);
-    if(access(path, R_OK) != 0)    return !ok;     /* no such dirent (anymore) */
-
-    errno = 0;
-    // open /proc/[pid]/statm
-    if ((fd = open(path, O_RDONLY)) < 0) {
-        print_errno(errno, QString("open %1 failed").arg(path));
-        return !ok;
-    }
-
-    nr = read(fd, buf, bsiz);
-    close(fd);
-    if (nr < 0) {
-        print_errno(errno, QString("read %1 failed").arg(path));
-        return !ok;
-    }
-
-    buf[nr] = '\0';
     // get resident set size & resident shared size in pages
-    nr = sscanf(buf, "%llu %llu %llu", &d->vmsize, &d->rss, &d->shm);
-    if (nr != 3) {
+    const char *p = scan::parseUnsigned(buf, end, &d->vmsize);
+    p = scan::parseUnsigned(p, end, &d->rss);
+    p = scan::parseUnsigned(p, end, &d->shm);
+    if (!p) {
         d->vmsize = 0;
         d->rss = 0;
         d->shm = 0;
-        print_errno(errno, QString("read %1 failed").arg(path));
+        print_errno(errno, QString("parse /proc/%1/statm failed").arg(d->pid));
     } else {
         // convert to kB
         d->vmsize <<= kb_shift;
         d->rss <<= kb_shift;
         d->shm <<= kb_shift;
     }
-    return ok;
+    return true;
 }
 
 // read /proc/[pid]/io
 void Process::readIO()
 {
-    const size_t bsiz = 128;
-    char path[128], buf[bsiz];
-
-    sprintf(path, PROC_IO_PATH, d->pid);
-    if(access(path, R_OK) != 0)    return;     /* no such dirent (anymore) */
-
-    errno = 0;
-    // open /proc/[pid]/io
-    uFile fp(fopen(path, "r"));
-    if (!fp) {
-        print_errno(errno, QString("open %1 failed").arg(path));
+    size_t len = 0;
+    const char *buf = readProcFile("io", &len);
+    if (!buf)
         return;
-    }
+    const char *end = buf + len;
+    const char *p;
 
-    // scan each line
-    while (fgets(buf, bsiz, fp.get())) {
-        if (!strncmp(buf, "read_bytes", 10)) {
-            sscanf(buf + 12, "%llu", &d->read_bytes);
-        } else if (!strncmp(buf, "write_bytes", 11)) {
-            sscanf(buf + 13, "%llu", &d->write_bytes);
-        } else if (!strncmp(buf, "cancelled_write_bytes", 21)) {
-            sscanf(buf + 23, "%llu", &d->cancelled_write_bytes);
-        }
-    } // ::while(fgets)
-    if (ferror(fp.get())) {
-        print_errno(errno, QString("read %1 failed").arg(path));
-    }
+    if ((p = scan::findKey(buf, end, "read_bytes:", 11)))
+        scan::parseUnsigned(p, end, &d->read_bytes);
+    if ((p = scan::findKey(buf, end, "write_bytes:", 12)))
+        scan::parseUnsigned(p, end, &d->write_bytes);
+    if ((p = scan::findKey(buf, end, "cancelled_write_bytes:", 22)))
+        scan::parseUnsigned(p, end, &d->cancelled_write_bytes);
 }
 
 // read /proc/[pid]/fd
 void Process::readSockInodes()
 {
     struct dirent *dp;
-    char path[128], fdp[256 + 32];
     struct stat sbuf;
 
-    sprintf(path, PROC_FD_PATH, d->pid);
-    if(access(path, R_OK) != 0)    return;     /* no such dirent (anymore) */
-
     errno = 0;
-    // open /proc/[pid]/fd dir
-    uDir dir(opendir(path));
+    // open /proc/[pid]/fd dir relative to the cached /proc/[pid] dir
+    int fd = d->reader.openDir(d->pid, "fd");
+    if (fd < 0)
+        return;
+    uDir dir(fdopendir(fd));
     if (!dir) {
-        print_errno(errno, QString("open %1 failed").arg(path));
+        close(fd);
         return;
     }
 
@@ -632,10 +563,9 @@ void Process::readSockInodes()
     while ((dp = readdir(dir.get()))) {
         // only if entry name starts with a digit
         if (isdigit(dp->d_name[0])) {
-            // open /proc/[pid]/fd/[fd]
-            sprintf(fdp, PROC_FD_NAME_PATH, d->pid, dp->d_name);
+            // stat /proc/[pid]/fd/[fd]
             memset(&sbuf, 0, sizeof(struct stat));
-            if (!stat(fdp, &sbuf)) {
+            if (!fstatat(dirfd(dir.get()), dp->d_name, &sbuf, 0)) {
                 // get inode if it's a socket descriptor
                 if (S_ISSOCK(sbuf.st_mode)) {
                     // not append repeat data, may memory leak.
@@ -646,9 +576,17 @@ void Process::readSockInodes()
             } // ::if(stat)
         } // ::if(isdigit)
     } // ::while(readdir)
-    // if (errno) {
-    //     print_errno(errno, QString("read %1 failed").arg(path));
-    // }
+}
+
+const char *Process::readProcFile(const char *name, size_t *len)
+{
+    errno = 0;
+    const char *buf = d->reader.read(d->pid, name, len);
+    // no such dirent (anymore) is expected for exited processes, keep silent
+    if (!buf && errno != ENOENT && errno != ESRCH) {
+        print_errno(errno, QString("read /proc/%1/%2 failed").arg(d->pid).arg(name));
+    }
+    return buf;
 }
 
 bool Process::isValid() const
@@ -698,7 +636,7 @@ QIcon Process::icon() const
 
 qreal Process::cpu() const
 {
-    auto *sample = d->cpuUsageSample->recentSample();
+    auto *sample = d->cpuUsageSample.recentSample();
     if (sample)
         return sample->data;
     else
@@ -707,7 +645,7 @@ qreal Process::cpu() const
 
 void Process::setCpu(qreal cpu)
 {
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(cpu));
+    d->cpuUsageSample.addSample(CPUUsageSampleFrame(cpu));
 }
 
 qulonglong Process::memory() const
@@ -782,7 +720,7 @@ QString Process::groupName() const
 
 qreal Process::readBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -791,7 +729,7 @@ qreal Process::readBps() const
 
 qreal Process::writeBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -815,7 +753,7 @@ qulonglong Process::cancelledWriteBytes() const
 
 qreal Process::recvBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -824,7 +762,7 @@ qreal Process::recvBps() const
 
 qreal Process::sentBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -834,12 +772,12 @@ qreal Process::sentBps() const
 void Process::setNetIoBps(qreal recvBps, qreal sendBps)
 {
     struct IOPS netIo = {recvBps, sendBps};
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netIo));
+    d->networkBandwidthSample.addSample(IOPSSampleFrame(netIo));
 }
 
 qulonglong Process::recvBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->networkIOSample.recentSample();
     if (sample)
         return sample->data.inBytes;
     else
@@ -848,7 +786,7 @@ qulonglong Process::recvBytes() const
 
 qulonglong Process::sentBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->networkIOSample.recentSample();
     if (sample)
         return sample->data.outBytes;
     else
@@ -19,8 +19,25 @@
 using namespace core::system;
 
 namespace core {
+namespace system {
+class NetifMonitor;
+} // namespace system
 namespace process {
 
+class ProcessSet;
+
+/**
+ * @brief Per-tick state shared by all processes, resolved once per scan instead of per process
+ */
+struct ProcessSampleContext {
+    struct timeval uptime; // system uptime of this scan
+    qulonglong cpuUsageTotalDelta; // total cpu jiffies elapsed since last scan
+    const ProcessSet *procset; // process set holding the previous scan stage
+    NetifMonitor *netifMonitor; // socket io stat source
+
+    static ProcessSampleContext current();
+};
+
 enum ProcessPriority {
     kInvalidPriority = INT_MAX,
     kVeryHighPriority = -20, // default veryhigh priority
@@ -117,6 +134,17 @@ public:
     void readProcessInfo();
     void readProcessSimpleInfo();
     void readProcessVariableInfo();
+    void readProcessVariableInfo(const ProcessSampleContext &ctx);
+    /**
+     * @brief Reentrant half of readProcessVariableInfo: reads /proc/[pid]/* and updates
+     * cpu & disk samples, only touches this process, safe to run on a worker thread
+     */
+    void readProcessVariableFiles(const ProcessSampleContext &ctx);
+    /**
+     * @brief Serial half of readProcessVariableInfo: refreshes the display name & pending
+     * window icon and consumes socket io stats, must run on the scanning thread in pid order
+     */
+    void mergeProcessVariableInfo(const ProcessSampleContext &ctx);
 
 private:
     /**
@@ -157,8 +185,16 @@ private:
      * @return true: success; false: failure
      */
     void readSockInodes();
+    /**
+     * @brief Read /proc/[pid]/[name] into the per-thread buffer of the process reader
+     * @return Buffer with file content, nullptr on failure
+     */
+    const char *readProcFile(const char *name, size_t *len);
 
 private:
+    // snapshots copy the icon handle, not the QIcon built from it
+    friend class ProcessSnapshot;
+
 //    QSharedDataPointer<ProcessPrivate> d;
     QExplicitlySharedDataPointer<ProcessPrivate> d;
 };
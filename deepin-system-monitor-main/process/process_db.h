@@ -86,7 +86,6 @@ private:
     DesktopEntryCache *m_desktopEntryCache;
 
     ProcessSet *m_procSet;
-    int m_desktopEntryTimeCount;
 
     uid_t m_euid;
 };
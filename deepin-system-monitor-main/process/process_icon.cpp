@@ -35,6 +35,7 @@ struct icon_data_t {
     char __pad__[4];
     QString proc_name;
     bool desktopentry = false;
+    bool pending = false;   // window icon requested but not received yet, looked up again next refresh
 
     virtual ~icon_data_t() {}
 };
@@ -44,8 +45,12 @@ struct icon_data_name_type : public icon_data_t {
 };
 struct icon_data_pix_map_type : public icon_data_t {
     QImage image;
+    quint64 image_key = 0;   // hash of the icon pixels
 };
 
+// bytes assumed for a theme icon, its pixmaps are rendered & cached by the icon engine
+const int kThemeIconCost = 64 * 64 * 4;
+
 ProcessIcon::ProcessIcon()
 {
 }
@@ -59,31 +64,44 @@ void ProcessIcon::refreashProcessIcon(Process *proc)
 {
     if (proc) {
         ProcessIconCache *cache = ProcessIconCache::instance();
-        if (cache->contains(proc->pid())) {
-            auto *procIcon = cache->getProcessIcon(proc->pid());
-            if (proc->name().compare(procIcon->m_data->proc_name, Qt::CaseInsensitive) == 0) {
-                m_data = procIcon->m_data;
-            } else {
-                m_data = getIcon(proc);
-                procIcon->m_data = m_data;
-            }
-
+        auto data = cache->getProcessIcon(proc->pid());
+        // new process, pid reused by another program or window icon still on its way
+        if (!data || data->pending || proc->name().compare(data->proc_name, Qt::CaseInsensitive) != 0) {
+            m_windowIconPending = false;
+            m_data = getIcon(proc);
+            m_data->pending = m_windowIconPending;
+            cache->addProcessIcon(proc->pid(), m_data);
+        } else {
+            m_data = data;
             if (m_data->desktopentry)
                 ProcessDB::instance()->windowList()->addDesktopEntryApp(proc);
-        } else {
-            auto *procIcon = new ProcessIcon();
-            m_data = getIcon(proc);
-            procIcon->m_data = m_data;
-            cache->addProcessIcon(proc->pid(), procIcon);
         }
     }
 }
 
+void ProcessIcon::refreashPendingIcon(Process *proc)
+{
+    if (m_data && m_data->pending)
+        refreashProcessIcon(proc);
+}
+
 QIcon ProcessIcon::icon() const
 {
     QIcon icon;
 
     if (m_data) {
+        QString key;
+        if (m_data->type == kIconDataNameType)
+            key = QString("name:%1").arg(static_cast<struct icon_data_name_type *>(m_data.get())->icon_name);
+        else
+            key = QString("window:%1").arg(static_cast<struct icon_data_pix_map_type *>(m_data.get())->image_key, 0, 16);
+
+        // one icon per key, shared by all processes showing it
+        ProcessIconCache *cache = ProcessIconCache::instance();
+        if (cache->findIcon(key, &icon))
+            return icon;
+
+        int cost = kThemeIconCost;
         if (m_data->type == kIconDataNameType) {
             auto *iconData = reinterpret_cast<struct icon_data_name_type *>(m_data.get());
             if (iconData)
@@ -92,8 +110,14 @@ QIcon ProcessIcon::icon() const
             auto *iconData = reinterpret_cast<struct icon_data_pix_map_type *>(m_data.get());
             if (iconData) {
                 icon.addPixmap(QPixmap::fromImage(iconData->image));
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+                cost = iconData->image.byteCount();
+#else
+                cost = int(iconData->image.sizeInBytes());
+#endif
             } // ::if(iconData)
         }
+        cache->insertIcon(key, icon, cost);
     } // ::if(m_data)
 
     return icon;
@@ -102,7 +126,7 @@ QIcon ProcessIcon::icon() const
 struct icon_data_t *ProcessIcon::defaultIconData(const QString &procname) const {
     auto *iconData = new struct icon_data_name_type();
     iconData->type = kIconDataNameType;
-    iconData->proc_name = "[::default::]";
+    iconData->proc_name = procname;
     iconData->icon_name = "application-x-executable";
     return iconData;
 }
@@ -110,7 +134,7 @@ struct icon_data_t *ProcessIcon::defaultIconData(const QString &procname) const
 struct icon_data_t *ProcessIcon::terminalIconData(const QString &procname) const {
     auto *iconData = new struct icon_data_name_type();
     iconData->type = kIconDataNameType;
-    iconData->proc_name = "[::terminal::]";
+    iconData->proc_name = procname;
     iconData->icon_name = "terminal";
     return iconData;
 }
@@ -151,10 +175,12 @@ std::shared_ptr<icon_data_t> ProcessIcon::getIcon(Process *proc)
         }
 
         if (windowList->isGuiApp(proc->pid())) {
-            const QImage &image = windowList->getWindowIcon(proc->pid());
+            quint64 imageKey = 0;
+            const QImage &image = windowList->getWindowIcon(proc->pid(), &imageKey, &m_windowIconPending);
             if (!image.isNull()) {
                 auto *iconData = new struct icon_data_pix_map_type();
                 iconData->image = image;
+                iconData->image_key = imageKey;
                 iconData->proc_name = proc->name();
                 iconData->type = kIconDataPixmapType;
                 iconDataPtr.reset(iconData);
@@ -24,6 +24,10 @@ public:
 
     QIcon icon() const;
     void refreashProcessIcon(Process *proc);
+    /**
+     * @brief Look the icon up again if the window icon was still being fetched last time
+     */
+    void refreashPendingIcon(Process *proc);
 
 private:
     std::shared_ptr<struct icon_data_t> getIcon(Process *proc);
@@ -33,6 +37,8 @@ private:
 
 private:
     std::shared_ptr<struct icon_data_t> m_data;
+    // set by getIcon while the window icon of a gui app is being fetched
+    bool m_windowIconPending {false};
 };
 
 } // namespace process
@@ -24,6 +24,8 @@ ProcessIconCache::ProcessIconCache(QObject *parent)
         theme = DGuiApplicationHelper::instance()->applicationTheme();
         connect(theme, &DPlatformTheme::iconThemeNameChanged, this, [ = ]() {
             iconPixmapCache.clear();
+            // theme icons are looked up again under the new theme
+            m_icons.clear();
         });
     }
 }
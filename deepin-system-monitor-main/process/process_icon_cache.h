@@ -7,6 +7,7 @@
 #define PROCESS_ICON_CACHE_H
 
 #include <QCache>
+#include <QHash>
 #include <QThread>
 #include <QPixmapCache>
 
@@ -14,6 +15,14 @@
 
 namespace core {
 namespace process {
+
+/**
+ * @brief Process icons in two levels
+ *
+ * Per process icon data (what to show) is kept by pid until the process exits, the icons themselves are
+ * kept by icon key (theme icon name or window icon hash), so processes showing the same icon share one
+ * QIcon. Icons are budgeted by bytes instead of entries.
+ */
 class ProcessIconCache : public QObject
 {
     Q_OBJECT
@@ -22,11 +31,25 @@ class ProcessIconCache : public QObject
 public:
     static ProcessIconCache *instance();
 
-    ProcessIcon *getProcessIcon(pid_t pid) const;
-    void addProcessIcon(pid_t pid, ProcessIcon *procIcon);
+    std::shared_ptr<struct icon_data_t> getProcessIcon(pid_t pid) const;
+    void addProcessIcon(pid_t pid, const std::shared_ptr<struct icon_data_t> &data);
     void removeProcessIcon(pid_t pid);
     bool contains(pid_t pid) const;
     void clear();
+
+    /**
+     * @brief Shared icon of key, GUI thread only
+     * @return Return false if the icon is not cached (yet)
+     */
+    bool findIcon(const QString &key, QIcon *icon) const;
+    /**
+     * @brief Cache the icon of key, GUI thread only
+     * @param cost Bytes held by the icon
+     */
+    void insertIcon(const QString &key, const QIcon &icon, int cost);
+    /**
+     * @brief Set byte budget of shared icons
+     */
     void setMaxCost(int cost);
 
 public:
@@ -36,7 +59,10 @@ private:
     explicit ProcessIconCache(QObject *parent = nullptr);
 
 private:
-    QCache<pid_t, ProcessIcon> m_cache {200};
+    // pid => icon data of the process, dropped when the process exits
+    QHash<pid_t, std::shared_ptr<struct icon_data_t>> m_procIcons;
+    // icon key => icon shared by all processes showing it, cost in bytes (4MB)
+    QCache<QString, QIcon> m_icons {4 * 1024 * 1024};
 
     static ProcessIconCache *m_instance;
 };
@@ -49,37 +75,50 @@ inline ProcessIconCache *ProcessIconCache::instance()
     return m_instance;
 }
 
-inline ProcessIcon *ProcessIconCache::getProcessIcon(pid_t pid) const
+inline std::shared_ptr<struct icon_data_t> ProcessIconCache::getProcessIcon(pid_t pid) const
 {
-    if (m_cache.contains(pid))
-        return m_cache[pid];
-
-    return nullptr;
+    return m_procIcons.value(pid);
 }
 
-inline void ProcessIconCache::addProcessIcon(pid_t pid, ProcessIcon *procIcon)
+inline void ProcessIconCache::addProcessIcon(pid_t pid, const std::shared_ptr<struct icon_data_t> &data)
 {
-    m_cache.insert(pid, procIcon);
+    m_procIcons.insert(pid, data);
 }
 
 inline void ProcessIconCache::removeProcessIcon(pid_t pid)
 {
-    m_cache.remove(pid);
+    m_procIcons.remove(pid);
 }
 
 inline bool ProcessIconCache::contains(pid_t pid) const
 {
-    return m_cache.contains(pid);
+    return m_procIcons.contains(pid);
 }
 
 inline void ProcessIconCache::clear()
 {
-    m_cache.clear();
+    m_procIcons.clear();
+    m_icons.clear();
+}
+
+inline bool ProcessIconCache::findIcon(const QString &key, QIcon *icon) const
+{
+    auto *cached = m_icons.object(key);
+    if (!cached)
+        return false;
+
+    *icon = *cached;
+    return true;
+}
+
+inline void ProcessIconCache::insertIcon(const QString &key, const QIcon &icon, int cost)
+{
+    m_icons.insert(key, new QIcon(icon), cost);
 }
 
 inline void ProcessIconCache::setMaxCost(int cost)
 {
-    m_cache.setMaxCost(cost);
+    m_icons.setMaxCost(cost);
 }
 
 } // namespace process
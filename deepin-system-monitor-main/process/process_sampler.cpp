@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_sampler.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+
+#include <atomic>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace core {
+namespace process {
+
+// processes claimed per cursor bump, small enough to balance, large enough to not contend
+static const int kChunkSize = 16;
+// below this many processes the pool hand-off costs more than it saves
+static const int kMinParallelCount = 2 * kChunkSize;
+// idle workers survive a few scan ticks (10 seconds), then exit until scanning resumes
+static const int kWorkerExpiryTimeout = 10000;
+
+namespace {
+
+class ChunkJob : public QRunnable
+{
+public:
+    ChunkJob(const std::function<void()> &fn, QSemaphore *done)
+        : m_fn(fn)
+        , m_done(done)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        m_fn();
+        m_done->release();
+    }
+
+private:
+    std::function<void()> m_fn;
+    QSemaphore *m_done;
+};
+
+} // namespace
+
+ProcessSampler::ProcessSampler(int threads)
+    : m_threads(qMax(1, threads))
+    , m_parallel(true)
+{
+    // DSM_SERIAL_SAMPLING=1 falls back to the single threaded scan
+    const char *serial = getenv("DSM_SERIAL_SAMPLING");
+    if (serial && strcmp(serial, "0") != 0)
+        m_parallel = false;
+
+    // the scanning thread takes part as well
+    m_pool.setMaxThreadCount(qMax(1, m_threads - 1));
+    // keep workers alive between ticks
+    m_pool.setExpiryTimeout(kWorkerExpiryTimeout);
+}
+
+ProcessSampler::~ProcessSampler()
+{
+    m_pool.waitForDone();
+}
+
+void ProcessSampler::forEach(int count, const std::function<void(int)> &fn)
+{
+    if (!m_parallel || m_threads < 2 || count < kMinParallelCount) {
+        for (int i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<int> cursor {0};
+    auto drain = [&cursor, count, &fn]() {
+        for (;;) {
+            int begin = cursor.fetch_add(kChunkSize, std::memory_order_relaxed);
+            if (begin >= count)
+                break;
+            int end = qMin(begin + kChunkSize, count);
+            for (int i = begin; i < end; ++i)
+                fn(i);
+        }
+    };
+
+    int chunks = (count + kChunkSize - 1) / kChunkSize;
+    int helpers = qMin(m_pool.maxThreadCount(), chunks - 1);
+    // QThreadPool::waitForDone would tear the idle workers down, count finished jobs instead
+    QSemaphore done;
+    for (int i = 0; i < helpers; ++i)
+        m_pool.start(new ChunkJob(drain, &done));
+    drain();
+    done.acquire(helpers);
+}
+
+void ProcessSampler::sample(QVector<Process> &procs, const ProcessSampleContext &ctx)
+{
+    // detach once here, workers must not trigger copy on write of the vector
+    Process *data = procs.data();
+    forEach(procs.size(), [data, &ctx](int i) {
+        data[i].readProcessVariableFiles(ctx);
+    });
+
+    for (Process &proc : procs)
+        proc.mergeProcessVariableInfo(ctx);
+}
+
+} // namespace process
+} // namespace core
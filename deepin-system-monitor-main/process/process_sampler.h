@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_SAMPLER_H
+#define PROCESS_SAMPLER_H
+
+#include "process.h"
+
+#include <QThreadPool>
+#include <QVector>
+
+#include <functional>
+
+namespace core {
+namespace process {
+
+/**
+ * @brief Spreads per-process sampling of a scan across a worker pool
+ *
+ * Workers (and the scanning thread itself) claim small chunks of the process list from a
+ * shared cursor until it is drained, so slow processes (many fds, busy io) never leave the
+ * other threads idle. Only the reentrant part of sampling runs in parallel, the part that
+ * touches shared caches is applied afterwards in list order, which keeps the result
+ * identical to a serial scan.
+ */
+class ProcessSampler
+{
+public:
+    /**
+     * @param threads Total threads taking part in a scan, including the caller
+     */
+    explicit ProcessSampler(int threads = QThread::idealThreadCount());
+    ~ProcessSampler();
+
+    ProcessSampler(const ProcessSampler &) = delete;
+    ProcessSampler &operator=(const ProcessSampler &) = delete;
+
+    /**
+     * @brief Sample every process of the list, returns when all of them are done
+     */
+    void sample(QVector<Process> &procs, const ProcessSampleContext &ctx);
+
+    /**
+     * @brief Run fn(0) ... fn(count - 1) across the pool, each index exactly once
+     */
+    void forEach(int count, const std::function<void(int)> &fn);
+
+    inline bool isParallel() const
+    {
+        return m_parallel;
+    }
+    /**
+     * @brief Switch to serial sampling on the calling thread (e.g. for debugging)
+     */
+    inline void setParallel(bool parallel)
+    {
+        m_parallel = parallel;
+    }
+    inline int threadCount() const
+    {
+        return m_threads;
+    }
+
+private:
+    int m_threads;
+    bool m_parallel;
+    QThreadPool m_pool;
+};
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_SAMPLER_H
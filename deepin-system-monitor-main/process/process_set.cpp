@@ -5,7 +5,9 @@
 
 #include "process_set.h"
 #include "process/process_db.h"
+#include "process/process_icon_cache.h"
 #include "common/common.h"
+#include "system/sys_info.h"
 #include "wm/wm_window_list.h"
 // #include "settings.h"
 
@@ -16,6 +18,7 @@
 #define PROC_PATH "/proc"
 
 using namespace common::error;
+using namespace core::system;
 
 namespace core {
 namespace process {
@@ -25,6 +28,7 @@ ProcessSet::ProcessSet()
     , m_recentProcStage {}
     , m_pidCtoPMapping {}
     , m_pidPtoCMapping {}
+    , m_snapshot(std::make_shared<const ProcessSnapshot>())
 {
 }
 
@@ -33,6 +37,7 @@ ProcessSet::ProcessSet(const ProcessSet &other)
     , m_recentProcStage(other.m_recentProcStage)
     , m_pidCtoPMapping(other.m_pidCtoPMapping)
     , m_pidPtoCMapping(other.m_pidPtoCMapping)
+    , m_snapshot(other.snapshot())
 {
     m_prePid.clear();
     m_curPid.clear();
@@ -71,6 +76,11 @@ void ProcessSet::refresh()
     scanProcess();
 }
 
+ProcessSampler *ProcessSet::sampler()
+{
+    return &m_sampler;
+}
+
 void ProcessSet::scanProcess()
 {
     for (auto iter = m_set.begin(); iter != m_set.end(); iter++) {
@@ -83,66 +93,68 @@ void ProcessSet::scanProcess()
         m_recentProcStage[iter->pid()] = procstage;
     }
     m_curPid.clear();
+    m_curPid.reserve(m_prePid.size());
     m_set.clear();
     m_pidPtoCMapping.clear();
     m_pidCtoPMapping.clear();
     WMWindowList *wmwindowList = ProcessDB::instance()->windowList();
 
+    // one linear pass over /proc, born & died pids fall out of the generation stamps
+    QList<pid_t> bornPids;
+    QList<pid_t> diedPids;
+    m_pidIndex.beginScan();
     Iterator iter;
-    QList<pid_t> appLst;
     while (iter.hasNext()) {
-        Process proc = iter.next();
-
-        if(!m_curPid.contains(proc.pid()))
-            m_curPid.append(proc.pid());
-
+        pid_t pid = iter.nextPid();
+        m_curPid.append(pid);
+        if (m_pidIndex.mark(pid))
+            bornPids.append(pid);
+    }
+    m_pidIndex.endScan(&diedPids);
+    // every live process, sampled or not
+    quint32 nprocs = iter.count();
+
+    // icon data is kept per pid until the process exits
+    auto *iconCache = ProcessIconCache::instance();
+    for (const pid_t &pid : diedPids) {
+        m_simpleSet.remove(pid);
+        m_pidMyApps.remove(pid);
+        iconCache->removeProcessIcon(pid);
     }
 
-    if(m_prePid != m_curPid) {
-        for (auto it = m_prePid.begin(); it != m_prePid.end();) {
-            if (!m_curPid.contains(*it)) {
-                if (m_simpleSet.contains(*it))
-                    m_simpleSet.remove(*it);
-                if (m_pidMyApps.contains(*it))
-                    m_pidMyApps.removeOne(*it);
-                it = m_prePid.erase(it);
-            } else {
-                ++it;
-            }
-        }
-
-        for (const pid_t &pid : m_curPid) {
-            if(!m_prePid.contains(pid)){ //add  new process pid
-                Process proc(pid);
-                proc.readProcessSimpleInfo();
-                if(!m_simpleSet.contains(pid))
-                     m_simpleSet.insert(proc.pid(), proc);
+    for (const pid_t &pid : bornPids) {
+        //add  new process pid
+        Process proc(pid);
+        proc.readProcessSimpleInfo();
+        if (!m_simpleSet.contains(pid))
+            m_simpleSet.insert(proc.pid(), proc);
 
-                if (proc.appType() == kFilterApps && !wmwindowList->isTrayApp(proc.pid())) {
-                     m_pidMyApps << proc.pid();
-                }
-            }
+        if (proc.appType() == kFilterApps && !wmwindowList->isTrayApp(proc.pid())) {
+            m_pidMyApps << proc.pid();
         }
-        m_prePid = m_curPid;
     }
+    m_prePid.swap(m_curPid);
 
     // const QVariant &vindex = m_settings->getOption(kSettingKeyProcessTabIndex, kFilterApps);
     // int index = vindex.toInt();
 
+    // resolve the per-tick singletons once instead of once per process
+    const ProcessSampleContext &sampleCtx = ProcessSampleContext::current();
+    QVector<Process> procs;
+    procs.reserve(m_prePid.size());
     for (const pid_t &pid : m_prePid) {
-        Process proc = m_simpleSet[pid];
-        // if( ((kFilterApps == index) && (proc.appType()<= kFilterApps)) ||
-        //     ((kFilterCurrentUser == index) && (proc.appType() <= kFilterCurrentUser)) ||
-        //         (kNoFilter == index))
-                {
-             proc.readProcessVariableInfo();  //
-               if (!proc.isValid())
-                     continue;
-
-               m_set.insert(proc.pid(), proc);
-               m_pidPtoCMapping.insert(proc.ppid(), proc.pid());
-               m_pidCtoPMapping.insert(proc.pid(), proc.ppid());
-        }
+        procs.append(m_simpleSet[pid]);
+    }
+    m_sampler.sample(procs, sampleCtx);
+
+    // merge in scan order, the result does not depend on which worker sampled what
+    for (const Process &proc : procs) {
+        if (!proc.isValid())
+            continue;
+
+        m_set.insert(proc.pid(), proc);
+        m_pidPtoCMapping.insert(proc.ppid(), proc.pid());
+        m_pidCtoPMapping.insert(proc.pid(), proc.ppid());
     }
 
     std::function<bool(pid_t ppid)> anyRootIsGuiProc;
@@ -186,15 +198,27 @@ void ProcessSet::scanProcess()
         }
     }
 
+    // falls out of the listing, SysInfo doesn't walk /proc for it
+    SysInfo::instance()->set_nprocesses(nprocs);
+
+    // readers holding the previous snapshot keep it alive until they let go
+    auto snapshot = std::make_shared<const ProcessSnapshot>(++m_snapshotVersion, m_set.values());
+    std::atomic_store(&m_snapshot, snapshot);
+
     m_recentProcStage.clear();
 }
 
 ProcessSet::Iterator::Iterator()
+    : Iterator(PROC_PATH)
+{
+}
+
+ProcessSet::Iterator::Iterator(const char *procPath)
 {
     errno = 0;
-    auto *dp = opendir(PROC_PATH);
+    auto *dp = opendir(procPath);
     if (!dp) {
-        print_errno(errno, "open /proc failed");
+        print_errno(errno, QString("open %1 failed").arg(procPath));
         return;
     }
     m_dir.reset(dp);
@@ -221,14 +245,26 @@ Process ProcessSet::Iterator::next()
     return Process();
 }
 
+pid_t ProcessSet::Iterator::nextPid()
+{
+    if (m_dirent && isdigit(m_dirent->d_name[0])) {
+        auto pid = pid_t(atoi(m_dirent->d_name));
+        advance();
+        return pid;
+    }
+
+    return 0;
+}
+
 void ProcessSet::Iterator::advance()
 {
     while ((m_dirent = readdir(m_dir.get()))) {
-        if (isdigit(m_dirent->d_name[0]))
-        if(pid_t(atoi(m_dirent->d_name)) < 10)
+        if (isdigit(m_dirent->d_name[0])) {
+            ++m_count;
+            if (pid_t(atoi(m_dirent->d_name)) < 10)
                 continue;
-        else 
             break;
+        }
     }
     if (!m_dirent && errno) {
         print_errno(errno, "read /proc failed");
@@ -247,19 +283,12 @@ const Process ProcessSet::getProcessById(pid_t pid) const
 
 QList<pid_t> ProcessSet::getPIDList() const
 {
-    // 当系统读取到的m_set为空时,通过keys()函数返回会造成段错误 原因是keys函数效率低下,会造成大量的内存拷贝
-    // 替换方案是
-    QList<pid_t> pidList {};
-    pidList.clear();
-    int size = m_set.size();
-    QMap<pid_t, Process>::key_iterator iterBegin = m_set.keyBegin();
-    for (;iterBegin != m_set.keyEnd(); ++iterBegin) {
-        pid_t tmpKey = *iterBegin;
-        pidList.append(tmpKey);
-        if (size != m_set.size())
-            break;
-    }
-    return pidList;
+    return m_set.keys();
+}
+
+ProcessSnapshotPtr ProcessSet::snapshot() const
+{
+    return std::atomic_load(&m_snapshot);
 }
 
 void ProcessSet::removeProcess(pid_t pid)
@@ -7,9 +7,13 @@
 #define PROCESS_SET_H
 
 #include "process.h"
+#include "pid_index.h"
+#include "process_sampler.h"
+#include "process_snapshot.h"
 #include "common/common.h"
 
 #include <QMap>
+#include <QSet>
 
 #include <dirent.h>
 
@@ -39,6 +43,14 @@ public:
     ProcessSet(const ProcessSet &other);
     ~ProcessSet() = default;
 
+    /**
+     * @brief Process list of the last scan, safe to call from any thread
+     *
+     * The returned snapshot never changes, the next scan publishes a new one.
+     */
+    ProcessSnapshotPtr snapshot() const;
+
+    // Live process entries, updated in place by each scan: scanning thread only, others use snapshot()
     const Process getProcessById(pid_t pid) const;
     QList<pid_t> getPIDList() const;
     void removeProcess(pid_t pid);
@@ -48,6 +60,11 @@ public:
 
     void refresh();
 
+    /**
+     * @brief Sampler spreading per-process reads over the cpus, see ProcessSampler::setParallel
+     */
+    ProcessSampler *sampler();
+
 private:
     void scanProcess();
     void mergeSubProcNetIO(pid_t ppid, qreal &recvBps, qreal &sendBps);
@@ -58,14 +75,22 @@ private:
     public:
         Iterator();
 
+        explicit Iterator(const char *procPath);
+
         bool hasNext();
         Process next();
+        pid_t nextPid();
+        /**
+         * @brief Numeric /proc entries seen so far, including the ones not returned
+         */
+        inline quint32 count() const { return m_count; }
 
     private:
         void advance();
 
         uDir m_dir {};
         struct dirent *m_dirent {};
+        quint32 m_count {0};
     };
 
 private:
@@ -76,9 +101,15 @@ private:
 
     QMap<pid_t, pid_t> m_pidCtoPMapping {}; // child to parent pid mapping
     QMultiMap<pid_t, pid_t> m_pidPtoCMapping {}; // parent to child pid mapping
+    PidIndex m_pidIndex {}; // pids seen by the previous /proc scan
     QList<pid_t> m_prePid;
     QList<pid_t> m_curPid;
-    QList<pid_t> m_pidMyApps;
+    QSet<pid_t> m_pidMyApps;
+    ProcessSampler m_sampler {};
+
+    quint64 m_snapshotVersion {0}; // bumped once per scan
+
+    ProcessSnapshotPtr m_snapshot; // swapped atomically, readers may be on any thread
 
     friend class Iterator;
 };
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "process_snapshot.h"
+#include "process.h"
+#include "private/process_p.h"
+
+#include <QUrl>
+
+#include <algorithm>
+
+namespace core {
+namespace process {
+
+ProcessSnapshot::ProcessSnapshot(quint64 version)
+    : m_version(version)
+{
+}
+
+ProcessSnapshot::ProcessSnapshot(quint64 version, const QList<Process> &procs)
+    : m_version(version)
+{
+    int size = procs.size();
+    m_pids.reserve(size);
+    m_ppids.reserve(size);
+    m_uids.reserve(size);
+    m_appTypes.reserve(size);
+    m_states.reserve(size);
+    m_priorities.reserve(size);
+    m_startTimes.reserve(size);
+    m_cpus.reserve(size);
+    m_memories.reserve(size);
+    m_shareMemories.reserve(size);
+    m_vtrMemories.reserve(size);
+    m_readBps.reserve(size);
+    m_writeBps.reserve(size);
+    m_recvBps.reserve(size);
+    m_sentBps.reserve(size);
+    m_recvBytes.reserve(size);
+    m_sentBytes.reserve(size);
+    m_names.reserve(size);
+    m_displayNames.reserve(size);
+    m_userNames.reserve(size);
+    m_cmdlines.reserve(size);
+    m_environs.reserve(size);
+    m_icons.reserve(size);
+
+    for (const Process &proc : procs) {
+        m_pids << proc.pid();
+        m_ppids << proc.ppid();
+        m_uids << proc.uid();
+        m_appTypes << proc.appType();
+        m_states << proc.state();
+        m_priorities << proc.priority();
+        m_startTimes << proc.startTime();
+
+        m_cpus << proc.cpu();
+        m_memories << proc.memory();
+        m_shareMemories << proc.sharememory();
+        m_vtrMemories << proc.vtrmemory();
+        m_readBps << proc.readBps();
+        m_writeBps << proc.writeBps();
+        m_recvBps << proc.recvBps();
+        m_sentBps << proc.sentBps();
+        m_recvBytes << proc.recvBytes();
+        m_sentBytes << proc.sentBytes();
+
+        // implicitly shared, later scans assign new values instead of editing these
+        m_names << proc.name();
+        m_displayNames << proc.displayName();
+        m_userNames << proc.userName();
+        m_cmdlines << proc.cmdline();
+        m_environs << proc.environ();
+        m_icons << proc.d->proc_icon;
+    }
+}
+
+int ProcessSnapshot::indexOf(pid_t pid) const
+{
+    auto it = std::lower_bound(m_pids.cbegin(), m_pids.cend(), pid);
+    if (it == m_pids.cend() || *it != pid)
+        return -1;
+    return int(it - m_pids.cbegin());
+}
+
+QString ProcessSnapshot::cmdlineString(int index) const
+{
+    return QUrl::fromPercentEncoding(m_cmdlines[index].join(' '));
+}
+
+QIcon ProcessSnapshot::icon(int index) const
+{
+    return m_icons[index].icon();
+}
+
+} // namespace process
+} // namespace core
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PROCESS_SNAPSHOT_H
+#define PROCESS_SNAPSHOT_H
+
+#include "process_icon.h"
+
+#include <QByteArrayList>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+#include <sys/types.h>
+
+namespace core {
+namespace process {
+
+class Process;
+
+/**
+ * @brief Immutable copy of one process list scan
+ *
+ * Values are copied out of the scanned processes into one array per column, indexed like the
+ * ascending pid array, so readers on any thread never see the sampler updating a process in
+ * place. Snapshots are published through ProcessSet::snapshot() & shared by reference count,
+ * a reader keeps the one it got for as long as it needs consistent data.
+ */
+class ProcessSnapshot
+{
+public:
+    explicit ProcessSnapshot(quint64 version = 0);
+    /**
+     * @brief Copy values out of procs
+     * @param version Scan sequence number, bumped by ProcessSet once per scan
+     * @param procs Valid processes in ascending pid order
+     */
+    ProcessSnapshot(quint64 version, const QList<Process> &procs);
+
+    inline quint64 version() const { return m_version; }
+    inline int size() const { return m_pids.size(); }
+    inline bool isEmpty() const { return m_pids.isEmpty(); }
+    // ascending
+    inline const QVector<pid_t> &pids() const { return m_pids; }
+    /**
+     * @brief Index of pid in every column
+     * @return -1 if pid is not in the snapshot
+     */
+    int indexOf(pid_t pid) const;
+    inline bool contains(pid_t pid) const { return indexOf(pid) >= 0; }
+
+    inline pid_t pid(int index) const { return m_pids[index]; }
+    inline pid_t ppid(int index) const { return m_ppids[index]; }
+    inline uid_t uid(int index) const { return m_uids[index]; }
+    inline int appType(int index) const { return m_appTypes[index]; }
+    inline char state(int index) const { return m_states[index]; }
+    inline int priority(int index) const { return m_priorities[index]; }
+    inline time_t startTime(int index) const { return m_startTimes[index]; }
+
+    inline qreal cpu(int index) const { return m_cpus[index]; }
+    inline qulonglong memory(int index) const { return m_memories[index]; }
+    inline qulonglong sharememory(int index) const { return m_shareMemories[index]; }
+    inline qulonglong vtrmemory(int index) const { return m_vtrMemories[index]; }
+    inline qreal readBps(int index) const { return m_readBps[index]; }
+    inline qreal writeBps(int index) const { return m_writeBps[index]; }
+    inline qreal recvBps(int index) const { return m_recvBps[index]; }
+    inline qreal sentBps(int index) const { return m_sentBps[index]; }
+    inline qulonglong recvBytes(int index) const { return m_recvBytes[index]; }
+    inline qulonglong sentBytes(int index) const { return m_sentBytes[index]; }
+
+    inline const QString &name(int index) const { return m_names[index]; }
+    inline const QString &displayName(int index) const { return m_displayNames[index]; }
+    inline const QString &userName(int index) const { return m_userNames[index]; }
+    inline const QByteArrayList &cmdline(int index) const { return m_cmdlines[index]; }
+    QString cmdlineString(int index) const;
+    inline const QHash<QString, QString> &environ(int index) const { return m_environs[index]; }
+    /**
+     * @brief Process icon, pixmaps are created on demand so call it from the gui thread only
+     */
+    QIcon icon(int index) const;
+
+private:
+    quint64 m_version;
+
+    QVector<pid_t> m_pids;
+    QVector<pid_t> m_ppids;
+    QVector<uid_t> m_uids;
+    QVector<int> m_appTypes;
+    QVector<char> m_states;
+    QVector<int> m_priorities;
+    QVector<time_t> m_startTimes;
+
+    QVector<qreal> m_cpus;
+    QVector<qulonglong> m_memories;
+    QVector<qulonglong> m_shareMemories;
+    QVector<qulonglong> m_vtrMemories;
+    QVector<qreal> m_readBps;
+    QVector<qreal> m_writeBps;
+    QVector<qreal> m_recvBps;
+    QVector<qreal> m_sentBps;
+    QVector<qulonglong> m_recvBytes;
+    QVector<qulonglong> m_sentBytes;
+
+    QVector<QString> m_names;
+    QVector<QString> m_displayNames;
+    QVector<QString> m_userNames;
+    QVector<QByteArrayList> m_cmdlines;
+    QVector<QHash<QString, QString>> m_environs;
+    QVector<ProcessIcon> m_icons;
+};
+
+using ProcessSnapshotPtr = std::shared_ptr<const ProcessSnapshot>;
+
+} // namespace process
+} // namespace core
+
+#endif // PROCESS_SNAPSHOT_H
@@ -105,6 +105,9 @@ ServiceManager::ServiceManager(QObject *parent)
     connect(this, &ServiceManager::beginUpdateList, m_worker, &ServiceManagerWorker::startJob);
     connect(&m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
     connect(m_worker, &ServiceManagerWorker::resultReady, this, &ServiceManager::serviceListUpdated);
+    connect(this, &ServiceManager::beginFetchDetails, m_worker, &ServiceManagerWorker::fetchDetails);
+    connect(m_worker, &ServiceManagerWorker::entriesUpdated, this, &ServiceManager::serviceEntriesUpdated);
+    connect(m_worker, &ServiceManagerWorker::entryRemoved, this, &ServiceManager::serviceRemoved);
     m_workerThread.start();
 }
 
@@ -119,6 +122,11 @@ void ServiceManager::updateServiceList()
     Q_EMIT beginUpdateList();
 }
 
+void ServiceManager::fetchServiceDetails(const QStringList &snames)
+{
+    Q_EMIT beginFetchDetails(snames);
+}
+
 QString ServiceManager::normalizeServiceId(const QString &id, const QString &param)
 {
     QString buf = id;
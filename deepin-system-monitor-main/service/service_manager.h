@@ -7,6 +7,7 @@
 #define SERVICE_MANAGER_H
 
 #include <QList>
+#include <QStringList>
 #include <mutex>
 #include <thread>
 
@@ -58,6 +59,11 @@ public:
     }
 
     void updateServiceList();
+    /**
+     * @brief Ask for details of listed services (MainPID, CanStart...), e.g. when their rows get shown
+     * @param snames Service names
+     */
+    void fetchServiceDetails(const QStringList &snames);
 
     inline static QString getServiceStartupType(const QString &id, const QString &state)
     {
@@ -80,6 +86,9 @@ Q_SIGNALS:
     void beginUpdateList();
     void serviceListUpdated(const QList<SystemServiceEntry> &list);
     void serviceStatusUpdated(const SystemServiceEntry &entry);
+    void beginFetchDetails(const QStringList &snames);
+    void serviceEntriesUpdated(const QList<SystemServiceEntry> &list);
+    void serviceRemoved(const QString &sname);
 
 public:
     SystemServiceEntry updateServiceEntry(const QString &opath);
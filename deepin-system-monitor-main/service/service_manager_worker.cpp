@@ -16,161 +16,127 @@
 #include "service_manager.h"
 
 #include <QDebug>
-#include <QtConcurrent>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QRegularExpression>
 
+#define SERVICE_DETAIL_PIPELINE 32 // services with detail calls in flight
+#define SERVICE_UPDATE_BATCH 64 // updated entries per entriesUpdated signal at most
+#define SERVICE_UPDATE_DELAY 100 // coalesce updates for this long before handing them out (ms)
+
 using namespace DDLog;
 ServiceManagerWorker::ServiceManagerWorker(QObject *parent)
+    : ServiceManagerWorker(DBUS_SYSTEMD1_SERVICE, QDBusConnection::systemBus(), parent)
+{
+}
+
+ServiceManagerWorker::ServiceManagerWorker(const QString &service, const QDBusConnection &connection, QObject *parent)
     : QObject(parent)
+    , m_service(service)
+    , m_connection(connection)
+    , m_flushTimer(this)
 {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(SERVICE_UPDATE_DELAY);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ServiceManagerWorker::flushUpdates);
 }
 
 void ServiceManagerWorker::startJob()
 {
+    ++m_job;
+    m_entries.clear();
+    m_paths.clear();
+    m_unitFiles.clear();
+    m_requested.clear();
+    m_pending.clear();
+    m_inflight.clear();
+    m_updates.clear();
+    m_flushTimer.stop();
+
+    subscribe();
+
     QList<SystemServiceEntry> list;
-    // id hash, only keys are used here
-    QHash<QString, int> hash;
     ErrorContext ec;
 
-    Systemd1ManagerInterface mgrIf(DBUS_SYSTEMD1_SERVICE,
+    Systemd1ManagerInterface mgrIf(m_service,
                                    kSystemDObjectPath.path(),
-                                   QDBusConnection::systemBus());
+                                   m_connection);
+    // let systemd filter-out non service type units, plain list calls are kept for systemd older than 233
+    const QStringList patterns {QString("*%1").arg(UnitTypeServiceSuffix)};
 
-    auto unitFilesResult = mgrIf.ListUnitFiles();
+    auto unitFilesResult = mgrIf.ListUnitFilesByPatterns({}, patterns);
     ec = unitFilesResult.first;
     if (ec) {
-        qCDebug(app) << "ListUnitFiles failed:" << ec.getErrorName() << ec.getErrorMessage();
+        qCDebug(app) << "ListUnitFilesByPatterns failed:" << ec.getErrorName() << ec.getErrorMessage();
+        unitFilesResult = mgrIf.ListUnitFiles();
+        ec = unitFilesResult.first;
+        if (ec) {
+            qCDebug(app) << "ListUnitFiles failed:" << ec.getErrorName() << ec.getErrorMessage();
+        }
     }
-    UnitFileInfoList unitFiles = unitFilesResult.second;
+    const UnitFileInfoList &unitFiles = unitFilesResult.second;
 
-    auto unitsResult = mgrIf.ListUnits();
+    auto unitsResult = mgrIf.ListUnitsByPatterns({}, patterns);
     ec = unitsResult.first;
     if (ec) {
-        qCDebug(app) << "ListUnits failed:" << ec.getErrorName() << ec.getErrorMessage();
+        qCDebug(app) << "ListUnitsByPatterns failed:" << ec.getErrorName() << ec.getErrorMessage();
+        unitsResult = mgrIf.ListUnits();
+        ec = unitsResult.first;
+        if (ec) {
+            qCDebug(app) << "ListUnits failed:" << ec.getErrorName() << ec.getErrorMessage();
+        }
     }
-    UnitInfoList units = unitsResult.second;
-    for (auto u : units) {
-        if (u.getName().endsWith(UnitTypeServiceSuffix)) {
-            hash[u.getName()] = 0;
+    const UnitInfoList &units = unitsResult.second;
+
+    // unit file state by id, saves a GetUnitFileState call per loaded unit
+    QHash<QString, QString> states;
+    for (const auto &unf : unitFiles) {
+        auto id = unf.getName().mid(unf.getName().lastIndexOf('/') + 1);
+        if (id.endsWith(UnitTypeServiceSuffix) && !states.contains(id)) {
+            states[id] = unf.getStatus();
+            m_unitFiles << id.left(id.lastIndexOf('.'));
         }
     }
 
-    // filter-out non service type units
-    std::function<bool(const UnitInfo &)> fltUnits;
-    fltUnits = [](const UnitInfo &unit) -> bool {
-        return unit.getName().endsWith(UnitTypeServiceSuffix);
-    };
-    std::function<SystemServiceEntry(const UnitInfo &)> mapUnit = [&mgrIf](const UnitInfo &unit) {
-        ErrorContext ec1 {};
+    // loaded units, everything but MainPID & CanStart/CanStop/CanReload comes with the list
+    for (const auto &unit : units) {
+        if (!unit.getName().endsWith(UnitTypeServiceSuffix))
+            continue;
+
         SystemServiceEntry entry {};
-        // SName
-        entry.setSName(unit.getName().left(unit.getName().lastIndexOf('.')));
-        // LoadState
+        auto sname = unit.getName().left(unit.getName().lastIndexOf('.'));
+        if (m_entries.contains(sname))
+            continue;
+
+        entry.setId(unit.getName());
+        entry.setSName(sname);
         entry.setLoadState(unit.getLoadState());
-        // ActiveState
         entry.setActiveState(unit.getActiveState());
-        // subState
         entry.setSubState(unit.getSubState());
         entry.setUnitObjectPath(unit.getUnitObjectPath());
-        // Description
         entry.setDescription(unit.getDescription());
-
-        Systemd1UnitInterface unitIf(DBUS_SYSTEMD1_SERVICE,
-                                     unit.getUnitObjectPath(),
-                                     QDBusConnection::systemBus());
-        // Id
-        auto id = unitIf.getId();
-        ec1 = id.first;
-        if (ec1) {
-            qCDebug(app) << "call getId failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            entry.setId(id.second);
-        }
-
-        auto bStart = unitIf.canStart();
-        ec1 = bStart.first;
-        if (ec1) {
-            qCDebug(app) << "call canStart failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            entry.setCanStart(bStart.second);
-        }
-
-        auto bStop = unitIf.canStop();
-        ec1 = bStop.first;
-        if (ec1) {
-            qCDebug(app) << "call canStart failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            entry.setCanStop(bStop.second);
-        }
-
-        auto bReload = unitIf.canReload();
-        ec1 = bReload.first;
-        if (ec1) {
-            qCDebug(app) << "call canStart failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            entry.setCanReload(bReload.second);
-        }
-
-        // mainPID
-        Systemd1ServiceInterface svcIf(DBUS_SYSTEMD1_SERVICE,
-                                       unit.getUnitObjectPath(),
-                                       QDBusConnection::systemBus());
-        auto pid = svcIf.getMainPID();
-        ec1 = pid.first;
-        if (ec1) {
-            qCDebug(app) << "getMainPID failed" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            entry.setMainPID(pid.second);
-        }
-
-        // unit state
-        auto state = mgrIf.GetUnitFileState(unit.getName());
-        ec1 = state.first;
-        if (ec1) {
-            qCDebug(app) << "getUnitFileState failed" << ec1.getErrorName() << ec1.getErrorMessage();
-        } else {
-            entry.setState(state.second);
-        }
-
-        // startupType
+        // units without an installed file (transient, generated...) get their state with the details
+        entry.setState(states.value(unit.getName()));
         entry.setStartupType(ServiceManager::getServiceStartupType(
                 entry.getSName(),
                 entry.getState()));
 
-        return entry;
-    };
-    std::function<void(QList<SystemServiceEntry> & elist, const SystemServiceEntry &entry)> addServiceEntryFromUnitInfo;
-    addServiceEntryFromUnitInfo = [](QList<SystemServiceEntry> &elist, const SystemServiceEntry &entry) {
-        elist << entry;
-    };
-    auto fltufe = QtConcurrent::filter(units, fltUnits);
-    fltufe.waitForFinished();
-    auto ufe = QtConcurrent::mappedReduced<QList<SystemServiceEntry>>(units, mapUnit, addServiceEntryFromUnitInfo);
-
-    std::function<void(QList<SystemServiceEntry> & elist, const SystemServiceEntry &entry)> addServiceEntryFromUnitFileInfo;
-    addServiceEntryFromUnitFileInfo = [&hash](QList<SystemServiceEntry> &elist, const SystemServiceEntry &entry) {
-        if (!hash.contains(entry.getId())) {
-            elist << entry;
-        }
-    };
-    // filter-out non service type unit-files
-    std::function<bool(const UnitFileInfo &)> fltUnitFiles;
-    fltUnitFiles = [&hash](const UnitFileInfo &unitFile) -> bool {
-        auto id = unitFile.getName().mid(unitFile.getName().lastIndexOf('/') + 1);
-        if (hash.contains(id)) {
-            return false;
-        } else {
-            return unitFile.getName().endsWith(UnitTypeServiceSuffix);
-        }
-    };
-    std::function<SystemServiceEntry(const UnitFileInfo &)> mapUnitFiles;
-    mapUnitFiles = [](const UnitFileInfo &unf) {
-        SystemServiceEntry entry {};
-        ErrorContext ec1 {};
+        m_entries[sname] = entry;
+        m_paths[unit.getUnitObjectPath()] = sname;
+        list << entry;
+    }
 
+    // installed but not loaded units, unit states come with the details
+    for (const auto &unf : unitFiles) {
         auto id = unf.getName().mid(unf.getName().lastIndexOf('/') + 1);
+        if (!id.endsWith(UnitTypeServiceSuffix))
+            continue;
+
+        SystemServiceEntry entry {};
         auto sname = id;
         sname.chop(strlen(UnitTypeServiceSuffix));
+        if (m_entries.contains(sname))
+            continue;
 
         entry.setSName(sname);
         entry.setState(unf.getStatus());
@@ -178,80 +144,259 @@ void ServiceManagerWorker::startJob()
                 entry.getSName(),
                 entry.getState()));
         if (sname.endsWith('@')) {
-            // read description from unit file
+            // read description from unit file, templates have no unit object to ask
             auto desc = readUnitDescriptionFromUnitFile(unf.getName());
             entry.setDescription(desc);
+            m_requested << sname;
         } else {
-            auto o = Systemd1UnitInterface::normalizeUnitPath(id);
-            Systemd1UnitInterface unitIf(DBUS_SYSTEMD1_SERVICE,
-                                         o.path(),
-                                         QDBusConnection::systemBus());
-            Systemd1ServiceInterface svcIf(DBUS_SYSTEMD1_SERVICE,
-                                           o.path(),
-                                           QDBusConnection::systemBus());
-
-            // Id
-            auto id1 = unitIf.getId();
-            ec1 = id1.first;
-            if (ec1) {
-                qCDebug(app) << "call getId failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                entry.setId(id1.second);
-            }
+            entry.setId(id);
+            m_paths[Systemd1UnitInterface::normalizeUnitPath(id).path()] = sname;
+        }
 
-            auto desc = unitIf.getDescription();
-            ec1 = desc.first;
-            if (ec1) {
-                qCDebug(app) << "getDescription failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                entry.setDescription(desc.second);
-            }
+        m_entries[sname] = entry;
+        list << entry;
+    }
 
-            auto actState = unitIf.getActiveState();
-            ec1 = actState.first;
-            if (ec1) {
-                qCDebug(app) << "getActiveState failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                entry.setActiveState(actState.second);
-            }
+    Q_EMIT resultReady(list);
+}
 
-            auto loadState = unitIf.getLoadState();
-            ec1 = loadState.first;
-            if (ec1) {
-                qCDebug(app) << "getLoadState failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                entry.setLoadState(loadState.second);
-            }
+void ServiceManagerWorker::fetchDetails(const QStringList &snames)
+{
+    for (const auto &sname : snames) {
+        if (!m_entries.contains(sname) || m_requested.contains(sname))
+            continue;
 
-            auto subState = unitIf.getSubState();
-            ec1 = subState.first;
-            if (ec1) {
-                qCDebug(app) << "getSubState failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                entry.setSubState(subState.second);
-            }
+        m_requested << sname;
+        m_pending.enqueue(sname);
+    }
+    issueDetailCalls();
+}
 
-            auto mainPID = svcIf.getMainPID();
-            ec1 = mainPID.first;
-            if (ec1) {
-                qCDebug(app) << "getMainPID failed:" << ec1.getErrorName() << ec1.getErrorMessage();
-            } else {
-                entry.setMainPID(mainPID.second);
-            }
+void ServiceManagerWorker::onUnitNew(const QString &id, const QDBusObjectPath &path)
+{
+    if (!id.endsWith(UnitTypeServiceSuffix))
+        return;
+
+    auto sname = id.left(id.lastIndexOf('.'));
+    m_paths[path.path()] = sname;
+    // listed already (systemd loads units we ask details for), PropertiesChanged keeps the row current
+    if (m_entries.contains(sname))
+        return;
+
+    // new service, the row is handed out once its details arrived
+    SystemServiceEntry entry {};
+    entry.setId(id);
+    entry.setSName(sname);
+    entry.setUnitObjectPath(path.path());
+    m_entries[sname] = entry;
+    fetchDetails({sname});
+}
+
+void ServiceManagerWorker::onUnitRemoved(const QString &id, const QDBusObjectPath &path)
+{
+    if (!id.endsWith(UnitTypeServiceSuffix))
+        return;
+
+    auto sname = id.left(id.lastIndexOf('.'));
+    if (!m_entries.contains(sname))
+        return;
+
+    if (m_unitFiles.contains(sname)) {
+        // unit got unloaded by systemd, the installed service itself stays in the list
+        auto entry = m_entries[sname];
+        entry.detach();
+        entry.setActiveState("inactive");
+        entry.setSubState("dead");
+        entry.setMainPID(0);
+        m_entries[sname] = entry;
+        queueUpdate(entry);
+        return;
+    }
+
+    m_entries.remove(sname);
+    m_paths.remove(path.path());
+    m_requested.remove(sname);
+    // updates queued before must not bring the row back after removal
+    flushUpdates();
+    Q_EMIT entryRemoved(sname);
+}
+
+void ServiceManagerWorker::onPropertiesChanged(const QDBusMessage &msg)
+{
+    // signals of all systemd objects end up here, only listed services are of interest
+    auto it = m_paths.constFind(msg.path());
+    if (it == m_paths.cend() || !m_entries.contains(*it))
+        return;
+
+    const auto args = msg.arguments();
+    if (args.size() < 2)
+        return;
+
+    auto sname = *it;
+    auto ifname = args[0].toString();
+    auto changed = qdbus_cast<QVariantMap>(args[1]);
+
+    auto entry = m_entries[sname];
+    entry.detach();
+    if (ifname == Systemd1UnitInterface::staticInterfaceName()) {
+        if (!mergeUnitProperties(entry, changed))
+            return;
+    } else if (ifname == Systemd1ServiceInterface::staticInterfaceName() && changed.contains("MainPID")) {
+        entry.setMainPID(changed["MainPID"].toUInt());
+    } else {
+        return;
+    }
+
+    m_entries[sname] = entry;
+    queueUpdate(entry);
+}
+
+void ServiceManagerWorker::flushUpdates()
+{
+    m_flushTimer.stop();
+    if (m_updates.isEmpty())
+        return;
+
+    auto list = m_updates;
+    m_updates.clear();
+    Q_EMIT entriesUpdated(list);
+}
+
+void ServiceManagerWorker::subscribe()
+{
+    if (m_subscribed)
+        return;
+
+    Systemd1ManagerInterface mgrIf(m_service,
+                                   kSystemDObjectPath.path(),
+                                   m_connection);
+    // systemd only sends unit signals to subscribed clients, retried on next startJob if this fails
+    auto ec = mgrIf.Subscribe();
+    if (ec) {
+        qCDebug(app) << "Subscribe failed:" << ec.getErrorName() << ec.getErrorMessage();
+        return;
+    }
+
+    m_connection.connect(m_service, kSystemDObjectPath.path(), Systemd1ManagerInterface::staticInterfaceName(),
+                         "UnitNew", this, SLOT(onUnitNew(QString, QDBusObjectPath)));
+    m_connection.connect(m_service, kSystemDObjectPath.path(), Systemd1ManagerInterface::staticInterfaceName(),
+                         "UnitRemoved", this, SLOT(onUnitRemoved(QString, QDBusObjectPath)));
+    // empty path matches any unit object
+    m_connection.connect(m_service, QString(), DBusPropertiesInterface::staticInterfaceName(),
+                         "PropertiesChanged", this, SLOT(onPropertiesChanged(QDBusMessage)));
+    m_subscribed = true;
+}
+
+void ServiceManagerWorker::issueDetailCalls()
+{
+    // a bounded window of calls in flight, each reply frees a slot for the next service
+    while (m_inflight.size() < SERVICE_DETAIL_PIPELINE && !m_pending.isEmpty()) {
+        auto sname = m_pending.dequeue();
+        if (!m_entries.contains(sname))
+            continue;
+
+        const auto &entry = m_entries[sname];
+        auto path = entry.getUnitObjectPath();
+        if (path.isEmpty())
+            path = Systemd1UnitInterface::normalizeUnitPath(entry.getId()).path();
+
+        // one GetAll for the unit properties & MainPID of the service interface, instead of a call per property
+        auto unitMsg = QDBusMessage::createMethodCall(m_service, path,
+                                                      DBusPropertiesInterface::staticInterfaceName(),
+                                                      "GetAll");
+        unitMsg << QString(Systemd1UnitInterface::staticInterfaceName());
+        auto pidMsg = QDBusMessage::createMethodCall(m_service, path,
+                                                     DBusPropertiesInterface::staticInterfaceName(),
+                                                     "Get");
+        pidMsg << QString(Systemd1ServiceInterface::staticInterfaceName()) << QString("MainPID");
+
+        auto job = m_job;
+        auto *unitWatcher = new QDBusPendingCallWatcher(m_connection.asyncCall(unitMsg), this);
+        connect(unitWatcher, &QDBusPendingCallWatcher::finished, this, [this, sname, job](QDBusPendingCallWatcher *watcher) {
+            detailCallFinished(watcher, sname, job, true);
+        });
+        auto *pidWatcher = new QDBusPendingCallWatcher(m_connection.asyncCall(pidMsg), this);
+        connect(pidWatcher, &QDBusPendingCallWatcher::finished, this, [this, sname, job](QDBusPendingCallWatcher *watcher) {
+            detailCallFinished(watcher, sname, job, false);
+        });
+        m_inflight[sname] = 2;
+    }
+}
+
+void ServiceManagerWorker::detailCallFinished(QDBusPendingCallWatcher *watcher, const QString &sname, quint64 job, bool unitProps)
+{
+    watcher->deleteLater();
+    // reply to a job replaced by startJob meanwhile
+    if (job != m_job || !m_inflight.contains(sname))
+        return;
+
+    if (watcher->isError()) {
+        qCDebug(app) << (unitProps ? "GetAll failed:" : "getMainPID failed:") << sname
+                     << watcher->error().name() << watcher->error().message();
+    } else if (m_entries.contains(sname)) {
+        auto entry = m_entries[sname];
+        entry.detach();
+        if (unitProps) {
+            QDBusPendingReply<QVariantMap> reply = *watcher;
+            mergeUnitProperties(entry, reply.value());
+        } else {
+            QDBusPendingReply<QDBusVariant> reply = *watcher;
+            entry.setMainPID(reply.value().variant().toUInt());
         }
+        m_entries[sname] = entry;
+    }
 
-        return entry;
-    };
-    auto fltuffe = QtConcurrent::filter(unitFiles, fltUnitFiles);
-    fltuffe.waitForFinished();
-    auto uffe = QtConcurrent::mappedReduced<QList<SystemServiceEntry>>(unitFiles, mapUnitFiles, addServiceEntryFromUnitFileInfo);
+    if (--m_inflight[sname] > 0)
+        return;
 
-    ufe.waitForFinished();
-    uffe.waitForFinished();
+    m_inflight.remove(sname);
+    if (m_entries.contains(sname))
+        queueUpdate(m_entries[sname]);
+    issueDetailCalls();
+}
 
-    list << ufe.result();
-    list << uffe.result();
-    Q_EMIT resultReady(list);
+bool ServiceManagerWorker::mergeUnitProperties(SystemServiceEntry &entry, const QVariantMap &props)
+{
+    bool merged = false;
+    for (auto it = props.cbegin(); it != props.cend(); ++it) {
+        const auto &key = it.key();
+        if (key == "Id") {
+            entry.setId(it.value().toString());
+        } else if (key == "Description") {
+            entry.setDescription(it.value().toString());
+        } else if (key == "LoadState") {
+            entry.setLoadState(it.value().toString());
+        } else if (key == "ActiveState") {
+            entry.setActiveState(it.value().toString());
+        } else if (key == "SubState") {
+            entry.setSubState(it.value().toString());
+        } else if (key == "CanStart") {
+            entry.setCanStart(it.value().toBool());
+        } else if (key == "CanStop") {
+            entry.setCanStop(it.value().toBool());
+        } else if (key == "CanReload") {
+            entry.setCanReload(it.value().toBool());
+        } else if (key == "UnitFileState") {
+            entry.setState(it.value().toString());
+            // startupType
+            entry.setStartupType(ServiceManager::getServiceStartupType(
+                    entry.getSName(),
+                    entry.getState()));
+        } else {
+            continue;
+        }
+        merged = true;
+    }
+    return merged;
+}
+
+void ServiceManagerWorker::queueUpdate(const SystemServiceEntry &entry)
+{
+    m_updates << entry;
+    if (m_updates.size() >= SERVICE_UPDATE_BATCH)
+        flushUpdates();
+    else if (!m_flushTimer.isActive())
+        m_flushTimer.start();
 }
 
 QString ServiceManagerWorker::readUnitDescriptionFromUnitFile(const QString &path)
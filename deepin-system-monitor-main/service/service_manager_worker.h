@@ -6,25 +6,98 @@
 #ifndef SERVICE_MANAGER_WORKER_H
 #define SERVICE_MANAGER_WORKER_H
 
+#include "service/system_service_entry.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QHash>
 #include <QObject>
 #include <QList>
+#include <QQueue>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVariantMap>
 
-class SystemServiceEntry;
+class QDBusPendingCallWatcher;
 
+/**
+ * @brief Loads the service list from systemd
+ *
+ * startJob publishes rows built from two list calls only, per unit details (MainPID, CanStart...)
+ * are fetched on demand through pipelined asynchronous GetAll calls. Once loaded, the list is kept
+ * up to date from systemd's UnitNew, UnitRemoved & PropertiesChanged signals.
+ */
 class ServiceManagerWorker : public QObject
 {
     Q_OBJECT
 public:
     explicit ServiceManagerWorker(QObject *parent = nullptr);
+    /**
+     * @brief Worker talking to another systemd manager, e.g. a mock service on the session bus
+     * @param service Service name of the manager
+     * @param connection Bus connection the manager is found on
+     */
+    ServiceManagerWorker(const QString &service, const QDBusConnection &connection, QObject *parent = nullptr);
 
 Q_SIGNALS:
     void resultReady(const QList<SystemServiceEntry> list);
+    /**
+     * @brief Entries with details filled in or changed by systemd, unknown entries are new services
+     */
+    void entriesUpdated(const QList<SystemServiceEntry> list);
+    void entryRemoved(const QString &sname);
 
 public Q_SLOTS:
     void startJob();
+    /**
+     * @brief Queue detail requests for services, services fetched since the last startJob are skipped
+     * @param snames Service names
+     */
+    void fetchDetails(const QStringList &snames);
+
+private Q_SLOTS:
+    void onUnitNew(const QString &id, const QDBusObjectPath &path);
+    void onUnitRemoved(const QString &id, const QDBusObjectPath &path);
+    void onPropertiesChanged(const QDBusMessage &msg);
+    void flushUpdates();
 
 private:
+    void subscribe();
+    void issueDetailCalls();
+    void detailCallFinished(QDBusPendingCallWatcher *watcher, const QString &sname, quint64 job, bool unitProps);
+    /**
+     * @brief Copy known org.freedesktop.systemd1.Unit properties into entry
+     * @return Return false if props holds none of them
+     */
+    bool mergeUnitProperties(SystemServiceEntry &entry, const QVariantMap &props);
+    void queueUpdate(const SystemServiceEntry &entry);
+
     inline static QString readUnitDescriptionFromUnitFile(const QString &path);
+
+private:
+    QString m_service;
+    QDBusConnection m_connection;
+    bool m_subscribed {false};
+
+    // bumped by startJob, replies of an older job are dropped
+    quint64 m_job {0};
+    // service name - entry of current job, entries are detached before being changed
+    QHash<QString, SystemServiceEntry> m_entries {};
+    // unit object path - service name
+    QHash<QString, QString> m_paths {};
+    // services with an installed unit file, their rows stay when systemd unloads the unit
+    QSet<QString> m_unitFiles {};
+    // services with details requested
+    QSet<QString> m_requested {};
+    // services waiting for a free slot in the pipeline
+    QQueue<QString> m_pending {};
+    // outstanding replies per service
+    QHash<QString, int> m_inflight {};
+
+    QList<SystemServiceEntry> m_updates {};
+    QTimer m_flushTimer;
 };
 
 #endif // SERVICE_MANAGER_WORKER_H
@@ -31,6 +31,11 @@ public:
     SystemServiceEntry &operator=(const SystemServiceEntry &);
     ~SystemServiceEntry();
 
+    /**
+     * @brief Take a private copy of the shared data, copies handed out before stay untouched by setters
+     */
+    inline void detach() { data.detach(); }
+
     //////////////////////////////////// GET ///////////////////////////////////
 
     inline QString getId() const { return data->m_id; }
@@ -7,6 +7,12 @@
 
 #include <QPainterPath>
 #include <QPointF>
+#include <QVarLengthArray>
+
+namespace {
+// scratch doubles kept on the stack, curves of up to 64 knots don't allocate
+const int kScratchSize = 5 * 64;
+} // namespace
 
 QPainterPath SmoothCurveGenerator::generateSmoothCurve(const QList<QPointF> &points)
 {
@@ -30,9 +36,8 @@ QPainterPath SmoothCurveGenerator::generateSmoothCurve(const QList<QPointF> &poi
     return path;
 }
 
-void SmoothCurveGenerator::calculateFirstControlPoints(double *&result, const double *rhs, int n)
+void SmoothCurveGenerator::calculateFirstControlPoints(double *result, const double *rhs, double *tmp, int n)
 {
-    double *tmp = new double[n];
     double b = 2.0;
     result[0] = rhs[0] / b;
 
@@ -46,13 +51,13 @@ void SmoothCurveGenerator::calculateFirstControlPoints(double *&result, const do
     for (int i = 1; i < n; i++) {
         result[n - i - 1] -= tmp[n - i] * result[n - i]; // Backsubstitution.
     }
-
-    delete[] tmp;
 }
 
 void SmoothCurveGenerator::calculateControlPoints(const QList<QPointF> &knots, QList<QPointF> *firstControlPoints, QList<QPointF> *secondControlPoints)
 {
     int n = knots.size() - 1;
+    firstControlPoints->reserve(n);
+    secondControlPoints->reserve(n);
     for (int i = 0; i < n; ++i) {
         firstControlPoints->append(QPointF());
         secondControlPoints->append(QPointF());
@@ -69,11 +74,13 @@ void SmoothCurveGenerator::calculateControlPoints(const QList<QPointF> &knots, Q
         return;
     }
 
-    // Calculate first Bezier control points
-    double *xs = new double[n];
-    double *ys = new double[n];
-    double *rhsx = new double[n]; // Right hand side vector
-    double *rhsy = new double[n]; // Right hand side vector
+    // Calculate first Bezier control points, all vectors share one scratch block
+    QVarLengthArray<double, kScratchSize> scratch(5 * n);
+    double *xs = scratch.data();
+    double *ys = xs + n;
+    double *rhsx = ys + n; // Right hand side vector
+    double *rhsy = rhsx + n; // Right hand side vector
+    double *tmp = rhsy + n;
 
     // Set right hand side values
     for (int i = 1; i < n - 1; ++i) {
@@ -86,8 +93,8 @@ void SmoothCurveGenerator::calculateControlPoints(const QList<QPointF> &knots, Q
     rhsy[n - 1] = (8 * knots[n - 1].y() + knots[n].y()) / 2.0;
 
     // Calculate first control points coordinates
-    calculateFirstControlPoints(xs, rhsx, n);
-    calculateFirstControlPoints(ys, rhsy, n);
+    calculateFirstControlPoints(xs, rhsx, tmp, n);
+    calculateFirstControlPoints(ys, rhsy, tmp, n);
 
     // Fill output control points.
     for (int i = 0; i < n; ++i) {
@@ -101,9 +108,4 @@ void SmoothCurveGenerator::calculateControlPoints(const QList<QPointF> &knots, Q
             (*secondControlPoints)[i].ry() = (knots[n].y() + ys[n - 1]) / 2;
         }
     }
-
-    delete[] xs;
-    delete[] ys;
-    delete[] rhsx;
-    delete[] rhsy;
 }
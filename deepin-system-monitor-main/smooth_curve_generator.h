@@ -27,9 +27,10 @@ private:
      * of first Bezier control points.
      * @param result - Solution vector.
      * @param rhs - Right hand side vector.
+     * @param tmp - Scratch vector of size n.
      * @param n - Size of rhs.
      */
-    static void calculateFirstControlPoints(double *&result, const double *rhs, int n);
+    static void calculateFirstControlPoints(double *result, const double *rhs, double *tmp, int n);
 
     /**
      * Calculate control points of the smooth curve using the given knots.
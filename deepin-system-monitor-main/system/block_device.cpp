@@ -7,7 +7,6 @@
 #include <QDateTime>
 #include <QFile>
 #include <QSharedData>
-#include <QTextStream>
 #include "system/sys_info.h"
 #include "common/common.h"
 namespace core {
@@ -39,71 +38,58 @@ void BlockDevice::setDeviceName(const QByteArray &deviceName)
     readDeviceInfo();
 }
 
-void BlockDevice::readDeviceInfo()
+void BlockDevice::setDeviceStat(const disk_stat_t &stat)
 {
+    if (d->name != stat.name)
+        d->name = stat.name;
+
+    m_time_sec = QDateTime::currentSecsSinceEpoch();
+    timevalList[0] = timevalList[1];
+    timevalList[1] = SysInfo::instance()->uptime();
+
+    qint64 interval = m_time_sec - d->_time_Sec > 0 ? m_time_sec - d->_time_Sec : 1;
+    calcDiskIoStates(stat);
+    if (d->read_iss != 0)
+        d->r_ps = (stat.read_ios - d->read_iss) / static_cast<quint64>(interval);
+    if (d->blk_read != 0)
+        d->rsec_ps = (stat.read_sectors - d->blk_read) / static_cast<quint64>(interval);
+    if (d->blk_wrtn != 0)
+        d->wsec_ps = (stat.write_sectors - d->blk_wrtn) / static_cast<quint64>(interval);
+    if (d->read_merged != 0)
+        d->rrqm_ps = (stat.read_merges - d->read_merged) / static_cast<quint64>(interval);
+    if (d->write_com != 0)
+        d->w_ps = (stat.write_ios - d->write_com) / static_cast<quint64>(interval);
+    if (d->write_merged != 0)
+        d->wrqm_ps = (stat.write_merges - d->write_merged) / static_cast<quint64>(interval);
+    d->blk_read = stat.read_sectors;
+    d->bytes_read = stat.read_sectors * SECTOR_SIZE;
+    if (stat.read_ios != 0)
+        d->p_rrqm = double(stat.read_merges) / double(stat.read_ios) * 100;
+    d->tps = stat.read_ios + stat.write_ios;
+    d->blk_wrtn = stat.write_sectors;
+    d->bytes_wrtn = stat.write_sectors * SECTOR_SIZE;
+    if (stat.write_ios != 0)
+        d->p_wrqm = stat.write_merges / stat.write_ios * 100;
+    d->read_iss = stat.read_ios;
+    d->write_com = stat.write_ios;
+    d->read_merged = stat.read_merges;
+    d->write_merged = stat.write_merges;
+    d->discard_sector = stat.discard_sectors;
+    d->_time_Sec = QDateTime::currentSecsSinceEpoch();
+}
 
-    QFile file(PROC_PATH_DISK);
-    if (!file.open(QIODevice::ReadOnly)) {
+void BlockDevice::readDeviceInfo()
+{
+    // standalone read, BlockDeviceInfoDB feeds devices from the shared table instead
+    DiskStatTable table(false);
+    if (!table.update())
         return;
-    }
-    QList<QStringList> strList;
-    QTextStream in(&file);
-
-    QString line;
-    do{
-        line = in.readLine();
-        if (!line.contains("loop")){
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            strList << line.split(" ", QString::SkipEmptyParts);
-#else
-            strList << line.split(" ", Qt::SkipEmptyParts);
-#endif
-        }
-    }while (!line.isNull());
-    file.close();
 
-    for (int i = 0; i < strList.size(); ++i) {
-        QStringList deviceInfo = strList[i];
-        if (deviceInfo.size() > 16 && deviceInfo[2] == d->name) {
-            m_time_sec = QDateTime::currentSecsSinceEpoch();
-            timevalList[0] = timevalList[1];
-            timevalList[1] = SysInfo::instance()->uptime();
-
-            qint64 interval = m_time_sec - d->_time_Sec > 0 ? m_time_sec - d->_time_Sec : 1;
-            calcDiskIoStates(deviceInfo);
-            readDeviceModel();
-            d->capacity = readDeviceSize(deviceInfo[2]);
-            if (d->read_iss != 0)
-                d->r_ps = (deviceInfo[3].toULongLong() - d->read_iss) / static_cast<quint64>(interval);
-            if (d->blk_read != 0)
-                d->rsec_ps = (deviceInfo[5].toULongLong() - d->blk_read) / static_cast<quint64>(interval);
-            if (d->blk_wrtn != 0)
-                d->wsec_ps = (deviceInfo[9].toULongLong() - d->blk_wrtn) / static_cast<quint64>(interval);
-            if (d->read_merged != 0)
-                d->rrqm_ps = (deviceInfo[4].toULongLong() - d->read_merged) / static_cast<quint64>(interval);
-            if (d->write_com != 0)
-                d->w_ps = (deviceInfo[7].toULongLong() - d->write_com) / static_cast<quint64>(interval);
-            if (d->write_merged != 0)
-                d->wrqm_ps = (deviceInfo[8].toULongLong() - d->write_merged) / static_cast<quint64>(interval);
-            d->blk_read = deviceInfo[5].toULongLong();
-            d->bytes_read = deviceInfo[5].toULongLong() * SECTOR_SIZE;
-            if (deviceInfo[3].toULongLong() != 0)
-                d->p_rrqm =  deviceInfo[4].toDouble() / deviceInfo[3].toDouble() * 100;
-            d->tps = deviceInfo[3].toULongLong() + deviceInfo[7].toULongLong();
-            d->blk_wrtn = deviceInfo[9].toULongLong();
-            d->bytes_wrtn = deviceInfo[9].toULongLong() * SECTOR_SIZE;
-            if (deviceInfo[7].toULongLong() != 0)
-                d->p_wrqm = deviceInfo[8].toULongLong() / deviceInfo[7].toULongLong() * 100;
-            d->read_iss = deviceInfo[3].toULongLong();
-            d->write_com = deviceInfo[7].toULongLong();
-            d->read_merged = deviceInfo[4].toULongLong();
-            d->write_merged = deviceInfo[8].toULongLong();
-            d->discard_sector = deviceInfo[16].toULongLong();
-            d->_time_Sec = QDateTime::currentSecsSinceEpoch();
-            break;
-        }
+    const disk_stat_t *stat = table.find(d->name);
+    if (stat) {
+        setDeviceStat(*stat);
+        readDeviceAttributes();
     }
-
 }
 
 void BlockDevice::readDeviceModel()
@@ -130,11 +116,17 @@ quint64 BlockDevice::readDeviceSize(const QString &deviceName)
     return size;
 }
 
-void BlockDevice::calcDiskIoStates(const QStringList &diskInfo)
+void BlockDevice::readDeviceAttributes()
+{
+    readDeviceModel();
+    d->capacity = readDeviceSize(QString::fromLocal8Bit(d->name));
+}
+
+void BlockDevice::calcDiskIoStates(const disk_stat_t &stat)
 {
-    quint64 curr_read_sector =  diskInfo[5].toULongLong();
-    quint64 curr_write_sector = diskInfo[9].toULongLong();
-    quint64 curr_discard_sector = diskInfo[16].toULongLong();
+    quint64 curr_read_sector = stat.read_sectors;
+    quint64 curr_write_sector = stat.write_sectors;
+    quint64 curr_discard_sector = stat.discard_sectors;
     timeval cur_time = timevalList[1];
     timeval prev_time = timevalList[0];
 
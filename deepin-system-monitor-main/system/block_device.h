@@ -7,6 +7,7 @@
 #define BLOCK_DEVICE_H
 
 #include "private/block_device_p.h"
+#include "diskio_info.h"
 
 #include <QSharedDataPointer>
 #define MAX_NAME_LEN 128
@@ -52,12 +53,18 @@ public:
     quint64  writeSpeed() const; // 获取写速度
 
     void setDeviceName(const QByteArray &deviceName);
+    /**
+     * @brief Update io counters & rates from this tick's diskstats line, device name is taken from it
+     */
+    void setDeviceStat(const disk_stat_t &stat);
 
 public:
     void readDeviceInfo();
     void readDeviceModel();
     quint64 readDeviceSize(const QString &deviceName);
-    void calcDiskIoStates(const QStringList &diskInfo);
+    // model & capacity, only change when udev reports the disk
+    void readDeviceAttributes();
+    void calcDiskIoStates(const disk_stat_t &stat);
 
 private:
     QSharedDataPointer<BlockDevicePrivate> d;
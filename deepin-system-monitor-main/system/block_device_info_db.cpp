@@ -13,17 +13,17 @@
 #include "diskio_info.h"
 #include "common/common.h"
 #include "system/sys_info.h"
-#include <QDir>
+#include <QHash>
+#include <QVector>
 #include <ctype.h>
 #include <errno.h>
 #include <sched.h>
+#include <string.h>
 
 #include <libudev.h>
 
 using namespace DDLog;
 
-#define SYSFS_PATH_VIRTUAL_BLOCK "/sys/devices/virtual/block"
-
 namespace core {
 namespace system {
 /*static struct udev_device *
@@ -92,8 +92,10 @@ get_child(struct udev *udev, struct udev_device *parent, const char *subsystem)
 //    udev_enumerate_unref(enumerate);
 //}
 
-BlockDeviceInfoDB::BlockDeviceInfoDB()
+BlockDeviceInfoDB::BlockDeviceInfoDB(DiskStatTable *stats)
     : m_deviceList {}
+    , m_ownStats(stats ? nullptr : new DiskStatTable())
+    , m_stats(stats ? stats : m_ownStats.get())
 {
 }
 
@@ -103,79 +105,49 @@ BlockDeviceInfoDB::~BlockDeviceInfoDB()
 
 void BlockDeviceInfoDB::readDiskInfo()
 {
-    QDir dir(SYSFS_PATH_BLOCK);
-    if (!dir.exists()) {
+    if (m_ownStats && !m_ownStats->update())
         return;
-    }
 
-    QFileInfoList list = dir.entryInfoList();
-    //获取实体磁盘
-    for (int i = 0; i < list.size(); ++i) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QString t_link = list.at(i).readLink();
-#else
-        QString t_link = list.at(i).readSymLink();
-#endif
-        if (list[i].fileName() != "." && list[i].fileName() != ".." && !list[i].fileName().contains("ram") && !list[i].fileName().contains("loop") && !t_link.contains("virtual")) {
-            int index = -1;
-            //  查找当前的device是否存在
-            for (int si = 0; si < m_deviceList.size(); ++si) {
-                if (m_deviceList[si].deviceName() == list[i].fileName().toLocal8Bit()) {   // 存在
-                    index = si;
-                    break;
-                }
-            }
-            if (index == -1) {   // 不存在的话将该disk存储起来
-                BlockDevice bd;
-                if (bd.readDeviceSize(list[i].fileName()) > 0) {
-                    bd.setDeviceName(list[i].fileName().toLocal8Bit());
-                    m_deviceList << bd;
-                }
-            } else {
-                m_deviceList[index].setDeviceName(list[i].fileName().toLocal8Bit());   // 更新disk数据
-            }
-        }
-    }
+    // model & capacity only change along with udev block events
+    bool refresh = m_diskGeneration != m_stats->diskGeneration();
+    m_diskGeneration = m_stats->diskGeneration();
+
+    QWriteLocker lock(&m_rwlock);
 
-    //获取虚拟磁盘
-    for (int i = 0; i < list.size(); ++i) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QString t_link = list.at(i).readLink();
-#else
-        QString t_link = list.at(i).readSymLink();
-#endif
-        if (list[i].fileName() != "." && list[i].fileName() != ".." && !list[i].fileName().contains("ram") && !list[i].fileName().contains("loop") && t_link.contains("virtual")) {
-            int index = -1;
-            //  查找当前的device是否存在
-            for (int si = 0; si < m_deviceList.size(); ++si) {
-                if (m_deviceList[si].deviceName() == list[i].fileName().toLocal8Bit()) {   // 存在
-                    index = si;
-                    break;
-                }
+    QHash<QByteArray, int> rows;
+    for (int i = 0; i < m_deviceList.size(); ++i)
+        rows.insert(m_deviceList[i].deviceName(), i);
+    QVector<bool> found(m_deviceList.size(), false);
+
+    //获取实体磁盘, 再获取虚拟磁盘
+    for (bool virtualDisk : {false, true}) {
+        for (const auto &stat : m_stats->stats()) {
+            if (!stat.whole_disk || stat.virtual_disk != virtualDisk
+                    || strstr(stat.name, "ram") || strstr(stat.name, "loop")) {
+                continue;
             }
-            if (index == -1) {   // 不存在的话将该disk存储起来
+
+            auto row = rows.constFind(QByteArray::fromRawData(stat.name, int(strlen(stat.name))));
+            if (row == rows.constEnd()) {   // 不存在的话将该disk存储起来
                 BlockDevice bd;
-                if (bd.readDeviceSize(list[i].fileName()) > 0) {
-                    bd.setDeviceName(list[i].fileName().toLocal8Bit());
+                bd.setDeviceStat(stat);
+                bd.readDeviceAttributes();
+                if (bd.capacity() > 0)
                     m_deviceList << bd;
-                }
             } else {
-                m_deviceList[index].setDeviceName(list[i].fileName().toLocal8Bit());   // 更新disk数据
+                auto &bd = m_deviceList[row.value()];   // 更新disk数据
+                bd.setDeviceStat(stat);
+                if (refresh)
+                    bd.readDeviceAttributes();
+                found[row.value()] = true;
             }
         }
     }
 
-    for (int i = 0; i < m_deviceList.size(); ++i) {
-        bool isFind = false;
-        for (int si = 0; si < list.size(); ++si) {
-            if (list[si].fileName().toLocal8Bit() == m_deviceList[i].deviceName()) {
-                isFind = true;
-                break;
-            }
-        }
-        if (!isFind) {
+    // drop disks gone from /proc/diskstats
+    for (int i = found.size() - 1; i >= 0; --i) {
+        if (!found[i])
             m_deviceList.removeAt(i);
-        }
     }
 }
 
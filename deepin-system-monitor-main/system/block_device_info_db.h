@@ -11,6 +11,8 @@
 #include <QReadWriteLock>
 #include <QList>
 
+#include <memory>
+
 namespace core {
 namespace system {
 
@@ -23,7 +25,10 @@ class DeviceDB;
 class BlockDeviceInfoDB
 {
 public:
-    explicit BlockDeviceInfoDB();
+    /**
+     * @param stats Shared table refreshed by the owner every tick, a private one is used if null
+     */
+    explicit BlockDeviceInfoDB(DiskStatTable *stats = nullptr);
     virtual ~BlockDeviceInfoDB();
 
     QList<BlockDevice> deviceList();
@@ -36,6 +41,11 @@ private:
 private:
     mutable QReadWriteLock m_rwlock;
     QList<BlockDevice> m_deviceList;
+
+    std::unique_ptr<DiskStatTable> m_ownStats;
+    DiskStatTable *m_stats;
+    // whole disk set the device attributes were read against
+    quint64 m_diskGeneration {0};
 };
 
 inline QList<BlockDevice> BlockDeviceInfoDB::deviceList()
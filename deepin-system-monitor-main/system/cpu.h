@@ -8,6 +8,7 @@
 
 #include <QSharedDataPointer>
 
+#include <algorithm>
 #include <memory>
 #include <QDebug>
 
@@ -38,6 +39,66 @@ struct cpu_usage_t {
 using CPUStat = std::shared_ptr<struct cpu_stat_t>;
 using CPUUsage = std::shared_ptr<struct cpu_usage_t>;
 
+// fields of per cpu jiffies, same order as /proc/stat
+enum CPUStatField {
+    kCPUStatUser = 0,
+    kCPUStatNice,
+    kCPUStatSys,
+    kCPUStatIdle,
+    kCPUStatIOWait,
+    kCPUStatHardIRQ,
+    kCPUStatSoftIRQ,
+    kCPUStatSteal,
+    kCPUStatGuest,
+    kCPUStatGuestNice,
+    kCPUStatFieldCount
+};
+
+/**
+ * @brief Total & idle jiffies of n cpus
+ * @param jiffies Field major table, field F of cpu N at F * stride + N, so every pass below runs over contiguous memory
+ */
+inline void cpu_usage_sum(const unsigned long long *jiffies, size_t stride, unsigned long long *total, unsigned long long *idle, int n)
+{
+    std::fill(total, total + n, 0ull);
+    // guest time is accounted in user time already
+    for (int field = kCPUStatUser; field <= kCPUStatSteal; ++field) {
+        const unsigned long long *column = jiffies + field * stride;
+        for (int i = 0; i < n; ++i)
+            total[i] += column[i];
+    }
+
+    const unsigned long long *idleColumn = jiffies + kCPUStatIdle * stride;
+    const unsigned long long *iowaitColumn = jiffies + kCPUStatIOWait * stride;
+    for (int i = 0; i < n; ++i)
+        idle[i] = idleColumn[i] + iowaitColumn[i];
+}
+
+/**
+ * @brief Usage (percent) of n cpus between two reads, usage since boot if there is no last read
+ *
+ * Same as CPUUsageSampleFrame::cpupc, cpus without elapsed jiffies (e.g. offline) give NaN.
+ */
+inline void cpu_usage_percent(const unsigned long long *lastTotal, const unsigned long long *lastIdle,
+                              const unsigned long long *total, const unsigned long long *idle,
+                              qreal *percent, int n)
+{
+    if (!lastTotal || !lastIdle) {
+        for (int i = 0; i < n; ++i)
+            percent[i] = qreal(total[i] - idle[i]) / qreal(total[i]) * 100;
+        return;
+    }
+
+    // signed deltas clamped without branches, the loop stays vectorizable
+    for (int i = 0; i < n; ++i) {
+        long long totald = (long long)(total[i] - lastTotal[i]);
+        long long idled = (long long)(idle[i] - lastIdle[i]);
+        totald = totald > 0 ? totald : 0;
+        idled = idled > 0 ? idled : 0;
+        percent[i] = qreal(totald - idled) / qreal(totald) * 100;
+    }
+}
+
 class CPUSet;
 class CPUInfoPrivate;
 
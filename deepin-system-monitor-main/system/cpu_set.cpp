@@ -459,23 +459,99 @@ const CPUStat CPUSet::stat() const
 
 QList<QByteArray> CPUSet::cpuLogicName() const
 {
-    return d->m_usageDB.keys();
+    QList<QByteArray> names;
+    for (int i = 0; i < d->m_ncpus; ++i) {
+        if (d->m_cpuOnline[size_t(i)])
+            names << QByteArray("cpu").append(QByteArray::number(i));
+    }
+    return names;
 }
 
 const CPUStat CPUSet::statDB(const QByteArray &cpu) const
 {
-    return d->m_statDB[cpu];
+    auto stat = std::make_shared<struct cpu_stat_t>();
+    int index = cpuIndex(cpu);
+    if (index < 0)
+        return stat;
+
+    stat->cpu = cpu;
+    stat->user = cpuJiffies(index, kCPUStatUser);
+    stat->nice = cpuJiffies(index, kCPUStatNice);
+    stat->sys = cpuJiffies(index, kCPUStatSys);
+    stat->idle = cpuJiffies(index, kCPUStatIdle);
+    stat->iowait = cpuJiffies(index, kCPUStatIOWait);
+    stat->hardirq = cpuJiffies(index, kCPUStatHardIRQ);
+    stat->softirq = cpuJiffies(index, kCPUStatSoftIRQ);
+    stat->steal = cpuJiffies(index, kCPUStatSteal);
+    stat->guest = cpuJiffies(index, kCPUStatGuest);
+    stat->guest_nice = cpuJiffies(index, kCPUStatGuestNice);
+    return stat;
 }
 
 const CPUUsage CPUSet::usageDB(const QByteArray &cpu) const
 {
-    return d->m_usageDB[cpu];
+    auto usage = std::make_shared<struct cpu_usage_t>();
+    int index = cpuIndex(cpu);
+    if (index < 0)
+        return usage;
+
+    usage->cpu = cpu;
+    usage->total = d->m_cpuTotal[size_t(index)];
+    usage->idle = d->m_cpuIdle[size_t(index)];
+    return usage;
+}
+
+int CPUSet::cpuStatCount() const
+{
+    return d->m_ncpus;
+}
+
+bool CPUSet::cpuOnline(int index) const
+{
+    return index >= 0 && index < d->m_ncpus && d->m_cpuOnline[size_t(index)];
+}
+
+unsigned long long CPUSet::cpuJiffies(int index, CPUStatField field) const
+{
+    if (index < 0 || index >= d->m_ncpus)
+        return 0;
+    return d->m_jiffies[kCurrentStat][size_t(field) * size_t(d->m_stride) + size_t(index)];
+}
+
+const unsigned long long *CPUSet::cpuUsageTotals() const
+{
+    return d->m_cpuTotal.data();
+}
+
+const unsigned long long *CPUSet::cpuUsageIdles() const
+{
+    return d->m_cpuIdle.data();
+}
+
+int CPUSet::cpuIndex(const QByteArray &cpu) const
+{
+    if (!cpu.startsWith("cpu"))
+        return -1;
+
+    bool ok = false;
+    int index = cpu.mid(3).toInt(&ok);
+    return ok && cpuOnline(index) ? index : -1;
 }
 
 void CPUSet::update()
 {
     read_stats();
-    read_overall_info();
+
+    if (!d->m_hotplug) {
+        d->m_hotplug = std::make_shared<CPUHotplugMonitor>();
+        d->m_freq = std::make_shared<CPUFreqReader>();
+    }
+    // topology & identity only change when cpus are hotplugged, the frequency is sampled every update
+    if (d->m_hotplug->changed()) {
+        read_overall_info();
+        d->m_freq->openFiles();
+    }
+    read_cur_freq();
 
     d->cpusageTotal[kLastStat] = d->cpusageTotal[kCurrentStat];
     d->cpusageTotal[kCurrentStat] = d->m_usage->total;
@@ -495,6 +571,10 @@ void CPUSet::read_stats()
     }   // ::if(fopen)
     fPtr.reset(fp);
 
+    // last read becomes the previous one, rows are overwritten in place
+    d->m_jiffies[kLastStat].swap(d->m_jiffies[kCurrentStat]);
+    std::fill(d->m_cpuOnline.begin(), d->m_cpuOnline.end(), 0);
+
     while (fgets(line.data(), BUFSIZ, fp)) {
         if (!strncmp(line.data(), "cpu ", 4)) {
             if (!d->m_stat) {
@@ -536,43 +616,35 @@ void CPUSet::read_stats()
             }   // ::if(m_stat)
         } else if (!strncmp(line.data(), "cpu", 3)) {
             // per cpu stat in jiffies
-            auto stat = std::make_shared<struct cpu_stat_t>();
-            if (stat) {
-                *stat = {};
-
-                nr = sscanf(line.data() + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                            &ncpu,
-                            &stat->user,
-                            &stat->nice,
-                            &stat->sys,
-                            &stat->idle,
-                            &stat->iowait,
-                            &stat->hardirq,
-                            &stat->softirq,
-                            &stat->steal,
-                            &stat->guest,
-                            &stat->guest_nice);
-
-                if (nr == 11) {
-                    QByteArray cpu { "cpu" };
-                    cpu.append(QByteArray::number(ncpu));
-                    stat->cpu = cpu;
-
-                    // usage calc
-                    auto usage = std::make_shared<struct cpu_usage_t>();
-                    if (usage) {
-                        *usage = {};
-                        usage->cpu = cpu;
-                        usage->total = stat->user + stat->nice + stat->sys + stat->idle + stat->iowait + stat->hardirq + stat->softirq + stat->steal;
-                        usage->idle = stat->idle + stat->iowait;
-
-                        d->m_statDB[stat->cpu] = stat;
-                        d->m_usageDB[usage->cpu] = usage;
-                    }   //::if(usage)
-
-                } else
-                    print_errno(errno, QString("read %1 failed, cpu%2").arg(PROC_PATH_STAT).arg(ncpu));
-            }   // ::if(stat)
+            char *end = nullptr;
+            ncpu = int(strtol(line.data() + 3, &end, 10));
+            if (end == line.data() + 3 || ncpu < 0) {
+                print_errno(errno, QString("read %1 failed, cpu").arg(PROC_PATH_STAT));
+                continue;
+            }
+            if (ncpu >= d->m_ncpus)
+                resize_stats(ncpu + 1);
+
+            unsigned long long row[kCPUStatFieldCount] {};
+            nr = sscanf(end, "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+                        &row[kCPUStatUser],
+                        &row[kCPUStatNice],
+                        &row[kCPUStatSys],
+                        &row[kCPUStatIdle],
+                        &row[kCPUStatIOWait],
+                        &row[kCPUStatHardIRQ],
+                        &row[kCPUStatSoftIRQ],
+                        &row[kCPUStatSteal],
+                        &row[kCPUStatGuest],
+                        &row[kCPUStatGuestNice]);
+
+            if (nr == kCPUStatFieldCount) {
+                unsigned long long *jiffies = d->m_jiffies[kCurrentStat].data();
+                for (int field = 0; field < kCPUStatFieldCount; ++field)
+                    jiffies[size_t(field) * size_t(d->m_stride) + size_t(ncpu)] = row[field];
+                d->m_cpuOnline[size_t(ncpu)] = 1;
+            } else
+                print_errno(errno, QString("read %1 failed, cpu%2").arg(PROC_PATH_STAT).arg(ncpu));
         } else if (!strncmp(line.data(), "btime", 5)) {
             // read boot time in seconds since epoch
             struct timeval btime
@@ -593,16 +665,48 @@ void CPUSet::read_stats()
 
     if (ferror(fp))
         print_errno(errno, QString("read %1 failed").arg(PROC_PATH_STAT));
+
+    // offline cpus keep their last jiffies
+    for (int i = 0; i < d->m_ncpus; ++i) {
+        if (d->m_cpuOnline[size_t(i)])
+            continue;
+        for (int field = 0; field < kCPUStatFieldCount; ++field) {
+            size_t pos = size_t(field) * size_t(d->m_stride) + size_t(i);
+            d->m_jiffies[kCurrentStat][pos] = d->m_jiffies[kLastStat][pos];
+        }
+    }
+    cpu_usage_sum(d->m_jiffies[kCurrentStat].data(), size_t(d->m_stride), d->m_cpuTotal.data(), d->m_cpuIdle.data(), d->m_ncpus);
+}
+
+void CPUSet::resize_stats(int ncpus)
+{
+    // field major, columns move when the stride grows; grow by doubling, the first read adds cpus one by one
+    if (ncpus > d->m_stride) {
+        int stride = std::max(ncpus, d->m_stride * 2);
+        for (auto &jiffies : d->m_jiffies) {
+            std::vector<unsigned long long> table(size_t(stride) * kCPUStatFieldCount, 0);
+            for (int field = 0; field < kCPUStatFieldCount && !jiffies.empty(); ++field)
+                std::copy_n(jiffies.begin() + field * d->m_stride, d->m_ncpus, table.begin() + field * stride);
+            jiffies.swap(table);
+        }
+        d->m_stride = stride;
+    }
+    d->m_ncpus = ncpus;
+    d->m_cpuTotal.resize(size_t(ncpus), 0);
+    d->m_cpuIdle.resize(size_t(ncpus), 0);
+    d->m_cpuOnline.resize(size_t(ncpus), 0);
 }
 
 void CPUSet::read_overall_info()
 {
     //proc/cpuinfo
     QList<CPUInfo> infos;
-    QProcess process;
-    process.start("cat /proc/cpuinfo");
-    process.waitForFinished(3000);
-    QString cpuinfo = process.readAllStandardOutput();
+    QFile file(PROC_PATH_CPUINFO);
+    QString cpuinfo;
+    if (file.open(QIODevice::ReadOnly))
+        cpuinfo = file.readAll();
+    else
+        print_errno(errno, QString("open %1 failed").arg(PROC_PATH_CPUINFO));
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     QStringList processors = cpuinfo.split("\n\n", QString::SkipEmptyParts);
 #else
@@ -1055,6 +1159,17 @@ void CPUSet::read_lscpu()
     lscpu_free_context(cxt);
 }
 
+void CPUSet::read_cur_freq()
+{
+    // lscpu reports the nominal frequency on Kunpeng, there's nothing to sample
+    if (d->m_info.value("Model name").contains("Kunpeng"))
+        return;
+
+    double mhz = d->m_freq->maxCurFreq();
+    if (mhz > 0)
+        d->m_info["CPU MHz"] = QString::number(mhz, 'f', 4);
+}
+
 qulonglong CPUSet::getUsageTotalDelta() const
 {
     if (d->cpusageTotal[kCurrentStat] <= d->cpusageTotal[kLastStat])
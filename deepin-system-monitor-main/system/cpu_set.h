@@ -68,11 +68,37 @@ public://usage
 
     qulonglong getUsageTotalDelta() const;
 
+public://per cpu tables, cpu N at index N
+    /**
+     * @brief cpuStatCount 每CPU数据的个数, 即最大逻辑CPU编号 + 1
+     */
+    int cpuStatCount() const;
+
+    bool cpuOnline(int index) const;
+
+    /**
+     * @brief cpuJiffies 当前读取的CPU jiffies
+     */
+    unsigned long long cpuJiffies(int index, CPUStatField field) const;
+
+    /**
+     * @brief cpuUsageTotals 当前读取的每CPU总jiffies, cpuStatCount()个值
+     */
+    const unsigned long long *cpuUsageTotals() const;
+
+    /**
+     * @brief cpuUsageIdles 当前读取的每CPU空闲jiffies, cpuStatCount()个值
+     */
+    const unsigned long long *cpuUsageIdles() const;
+
 public:
     void update();
 
 private:
     void read_stats();
+    void resize_stats(int ncpus);
+    // "cpuN" => N, -1 if not an online cpu
+    int cpuIndex(const QByteArray &cpu) const;
     /**
      * @brief read_dmidecode 通过dmidecod读取CPU的cache信息
      */
@@ -82,6 +108,10 @@ private:
      */
     void read_lscpu();
     void read_overall_info();
+    /**
+     * @brief read_cur_freq 读取cpufreq当前频率, 各CPU中的最大值
+     */
+    void read_cur_freq();
 
 private:
     QSharedDataPointer<CPUSetPrivate> d;
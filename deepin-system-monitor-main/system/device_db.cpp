@@ -24,11 +24,12 @@ namespace system {
 
 DeviceDB::DeviceDB()
 {
+    m_diskStats = new DiskStatTable();
     m_cpuSet = new CPUSet();
     m_memInfo = new MemInfo();
     m_netifInfoDB = new NetifInfoDB();
-    m_blkDevInfoDB = new BlockDeviceInfoDB();
-    m_diskIoInfo = new DiskIOInfo();
+    m_blkDevInfoDB = new BlockDeviceInfoDB(m_diskStats);
+    m_diskIoInfo = new DiskIOInfo(m_diskStats);
     m_netInfo = new NetInfo();
 }
 
@@ -58,12 +59,17 @@ DeviceDB::~DeviceDB()
         delete m_netInfo;
         m_netInfo  = nullptr;
     }
+    if (m_diskStats) {
+        delete m_diskStats;
+        m_diskStats  = nullptr;
+    }
 }
 
 void DeviceDB::update()
 {
     m_cpuSet->update();
     m_memInfo->readMemInfo();
+    m_diskStats->update();
     m_netifInfoDB->update();
     m_blkDevInfoDB->update();
     m_diskIoInfo->update();
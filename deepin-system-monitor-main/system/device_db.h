@@ -15,6 +15,7 @@ class MemInfo;
 class CPUSet;
 class SystemMonitor;
 class DiskIOInfo;
+class DiskStatTable;
 class NetInfo;
 
 /**
@@ -43,6 +44,8 @@ private:
     NetifInfoDB *m_netifInfoDB;
     BlockDeviceInfoDB *m_blkDevInfoDB;
     DiskIOInfo *m_diskIoInfo;
+    // /proc/diskstats table shared by m_diskIoInfo & m_blkDevInfoDB, read once per update
+    DiskStatTable *m_diskStats;
     NetInfo *m_netInfo;
 };
 
@@ -5,138 +5,311 @@
 
 #include "diskio_info.h"
 #include "common/common.h"
+#include "process/proc_reader.h"
 #include "system/sys_info.h"
 
 #include <ctype.h>
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <sched.h>
+#include <string.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
 
-#include <QScopedArrayPointer>
+#include <libudev.h>
 
 using namespace common::error;
 using namespace common::alloc;
+using namespace core::process;
 
 namespace core {
 namespace system {
 
-#define MAX_NAME_LEN 128
 #define PROC_PATH_DISK      "/proc/diskstats"
 #define SYSFS_PATH_BLOCK    "/sys/block"
 
-DiskIOInfo::DiskIOInfo()
+// m_disks flags
+#define DISK_FLAG_WHOLE     0x1
+#define DISK_FLAG_VIRTUAL   0x2
+
+// initial read buffer, grown when the file doesn't fit
+#define DISKSTATS_BUFFER_SIZE 8192
+
+DiskStatTable::DiskStatTable(bool watchUdev)
 {
+    if (!watchUdev)
+        return;
 
+    m_udev = udev_new();
+    if (m_udev)
+        m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+    if (m_monitor
+            && (udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "block", nullptr) < 0
+                || udev_monitor_enable_receiving(m_monitor) < 0)) {
+        udev_monitor_unref(m_monitor);
+        m_monitor = nullptr;
+    }
+    // monitor fd is non blocking, events are drained on each update
 }
 
-DiskIOInfo::~DiskIOInfo()
+DiskStatTable::~DiskStatTable()
 {
+    if (m_monitor)
+        udev_monitor_unref(m_monitor);
+    if (m_udev)
+        udev_unref(m_udev);
+    if (m_fd >= 0)
+        close(m_fd);
+}
 
+const disk_stat_t *DiskStatTable::find(dev_t devno) const
+{
+    auto it = m_index.constFind(devno);
+    return it == m_index.constEnd() ? nullptr : &m_stats[size_t(it.value())];
 }
 
-qreal DiskIOInfo::diskIoReadBps()
+const disk_stat_t *DiskStatTable::find(const QByteArray &name) const
 {
-    return m_readBps;
+    for (const auto &stat : m_stats) {
+        if (name == stat.name)
+            return &stat;
+    }
+    return nullptr;
 }
 
-qreal DiskIOInfo::diskIoWriteBps()
+bool DiskStatTable::update()
 {
-    return m_writeBps;
+    if (!readFile())
+        return false;
+
+    if (receiveUdevEvents())
+        m_disks.clear();
+
+    parse(m_buffer.data(), m_length);
+    m_timestamp = SysInfo::instance()->uptime();
+    return true;
 }
 
-void DiskIOInfo::readDiskIOStats()
+bool DiskStatTable::readFile()
 {
-    bool b = false;
-    FILE *fp;
-    const size_t bsiz = 2048;
-    QScopedArrayPointer<char> line(new char[bsiz] {});
-    unsigned int major, minor;
-    char dev_name[MAX_NAME_LEN + 1];
+    if (m_fd < 0) {
+        m_fd = open(PROC_PATH_DISK, O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0) {
+            print_errno(errno, QString("open %1 failed").arg(PROC_PATH_DISK));
+            return false;
+        }
+    }
+    if (m_buffer.empty())
+        m_buffer.resize(DISKSTATS_BUFFER_SIZE);
 
-    // ignore any partition stats here, ref: sysstat#common.c#is_device
-    auto is_block_dev = [ = ](char *dev_name) -> bool {
-        char syspath[PATH_MAX];
-        char *slash;
-
-        // replace any '/' characters in device names if any
-        while ((slash = strchr(dev_name, '/')))
-        {
-            *slash = '!';
+    size_t total = 0;
+    for (;;) {
+        if (total + 1 >= m_buffer.size())
+            m_buffer.resize(m_buffer.size() * 2);
+
+        ssize_t n = pread(m_fd, m_buffer.data() + total, m_buffer.size() - total - 1, off_t(total));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            print_errno(errno, QString("read %1 failed").arg(PROC_PATH_DISK));
+            close(m_fd);
+            m_fd = -1;
+            return false;
         }
+        if (n == 0)
+            break;
+        total += size_t(n);
+    }
+    m_buffer[total] = '\0';
+    m_length = total;
+    return true;
+}
 
-        snprintf(syspath, sizeof(syspath), "%s/%s", SYSFS_PATH_BLOCK, dev_name);
-        return (!access(syspath, F_OK));
-    };
+bool DiskStatTable::receiveUdevEvents()
+{
+    if (!m_monitor)
+        return false;
 
-    if ((fp = fopen(PROC_PATH_DISK, "r")) == nullptr) {
-        print_errno(errno, QString("open %1 failed").arg(PROC_PATH_DISK));
-        return;
+    bool changed = false;
+    while (auto *device = udev_monitor_receive_device(m_monitor)) {
+        udev_device_unref(device);
+        changed = true;
     }
+    return changed;
+}
 
-    timevalList[kLastStat] = timevalList[kCurrentStat];
-    m_diskIoStatMap[kLastStat].clear();
-    m_diskIoStatMap[kLastStat] = m_diskIoStatMap[kCurrentStat];
-    m_diskIoStatMap[kCurrentStat].clear();
-
-    while (fgets(line.data(), bsiz, fp)) {
-        int rc;
-        auto stat = std::make_shared<disk_io_stat>();
-        //************************1**2**3****4********5********6*******7********************8********9**
-        rc = sscanf(line.data(), "%u %u %128s %llu %*u %llu %*u %llu %*u %llu %*u %*u %*u %*u %llu %*u %llu",
-                    &major,
-                    &minor,
-                    dev_name,
-                    &stat->read_ios,
-                    &stat->read_sectors,
-                    &stat->write_ios,
-                    &stat->write_sectors,
-                    &stat->discard_ios,
-                    &stat->discard_sectors);
-        // discard io stats might not be available
-        if (rc >= 7) {
-            if (is_block_dev(dev_name)) {
-                // per block dev stats
-                timevalList[kCurrentStat] = SysInfo::instance()->uptime();
-                m_diskIoStatMap[kCurrentStat][dev_name] = stat;
-                b = true;
+void DiskStatTable::parse(const char *buf, size_t len)
+{
+    m_stats.clear();
+    m_index.clear();
+
+    bool unknown = false;
+    const char *end = buf + len;
+    const char *p = buf;
+    while (p < end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', size_t(end - p)));
+        if (!eol)
+            eol = end;
+
+        //*****1*****2*****3****4********5*********6**********7****8*********9**********10***********11-14****15**********16****17
+        // major minor name read_ios read_merges read_sectors * write_ios write_merges write_sectors *     discard_ios * discard_sectors
+        disk_stat_t stat {};
+        unsigned int major = 0, minor = 0;
+        const char *q = scan::parseUnsigned(p, eol, &major);
+        q = scan::parseUnsigned(q, eol, &minor);
+        q = scan::skipSpaces(q, eol);
+        const char *name = q;
+        q = scan::skipField(q, eol);
+        if (q) {
+            size_t nlen = size_t(q - name) < DISK_NAME_LEN ? size_t(q - name) : DISK_NAME_LEN;
+            memcpy(stat.name, name, nlen);
+            stat.name[nlen] = '\0';
+        }
+        q = scan::parseUnsigned(q, eol, &stat.read_ios);
+        q = scan::parseUnsigned(q, eol, &stat.read_merges);
+        q = scan::parseUnsigned(q, eol, &stat.read_sectors);
+        q = scan::skipField(q, eol);
+        q = scan::parseUnsigned(q, eol, &stat.write_ios);
+        q = scan::parseUnsigned(q, eol, &stat.write_merges);
+        q = scan::parseUnsigned(q, eol, &stat.write_sectors);
+        if (q) {
+            // discard io stats might not be available
+            const char *r = scan::skipFields(q, eol, 4);
+            r = scan::parseUnsigned(r, eol, &stat.discard_ios);
+            r = scan::skipField(r, eol);
+            scan::parseUnsigned(r, eol, &stat.discard_sectors);
+
+            stat.devno = makedev(major, minor);
+            auto flags = m_disks.constFind(stat.devno);
+            if (flags == m_disks.constEnd()) {
+                unknown = true;
+            } else {
+                stat.whole_disk = flags.value() & DISK_FLAG_WHOLE;
+                stat.virtual_disk = flags.value() & DISK_FLAG_VIRTUAL;
             }
+            m_index.insert(stat.devno, int(m_stats.size()));
+            m_stats.push_back(stat);
         }
+
+        p = eol + 1;
     }
-    b = !ferror(fp) && b;
-    fclose(fp);
-    if (!b) {
-        print_errno(errno, QString("read %1 failed").arg(PROC_PATH_DISK));
+
+    if (!unknown)
+        return;
+
+    // new device (or udev event), rebuild the whole disk set & remember every other device as a partition
+    scanDisks();
+    for (auto &stat : m_stats) {
+        int flags = m_disks.value(stat.devno, 0);
+        stat.whole_disk = flags & DISK_FLAG_WHOLE;
+        stat.virtual_disk = flags & DISK_FLAG_VIRTUAL;
+        m_disks.insert(stat.devno, flags);
     }
 }
 
-void DiskIOInfo::calDiskIoStates()
+void DiskStatTable::scanDisks()
 {
-    qulonglong cur_read_sectors = 0;
-    qulonglong cur_write_sectors = 0;
-    qulonglong cur_discard_sectors = 0;
-    timeval cur_time = timevalList[kCurrentStat];;
+    m_disks.clear();
+    ++m_diskGeneration;
 
-    qulonglong prev_read_sectors = 0;
-    qulonglong prev_write_sectors = 0;
-    qulonglong prev_discard_sectors = 0;
-    timeval prev_time = timevalList[kLastStat];
+    DIR *dir = opendir(SYSFS_PATH_BLOCK);
+    if (!dir) {
+        print_errno(errno, QString("open %1 failed").arg(SYSFS_PATH_BLOCK));
+        return;
+    }
 
-    for (auto iter = m_diskIoStatMap[kCurrentStat].begin(); iter != m_diskIoStatMap[kCurrentStat].end(); iter++) {
-        auto disk_io_iter = iter.value();
-        if (disk_io_iter) {
-            cur_read_sectors += disk_io_iter->read_sectors;
-            cur_write_sectors += disk_io_iter->write_sectors;
-            cur_discard_sectors += disk_io_iter->discard_sectors;
+    char path[PATH_MAX];
+    char buf[PATH_MAX];
+    while (struct dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s/dev", SYSFS_PATH_BLOCK, entry->d_name);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (n <= 0)
+            continue;
+        buf[n] = '\0';
+
+        // maj:min
+        unsigned int major = 0, minor = 0;
+        const char *p = scan::parseUnsigned(buf, buf + n, &major);
+        if (!p || *p != ':' || !scan::parseUnsigned(p + 1, buf + n, &minor))
+            continue;
+
+        int flags = DISK_FLAG_WHOLE;
+        snprintf(path, sizeof(path), "%s/%s", SYSFS_PATH_BLOCK, entry->d_name);
+        n = readlink(path, buf, sizeof(buf) - 1);
+        if (n > 0) {
+            buf[n] = '\0';
+            if (strstr(buf, "/virtual/"))
+                flags |= DISK_FLAG_VIRTUAL;
         }
+        m_disks.insert(makedev(major, minor), flags);
     }
+    closedir(dir);
+}
 
-    for (auto iter = m_diskIoStatMap[kLastStat].begin(); iter != m_diskIoStatMap[kLastStat].end(); iter++) {
-        auto disk_io_iter = iter.value();
-        if (disk_io_iter) {
-            prev_read_sectors += disk_io_iter->read_sectors;
-            prev_write_sectors += disk_io_iter->write_sectors;
-            prev_discard_sectors += disk_io_iter->discard_sectors;
-        }
+DiskIOInfo::DiskIOInfo(DiskStatTable *stats)
+    : m_ownStats(stats ? nullptr : new DiskStatTable())
+    , m_stats(stats ? stats : m_ownStats.get())
+{
+
+}
+
+DiskIOInfo::~DiskIOInfo()
+{
+
+}
+
+qreal DiskIOInfo::diskIoReadBps()
+{
+    return m_readBps;
+}
+
+qreal DiskIOInfo::diskIoWriteBps()
+{
+    return m_writeBps;
+}
+
+void DiskIOInfo::readDiskIOStats()
+{
+    timevalList[kLastStat] = timevalList[kCurrentStat];
+    m_diskIoStat[kLastStat] = m_diskIoStat[kCurrentStat];
+    m_diskIoStat[kCurrentStat] = {};
+
+    // ignore any partition stats here, ref: sysstat#common.c#is_device
+    auto &total = m_diskIoStat[kCurrentStat];
+    for (const auto &stat : m_stats->stats()) {
+        if (!stat.whole_disk)
+            continue;
+        total.read_ios += stat.read_ios;
+        total.read_sectors += stat.read_sectors;
+        total.write_ios += stat.write_ios;
+        total.write_sectors += stat.write_sectors;
+        total.discard_ios += stat.discard_ios;
+        total.discard_sectors += stat.discard_sectors;
     }
+    total.total_ios = total.read_ios + total.write_ios + total.discard_ios;
+    timevalList[kCurrentStat] = m_stats->timestamp();
+}
+
+void DiskIOInfo::calDiskIoStates()
+{
+    qulonglong cur_read_sectors = m_diskIoStat[kCurrentStat].read_sectors;
+    qulonglong cur_write_sectors = m_diskIoStat[kCurrentStat].write_sectors;
+    qulonglong cur_discard_sectors = m_diskIoStat[kCurrentStat].discard_sectors;
+    timeval cur_time = timevalList[kCurrentStat];;
+
+    qulonglong prev_read_sectors = m_diskIoStat[kLastStat].read_sectors;
+    qulonglong prev_write_sectors = m_diskIoStat[kLastStat].write_sectors;
+    qulonglong prev_discard_sectors = m_diskIoStat[kLastStat].discard_sectors;
+    timeval prev_time = timevalList[kLastStat];
 
     // read increment between interval
     auto rdiff = (cur_read_sectors > prev_read_sectors) ? (cur_read_sectors - prev_read_sectors) : 0;
@@ -159,6 +332,9 @@ void DiskIOInfo::calDiskIoStates()
 
 void DiskIOInfo::update()
 {
+    if (m_ownStats && !m_ownStats->update())
+        return;
+
     readDiskIOStats();
 
     calDiskIoStates();
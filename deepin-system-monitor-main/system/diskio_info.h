@@ -6,12 +6,113 @@
 #ifndef DISKIO_INFO_H
 #define DISKIO_INFO_H
 
+#include <QByteArray>
+#include <QHash>
 #include <QMap>
+
 #include <memory>
+#include <vector>
+
+#include <sys/time.h>
+#include <sys/types.h>
+
+struct udev;
+struct udev_monitor;
 
 namespace core {
 namespace system {
 
+#define DISK_NAME_LEN 32
+
+/**
+ * @brief One line of /proc/diskstats
+ */
+struct disk_stat_t {
+    dev_t devno;                            // major:minor
+    char name[DISK_NAME_LEN + 1];           // kernel device name, eg: sda, sda1, nvme0n1
+    bool whole_disk;                        // listed under /sys/block, partitions are not
+    bool virtual_disk;                      // whole disk backed by /sys/devices/virtual, eg: dm-0, loop0
+    unsigned long long read_ios;            // # of reads completed
+    unsigned long long read_merges;         // # of reads merged
+    unsigned long long read_sectors;        // # of sectors read
+    unsigned long long write_ios;           // # of writes completed
+    unsigned long long write_merges;        // # of writes merged
+    unsigned long long write_sectors;       // # of sectors written
+    unsigned long long discard_ios;         // # of discards completed
+    unsigned long long discard_sectors;     // # of sectors discarded
+};
+
+/**
+ * @brief Device indexed /proc/diskstats table, read once per tick & shared by all disk consumers
+ *
+ * The file is read through a kept open fd into a reused buffer and parsed in place. Whether a
+ * device is a whole disk is looked up in a cached major:minor set built from /sys/block, the set
+ * is only rebuilt on udev block events or when a device not seen before shows up.
+ */
+class DiskStatTable
+{
+public:
+    /**
+     * @param watchUdev Subscribe to udev block events, short lived tables skip it
+     */
+    explicit DiskStatTable(bool watchUdev = true);
+    ~DiskStatTable();
+    DiskStatTable(const DiskStatTable &) = delete;
+    DiskStatTable &operator=(const DiskStatTable &) = delete;
+
+    /**
+     * @brief Read /proc/diskstats
+     * @return Return false if the file can't be read, previous table is kept
+     */
+    bool update();
+    /**
+     * @brief Parse diskstats text into the table
+     */
+    void parse(const char *buf, size_t len);
+
+    inline const std::vector<disk_stat_t> &stats() const
+    {
+        return m_stats;
+    }
+    const disk_stat_t *find(dev_t devno) const;
+    const disk_stat_t *find(const QByteArray &name) const;
+    /**
+     * @brief Uptime the table was read at
+     */
+    inline timeval timestamp() const
+    {
+        return m_timestamp;
+    }
+    /**
+     * @brief Bumped whenever the whole disk set is rebuilt, consumers re-read static disk attributes on change
+     */
+    inline quint64 diskGeneration() const
+    {
+        return m_diskGeneration;
+    }
+
+private:
+    bool readFile();
+    bool receiveUdevEvents();
+    void scanDisks();
+
+private:
+    std::vector<disk_stat_t> m_stats;
+    // devno => row in m_stats
+    QHash<dev_t, int> m_index;
+    // devno => whole disk flags of every device seen so far, 0 for partitions
+    QHash<dev_t, int> m_disks;
+    quint64 m_diskGeneration {0};
+    timeval m_timestamp {0, 0};
+
+    int m_fd {-1};
+    std::vector<char> m_buffer;
+    size_t m_length {0};
+
+    struct udev *m_udev {nullptr};
+    struct udev_monitor *m_monitor {nullptr};
+};
+
 struct disk_io_stat {
     unsigned long long total_ios;
     unsigned long long read_ios;            // # of reads completed
@@ -27,7 +128,10 @@ class DiskIOInfo
     enum StatIndex { kLastStat = 0, kCurrentStat = 1, kStatCount = kCurrentStat + 1 };
 
 public:
-    explicit DiskIOInfo();
+    /**
+     * @param stats Shared table refreshed by the owner every tick, a private one is used if null
+     */
+    explicit DiskIOInfo(DiskStatTable *stats = nullptr);
     virtual ~DiskIOInfo();
 
     void update();
@@ -39,7 +143,10 @@ private:
     void calDiskIoStates();
 
 private:
-    QMap<QString, std::shared_ptr<disk_io_stat>> m_diskIoStatMap[kStatCount];
+    std::unique_ptr<DiskStatTable> m_ownStats;
+    DiskStatTable *m_stats;
+    // whole disk totals
+    disk_io_stat m_diskIoStat[kStatCount] {};
     timeval timevalList[kStatCount] = {timeval{0, 0}, timeval{0, 0}};
 
     qreal m_readBps = 0;
@@ -10,8 +10,6 @@
 #include "wireless.h"
 #include "nl_hwaddr.h"
 
-#include <QProcess>
-
 #include <netlink/route/link.h>
 #include <netlink/addr.h>
 #include <linux/sockios.h>
@@ -100,10 +98,23 @@ void NetifInfo::updateLinkInfo(const NLLink *link)
     d->tx_fifo = link->tx_fifo();
     d->tx_carrier = link->tx_carrier();
     d->collisions = link->collisions();
+}
 
-    this->updateWirelessInfo();
-    this->updateBrandInfo();
+void NetifInfo::updateStaticInfo()
+{
     this->updateHWAddr(d->ifname);
+    this->updateWirelessInfo();
+    // wireless speed is the bitrate sampled along with the other wireless stats
+    if (!d->isWireless)
+        this->updateBrandInfo();
+}
+
+void NetifInfo::copyStaticInfo(const NetifInfo &other)
+{
+    d->conn_type = other.d->conn_type;
+    d->brand = other.d->brand;
+    d->isWireless = other.d->isWireless;
+    d->speed = other.d->speed;
 }
 
 void NetifInfo::updateWirelessInfo()
@@ -115,24 +126,8 @@ void NetifInfo::updateWirelessInfo()
         d->iw_info->qual.qual = wireless1.link_quality();
         d->iw_info->qual.level = wireless1.signal_levle();
         d->iw_info->qual.noise = wireless1.noise_level();
-        // 速率
-        //无线网速率ioctl没有提供相关接口，目前采用调用iwlist命令的方式获取 #bug 111694
-        QProcess process;
-        QString cmd = QString("iwlist ") + d.data()->ifname + QString(" rate");
-        process.start(cmd);
-        process.waitForFinished(-1);
-        //获取输出
-        QString data = process.readAllStandardOutput();
-        QStringList datalist = data.trimmed().split(":");
-        if (datalist.size() > 0) {
-            QString speedString = datalist[datalist.size() - 1];
-            float fspeed = 0;
-            QStringList  list = speedString.split(" ");
-            if (list.size() > 0) {
-                fspeed = list[0].toFloat();
-            }
-            d->speed = static_cast<uint>(fspeed);
-        }
+        // 速率, tx bitrate of the associated station (nl80211)
+        d->speed = wireless1.bitrate();
     } else {
         d->isWireless = false;
     }
@@ -143,16 +138,18 @@ void NetifInfo::updateBrandInfo()
     struct ifreq ifr;
     struct ethtool_cmd ecmd;
 
+    if (d->ifname.size() >= IFNAMSIZ)
+        return;
+
     ecmd.cmd = 0x00000001;
     memset(&ifr, 0, sizeof(ifr));
     strcpy(ifr.ifr_name, d->ifname);
 
     ifr.ifr_data = reinterpret_cast<caddr_t>(&ecmd);
-    int fd = socket(PF_INET, SOCK_DGRAM, 0);
-    if (ioctl(fd, SIOCETHTOOL, &ifr) == 0) {
+    int fd = inet_ioctl_socket();
+    if (fd >= 0 && ioctl(fd, SIOCETHTOOL, &ifr) == 0) {
         d->speed   = ecmd.speed;
     }
-    close(fd);
 }
 
 } // namespace system
@@ -151,8 +151,16 @@ protected:
     void updateAddr6Info(const QList<INet6Addr> &addrList);
     void updateHWAddr(const QByteArray ifname);
     void updateLinkInfo(const NLLink *link);
-    void updateWirelessInfo(); // ioctl
-    void updateBrandInfo(); // udev
+    /**
+     * @brief Probe attributes that only change along with the link: hw type, wireless or not, ethtool speed
+     */
+    void updateStaticInfo();
+    /**
+     * @brief Take static attributes probed for the same link earlier
+     */
+    void copyStaticInfo(const NetifInfo &other);
+    void updateWirelessInfo(); // ioctl & nl80211
+    void updateBrandInfo(); // ethtool
 
 private:
     QSharedDataPointer<NetifInfoPrivate> d;
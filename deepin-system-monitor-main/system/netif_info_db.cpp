@@ -23,6 +23,7 @@ namespace system {
 NetifInfoDB::NetifInfoDB()
     : m_netlink(new Netlink())
 {
+    m_linkWatcher.subscribe();
 }
 
 void NetifInfoDB::update_addr()
@@ -62,6 +63,12 @@ void NetifInfoDB::update_netif_info()
     timevalList[kLastStat] = timevalList[kCurrentStat];
     timevalList[kCurrentStat] = SysInfo::instance()->uptime();
 
+    // without notifications every link is probed each time
+    m_linkWatcher.readEvents();
+    bool probeAll = !m_linkWatcher.isValid() || m_linkWatcher.lost();
+    const QSet<int> &changedLinks = m_linkWatcher.changedLinks();
+    QMap<int, NetifInfoPtr> links;
+
     m_infoDB.clear();
     while (iter.hasNext()) {
         auto it = iter.next();
@@ -71,6 +78,18 @@ void NetifInfoDB::update_netif_info()
         }
         NetifInfoPtr item = std::make_shared<NetifInfo>();
         item->updateLinkInfo(it.get());
+
+        auto cached = m_links.value(item->index());
+        if (!probeAll && cached && !changedLinks.contains(item->index()) && cached->ifname() == item->ifname()) {
+            item->copyStaticInfo(*cached);
+            // signal & bitrate change all the time
+            if (item->isWireless())
+                item->updateWirelessInfo();
+        } else {
+            item->updateStaticInfo();
+        }
+        links.insert(item->index(), item);
+
         item->updateAddr4Info(m_addrIpv4DB.values(it->ifindex()));
         item->updateAddr6Info(m_addrIpv6DB.values(it->ifindex()));
 
@@ -96,6 +115,7 @@ void NetifInfoDB::update_netif_info()
 
         m_infoDB.insert(it->addr(), item);
     }
+    m_links.swap(links);
 }
 void NetifInfoDB::update()
 {
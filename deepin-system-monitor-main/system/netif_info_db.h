@@ -47,6 +47,11 @@ private:
 
     QMap<QByteArray, NetifInfoPtr> m_infoDB;
 
+    // link changes, static attributes of a link are probed again only when it changed
+    NetlinkWatcher m_linkWatcher;
+    // ifindex - interface of the last update
+    QMap<int, NetifInfoPtr> m_links;
+
     QMap<ino_t, SockIOStat> m_sockIOStatMap;
 
 
@@ -8,12 +8,20 @@
 #include "netif_monitor_thread.h"
 
 #include <QTimerEvent>
+#include <QElapsedTimer>
 #include <QDebug>
 
+#define PACKET_RING_CAPACITY 16384   // pending attributed packets between capture & consumer
+#define PACKET_RING_BATCH 256   // packets popped from ring in a batch
+#define PACKET_RING_IDLE_WAIT 50   // consumer wait while ring is empty, bounds a missed wakeup (50 ms)
+#define SOCKIOSTAT_PUBLISH_INTERVAL 100   // snapshot publish interval (100 ms)
+#define SOCKIOSTAT_PRUNE_INTERVAL 60000   // idle socket counters prune interval (60 seconds)
+
 namespace core {
 namespace system {
 NetifMonitor::NetifMonitor(QObject *parent)
     : QObject(parent)
+    , m_packetRing(PACKET_RING_CAPACITY)
 {
     // packet monitor job
     m_netifCapture = new NetifPacketCapture(this);
@@ -45,56 +53,114 @@ void NetifMonitor::startNetmonitorJob()
 
 void NetifMonitor::handleNetData()
 {
+    struct packet_record_t batch[PACKET_RING_BATCH];
+    // snapshot the last idle socket prune compared against
+    std::shared_ptr<const SockIOStatTable> pruneBase;
+    bool dirty = false;
+
+    QElapsedTimer publishTimer;
+    publishTimer.start();
+    QElapsedTimer pruneTimer;
+    pruneTimer.start();
+
     while (!m_quitRequested.load()) {
-        m_pktqLock.lock();      // +++m_pktqLock+++
-        // packets available for processing when pending queue mutex unlocked
-        m_pktqWatcher.wait(&m_pktqLock);
-
-        // check if quit requested again after wakeup by another thread, break the loop if need
-        if (m_quitRequested.load())
-            break;
-
-        // append pending queue packets to local queue, so we dont lock the mutex for too long
-        m_localPendingPackets.append(m_pendingPackets);
-        m_pendingPackets.clear();
-        m_pktqLock.unlock();    // ---m_pktqLock---
-
-        // process payload queue
-        while (!m_localPendingPackets.isEmpty()) {
-            auto payload = m_localPendingPackets.dequeue();
-
-            // lock sockiostatmap
-            m_sockIOStatMapLock.lock();     // +++m_sockIOStatMapLock+++
-
-            // sum up sock io stat by inode
-            auto ino = payload->ino;
-            if (m_sockIOStatMap.contains(ino)) {
-                // sum up sock io stat if already exists with same inode stat
-                auto &hist = m_sockIOStatMap[ino];
-                if (payload->direction == kInboundPacket) {
-                    hist->rx_bytes += payload->payload;
-                    hist->rx_packets++;
-                } else if (payload->direction == kOutboundPacket) {
-                    hist->tx_bytes += (payload->payload * 2);
-                    hist->tx_packets++;
-                }
-            } else {
-                // add new sock io stat if sock ino no exists in cache before
-                auto stat = QSharedPointer<struct sock_io_stat_t>::create();
-                stat->ino = payload->ino;
-                if (payload->direction == kInboundPacket) {
-                    stat->rx_bytes = payload->payload;
+        if (m_packetRing.empty()) {
+            m_pktqLock.lock();      // +++m_pktqLock+++
+            // producer wakes us without the lock, timed wait covers a wakeup sent right before waiting
+            if (m_packetRing.empty() && !m_quitRequested.load())
+                m_pktqWatcher.wait(&m_pktqLock, PACKET_RING_IDLE_WAIT);
+            m_pktqLock.unlock();    // ---m_pktqLock---
+
+            // check if quit requested again after wakeup by another thread, break the loop if need
+            if (m_quitRequested.load())
+                break;
+        }
+
+        // sum up sock io stat by inode
+        size_t n;
+        while ((n = m_packetRing.pop(batch, PACKET_RING_BATCH)) > 0) {
+            for (size_t i = 0; i < n; ++i) {
+                const auto &pkt = batch[i];
+                auto *stat = m_sockIOStats.insert(pkt.ino);
+                // new or pruned & seen again, readers restart their totals on epoch change
+                if (stat->epoch == 0)
+                    stat->epoch = ++m_sockIOEpoch;
+                if (pkt.direction == kInboundPacket) {
+                    stat->rx_bytes += pkt.payload;
                     stat->rx_packets++;
-                } else if (payload->direction == kOutboundPacket) {
-                    stat->tx_bytes = payload->payload;
+                } else if (pkt.direction == kOutboundPacket) {
+                    // same weighting as before: first packet of a socket counted once, later ones twice
+                    stat->tx_bytes += (stat->rx_packets + stat->tx_packets > 0) ? pkt.payload * 2 : pkt.payload;
                     stat->tx_packets++;
                 }
-                m_sockIOStatMap[stat->ino] = stat;
             }
-            m_sockIOStatMapLock.unlock();   // ---m_sockIOStatMapLock---
+            dirty = true;
+        }
+
+        if (dirty && publishTimer.elapsed() >= SOCKIOSTAT_PUBLISH_INTERVAL) {
+            // drop sockets without any traffic since the last prune, closed ones never come back
+            if (pruneTimer.elapsed() >= SOCKIOSTAT_PRUNE_INTERVAL) {
+                if (pruneBase) {
+                    m_sockIOStats.removeIf([&pruneBase](const struct sock_io_stat_t &stat) {
+                        auto *base = pruneBase->find(stat.ino);
+                        return base && base->rx_packets == stat.rx_packets && base->tx_packets == stat.tx_packets;
+                    });
+                }
+                pruneBase = std::atomic_load(&m_sockIOStatSnapshot);
+                pruneTimer.restart();
+            }
+
+            publishSockIOStats();
+            dirty = false;
+            publishTimer.restart();
         }
     }
 }
 
+void NetifMonitor::publishSockIOStats()
+{
+    // readers keep the old snapshot alive until they drop their reference
+    std::shared_ptr<const SockIOStatTable> snapshot = std::make_shared<SockIOStatTable>(m_sockIOStats);
+    std::atomic_store(&m_sockIOStatSnapshot, snapshot);
+}
+
+bool NetifMonitor::getSockIOStatByInode(ino_t ino, struct sock_io_stat_t &stat)
+{
+    auto snapshot = std::atomic_load(&m_sockIOStatSnapshot);
+    if (!snapshot)
+        return false;
+
+    const auto *total = snapshot->find(ino);
+    if (!total)
+        return false;
+
+    // forget sockets the consumer pruned, keeps the reader table bounded
+    if (m_sockIOConsumed.size() > snapshot->size() * 2 + 64) {
+        m_sockIOConsumed.removeIf([&snapshot](const struct sock_io_stat_t &consumed) {
+            return snapshot->find(consumed.ino) == nullptr;
+        });
+    }
+
+    auto *consumed = m_sockIOConsumed.insert(ino);
+    // counters recreated after the consumer pruned them, totals restarted from zero
+    if (consumed->epoch != total->epoch) {
+        *consumed = {};
+        consumed->ino = ino;
+        consumed->epoch = total->epoch;
+    }
+    // nothing new since the previous read
+    if (consumed->rx_packets == total->rx_packets && consumed->tx_packets == total->tx_packets)
+        return false;
+
+    stat.ino = ino;
+    stat.rx_bytes = total->rx_bytes - consumed->rx_bytes;
+    stat.rx_packets = total->rx_packets - consumed->rx_packets;
+    stat.tx_bytes = total->tx_bytes - consumed->tx_bytes;
+    stat.tx_packets = total->tx_packets - consumed->tx_packets;
+    *consumed = *total;
+
+    return true;
+}
+
 }
 }
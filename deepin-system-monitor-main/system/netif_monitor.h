@@ -7,6 +7,7 @@
 #define NETIF_MONITOR_H
 
 #include "common/time_period.h"
+#include "common/spsc_ring.h"
 #include "netif_packet_capture.h"
 
 #include <QObject>
@@ -15,25 +16,13 @@
 #include <QWaitCondition>
 #include <QThread>
 
+#include <memory>
+
 using namespace common::core;
 
 namespace core {
 namespace system {
 
-/**
- * @brief Network interface socket io stat structure
- */
-struct sock_io_stat_t {
-    ino_t ino; // socket inode
-    qulonglong rx_bytes; // received bytes
-    qulonglong rx_packets; // received packets
-    qulonglong tx_bytes; // sent bytes
-    qulonglong tx_packets; // sent packets
-};
-
-// socket io stat typedef
-using SockIOStat = QSharedPointer<struct sock_io_stat_t>;
-
 class NetifMonitor : public QObject
 {
     Q_OBJECT
@@ -55,60 +44,54 @@ public:
     void handleNetData();
 public:
     /**
-     * @brief Get socket io stat data with specified inode (thread safe accessor)
+     * @brief Get socket io stat data with specified inode
+     *
+     * Reads the last published snapshot without locking, returns the traffic since the previous
+     * read of the same inode. Must only be called from one thread (the process scan thread).
      * @param ino Socket inode
      * @param stat Socket io stat data
-     * @return Return true if stat data found in stat cache, otherwise return false
+     * @return Return true if new traffic found for the inode, otherwise return false
      */
-    inline bool getSockIOStatByInode(ino_t ino, SockIOStat &stat)
-    {
-        bool ok = false;
+    bool getSockIOStatByInode(ino_t ino, struct sock_io_stat_t &stat);
 
-        // lock cache before access
-        m_sockIOStatMapLock.lock();
-
-        // check stat data existence
-        if (m_sockIOStatMap.contains(ino)) {
-            stat = m_sockIOStatMap[ino];
-            // remove stat data from cache
-            m_sockIOStatMap.remove(ino);
-            ok = true;
-        }
-
-        m_sockIOStatMapLock.unlock();
-
-        return ok;
+    /**
+     * @brief Packet capture counters, kernel drops against delivered packets (thread safe accessor)
+     */
+    inline struct capture_stat_t captureStat() const
+    {
+        return m_netifCapture->captureStat();
     }
-    // socket inode to io stat mapping
-    QMap<ino_t, SockIOStat> m_sockIOStatMap     {};
 
 private:
+    /**
+     * @brief Publish a copy of the accumulated counters for readers (consumer thread only)
+     */
+    void publishSockIOStats();
+
     NetifPacketCapture *m_netifCapture;
     // packet monitor thread object
     QThread m_packetMonitorThread;
 
-    // pending packet queue
-    PacketPayloadQueue  m_pendingPackets        {};
-    // pending packet queue locker
+    // attributed packets from capture thread, single producer single consumer
+    SpscRing<struct packet_record_t> m_packetRing;
+    // wakes the consumer once per dispatch batch, never taken on the capture hot path
     QMutex              m_pktqLock              {};
     // packet queue watcher
     QWaitCondition      m_pktqWatcher           {};
-    // local pending packet queue
-    PacketPayloadQueue  m_localPendingPackets   {}; // local cache
 
+    // cumulative socket io counters, owned by the consumer thread
+    SockIOStatTable m_sockIOStats {};
+    // last epoch handed out to a (re)created m_sockIOStats entry, owned by the consumer thread
+    qulonglong m_sockIOEpoch {0};
+    // last published copy of m_sockIOStats, swapped atomically (read-copy-update)
+    std::shared_ptr<const SockIOStatTable> m_sockIOStatSnapshot {};
 
-    // socket io stat map access locker
-    QMutex                  m_sockIOStatMapLock {};
-
-    // packet monitor thread object
-    //QThread             m_packetMonitorThread;
-    // packet monitor job instace
+    // counters already returned to readers, owned by the reader thread
+    SockIOStatTable m_sockIOConsumed {};
 
     // quit atomic test flag
     std::atomic_bool m_quitRequested {false};
 
-
-
     friend void pcap_callback(u_char *, const struct pcap_pkthdr *, const u_char *);
     friend class NetifPacketCapture;
 };
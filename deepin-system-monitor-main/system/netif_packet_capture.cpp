@@ -5,7 +5,6 @@
 #include "ddlog.h"
 #include "netif_packet_capture.h"
 #include "netif_packet_parser.h"
-#include "common/hash.h"
 #include "netif_monitor.h"
 #include <arpa/inet.h>
 #include "device_db.h"
@@ -18,21 +17,25 @@
 #include <ifaddrs.h>
 #include <net/if.h>
 #include <QCoreApplication>
-#include <QProcess>
-#include <QRegularExpression>
-#ifndef IFNAMESZ
-#    define IFNAMESZ 16
-#endif
-
-//#define PACKET_DISPATCH_IDLE_TIME 200 // pcap dispatch interval
-#define PACKET_DISPATCH_IDLE_TIME 50   // pcap dispatch interval
-#define PACKET_DISPATCH_BATCH_COUNT 64   // packets to process in a batch
-#define PACKET_DISPATCH_QUEUE_LWAT 64   // queue low water mark
-#define PACKET_DISPATCH_QUEUE_HWAT 256   // queue high water mark
+#include <QSet>
+#include <QtConcurrent>
+
+#define PACKET_DISPATCH_IDLE_TIME 1000   // maintenance tick while waiting on pcap fd (1 second)
+#define PACKET_DISPATCH_POLL_TIME 50   // pcap dispatch interval if pcap has no selectable fd
+#define PACKET_DISPATCH_BATCH_MIN 64   // min packets to process in a batch
+#define PACKET_DISPATCH_BATCH_MAX 4096   // max packets to process in a batch
+#define PACKET_DISPATCH_MAX_ROUNDS 16   // dispatch calls per wakeup, keeps the event loop responsive
+#define PACKET_CAPTURE_BUFFER_SIZE (4 * 1024 * 1024)   // kernel capture ring size, split into TPACKET_V3 blocks
+#define PACKET_CAPTURE_BLOCK_TIMEOUT 100   // TPACKET_V3 partially filled block retire timeout (100 ms)
+#define PACKET_CAPTURE_SNAPLEN 160   // ethernet + ip/ipv6 (with extension headers) + tcp/udp headers
+#define CAPTURE_STAT_REFRESH_INTERVAL 2   // pcap_stats query interval (2 seconds)
+#define CAPTURE_FILTER_MAX_HOSTS 64   // more local addresses than this, filter on protocol only
 
 #define SOCKSTAT_REFRESH_INTERVAL 2   // socket stat refresh interval (2 seconds)
-#define IFADDRS_HASH_CACHE_REFRESH_INTERVAL 10   // socket ifaddrs cache refresh interval (10 seconds)
-#define DEVICE_CHANGE_JUDGEMENT_TIME 5000   //判断网卡是否变更时间间隔
+#define SOCKDIAG_RESYNC_INTERVAL 30   // sock_diag full dump interval, drops closed sockets destroy notifications missed (30 seconds)
+#define SOCKDIAG_LOOKUP_BUDGET 16   // targeted sock_diag lookups per dispatch batch
+#define IFADDRS_CACHE_REFRESH_INTERVAL 10   // socket ifaddrs cache refresh interval (10 seconds)
+#define NETLINK_CHANGE_SETTLE_TIME 200   // wait for a burst of link & address notifications to settle (200 ms)
 
 using namespace std;
 using namespace DDLog;
@@ -40,212 +43,266 @@ namespace core {
 namespace system {
 
 NetifPacketCapture::NetifPacketCapture(NetifMonitor *netIfmontor, QObject *parent)
-    : QObject(parent), m_netifMonitor(netIfmontor)
+    : QObject(parent), m_netifMonitor(netIfmontor), m_netlink(new Netlink())
 {
     m_timer = new QTimer(this);
     m_timer->setSingleShot(true);
     // dispatch packets on timerout signal
     connect(m_timer, &QTimer::timeout, this, &NetifPacketCapture::dispatchPackets);
-    //设置定时器定时判断是否变更网卡
-    m_timerChangeDev = new QTimer(this);
-    connect(m_timerChangeDev, &QTimer::timeout, this, &NetifPacketCapture::whetherDevChanged);
-    m_timerChangeDev->start(DEVICE_CHANGE_JUDGEMENT_TIME);
+    // refresh captured interfaces once netlink notifications settled
+    m_netlinkSettleTimer = new QTimer(this);
+    m_netlinkSettleTimer->setSingleShot(true);
+    connect(m_netlinkSettleTimer, &QTimer::timeout, this, [this]() {
+        refreshIfAddrsCache();
+        refreshCaptureInterfaces();
+        m_lastIfAddrsRefresh = time(nullptr);
+    });
+    // swap full socket dump in once the worker is done
+    m_sockResyncWatcher = new QFutureWatcher<bool>(this);
+    connect(m_sockResyncWatcher, &QFutureWatcher<bool>::finished, this, &NetifPacketCapture::finishSockStatResync);
 }
 
-void NetifPacketCapture::whetherDevChanged()
+NetifPacketCapture::~NetifPacketCapture()
 {
-    if (m_devName.isEmpty()) {
-        m_changedDev = true;
-        startNetifMonitorJob();
-    } else {
-        QString current_dev = m_devName;
-        getCurrentDevName();
-        //若新增网卡设备优先级高于当前使用网卡设备,则重新开始监测任务
-        if (current_dev.compare(m_devName) != 0) {
-            m_changedDev = true;
-            startNetifMonitorJob();
-        }
-    }
+    // worker is still writing to m_sockStatsNext
+    m_sockResyncWatcher->waitForFinished();
 }
 
-bool NetifPacketCapture::hasDevIP()
+void NetifPacketCapture::startNetifMonitorJob()
 {
-    if (!m_devName.isEmpty()) {
-        return false;
+    stopCapture();
+
+    // link & address changes pushed by the kernel, interfaces are re-checked periodically otherwise
+    if (!m_netlinkNotifier && m_netlinkWatcher.subscribe()) {
+        m_netlinkNotifier = new QSocketNotifier(m_netlinkWatcher.fd(), QSocketNotifier::Read, this);
+        connect(m_netlinkNotifier, &QSocketNotifier::activated, this, &NetifPacketCapture::handleNetlinkEvents);
     }
 
-    struct sockaddr_in *addr {};
-    struct ifreq ifr
-    {
-    };
-    char *address {};
-    int sockfd;
-    //设备名称过长
-    if (m_devName.size() >= IFNAMSIZ) {
-        //qCDebug(app)<<"Device name too long! Invalid device Name!";
-        return false;
+    // binary socket table backend, falls back to parsing /proc/net if unavailable
+    if (!m_sockDiag.open()) {
+        qCDebug(app) << "sock_diag unavailable, using /proc/net socket tables";
+    } else if (!m_sockDestroyNotifier && m_sockDiag.subscribeDestroyed()) {
+        // closed sockets are erased as the kernel reports them, periodic resync catches the rest
+        m_sockDestroyNotifier = new QSocketNotifier(m_sockDiag.eventFd(), QSocketNotifier::Read, this);
+        connect(m_sockDestroyNotifier, &QSocketNotifier::activated, this, &NetifPacketCapture::handleSockDestroyEvents);
     }
 
-    strcpy(ifr.ifr_name, m_devName.toLocal8Bit().data());
-    //创建socket
-    sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    go = true;
+    // local addresses & capture on every interface holding one
+    refreshIfAddrsCache();
+    refreshCaptureInterfaces();
+    m_lastIfAddrsRefresh = time(nullptr);
 
-    //获取网络IP(IPv4)
-    if (ioctl(sockfd, SIOCGIFADDR, &ifr) == -1) {
-        close(sockfd);
-        //qCDebug(app)<<"ioctl error!";
-        return false;
+    m_timer->start();
+}
+
+QMap<int, QByteArray> NetifPacketCapture::captureInterfaces()
+{
+    QMap<int, QByteArray> ifaces;
+
+    // interfaces holding an address see the host's own traffic; slaves of bonds & bridges and
+    // vlan parents carry the same packets again without addresses, skipping them avoids counting twice
+    QSet<int> addressed;
+    AddrIterator addrIter = m_netlink->addrIterator();
+    while (addrIter.hasNext()) {
+        auto addr = addrIter.next();
+        if (addr->family() == AF_INET || addr->family() == AF_INET6)
+            addressed << addr->ifindex();
     }
 
-    addr = (struct sockaddr_in *)&(ifr.ifr_addr);
-    address = inet_ntoa(addr->sin_addr);
-    if (address) {
-        close(sockfd);
-        //cout<<"IP of  "<<m_devName<<" :" <<address;
-        return true;
-    } else {
-        close(sockfd);
-        return false;
+    LinkIterator linkIter = m_netlink->linkIterator();
+    while (linkIter.hasNext()) {
+        auto link = linkIter.next();
+        // loopback traffic never leaves the host
+        if (!(link->flags() & IFF_UP) || (link->flags() & IFF_LOOPBACK))
+            continue;
+        if (addressed.contains(link->ifindex()))
+            ifaces.insert(link->ifindex(), link->ifname());
     }
+
+    return ifaces;
 }
 
-bool NetifPacketCapture::getCurrentDevName()
+void NetifPacketCapture::refreshCaptureInterfaces()
 {
-    QProcess process;
-    process.start("route", QStringList() << "-n");
-    process.waitForFinished(-1);
-    QString output = QString(process.readAllStandardOutput());
-    // 先区分换行符号
-    QStringList outputList = output.split("\n");
-    if (outputList.size() > 0)
-        outputList.removeFirst();
-    QList<QStringList> totalList;
-    foreach (QString tmpList, outputList) {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        QStringList lineList = tmpList.split(QRegExp("\\s{1,}"));
-#else
-        QStringList lineList = tmpList.split(QRegularExpression("\\s{1,}"));
-#endif
-        totalList.append(lineList);
-    }
-    // 设备和优先级列编号
-    int metricColNum = 0;
-    int devColNum = 0;
-    QList<QPair<QString, int>> metricList = {};
-    QString devName = "";
-    if (totalList.size() > 0) {
-        QStringList firstLine = totalList[0];
-        for (int j = 0; j < firstLine.size(); j++) {
-            if (firstLine[j].compare("Metric", Qt::CaseInsensitive) == 0) {
-                metricColNum = j;
-            }
-            if (firstLine[j].compare("Iface", Qt::CaseInsensitive) == 0) {
-                devColNum = j;
-            }
-        }
-    }
+    if (!go)
+        return;
 
-    if (totalList.size() > 0)
-        totalList.removeFirst();
+    auto ifaces = captureInterfaces();
 
-    for (int i = 0; i < totalList.size(); i++) {
-        auto list = totalList[i];
-        if (list.size() > devColNum && list.size() > metricColNum) {
-            // 默认网卡
-            if (!list.isEmpty() && list.first() == "0.0.0.0") {
-                metricList.clear();
-                metricList.append(QPair<QString, int>(list[devColNum], list[metricColNum].toInt()));
-                break;
-            } else {
-                metricList.append(QPair<QString, int>(list[devColNum], list[metricColNum].toInt()));
-            }
-        }
-    }
-    int minMetric = 0;
-    QString perfectDev = "";
-    for (int i = 0; i < metricList.size(); i++) {
-        QPair<QString, int> pair = metricList[i];
-        if (i == 0) {
-            minMetric = pair.second;
-            perfectDev = pair.first;
+    // interfaces gone or renamed
+    for (auto it = m_captures.begin(); it != m_captures.end();) {
+        auto iface = ifaces.find(it->first);
+        if (iface == ifaces.end() || iface.value() != it->second->ifname) {
+            qCDebug(app) << "stop capturing on" << it->second->ifname;
+            closeCapture(it->second);
+            it = m_captures.erase(it);
         } else {
-            if (minMetric > pair.second) {
-                minMetric = pair.second;
-                perfectDev = pair.first;
-            }
+            ++it;
         }
     }
-    m_devName = perfectDev;
 
-    //无可用设备
-    if (m_devName.isEmpty()) {
-        return false;
+    // new interfaces
+    for (auto it = ifaces.constBegin(); it != ifaces.constEnd(); ++it) {
+        if (m_captures.count(it.key()))
+            continue;
+
+        auto capture = openCapture(it.key(), it.value());
+        if (capture) {
+            qCDebug(app) << "start capturing on" << it.value();
+            m_captures[it.key()] = std::move(capture);
+        }
     }
-    return true;
 }
-//
-void NetifPacketCapture::startNetifMonitorJob()
+
+NetifPacketCapture::NetifCapture NetifPacketCapture::openCapture(int ifindex, const QByteArray &ifname)
 {
     int rc = 0;
     char errbuf[PCAP_ERRBUF_SIZE] {};
 
-    getCurrentDevName();
-    if (m_devName.isEmpty()) {
-        return;
-    }
-
     // create pcap handler
-    m_handle = pcap_create(m_devName.toLocal8Bit().data(), errbuf);
-    if (!m_handle) {
+    pcap_t *handle = pcap_create(ifname.constData(), errbuf);
+    if (!handle) {
         qCDebug(app) << "pcap_create failed: " << errbuf;
-        return;
+        return nullptr;
     }
 
-    // pcap_compile crashes everytime without any reason, need researching...
-#if 0
-    char pattern[] = 0111 "TCP and UDP";
-    struct bpf_program pgm;
+    // headers are all the parser reads, payload size is taken from the length on the wire
+    pcap_set_snaplen(handle, PACKET_CAPTURE_SNAPLEN);
 
-    rc = pcap_compile(m_handle, &pgm, pattern, 1, PCAP_NETMASK_UNKNOWN);
-    if (rc == -1) {
-        qCDebug(app) << "pcap_compile failed: " << pcap_geterr(m_handle);
-        pcap_close(m_handle);
-        return;
-    }
-    rc = pcap_setfilter(m_handle, &pgm);
-    if (rc == -1) {
-        qCDebug(app) << "pcap_setfilter failed: " << pcap_geterr(m_handle);
-        pcap_close(m_handle);
-        return;
-    }
-#endif
+    // memory mapped TPACKET_V3 ring: the kernel hands over a block of packets at a time, a block is
+    // retired when full or after the timeout; immediate mode would fall back to per packet wakeups
+    pcap_set_immediate_mode(handle, 0);
+    pcap_set_buffer_size(handle, PACKET_CAPTURE_BUFFER_SIZE);
+    pcap_set_timeout(handle, PACKET_CAPTURE_BLOCK_TIMEOUT);
 
     // activate pcap handler
-    rc = pcap_activate(m_handle);
+    rc = pcap_activate(handle);
     if (rc > 0) {
         qCDebug(app) << "pcap_activate warning: " << pcap_statustostr(rc);
     } else if (rc < 0) {
-        qCDebug(app) << "pcap_setnonblock failed: " << pcap_statustostr(rc);
-        pcap_close(m_handle);
-        return;
+        qCDebug(app) << "pcap_activate failed: " << ifname << pcap_statustostr(rc);
+        pcap_close(handle);
+        return nullptr;
     }
 
-    // setm_timer->start(); non block dispatch mode
-    rc = pcap_setnonblock(m_handle, 1, errbuf);
+    // non block dispatch mode
+    rc = pcap_setnonblock(handle, 1, errbuf);
     if (rc == -1) {
-        pcap_close(m_handle);
+        pcap_close(handle);
+        return nullptr;
+    }
+
+    NetifCapture capture(new netif_capture_t {});
+    capture->ifindex = ifindex;
+    capture->ifname = ifname;
+    capture->handle = handle;
+    capture->linkType = pcap_datalink(handle);
+    capture->batchCount = PACKET_DISPATCH_BATCH_MIN;
+
+    // dispatch when the kernel retires a block, timer polling only if there is no selectable fd
+    int fd = pcap_get_selectable_fd(handle);
+    if (fd >= 0) {
+        capture->notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(capture->notifier, &QSocketNotifier::activated, this, &NetifPacketCapture::dispatchPackets);
+    }
+
+    // in-kernel filter on local addresses
+    if (!applyCaptureFilter(*capture, captureFilter(m_ifaddrs))) {
+        // too many addresses for the bpf program, admit tcp & udp from anywhere
+        applyCaptureFilter(*capture, captureFilter(IfAddrSet()));
+    }
+
+    return capture;
+}
+
+void NetifPacketCapture::closeCapture(NetifCapture &capture)
+{
+    if (!capture)
         return;
+
+    if (capture->notifier) {
+        capture->notifier->setEnabled(false);
+        capture->notifier->deleteLater();
+        capture->notifier = nullptr;
     }
-    go = true;
-    m_timer->start();
+    // keep counters of the closed handle in the totals
+    m_closedStat.kernel_received += capture->stat.ps_recv;
+    m_closedStat.kernel_dropped += capture->stat.ps_drop;
+    m_closedStat.if_dropped += capture->stat.ps_ifdrop;
+    if (capture->handle) {
+        pcap_close(capture->handle);
+        capture->handle = nullptr;
+    }
+    capture.reset();
 }
 
-void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char *packet)
+void NetifPacketCapture::handleNetlinkEvents()
+{
+    if (m_netlinkWatcher.readEvents())
+        m_netlinkSettleTimer->start(NETLINK_CHANGE_SETTLE_TIME);
+}
+
+void NetifPacketCapture::handleSockDestroyEvents()
 {
-    QByteArray fmtbuf;
-    uint64_t hash {}, cchash[2] {};
-    QString pattern {};
+    bool ok = m_sockDiag.readDestroyed([this](const flow_key_t &key, ino_t ino) {
+        // the flow may have been taken over by a new socket meanwhile
+        if (ino == 0 || m_sockStats.find(key) == ino)
+            m_sockStats.remove(key);
+        if (m_sockResyncPending)
+            m_sockResyncLog << sock_resync_op_t {key, ino, true};
+    });
+    // notifications were dropped, only a full dump finds the sockets closed meanwhile
+    if (!ok)
+        startSockStatResync();
+}
 
+void NetifPacketCapture::startSockStatResync()
+{
+    if (m_sockResyncPending)
+        return;
+
+    m_sockResyncPending = true;
+    m_sockResyncLog.clear();
+    m_lastSockStatRefresh = time(nullptr);
+
+    // dump on its own socket, m_sockDiag keeps serving targeted lookups meanwhile
+    SockStatTable *next = &m_sockStatsNext;
+    m_sockResyncWatcher->setFuture(QtConcurrent::run([next]() {
+        SockDiag diag;
+        return diag.open() && diag.dump(*next);
+    }));
+}
+
+void NetifPacketCapture::finishSockStatResync()
+{
+    m_sockResyncPending = false;
+
+    if (!m_sockResyncWatcher->result()) {
+        qCDebug(app) << "sock_diag dump failed, using /proc/net socket tables";
+        delete m_sockDestroyNotifier;
+        m_sockDestroyNotifier = nullptr;
+        m_sockDiag.close();
+        m_sockResyncLog.clear();
+        SysInfo::readSockStat(m_sockStats);
+        return;
+    }
+
+    // lookups & destroy notifications handled after the dump read the kernel tables
+    for (const auto &op : m_sockResyncLog) {
+        if (!op.removed)
+            m_sockStatsNext.insert(op.key, op.ino);
+        else if (op.ino == 0 || m_sockStatsNext.find(op.key) == op.ino)
+            m_sockStatsNext.remove(op.key);
+    }
+    m_sockResyncLog.clear();
+
+    // previous table becomes the next dump target, its slots are reused
+    m_sockStats.swap(m_sockStatsNext);
+}
+
+void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char *packet)
+{
     // packet payload calc
     if (!context)
         return;
@@ -255,192 +312,284 @@ void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char
     Q_ASSERT(netifMonitorJob != nullptr);
     auto *netifMonitor = netifMonitorJob->m_netifMonitor;
     Q_ASSERT(netifMonitor != nullptr);
+    ++netifMonitorJob->m_captureStat.delivered;
 
-    // parse packet & calculate payload
-    PacketPayload payload = QSharedPointer<struct packet_payload_t>::create();
-    auto ok = NetifPacketParser::parsePacket(hdr, packet, payload);
+    // parse packet & calculate payload, parsed on stack so dropped packets cost no allocation
+    struct packet_payload_t pkt {};
+    auto ok = NetifPacketParser::parsePacket(hdr, packet, pkt, netifMonitorJob->m_dispatchLinkType);
     if (!ok)
         return;
-    char dMac[256];
-    auto *eth_hdr = reinterpret_cast<const struct ether_header *>(packet);
-    sprintf(dMac, "%x:%x:%x:%x:%x:%x", (eth_hdr->ether_dhost)[0], (eth_hdr->ether_dhost)[1],
-            (eth_hdr->ether_dhost)[2], (eth_hdr->ether_dhost)[3],
-            (eth_hdr->ether_dhost)[4], (eth_hdr->ether_dhost)[5]);
-    // calc hash from caputured packet's src:sport-dest:dport
-    if (payload->sa_family == AF_INET) {
-        // ipv4 packet payload
-        char saddr_str[INET_ADDRSTRLEN + 1] {}, daddr_str[INET_ADDRSTRLEN + 1] {};
-        // convert ipv4 source & destination address to string format
-        inet_ntop(AF_INET, &payload->s_addr.in4, saddr_str, INET_ADDRSTRLEN);
-        inet_ntop(AF_INET, &payload->d_addr.in4, daddr_str, INET_ADDRSTRLEN);
-
-        // pattern that matches kernel sock stat table
-        pattern = QString("%1:%2-%3:%4").arg(saddr_str).arg(payload->s_port).arg(daddr_str).arg(payload->d_port);
-        uint64_t saddr_hpair[2] {}, daddr_hpair[2] {};
-        // generate source address hash
-        util::common::hash(saddr_str, int(strlen(saddr_str)), util::common::global_seed, saddr_hpair);
-        // generate destination address hash
-        util::common::hash(daddr_str, int(strlen(daddr_str)), util::common::global_seed, daddr_hpair);
-        if (netifMonitorJob->m_ifaddrsHashCache.contains(saddr_hpair[0])) {
-            payload->direction = kOutboundPacket;
-        } else if (netifMonitorJob->m_ifaddrsHashCache.contains(daddr_hpair[0])) {
-            payload->direction = kInboundPacket;
+
+    // packet direction from raw interface addresses
+    if (pkt.sa_family == AF_INET) {
+        if (netifMonitorJob->m_ifaddrs.contains(pkt.s_addr.in4)) {
+            pkt.direction = kOutboundPacket;
+        } else if (netifMonitorJob->m_ifaddrs.contains(pkt.d_addr.in4)) {
+            pkt.direction = kInboundPacket;
         } else {
             return;
         }
-
-    } else if (payload->sa_family == AF_INET6) {
-        // ipv6 packet payload
-        char saddr6_str[INET6_ADDRSTRLEN + 1] {}, daddr6_str[INET6_ADDRSTRLEN + 1] {};
-        inet_ntop(AF_INET6, &payload->s_addr.in6, saddr6_str, INET6_ADDRSTRLEN);
-        inet_ntop(AF_INET6, &payload->d_addr.in6, daddr6_str, INET6_ADDRSTRLEN);
-
-        // pattern that matches kernel sock stat table
-        pattern = QString("%1:%2-%3:%4").arg(saddr6_str).arg(payload->s_port).arg(daddr6_str).arg(payload->d_port);
-        uint64_t saddr6_hpair[2] {}, daddr6_hpair[2] {};
-        // generate source address hash
-        util::common::hash(saddr6_str, int(strlen(saddr6_str)), util::common::global_seed, saddr6_hpair);
-        // generate destination address hash
-        util::common::hash(daddr6_str, int(strlen(daddr6_str)), util::common::global_seed, daddr6_hpair);
-        if (netifMonitorJob->m_ifaddrsHashCache.contains(saddr6_hpair[0])) {
-            payload->direction = kOutboundPacket;
-        } else if (netifMonitorJob->m_ifaddrsHashCache.contains(daddr6_hpair[0])) {
-            payload->direction = kInboundPacket;
+    } else if (pkt.sa_family == AF_INET6) {
+        if (netifMonitorJob->m_ifaddrs.contains(pkt.s_addr.in6)) {
+            pkt.direction = kOutboundPacket;
+        } else if (netifMonitorJob->m_ifaddrs.contains(pkt.d_addr.in6)) {
+            pkt.direction = kInboundPacket;
         } else {
             return;
         }
-
     } else {
         // unexpected here
+        return;
     }
 
-    fmtbuf = pattern.toLocal8Bit();
-    util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-    hash = cchash[0];
-    // get ino from map
-    if (netifMonitorJob->m_sockStats.contains(hash)) {
-        QMultiMap<uint64_t, SockStat>::const_iterator it = netifMonitorJob->m_sockStats.find(hash);
-        while (it != netifMonitorJob->m_sockStats.cend() && it.key() == hash) {
-            // TODO: UDP traffic identify method refine
-            // UDP socks may have same kernel hash slot (sl: hash generated with same src:port + dest:port),
-            // which means there's no way to distinguish which packet sent/received by which socket, what
-            // makes it very tricky to get the real UDP traffic for specific process, we assume
-            // socks with same sl are created by same process for temporary, need a much fine way to
-            // distinguish the traffic at a later time.
-            payload->ino = it.value()->ino;
-            break;
-        }
-    } else {
-        // no matching sockets in /proc tcp/udp table, which means we cant grab inode from socket table,
+    // src:sport-dest:dport flow key that matches kernel sock stat table
+    // TODO: UDP traffic identify method refine
+    // UDP socks may have same kernel hash slot (sl: hash generated with same src:port + dest:port),
+    // which means there's no way to distinguish which packet sent/received by which socket, what
+    // makes it very tricky to get the real UDP traffic for specific process, we assume
+    // socks with same sl are created by same process for temporary, need a much fine way to
+    // distinguish the traffic at a later time.
+    pkt.ino = netifMonitorJob->lookupSockInode(pkt);
+    if (pkt.ino == 0) {
+        // no matching sockets in kernel tcp/udp table, which means we cant grab inode from socket table,
         // the only thing we can do here is ignore this packet.
         return;
     }
-    netifMonitorJob->m_localPendingPackets.enqueue(payload);
-    auto npkts = netifMonitorJob->m_localPendingPackets.size();
-    if (npkts >= PACKET_DISPATCH_QUEUE_LWAT && npkts < PACKET_DISPATCH_QUEUE_HWAT) {
-        // if dispatch queue is between low & high water mark, then we can just use try lock in relax way
-        if (netifMonitor->m_pktqLock.tryLock()) {
-            netifMonitor->m_pendingPackets.append(netifMonitorJob->m_localPendingPackets);
-            netifMonitor->m_pktqLock.unlock();
 
-            // clear local pending queue after move packets to monitor instance's queue
-            netifMonitorJob->m_localPendingPackets.clear();
-
-            netifMonitor->m_pktqWatcher.wakeAll();
-        }
-    } else if (npkts >= PACKET_DISPATCH_QUEUE_HWAT) {
-        // otherwise we forcefully use lock instead
-        netifMonitor->m_pktqLock.lock();
-        netifMonitor->m_pendingPackets.append(netifMonitorJob->m_localPendingPackets);
-        netifMonitor->m_pktqLock.unlock();
-
-        // clear local pending queue after move packets to monitor instance's queue
-        netifMonitorJob->m_localPendingPackets.clear();
-
-        netifMonitor->m_pktqWatcher.wakeAll();
+    // hand over a fixed size record, consumer is woken once per dispatch batch
+    struct packet_record_t record {pkt.ino, pkt.payload, pkt.direction};
+    if (netifMonitor->m_packetRing.push(record)) {
+        ++netifMonitorJob->m_batchPackets;
+        ++netifMonitorJob->m_captureStat.attributed;
+    } else {
+        ++netifMonitorJob->m_captureStat.ring_dropped;
     }
 }
 
 // dispatch packet handler
 void NetifPacketCapture::dispatchPackets()
 {
-    usleep(20000);
     if (!go) return;
-    //无可用设备
-    if (m_devName.isEmpty()) return;
-    // check pending packets before dispatching packets
-    auto npkts = m_localPendingPackets.size();
-    if (npkts > 0) {
-        if (npkts >= PACKET_DISPATCH_QUEUE_LWAT && npkts < PACKET_DISPATCH_QUEUE_HWAT) {
-            // pending packets between low & high water mark
-            if (m_netifMonitor->m_pktqLock.tryLock()) {
-                m_netifMonitor->m_pendingPackets.append(m_localPendingPackets);
-                m_netifMonitor->m_pktqLock.unlock();
-
-                m_netifMonitor->m_pktqWatcher.wakeAll();
-
-                m_localPendingPackets.clear();
-            }
-        } else if (npkts >= PACKET_DISPATCH_QUEUE_HWAT) {
-            // acquire lock forcefully if too many packets pending
-            m_netifMonitor->m_pktqLock.lock();
-            m_netifMonitor->m_pendingPackets.append(m_localPendingPackets);
-            m_netifMonitor->m_pktqLock.unlock();
 
-            m_netifMonitor->m_pktqWatcher.wakeAll();
+    // quit requested, stop capturing then
+    if (m_quitRequested.load()) {
+        m_timer->stop();
+        stopCapture();
+        return;
+    }
 
-            m_localPendingPackets.clear();
-        }
+    time_t now = time(nullptr);
+    // refresh m_ifaddrs every 10 seconds in case netlink notifications are not available
+    if (!m_lastIfAddrsRefresh || (now - m_lastIfAddrsRefresh) >= IFADDRS_CACHE_REFRESH_INTERVAL) {
+        refreshIfAddrsCache();
+        if (!m_netlinkWatcher.isValid())
+            refreshCaptureInterfaces();
+        m_lastIfAddrsRefresh = now;
     }
 
-    time_t last_sockstat {};
-    time_t last_ifaddrs_refresh {};
+    //无可用设备
+    if (m_captures.empty()) {
+        // without netlink notifications interfaces are only picked up by polling
+        if (!m_netlinkWatcher.isValid())
+            m_timer->start(PACKET_DISPATCH_IDLE_TIME);
+        return;
+    }
 
-    do {
-        usleep(20000);
-        // quit requested, break the loop then
-        auto quit = m_quitRequested.load();
-        if (quit) {
-            m_timer->stop();
-            break;
+    if (m_sockDiag.isValid()) {
+        // new sockets are looked up on packet miss, full dump only to drop closed ones, live table is kept meanwhile
+        if (!m_lastSockStatRefresh || (now - m_lastSockStatRefresh) >= SOCKDIAG_RESYNC_INTERVAL)
+            startSockStatResync();
+        // forget failed lookups every 2 seconds, sockets may have been opened meanwhile
+        if (!m_lastSockMissesFlush || (now - m_lastSockMissesFlush) >= SOCKSTAT_REFRESH_INTERVAL) {
+            m_sockMisses.clear();
+            m_lastSockMissesFlush = now;
         }
+    } else if (!m_lastSockStatRefresh || (now - m_lastSockStatRefresh) >= SOCKSTAT_REFRESH_INTERVAL) {
         // refresh m_sockStat cache every 2 seconds
-        time_t now = time(nullptr);
-        if (!last_sockstat || (now - last_sockstat) >= SOCKSTAT_REFRESH_INTERVAL) {
-            m_sockStats.clear();
-            SysInfo::readSockStat(m_sockStats);
-            last_sockstat = now;
-        }
+        SysInfo::readSockStat(m_sockStats);
+        m_lastSockStatRefresh = now;
+    }
 
-        // refresh m_ifaddrsHashCache every 10 seconds in case user change ip address on the fly
-        if (!last_ifaddrs_refresh || (now - last_ifaddrs_refresh) >= IFADDRS_HASH_CACHE_REFRESH_INTERVAL) {
-            refreshIfAddrsHashCache();
-            last_ifaddrs_refresh = now;
+    bool polling = false;
+    for (auto it = m_captures.begin(); it != m_captures.end();) {
+        auto &capture = it->second;
+        int nr = dispatchCapture(*capture);
+        if (nr == -1) {
+            // error occurred while processing packets, e.g. interface went down
+            qCDebug(app) << "pcap_dispatch failed: " << capture->ifname << pcap_geterr(capture->handle);
+            closeCapture(capture);
+            it = m_captures.erase(it);
+            continue;
         }
+        polling = polling || !capture->notifier;
+        ++it;
+    }
+
+    // kernel side counters
+    bool queryKernel = !m_lastCaptureStatRefresh || (now - m_lastCaptureStatRefresh) >= CAPTURE_STAT_REFRESH_INTERVAL;
+    publishCaptureStat(queryKernel);
+    if (queryKernel)
+        m_lastCaptureStatRefresh = now;
+
+    // maintenance tick, also picks up a partially filled block if the fd was not signaled
+    m_timer->start(polling ? PACKET_DISPATCH_POLL_TIME : PACKET_DISPATCH_IDLE_TIME);
+}
+
+int NetifPacketCapture::dispatchCapture(struct netif_capture_t &capture)
+{
+    // link layer header is parsed by pcap_callback
+    m_dispatchLinkType = capture.linkType;
+
+    // drain retired blocks, bounded so a flood can't starve the event loop
+    int nr = 0;
+    for (int round = 0; round < PACKET_DISPATCH_MAX_ROUNDS; ++round) {
+        int batch = capture.batchCount;
+        m_sockLookupBudget = SOCKDIAG_LOOKUP_BUDGET;
 
         // start packet dispatching
-        auto nr = pcap_dispatch(m_handle,
-                                PACKET_DISPATCH_BATCH_COUNT,
-                                pcap_callback,
-                                reinterpret_cast<u_char *>(this));
-        if (nr == 0) {
-            // no packets are available, idle this loop for a fraction second
-            m_timer->start(PACKET_DISPATCH_IDLE_TIME);
-            return;
-        } else if (nr == -1) {
-            // error occurred while processing packets
-            qCDebug(app) << "pcap_dispatch failed: " << pcap_geterr(m_handle);
-            m_timer->stop();
+        nr = pcap_dispatch(capture.handle,
+                           batch,
+                           pcap_callback,
+                           reinterpret_cast<u_char *>(this));
+        if (m_batchPackets > 0) {
+            m_netifMonitor->m_pktqWatcher.wakeOne();
+            m_batchPackets = 0;
+        }
+        if (nr < 0)
             break;
-        } else if (nr == -2) {
-            // breakloop requested (can only happen inside the callbackm_localPendingPackets function)
-            m_timer->stop();
+
+        adaptBatchCount(capture, nr);
+        // no more packets available
+        if (nr < batch)
             break;
-        }
-    } while (true);
+    }
 
-    // close pcap handle
-    pcap_close(m_handle);
+    return nr;
+}
+
+void NetifPacketCapture::adaptBatchCount(struct netif_capture_t &capture, int nr)
+{
+    if (nr >= capture.batchCount) {
+        capture.batchCount = qMin(capture.batchCount * 2, PACKET_DISPATCH_BATCH_MAX);
+    } else if (nr < capture.batchCount / 4) {
+        capture.batchCount = qMax(capture.batchCount / 2, PACKET_DISPATCH_BATCH_MIN);
+    }
+}
+
+void NetifPacketCapture::publishCaptureStat(bool queryKernel)
+{
+    // pcap_stat counters are 32 bit & wrap around on long captures
+    m_captureStat.kernel_received = m_closedStat.kernel_received;
+    m_captureStat.kernel_dropped = m_closedStat.kernel_dropped;
+    m_captureStat.if_dropped = m_closedStat.if_dropped;
+    for (auto &it : m_captures) {
+        auto &capture = it.second;
+        if (queryKernel)
+            pcap_stats(capture->handle, &capture->stat);
+        m_captureStat.kernel_received += capture->stat.ps_recv;
+        m_captureStat.kernel_dropped += capture->stat.ps_drop;
+        m_captureStat.if_dropped += capture->stat.ps_ifdrop;
+    }
+
+    m_captureStatLock.lock();
+    m_publishedStat = m_captureStat;
+    m_captureStatLock.unlock();
+}
+
+void NetifPacketCapture::stopCapture()
+{
+    for (auto &it : m_captures)
+        closeCapture(it.second);
+    m_captures.clear();
+    go = false;
+}
+
+QString NetifPacketCapture::captureFilter(const IfAddrSet &addrs)
+{
+    // only tcp & udp are attributed to sockets, primitives match ipv4 & ipv6 (incl. fragment header)
+    QString filter("(tcp or udp)");
+    if (addrs.size() == 0 || addrs.size() > CAPTURE_FILTER_MAX_HOSTS)
+        return filter;
+
+    QStringList hosts;
+    char buf[INET6_ADDRSTRLEN] {};
+    for (const auto &addr : addrs.addrs4()) {
+        if (inet_ntop(AF_INET, &addr, buf, sizeof(buf)))
+            hosts << QString("host %1").arg(buf);
+    }
+    for (const auto &addr : addrs.addrs6()) {
+        if (inet_ntop(AF_INET6, &addr, buf, sizeof(buf)))
+            hosts << QString("host %1").arg(buf);
+    }
+
+    return QString("%1 and (%2)").arg(filter).arg(hosts.join(" or "));
+}
+
+bool NetifPacketCapture::applyCaptureFilter(struct netif_capture_t &capture, const QString &filter)
+{
+    if (!capture.handle)
+        return false;
+    if (filter == capture.filter)
+        return true;
+
+    struct bpf_program prog {};
+    QByteArray expr = filter.toLatin1();
+    if (pcap_compile(capture.handle, &prog, expr.constData(), 1, PCAP_NETMASK_UNKNOWN) == -1) {
+        qCDebug(app) << "pcap_compile failed: " << pcap_geterr(capture.handle) << filter;
+        return false;
+    }
+    int rc = pcap_setfilter(capture.handle, &prog);
+    pcap_freecode(&prog);
+    if (rc == -1) {
+        qCDebug(app) << "pcap_setfilter failed: " << pcap_geterr(capture.handle) << filter;
+        return false;
+    }
+
+    capture.filter = filter;
+    return true;
+}
+
+struct capture_stat_t NetifPacketCapture::captureStat() const
+{
+    QMutexLocker locker(&m_captureStatLock);
+    return m_publishedStat;
+}
+
+ino_t NetifPacketCapture::lookupSockInode(const struct packet_payload_t &pkt)
+{
+    auto key = makeFlowKey(pkt.sa_family, int(pkt.proto), &pkt.s_addr, pkt.s_port, &pkt.d_addr, pkt.d_port);
+    ino_t ino = m_sockStats.find(key);
+    if (ino != 0 || !m_sockDiag.isValid())
+        return ino;
+
+    // socket opened after the last dump, ask the kernel for this flow only
+    if (m_sockMisses.find(key) != 0 || m_sockLookupBudget <= 0)
+        return 0;
+    --m_sockLookupBudget;
+
+    bool outbound = (pkt.direction == kOutboundPacket);
+    ino = m_sockDiag.lookup(pkt.sa_family, int(pkt.proto),
+                            outbound ? static_cast<const void *>(&pkt.s_addr) : static_cast<const void *>(&pkt.d_addr),
+                            outbound ? pkt.s_port : pkt.d_port,
+                            outbound ? static_cast<const void *>(&pkt.d_addr) : static_cast<const void *>(&pkt.s_addr),
+                            outbound ? pkt.d_port : pkt.s_port);
+    if (ino == 0) {
+        // any non zero value marks a miss
+        m_sockMisses.insert(key, 1);
+        return 0;
+    }
+
+    auto rkey = makeFlowKey(pkt.sa_family, int(pkt.proto), &pkt.d_addr, pkt.d_port, &pkt.s_addr, pkt.s_port);
+    m_sockStats.insert(key, ino);
+    if (pkt.proto == IPPROTO_TCP)
+        m_sockStats.insert(rkey, ino);
+    // running resync may have dumped the tables before this socket showed up
+    if (m_sockResyncPending) {
+        m_sockResyncLog << sock_resync_op_t {key, ino, false};
+        if (pkt.proto == IPPROTO_TCP)
+            m_sockResyncLog << sock_resync_op_t {rkey, ino, false};
+    }
+    return ino;
 }
 
 bool readNetIfAddrs(NetIFAddrsMap &addrsMap)
@@ -478,41 +627,39 @@ bool readNetIfAddrs(NetIFAddrsMap &addrsMap)
         return false;
 }
 
-// refresh network interface hash cache
-void NetifPacketCapture::refreshIfAddrsHashCache()
+// refresh network interface address cache
+void NetifPacketCapture::refreshIfAddrsCache()
 {
     NetIFAddrsMap addrsMap;
 
     // get network interface map
     auto ok = readNetIfAddrs(addrsMap);
     if (ok) {
+        IfAddrSet ifaddrs;
         NetIFAddrsMap::const_iterator it = addrsMap.constBegin();
         // process each address in map
         while (it != addrsMap.constEnd()) {
             auto ifaddr = it.value();
 
-            uint64_t ifaddr_hash[2] {};
             if (ifaddr->family == AF_INET) {
-                char addr_str[INET_ADDRSTRLEN + 1] {};
-                // convert to ipv4 format string
-                inet_ntop(AF_INET, &ifaddr->addr.in4, addr_str, INET_ADDRSTRLEN);
-
-                // calculate hash
-                util::common::hash(addr_str, int(strlen(addr_str)), util::common::global_seed, ifaddr_hash);
-                m_ifaddrsHashCache[ifaddr_hash[0]] = 0;
-
+                ifaddrs.insert(ifaddr->addr.in4);
             } else if (ifaddr->family == AF_INET6) {
-                char addr6_str[INET6_ADDRSTRLEN + 1] {};
-                // convert to ipv6 format string
-                inet_ntop(AF_INET6, &ifaddr->addr.in6, addr6_str, INET6_ADDRSTRLEN);
-
-                // calculate hash
-                util::common::hash(addr6_str, int(strlen(addr6_str)), util::common::global_seed, ifaddr_hash);
-                m_ifaddrsHashCache[ifaddr_hash[0]] = 0;
+                ifaddrs.insert(ifaddr->addr.in6);
             }
 
             ++it;
         }
+        m_ifaddrs = ifaddrs;
+    }
+
+    // regenerate capture filters, only recompiled if addresses changed
+    QString filter = captureFilter(m_ifaddrs);
+    for (auto &it : m_captures) {
+        auto &capture = *it.second;
+        if (!applyCaptureFilter(capture, filter)) {
+            // too many addresses for the bpf program, admit tcp & udp from anywhere
+            applyCaptureFilter(capture, captureFilter(IfAddrSet()));
+        }
     }
 }
 
@@ -8,10 +8,20 @@
 
 #include <QObject>
 #include "packet.h"
+#include "sock_stat_table.h"
+#include "sock_diag.h"
+#include "netlink.h"
 #include <QTimer>
+#include <QSocketNotifier>
+#include <QMutex>
 #include <QMap>
+#include <QVector>
+#include <QFutureWatcher>
 #include <unistd.h>
 
+#include <map>
+#include <memory>
+
 
 namespace core {
 namespace system {
@@ -21,6 +31,7 @@ class NetifPacketCapture : public QObject
     Q_OBJECT
 public:
     explicit NetifPacketCapture(NetifMonitor *netInfmontor, QObject *parent = nullptr);
+    ~NetifPacketCapture() override;
     inline void requestQuit()
     {
         m_quitRequested.store(true);
@@ -29,19 +40,20 @@ public:
      * @brief Packet dispatch handler
      */
     void dispatchPackets();
-    pcap_t  *getHandle() { return m_handle;}
-
-
-protected:
 
     /**
-     * @brief 获取当前网卡名
+     * @brief Capture counters as of the last dispatch batch (thread safe accessor)
      */
-    bool getCurrentDevName();
+    struct capture_stat_t captureStat() const;
+
     /**
-     * @brief 判断当前网卡是否被分配可用网络IP(IPv4)
+     * @brief Build in-kernel capture filter expression, tcp & udp to or from local addresses
+     * @param addrs Local interface addresses, protocol only filter if empty or too many
+     * @return pcap filter expression
      */
-    bool hasDevIP();
+    static QString captureFilter(const IfAddrSet &addrs);
+
+
 signals:
 
 public slots:
@@ -50,31 +62,174 @@ public slots:
      */
     void startNetifMonitorJob();
 
+private:
     /**
-     * @brief 判断使用网卡是否变更,变更则重启startNetifMonitorJob槽函数;
+     * @brief Capture on one network interface
      */
-    void whetherDevChanged();
+    struct netif_capture_t {
+        int ifindex;                // interface index
+        QByteArray ifname;          // interface name
+        pcap_t *handle;             // pcap handler instance
+        int linkType;               // pcap link layer header type
+        QSocketNotifier *notifier;  // readable notifier on pcap selectable fd, nullptr if polling by timer
+        QString filter;             // capture filter installed on handle
+        int batchCount;             // packets to process per pcap_dispatch call
+        struct pcap_stat stat;      // last pcap_stats of handle
+    };
+    using NetifCapture = std::unique_ptr<struct netif_capture_t>;
 
-private:
+    /**
+     * @brief Socket table change made while a resync dump is running
+     */
+    struct sock_resync_op_t {
+        flow_key_t key;             // flow key
+        ino_t ino;                  // inserted inode, or inode of the closed socket (0 if unknown)
+        bool removed;               // flow erased on destroy notification
+    };
+
+    /**
+     * @brief Interfaces to capture on: up, not loopback & holding at least one address
+     * @return Interface index to name mapping
+     */
+    QMap<int, QByteArray> captureInterfaces();
+
+    /**
+     * @brief Open capture on interfaces that came up & close it on interfaces that went away
+     */
+    void refreshCaptureInterfaces();
+
+    /**
+     * @brief Create, configure & activate pcap handle for one interface
+     * @return Capture instance, nullptr if interface can't be captured
+     */
+    NetifCapture openCapture(int ifindex, const QByteArray &ifname);
+
+    /**
+     * @brief Close pcap handle & stop watching its selectable fd
+     */
+    void closeCapture(NetifCapture &capture);
+
+    /**
+     * @brief Drain netlink notifications, interface set is refreshed once a burst settled
+     */
+    void handleNetlinkEvents();
+
+    /**
+     * @brief Drain sock_diag destroy notifications, closed sockets are erased from socket table
+     */
+    void handleSockDestroyEvents();
+
+    /**
+     * @brief Start a full sock_diag dump into m_sockStatsNext on a worker thread, m_sockStats stays live
+     */
+    void startSockStatResync();
+
+    /**
+     * @brief Swap finished resync dump in, replaying flows changed while it was running
+     */
+    void finishSockStatResync();
+
+    /**
+     * @brief Close captures on all interfaces
+     */
+    void stopCapture();
+
+    /**
+     * @brief Drain one interface's retired blocks
+     * @return Result of the last pcap_dispatch call
+     */
+    int dispatchCapture(struct netif_capture_t &capture);
+
+    /**
+     * @brief Compile & install capture filter on pcap handle, skipped if already installed
+     * @param capture Interface capture
+     * @param filter pcap filter expression
+     * @return Return true if filter is installed
+     */
+    bool applyCaptureFilter(struct netif_capture_t &capture, const QString &filter);
+
+    /**
+     * @brief Grow batch size while dispatches come back full, shrink it when traffic calms down
+     * @param capture Interface capture
+     * @param nr Packets processed by the last dispatch
+     */
+    void adaptBatchCount(struct netif_capture_t &capture, int nr);
+
+    /**
+     * @brief Sum up pcap_stats of all interfaces & publish capture counters
+     * @param queryKernel Query pcap_stats of each handle, cached values are summed up otherwise
+     */
+    void publishCaptureStat(bool queryKernel);
+
+    /**
+     * @brief Refresh network interface address cache
+     */
+    void refreshIfAddrsCache();
 
     /**
-     * @brief Refresh network interface address hash cache
+     * @brief Find inode of the socket a packet belongs to, asks sock_diag for flows missing in the cache
+     * @param pkt Parsed packet with direction set
+     * @return Socket inode, 0 if not found
      */
-    void refreshIfAddrsHashCache();
+    ino_t lookupSockInode(const struct packet_payload_t &pkt);
 
 
 private:
-    // socket io stat cache
-    SockStatMap     m_sockStats {};
-    // network interface name hash cache
-    QMap<uint64_t, int> m_ifaddrsHashCache; // key: hash code generated from ifaddr; value: not used
+    // socket io stat cache: flow key -> socket inode
+    SockStatTable   m_sockStats {};
+    // local network interface addresses
+    IfAddrSet       m_ifaddrs {};
+    // netlink socket table backend, invalid if /proc/net is parsed instead
+    SockDiag        m_sockDiag {};
+    // flows a targeted lookup failed for recently, avoids asking the kernel per packet
+    SockStatTable   m_sockMisses {};
+    // readable notifier on sock_diag destroy notification fd
+    QSocketNotifier *m_sockDestroyNotifier {};
+    // resync dump target, owned by the worker thread while m_sockResyncWatcher is running
+    SockStatTable   m_sockStatsNext {};
+    // changes made while a resync is running, replayed on the new table before it's swapped in
+    QVector<struct sock_resync_op_t> m_sockResyncLog {};
+    // full dump running off the capture thread
+    QFutureWatcher<bool> *m_sockResyncWatcher {};
+    // resync started & not swapped in yet
+    bool            m_sockResyncPending {};
+    // targeted lookups left for current dispatch batch
+    int             m_sockLookupBudget {};
+    // last full socket table refresh
+    time_t          m_lastSockStatRefresh {};
+    // last failed lookups flush
+    time_t          m_lastSockMissesFlush {};
+    // last network interface address refresh
+    time_t          m_lastIfAddrsRefresh {};
 
     // network interface monitor
     NetifMonitor       *m_netifMonitor         {};
-    // pcap handler instance
-    pcap_t             *m_handle               {};
-    // local pending packet queue
-    PacketPayloadQueue  m_localPendingPackets  {};
+    // interface index -> capture
+    std::map<int, NetifCapture> m_captures     {};
+    // link layer header type of the capture being dispatched
+    int                 m_dispatchLinkType     {DLT_EN10MB};
+    // packets pushed to the monitor ring during current dispatch batch
+    int                 m_batchPackets         {};
+
+    // interface & address list backend
+    std::unique_ptr<Netlink> m_netlink         {};
+    // link & address change notifications
+    NetlinkWatcher      m_netlinkWatcher       {};
+    // readable notifier on netlink watcher fd
+    QSocketNotifier    *m_netlinkNotifier      {};
+    // coalesces a burst of netlink notifications into one refresh
+    QTimer             *m_netlinkSettleTimer   {};
+
+    // capture counters, updated by capture thread only
+    struct capture_stat_t m_captureStat        {};
+    // copy of m_captureStat published for other threads
+    struct capture_stat_t m_publishedStat      {};
+    // published capture counters access locker
+    mutable QMutex      m_captureStatLock      {};
+    // kernel counters of captures closed meanwhile
+    struct capture_stat_t m_closedStat         {};
+    // last pcap_stats query
+    time_t              m_lastCaptureStatRefresh {};
 
     // request quit atomic flag
     std::atomic_bool m_quitRequested {false};
@@ -82,14 +237,6 @@ private:
     // packet dispatch timer
     QTimer *m_timer {};
 
-    //是否变更网卡
-    bool m_changedDev {false}; 
-    //当前使用网卡名
-    QString m_devName {};
-    //当前系统所有网卡设备链表
-    pcap_if_t *m_alldevs {};
-    //判断网卡是否变更定时器
-    QTimer *m_timerChangeDev {};
     friend void pcap_callback(u_char *, const struct pcap_pkthdr *, const u_char *);
 
 };
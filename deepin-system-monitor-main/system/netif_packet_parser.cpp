@@ -28,6 +28,8 @@
 #define IP6_NEXT_HEADER_NNH 59
 #define IP6_NEXT_HEADER_DESOPT 60
 
+#define LINUX_SLL_HDR_LEN 16 // linux cooked capture header length
+
 namespace core {
 namespace system {
 
@@ -38,16 +40,63 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
     if (!payload) {
         payload = QSharedPointer<struct packet_payload_t>::create();
     }
-    payload->ts = pkt_hdr->ts;
+    return parsePacket(pkt_hdr, packet, *payload);
+}
+
+bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
+                                    const u_char *packet,
+                                    struct packet_payload_t &payload,
+                                    int linkType)
+{
+    payload.ts = pkt_hdr->ts;
     const u_char *hdr = packet;
-    // parse hdr&packet
-    auto *eth_hdr = reinterpret_cast<const struct ether_header *>(packet);
-    auto type = ntohs(eth_hdr->ether_type);
-    auto eth_hdr_len = sizeof(struct ether_header);
+    // capture is trimmed to the headers (snaplen), never read past the captured bytes
+    const u_char *end = packet + pkt_hdr->caplen;
+
+    // link layer header length & network protocol type
+    size_t eth_hdr_len {};
+    uint16_t type {};
+    switch (linkType) {
+    case DLT_EN10MB: {
+        eth_hdr_len = sizeof(struct ether_header);
+        if (pkt_hdr->caplen < eth_hdr_len) {
+            return false;
+        }
+        auto *eth_hdr = reinterpret_cast<const struct ether_header *>(packet);
+        type = ntohs(eth_hdr->ether_type);
+        break;
+    }
+    case DLT_LINUX_SLL: {
+        // linux cooked capture: packet type, arphrd type, address length, address[8], protocol
+        eth_hdr_len = LINUX_SLL_HDR_LEN;
+        if (pkt_hdr->caplen < eth_hdr_len) {
+            return false;
+        }
+        type = ntohs(*reinterpret_cast<const uint16_t *>(packet + 14));
+        break;
+    }
+    case DLT_RAW:
+#ifdef DLT_IPV4
+    case DLT_IPV4:
+    case DLT_IPV6:
+#endif
+        // tun devices, no link layer header: ip version from first nibble
+        if (pkt_hdr->caplen < 1) {
+            return false;
+        }
+        type = (packet[0] >> 4) == 6 ? ETHERTYPE_IPV6 : ETHERTYPE_IP;
+        break;
+    default:
+        // unsupported link layer
+        return false;
+    }
     uint proto {};
     ulong ip_hdr_len {};
 
     if (type == ETHERTYPE_IP) {
+        if (packet + eth_hdr_len + sizeof(struct ip) > end) {
+            return false;
+        }
         auto *ip_hdr = reinterpret_cast<const struct ip *>(packet + eth_hdr_len);
         // ip header length
         ip_hdr_len = ulong((ip_hdr->ip_hl & 0x0f) * 4);
@@ -61,12 +110,15 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
             return false;
         }
 
-        payload->sa_family = AF_INET;
-        payload->proto = proto;
-        payload->s_addr.in4 = ip_hdr->ip_src;
-        payload->d_addr.in4 = ip_hdr->ip_dst;
+        payload.sa_family = AF_INET;
+        payload.proto = proto;
+        payload.s_addr.in4 = ip_hdr->ip_src;
+        payload.d_addr.in4 = ip_hdr->ip_dst;
 
     } else if (type == ETHERTYPE_IPV6) {
+        if (packet + eth_hdr_len + sizeof(struct ip6_hdr) > end) {
+            return false;
+        }
         auto *ip6_hdr = reinterpret_cast<const struct ip6_hdr *>(packet + eth_hdr_len);
 
         // next header field in ip6 header
@@ -75,6 +127,10 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
         hdr = packet + eth_hdr_len + sizeof(struct ip6_hdr);
         bool stop {false};
         while (!stop) {
+            // extension headers start with next header & length, at least 8 bytes
+            if (hdr + 8 > end) {
+                return false;
+            }
             switch (nhtype) {
             case  IP6_NEXT_HEADER_HBH: {
                 // Hop-by-Hop Options Header
@@ -146,28 +202,36 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
             } // !switch
         } // !while
 
-        payload->sa_family = AF_INET6;
-        payload->proto = proto;
-        payload->s_addr.in6 = ip6_hdr->ip6_src;
-        payload->d_addr.in6 = ip6_hdr->ip6_dst;
+        payload.sa_family = AF_INET6;
+        payload.proto = proto;
+        payload.s_addr.in6 = ip6_hdr->ip6_src;
+        payload.d_addr.in6 = ip6_hdr->ip6_dst;
 
     } else {
         // ignore non ip4 & ip6 packets
         return false;
     }
 
+    // payload is calculated from the length on the wire, captured length only covers the headers
     if (proto == IPPROTO_TCP) {
+        if (hdr + sizeof(struct tcphdr) > end) {
+            return false;
+        }
         auto *tcp_hdr = reinterpret_cast<const struct tcphdr *>(hdr);
-        auto tcp_hdr_len = ulong(((tcp_hdr->th_off & 0xf0) >> 4) * 4);
+        // th_off is the 4 bit data offset field itself, in 32 bit words
+        auto tcp_hdr_len = ulong(tcp_hdr->th_off * 4);
         // no payload data
-        if (pkt_hdr->caplen <= eth_hdr_len + ip_hdr_len + tcp_hdr_len) {
+        if (pkt_hdr->len <= eth_hdr_len + ip_hdr_len + tcp_hdr_len) {
             return false;
         }
-        payload->payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - tcp_hdr_len;
-        payload->s_port = ntohs(tcp_hdr->th_sport);
-        payload->d_port = ntohs(tcp_hdr->th_dport);
+        payload.payload = pkt_hdr->len - eth_hdr_len - ip_hdr_len - tcp_hdr_len;
+        payload.s_port = ntohs(tcp_hdr->th_sport);
+        payload.d_port = ntohs(tcp_hdr->th_dport);
 
     } else if (proto == IPPROTO_UDP) {
+        if (hdr + sizeof(struct udphdr) > end) {
+            return false;
+        }
         auto *udp_hdr = reinterpret_cast<const struct udphdr *>(hdr);
         auto udp_len = ulong(ntohs(udp_hdr->uh_ulen));
         auto udp_hdr_len = sizeof(struct udphdr);
@@ -183,12 +247,12 @@ bool NetifPacketParser::parsePacket(const pcap_pkthdr *pkt_hdr,
             ulen = udp_hdr_len;
         }
         // truncated, no payload data
-        if (pkt_hdr->caplen <= eth_hdr_len + ip_hdr_len + ulen) {
+        if (pkt_hdr->len <= eth_hdr_len + ip_hdr_len + ulen) {
             return false;
         }
-        payload->payload = pkt_hdr->caplen - eth_hdr_len - ip_hdr_len - ulen;
-        payload->s_port = ntohs(udp_hdr->uh_sport);
-        payload->d_port = ntohs(udp_hdr->uh_dport);
+        payload.payload = pkt_hdr->len - eth_hdr_len - ip_hdr_len - ulen;
+        payload.s_port = ntohs(udp_hdr->uh_sport);
+        payload.d_port = ntohs(udp_hdr->uh_dport);
 
     } else {
         // unexpected case, unknown proto type
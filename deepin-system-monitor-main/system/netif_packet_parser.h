@@ -17,6 +17,14 @@ public:
     static bool parsePacket(const struct pcap_pkthdr *pkt_hdr,
                             const u_char *packet,
                             PacketPayload &payload);
+    /**
+     * @brief Parse tcp/udp packet headers & payload size
+     * @param linkType pcap link layer header type of the capture (DLT_EN10MB, DLT_RAW, DLT_LINUX_SLL...)
+     */
+    static bool parsePacket(const struct pcap_pkthdr *pkt_hdr,
+                            const u_char *packet,
+                            struct packet_payload_t &payload,
+                            int linkType = DLT_EN10MB);
 
 
 private:
@@ -14,11 +14,16 @@
 #include <netlink/route/link.h>
 #include <netlink/route/addr.h>
 #include <netlink/cache.h>
+#include <netlink/msg.h>
+#include <linux/rtnetlink.h>
 using namespace DDLog;
 namespace core {
 namespace system {
 
 Netlink::Netlink()
+    : m_sock(nullptr)
+    , m_linkCache(nullptr)
+    , m_addrCache(nullptr)
 {
     int rc = 0;
     m_sock = nl_socket_alloc();
@@ -64,5 +69,100 @@ AddrIterator Netlink::addrIterator()
     return it;
 }
 
+NetlinkWatcher::NetlinkWatcher()
+    : m_sock(nullptr)
+    , m_fd(-1)
+    , m_changed(false)
+    , m_lost(false)
+{
+}
+
+NetlinkWatcher::~NetlinkWatcher()
+{
+    nl_socket_free(m_sock);
+}
+
+bool NetlinkWatcher::subscribe()
+{
+    if (m_sock)
+        return isValid();
+
+    m_sock = nl_socket_alloc();
+    if (!m_sock) {
+        qCWarning(app) << "Error: nl_socket_alloc failed";
+        return false;
+    }
+
+    // notifications are not replies to our requests, no sequence numbers to check
+    nl_socket_disable_seq_check(m_sock);
+    nl_socket_modify_cb(m_sock, NL_CB_VALID, NL_CB_CUSTOM, &NetlinkWatcher::handleEvent, this);
+
+    int rc = nl_connect(m_sock, NETLINK_ROUTE);
+    if (rc) {
+        qCWarning(app) << "Error: nl_connect failed";
+        return false;
+    }
+
+    rc = nl_socket_add_memberships(m_sock, RTNLGRP_LINK, RTNLGRP_IPV4_IFADDR, RTNLGRP_IPV6_IFADDR, 0);
+    if (rc) {
+        qCWarning(app) << "Error: nl_socket_add_memberships failed";
+        return false;
+    }
+
+    nl_socket_set_nonblocking(m_sock);
+    m_fd = nl_socket_get_fd(m_sock);
+
+    return true;
+}
+
+bool NetlinkWatcher::readEvents()
+{
+    if (!isValid())
+        return false;
+
+    m_changed = false;
+    m_lost = false;
+    m_changedLinks.clear();
+
+    struct nl_cb *cb = nl_socket_get_cb(m_sock);
+    int rc;
+    while ((rc = nl_recvmsgs_report(m_sock, cb)) > 0) {
+    }
+    nl_cb_put(cb);
+
+    // socket buffer overrun, notifications lost: report a change so caller resyncs
+    if (rc < 0 && rc != -NLE_AGAIN) {
+        m_changed = true;
+        m_lost = true;
+    }
+
+    return m_changed;
+}
+
+int NetlinkWatcher::handleEvent(struct nl_msg *msg, void *arg)
+{
+    auto *watcher = static_cast<NetlinkWatcher *>(arg);
+
+    struct nlmsghdr *hdr = nlmsg_hdr(msg);
+    switch (hdr->nlmsg_type) {
+    case RTM_NEWLINK:
+    case RTM_DELLINK:
+        if (nlmsg_valid_hdr(hdr, sizeof(struct ifinfomsg)))
+            watcher->m_changedLinks.insert(static_cast<struct ifinfomsg *>(nlmsg_data(hdr))->ifi_index);
+        else
+            watcher->m_lost = true;
+        watcher->m_changed = true;
+        break;
+    case RTM_NEWADDR:
+    case RTM_DELADDR:
+        watcher->m_changed = true;
+        break;
+    default:
+        break;
+    }
+
+    return NL_OK;
+}
+
 }   // namespace system
 }   // namespace core
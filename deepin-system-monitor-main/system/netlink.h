@@ -11,6 +11,7 @@
 
 #include <QtGlobal>
 #include <QList>
+#include <QSet>
 
 #include <netlink/socket.h>
 #include <netlink/cache.h>
@@ -19,6 +20,7 @@
 
 struct nl_cache;
 struct nl_link;
+struct nl_msg;
 
 namespace core {
 namespace system {
@@ -100,6 +102,62 @@ private:
     nl_cache *m_addrCache;
 };
 
+/**
+ * @brief rtnetlink multicast listener, link & address changes are pushed by the kernel
+ */
+class NetlinkWatcher
+{
+public:
+    explicit NetlinkWatcher();
+    ~NetlinkWatcher();
+
+    /**
+     * @brief Join link & ipv4/ipv6 address multicast groups
+     * @return Return false if netlink socket could not be set up
+     */
+    bool subscribe();
+    inline bool isValid() const
+    {
+        return m_fd >= 0;
+    }
+    /**
+     * @brief Pollable socket fd, -1 if not subscribed
+     */
+    inline int fd() const
+    {
+        return m_fd;
+    }
+
+    /**
+     * @brief Drain pending notifications without blocking
+     * @return Return true if any link or address change was received (or notifications were lost)
+     */
+    bool readEvents();
+    /**
+     * @brief Ifindexes of links added, changed or removed, as of the last readEvents
+     */
+    inline const QSet<int> &changedLinks() const
+    {
+        return m_changedLinks;
+    }
+    /**
+     * @brief Check if the last readEvents lost notifications, any link may have changed then
+     */
+    inline bool lost() const
+    {
+        return m_lost;
+    }
+
+private:
+    static int handleEvent(struct nl_msg *msg, void *arg);
+
+    nl_sock *m_sock;
+    int m_fd;
+    bool m_changed;
+    bool m_lost;
+    QSet<int> m_changedLinks;
+};
+
 } // namespace system
 } // namespace core
 
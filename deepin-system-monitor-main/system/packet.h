@@ -43,6 +43,37 @@ struct packet_payload_t {
     uint16_t d_port;
     unsigned long long payload;
 };
+// attributed packet handed from capture thread to NetifMonitor, fixed size so no allocation per packet
+struct packet_record_t {
+    ino_t ino;                  // socket inode
+    unsigned long long payload; // payload bytes
+    packet_direction direction;
+};
+
+/**
+ * @brief Network interface socket io stat structure
+ */
+struct sock_io_stat_t {
+    ino_t ino; // socket inode
+    qulonglong rx_bytes; // received bytes
+    qulonglong rx_packets; // received packets
+    qulonglong tx_bytes; // sent bytes
+    qulonglong tx_packets; // sent packets
+    qulonglong epoch; // bumped each time the counters are created, 0 until then
+};
+
+/**
+ * @brief Packet capture counters, kernel side from pcap_stats against what reached the monitor
+ */
+struct capture_stat_t {
+    qulonglong kernel_received; // packets seen by the kernel capture filter (ps_recv)
+    qulonglong kernel_dropped;  // packets dropped by the kernel, capture buffer full (ps_drop)
+    qulonglong if_dropped;      // packets dropped by the interface or driver (ps_ifdrop)
+    qulonglong delivered;       // packets delivered to pcap_callback
+    qulonglong attributed;      // packets attributed to a socket & handed to NetifMonitor
+    qulonglong ring_dropped;    // attributed packets dropped, NetifMonitor ring full
+};
+
 struct net_ifaddr_t {
     char iface[16]; // interface name
     int family; // address family
@@ -76,7 +107,7 @@ struct sock_stat_t {
 using PacketPayload      = QSharedPointer<struct packet_payload_t>;
 using PacketPayloadQueue = QQueue<PacketPayload>;
 using SockStat      = QSharedPointer<struct sock_stat_t>;
-using SockStatMap   = QMultiMap<uint64_t, SockStat>; // [hash, SockStat]
+using SockIOStat    = QSharedPointer<struct sock_io_stat_t>;
 using NetIFAddr     = QSharedPointer<struct net_ifaddr_t>;
 using NetIFAddrsMap = QMultiMap<QString, NetIFAddr>;
 
@@ -11,9 +11,144 @@
 #include <QSharedData>
 #include <QMap>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <libudev.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define SYSFS_PATH_CPU "/sys/devices/system/cpu"
+
 namespace core {
 namespace system {
 
+/**
+ * @brief Reports cpu hotplug through udev "cpu" subsystem events
+ */
+class CPUHotplugMonitor
+{
+public:
+    CPUHotplugMonitor()
+    {
+        m_udev = udev_new();
+        if (m_udev)
+            m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+        if (m_monitor
+                && (udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "cpu", nullptr) < 0
+                    || udev_monitor_enable_receiving(m_monitor) < 0)) {
+            udev_monitor_unref(m_monitor);
+            m_monitor = nullptr;
+        }
+        // monitor fd is non blocking, events are drained on each check
+    }
+    ~CPUHotplugMonitor()
+    {
+        if (m_monitor)
+            udev_monitor_unref(m_monitor);
+        if (m_udev)
+            udev_unref(m_udev);
+    }
+    CPUHotplugMonitor(const CPUHotplugMonitor &) = delete;
+    CPUHotplugMonitor &operator=(const CPUHotplugMonitor &) = delete;
+
+    /**
+     * @brief True on first call & after cpus were added, removed, brought on- or offline
+     */
+    bool changed()
+    {
+        bool changed = m_first;
+        m_first = false;
+        if (!m_monitor)
+            return changed;
+
+        while (auto *device = udev_monitor_receive_device(m_monitor)) {
+            udev_device_unref(device);
+            changed = true;
+        }
+        return changed;
+    }
+
+private:
+    struct udev *m_udev {nullptr};
+    struct udev_monitor *m_monitor {nullptr};
+    bool m_first {true};
+};
+
+/**
+ * @brief Current frequency of all cpus from cpufreq, files are kept open & read again in place
+ */
+class CPUFreqReader
+{
+public:
+    CPUFreqReader() = default;
+    ~CPUFreqReader()
+    {
+        closeFiles();
+    }
+    CPUFreqReader(const CPUFreqReader &) = delete;
+    CPUFreqReader &operator=(const CPUFreqReader &) = delete;
+
+    /**
+     * @brief (Re)open scaling_cur_freq of every cpu, cpus without cpufreq are skipped
+     */
+    void openFiles()
+    {
+        closeFiles();
+
+        DIR *dir = opendir(SYSFS_PATH_CPU);
+        if (!dir)
+            return;
+
+        struct dirent *ent;
+        char path[128];
+        while ((ent = readdir(dir))) {
+            int cpu;
+            if (sscanf(ent->d_name, "cpu%d", &cpu) != 1)
+                continue;
+
+            snprintf(path, sizeof(path), SYSFS_PATH_CPU "/cpu%d/cpufreq/scaling_cur_freq", cpu);
+            int fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd >= 0)
+                m_fds.push_back(fd);
+        }
+        closedir(dir);
+    }
+
+    /**
+     * @brief Highest current frequency (MHz), 0 if no cpu has cpufreq
+     */
+    double maxCurFreq() const
+    {
+        char buf[32];
+        long maxFreq = 0;
+        for (int fd : m_fds) {
+            ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+            if (n <= 0)
+                continue;
+            buf[n] = '\0';
+            maxFreq = std::max(maxFreq, strtol(buf, nullptr, 10));
+        }
+        // kHz
+        return double(maxFreq) / 1000;
+    }
+
+private:
+    void closeFiles()
+    {
+        for (int fd : m_fds)
+            close(fd);
+        m_fds.clear();
+    }
+
+private:
+    std::vector<int> m_fds;
+};
+
 class CPUSet;
 
 enum StatIndex {
@@ -39,10 +174,16 @@ public:
         , m_virtualization {}
         , m_stat {std::make_shared<cpu_stat_t>()}
         , m_usage {std::make_shared<cpu_usage_t>()}
-        , m_statDB {}
-        , m_usageDB {}
+        , m_ncpus {0}
+        , m_stride {0}
+        , m_jiffies {}
+        , m_cpuTotal {}
+        , m_cpuIdle {}
+        , m_cpuOnline {}
         , m_info {}
         , m_infos {}
+        , m_hotplug {}
+        , m_freq {}
     {
 
     }
@@ -61,20 +202,16 @@ public:
         , m_virtualization(other.m_virtualization)
         , m_stat(std::make_shared<cpu_stat_t>(*(other.m_stat)))
         , m_usage(std::make_shared<cpu_usage_t>(*(other.m_usage)))
+        , m_ncpus(other.m_ncpus)
+        , m_stride(other.m_stride)
+        , m_jiffies {other.m_jiffies[kLastStat], other.m_jiffies[kCurrentStat]}
+        , m_cpuTotal(other.m_cpuTotal)
+        , m_cpuIdle(other.m_cpuIdle)
+        , m_cpuOnline(other.m_cpuOnline)
         , m_info(other.m_info)
+        , m_hotplug(other.m_hotplug)
+        , m_freq(other.m_freq)
     {
-        for (auto &stat : other.m_statDB) {
-            if (stat) {
-                auto cp = std::make_shared<cpu_stat_t>(*stat);
-                m_statDB[stat->cpu] = cp;
-            }
-        }
-        for (auto &usage : other.m_usageDB) {
-            if (usage) {
-                auto cp = std::make_shared<cpu_usage_t>(*usage);
-                m_usageDB[usage->cpu] = cp;
-            }
-        }
         for (auto &info : other.m_infos) {
             CPUInfo cp(info);
             m_infos << cp;
@@ -97,14 +234,23 @@ private:
     CPUStat m_stat; // overall stat
     CPUUsage m_usage; // overall usage
 
-    QMap<QByteArray, CPUStat> m_statDB; // per cpu stat
-    QMap<QByteArray, CPUUsage> m_usageDB; // per cpu usage
+    // per cpu stat, cpu N at index N; tables only grow, so steady state reads never allocate
+    int m_ncpus; // cpus in use, highest cpu number + 1
+    int m_stride; // allocated cpus per field, >= m_ncpus
+    std::vector<unsigned long long> m_jiffies[kStatCount]; // field major (field F of cpu N at F * m_stride + N), last & current read
+    std::vector<unsigned long long> m_cpuTotal; // per cpu total jiffies of current read
+    std::vector<unsigned long long> m_cpuIdle; // per cpu idle jiffies of current read
+    std::vector<unsigned char> m_cpuOnline; // cpu listed in current read
 
     qulonglong cpusageTotal[kStatCount] = {0, 0};
     friend class CPUSet;
 
     QMap<QString, QString> m_info;   //overall info
     QList<CPUInfo> m_infos;         //per cpu info
+
+    // topology & identity above are read again on hotplug only, frequency every update; shared by copies
+    std::shared_ptr<CPUHotplugMonitor> m_hotplug;
+    std::shared_ptr<CPUFreqReader> m_freq;
 };
 
 } // namespace system
@@ -0,0 +1,321 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sock_diag.h"
+#include "ddlog.h"
+
+#include <QDebug>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+
+#define SOCK_DIAG_RECV_BUFFER_SIZE (64 * 1024)   // netlink receive buffer size
+#define SOCK_DIAG_RECV_TIMEOUT 1   // receive timeout (1 second)
+
+using namespace DDLog;
+
+namespace core {
+namespace system {
+
+namespace {
+
+// flow keys of one diag record the way /proc/net parsing maps them
+template<typename Fn>
+void forEachFlowKey(int proto, const struct inet_diag_msg *msg, Fn fn)
+{
+    int family = msg->idiag_family;
+    const void *saddr = msg->id.idiag_src;
+    const void *daddr = msg->id.idiag_dst;
+    // convert ipv4 mapped ipv6 address to ipv4
+    if (family == AF_INET6 && IN6_IS_ADDR_V4MAPPED(reinterpret_cast<const struct in6_addr *>(msg->id.idiag_src))) {
+        family = AF_INET;
+        saddr = &msg->id.idiag_src[3];
+        daddr = &msg->id.idiag_dst[3];
+    }
+
+    uint16_t sport = ntohs(msg->id.idiag_sport);
+    uint16_t dport = ntohs(msg->id.idiag_dport);
+    fn(makeFlowKey(family, proto, saddr, sport, daddr, dport));
+    // tcp is mapped in both directions due to its bidirectional piping feature
+    if (proto == IPPROTO_TCP)
+        fn(makeFlowKey(family, proto, daddr, dport, saddr, sport));
+}
+
+// insert one diag record
+void insertSockStat(SockStatTable &table, int proto, const struct inet_diag_msg *msg)
+{
+    if (msg->idiag_inode == 0)
+        return;
+
+    forEachFlowKey(proto, msg, [&table, msg](const flow_key_t &key) {
+        table.insert(key, msg->idiag_inode);
+    });
+}
+
+} // namespace
+
+SockDiag::SockDiag()
+    : m_fd(-1)
+    , m_eventFd(-1)
+    , m_seq(0)
+    , m_buffer(SOCK_DIAG_RECV_BUFFER_SIZE, 0)
+{
+}
+
+SockDiag::~SockDiag()
+{
+    close();
+}
+
+bool SockDiag::open()
+{
+    if (m_fd >= 0)
+        return true;
+
+    m_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (m_fd < 0) {
+        qCDebug(app) << QString("sock_diag socket failed: [%1] %2").arg(errno).arg(strerror(errno));
+        return false;
+    }
+
+    // replies are synchronous, timeout only guards against a stuck kernel module
+    struct timeval tv = {SOCK_DIAG_RECV_TIMEOUT, 0};
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    return true;
+}
+
+void SockDiag::close()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_eventFd >= 0) {
+        ::close(m_eventFd);
+        m_eventFd = -1;
+    }
+}
+
+bool SockDiag::subscribeDestroyed()
+{
+    if (m_eventFd >= 0)
+        return true;
+
+    m_eventFd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_SOCK_DIAG);
+    if (m_eventFd < 0) {
+        qCDebug(app) << QString("sock_diag event socket failed: [%1] %2").arg(errno).arg(strerror(errno));
+        return false;
+    }
+
+    // group tells protocol of a notification, inet_diag_msg only carries the family
+    int on = 1;
+    bool ok = setsockopt(m_eventFd, SOL_NETLINK, NETLINK_PKTINFO, &on, sizeof(on)) == 0;
+    const int groups[] = {SKNLGRP_INET_TCP_DESTROY, SKNLGRP_INET_UDP_DESTROY,
+                          SKNLGRP_INET6_TCP_DESTROY, SKNLGRP_INET6_UDP_DESTROY};
+    for (int group : groups) {
+        if (!ok)
+            break;
+        ok = setsockopt(m_eventFd, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, &group, sizeof(group)) == 0;
+    }
+    if (!ok) {
+        qCDebug(app) << QString("sock_diag destroy notifications unavailable: [%1] %2").arg(errno).arg(strerror(errno));
+        ::close(m_eventFd);
+        m_eventFd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+bool SockDiag::readDestroyed(const std::function<void(const flow_key_t &, ino_t)> &handler)
+{
+    if (m_eventFd < 0)
+        return false;
+
+    char control[CMSG_SPACE(sizeof(struct nl_pktinfo))];
+    while (true) {
+        struct iovec iov = {m_buffer.data(), size_t(m_buffer.size())};
+        struct msghdr mh {};
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_control = control;
+        mh.msg_controllen = sizeof(control);
+
+        ssize_t len = recvmsg(m_eventFd, &mh, 0);
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            // ENOBUFS: kernel dropped notifications, closed sockets may be left behind
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (len == 0)
+            return true;
+
+        uint32_t group {0};
+        for (auto *cmsg = CMSG_FIRSTHDR(&mh); cmsg; cmsg = CMSG_NXTHDR(&mh, cmsg)) {
+            if (cmsg->cmsg_level == SOL_NETLINK && cmsg->cmsg_type == NETLINK_PKTINFO)
+                group = reinterpret_cast<struct nl_pktinfo *>(CMSG_DATA(cmsg))->group;
+        }
+        int proto;
+        if (group == SKNLGRP_INET_TCP_DESTROY || group == SKNLGRP_INET6_TCP_DESTROY)
+            proto = IPPROTO_TCP;
+        else if (group == SKNLGRP_INET_UDP_DESTROY || group == SKNLGRP_INET6_UDP_DESTROY)
+            proto = IPPROTO_UDP;
+        else
+            continue;
+
+        int remaining = int(len);
+        auto *nlh = reinterpret_cast<struct nlmsghdr *>(m_buffer.data());
+        for (; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining)) {
+            if (nlh->nlmsg_type != SOCK_DIAG_BY_FAMILY)
+                continue;
+            if (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg)))
+                continue;
+
+            auto *msg = reinterpret_cast<const struct inet_diag_msg *>(NLMSG_DATA(nlh));
+            forEachFlowKey(proto, msg, [&handler, msg](const flow_key_t &key) {
+                handler(key, msg->idiag_inode);
+            });
+        }
+    }
+}
+
+bool SockDiag::sendRequest(int family, int proto, bool dumpAll, const struct inet_diag_sockid *id)
+{
+    struct {
+        struct nlmsghdr nlh;
+        struct inet_diag_req_v2 req;
+    } msg {};
+
+    msg.nlh.nlmsg_len = sizeof(msg);
+    msg.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    msg.nlh.nlmsg_flags = NLM_F_REQUEST | (dumpAll ? NLM_F_DUMP : 0);
+    msg.nlh.nlmsg_seq = ++m_seq;
+    msg.req.sdiag_family = uint8_t(family);
+    msg.req.sdiag_protocol = uint8_t(proto);
+    msg.req.idiag_states = ~0U;
+    if (id)
+        msg.req.id = *id;
+
+    struct sockaddr_nl nladdr {};
+    nladdr.nl_family = AF_NETLINK;
+
+    ssize_t rc;
+    do {
+        rc = sendto(m_fd, &msg, sizeof(msg), 0, reinterpret_cast<struct sockaddr *>(&nladdr), sizeof(nladdr));
+    } while (rc < 0 && errno == EINTR);
+
+    return rc == ssize_t(sizeof(msg));
+}
+
+bool SockDiag::recvReplies(const std::function<void(const struct inet_diag_msg *)> &handler)
+{
+    while (true) {
+        ssize_t len = recv(m_fd, m_buffer.data(), size_t(m_buffer.size()), 0);
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (len == 0)
+            return false;
+
+        int remaining = int(len);
+        auto *nlh = reinterpret_cast<struct nlmsghdr *>(m_buffer.data());
+        for (; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining)) {
+            // stale reply of a timed out request
+            if (nlh->nlmsg_seq != m_seq)
+                continue;
+
+            if (nlh->nlmsg_type == NLMSG_DONE)
+                return true;
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                auto *err = reinterpret_cast<struct nlmsgerr *>(NLMSG_DATA(nlh));
+                // no socket matches a targeted lookup
+                return err->error == -ENOENT;
+            }
+            if (nlh->nlmsg_type != SOCK_DIAG_BY_FAMILY)
+                continue;
+            if (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg)))
+                continue;
+
+            handler(reinterpret_cast<const struct inet_diag_msg *>(NLMSG_DATA(nlh)));
+
+            // targeted lookups get a single reply without NLMSG_DONE
+            if (!(nlh->nlmsg_flags & NLM_F_MULTI))
+                return true;
+        }
+    }
+}
+
+bool SockDiag::dump(SockStatTable &table)
+{
+    if (!isValid())
+        return false;
+
+    table.clear();
+
+    bool ok {true};
+    const int families[] = {AF_INET, AF_INET6};
+    const int protos[] = {IPPROTO_TCP, IPPROTO_UDP};
+    for (int family : families) {
+        for (int proto : protos) {
+            if (!sendRequest(family, proto, true, nullptr)) {
+                ok = false;
+                continue;
+            }
+            ok = recvReplies([&table, proto](const struct inet_diag_msg *msg) {
+                insertSockStat(table, proto, msg);
+            }) && ok;
+        }
+    }
+
+    return ok;
+}
+
+ino_t SockDiag::lookup(int family, int proto,
+                       const void *laddr, uint16_t lport,
+                       const void *raddr, uint16_t rport)
+{
+    if (!isValid())
+        return 0;
+
+    size_t alen = (family == AF_INET6) ? sizeof(struct in6_addr) : sizeof(struct in_addr);
+    struct inet_diag_sockid id {};
+    id.idiag_cookie[0] = INET_DIAG_NOCOOKIE;
+    id.idiag_cookie[1] = INET_DIAG_NOCOOKIE;
+    if (proto == IPPROTO_UDP) {
+        // udp_dump_one passes src & dst to the udp lookup swapped (for historical reasons), src is remote here
+        memcpy(id.idiag_src, raddr, alen);
+        id.idiag_sport = htons(rport);
+        memcpy(id.idiag_dst, laddr, alen);
+        id.idiag_dport = htons(lport);
+    } else {
+        memcpy(id.idiag_src, laddr, alen);
+        id.idiag_sport = htons(lport);
+        memcpy(id.idiag_dst, raddr, alen);
+        id.idiag_dport = htons(rport);
+    }
+
+    if (!sendRequest(family, proto, false, &id))
+        return 0;
+
+    ino_t ino {0};
+    recvReplies([&ino](const struct inet_diag_msg *msg) {
+        ino = msg->idiag_inode;
+    });
+    return ino;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCK_DIAG_H
+#define SOCK_DIAG_H
+
+#include "sock_stat_table.h"
+
+#include <QByteArray>
+
+#include <functional>
+
+struct inet_diag_msg;
+struct inet_diag_sockid;
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Socket table backend on NETLINK_SOCK_DIAG (inet_diag), binary replies instead of /proc/net text
+ */
+class SockDiag
+{
+public:
+    SockDiag();
+    ~SockDiag();
+
+    /**
+     * @brief Open netlink sock_diag socket
+     * @return false if sock_diag is not available (e.g. inet_diag module missing)
+     */
+    bool open();
+    /**
+     * @brief Close request socket & destroy notification socket
+     */
+    void close();
+    inline bool isValid() const
+    {
+        return m_fd >= 0;
+    }
+
+    /**
+     * @brief Join tcp & udp socket destroy multicast groups (ipv4 & ipv6) on a separate non-blocking socket
+     * @return false if the kernel does not broadcast socket destruction or joining is not permitted
+     */
+    bool subscribeDestroyed();
+    /**
+     * @brief Destroy notification socket, watch it for readability
+     * @return Socket fd, -1 if not subscribed
+     */
+    inline int eventFd() const
+    {
+        return m_eventFd;
+    }
+    /**
+     * @brief Drain pending destroy notifications
+     * @param handler Called with each flow key of a closed socket, inode is 0 if the socket was detached from its file already
+     * @return false if notifications were lost (receive buffer overrun), socket table needs a full dump then
+     */
+    bool readDestroyed(const std::function<void(const flow_key_t &, ino_t)> &handler);
+
+    /**
+     * @brief Dump all tcp & udp sockets (ipv4 & ipv6) into table, same mapping as SysInfo::readSockStat
+     * @param table Socket table, cleared before dumping
+     * @return Return true if all dumps succeeded
+     */
+    bool dump(SockStatTable &table);
+
+    /**
+     * @brief Targeted lookup of the socket owning one flow
+     * @param family AF_INET or AF_INET6
+     * @param proto IPPROTO_TCP or IPPROTO_UDP
+     * @param laddr Local address (in_addr or in6_addr)
+     * @param lport Local port in host byte order
+     * @param raddr Remote address (in_addr or in6_addr)
+     * @param rport Remote port in host byte order
+     * @return Socket inode, 0 if no socket matches
+     */
+    ino_t lookup(int family, int proto,
+                 const void *laddr, uint16_t lport,
+                 const void *raddr, uint16_t rport);
+
+private:
+    bool sendRequest(int family, int proto, bool dumpAll, const struct inet_diag_sockid *id);
+    bool recvReplies(const std::function<void(const struct inet_diag_msg *)> &handler);
+
+    int m_fd;
+    int m_eventFd; // destroy notification socket
+    uint32_t m_seq;
+    QByteArray m_buffer; // netlink receive buffer
+};
+
+} // namespace system
+} // namespace core
+
+#endif // SOCK_DIAG_H
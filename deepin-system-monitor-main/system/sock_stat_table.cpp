@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sock_stat_table.h"
+
+#include "common/hash.h"
+
+namespace core {
+namespace system {
+
+// MurmurHash3 64-bit finalizer
+static inline uint64_t fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+SockStatTable::SockStatTable(int capacity)
+    : m_slots()
+    , m_size(0)
+    , m_mask(0)
+{
+    int n = 16;
+    while (n < capacity)
+        n <<= 1;
+    rehash(n);
+}
+
+uint64_t SockStatTable::hash(const flow_key_t &key)
+{
+    uint64_t words[sizeof(flow_key_t) / sizeof(uint64_t)];
+    memcpy(words, &key, sizeof(flow_key_t));
+
+    // multiply-xor each word, one full avalanche at the end
+    uint64_t h = util::common::global_seed ^ (sizeof(flow_key_t) * 0x9e3779b97f4a7c15ULL);
+    for (auto w : words) {
+        h ^= w * 0x87c37b91114253d5ULL;
+        h = ((h << 31) | (h >> 33)) * 0x4cf5ad432745937fULL;
+    }
+    return fmix64(h);
+}
+
+void SockStatTable::insert(const flow_key_t &key, ino_t ino)
+{
+    if (ino == 0)
+        return;
+
+    // keep load factor under 1/2, probe sequences stay short
+    if ((m_size + 1) * 2 > m_slots.size())
+        rehash(m_slots.size() * 2);
+
+    slot_t *slots = m_slots.data();
+    uint64_t i = hash(key) & m_mask;
+    while (slots[i].ino != 0) {
+        if (slots[i].key == key) {
+            slots[i].ino = ino;
+            return;
+        }
+        i = (i + 1) & m_mask;
+    }
+    slots[i].key = key;
+    slots[i].ino = ino;
+    ++m_size;
+}
+
+ino_t SockStatTable::find(const flow_key_t &key) const
+{
+    const slot_t *slots = m_slots.constData();
+    uint64_t i = hash(key) & m_mask;
+    while (slots[i].ino != 0) {
+        if (slots[i].key == key)
+            return slots[i].ino;
+        i = (i + 1) & m_mask;
+    }
+    return 0;
+}
+
+bool SockStatTable::remove(const flow_key_t &key)
+{
+    slot_t *slots = m_slots.data();
+    uint64_t i = hash(key) & m_mask;
+    while (slots[i].ino != 0 && !(slots[i].key == key))
+        i = (i + 1) & m_mask;
+    if (slots[i].ino == 0)
+        return false;
+
+    // backward shift: move up every following slot whose home is not within (i, j]
+    uint64_t j = i;
+    while (true) {
+        j = (j + 1) & m_mask;
+        if (slots[j].ino == 0)
+            break;
+        uint64_t home = hash(slots[j].key) & m_mask;
+        if (((j - home) & m_mask) >= ((j - i) & m_mask)) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i] = {};
+    --m_size;
+    return true;
+}
+
+void SockStatTable::clear()
+{
+    if (m_size == 0)
+        return;
+
+    memset(static_cast<void *>(m_slots.data()), 0, size_t(m_slots.size()) * sizeof(slot_t));
+    m_size = 0;
+}
+
+void SockStatTable::rehash(int capacity)
+{
+    QVector<slot_t> old;
+    old.swap(m_slots);
+
+    m_slots.resize(capacity);
+    m_mask = uint64_t(capacity - 1);
+    m_size = 0;
+
+    for (const auto &slot : old) {
+        if (slot.ino != 0)
+            insert(slot.key, slot.ino);
+    }
+}
+
+SockIOStatTable::SockIOStatTable(int capacity)
+    : m_slots()
+    , m_size(0)
+    , m_mask(0)
+{
+    int n = 16;
+    while (n < capacity)
+        n <<= 1;
+    rehash(n);
+}
+
+struct sock_io_stat_t *SockIOStatTable::insert(ino_t ino)
+{
+    if ((m_size + 1) * 2 > m_slots.size())
+        rehash(m_slots.size() * 2);
+
+    struct sock_io_stat_t *slots = m_slots.data();
+    uint64_t i = fmix64(uint64_t(ino)) & m_mask;
+    while (slots[i].ino != 0) {
+        if (slots[i].ino == ino)
+            return &slots[i];
+        i = (i + 1) & m_mask;
+    }
+    slots[i] = {};
+    slots[i].ino = ino;
+    ++m_size;
+    return &slots[i];
+}
+
+const struct sock_io_stat_t *SockIOStatTable::find(ino_t ino) const
+{
+    if (ino == 0)
+        return nullptr;
+
+    const struct sock_io_stat_t *slots = m_slots.constData();
+    uint64_t i = fmix64(uint64_t(ino)) & m_mask;
+    while (slots[i].ino != 0) {
+        if (slots[i].ino == ino)
+            return &slots[i];
+        i = (i + 1) & m_mask;
+    }
+    return nullptr;
+}
+
+void SockIOStatTable::clear()
+{
+    if (m_size == 0)
+        return;
+
+    memset(static_cast<void *>(m_slots.data()), 0, size_t(m_slots.size()) * sizeof(struct sock_io_stat_t));
+    m_size = 0;
+}
+
+void SockIOStatTable::rehash(int capacity)
+{
+    QVector<struct sock_io_stat_t> old;
+    old.swap(m_slots);
+
+    m_slots.resize(capacity);
+    m_mask = uint64_t(capacity - 1);
+    m_size = 0;
+
+    for (const auto &slot : old) {
+        if (slot.ino != 0)
+            *insert(slot.ino) = slot;
+    }
+}
+
+void IfAddrSet::insert(const in_addr &addr)
+{
+    if (!contains(addr))
+        m_addrs4 << addr;
+}
+
+void IfAddrSet::insert(const in6_addr &addr)
+{
+    if (!contains(addr))
+        m_addrs6 << addr;
+}
+
+bool IfAddrSet::operator==(const IfAddrSet &rhs) const
+{
+    if (m_addrs4.size() != rhs.m_addrs4.size() || m_addrs6.size() != rhs.m_addrs6.size())
+        return false;
+
+    for (const auto &a : m_addrs4) {
+        if (!rhs.contains(a))
+            return false;
+    }
+    for (const auto &a : m_addrs6) {
+        if (!rhs.contains(a))
+            return false;
+    }
+    return true;
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SOCK_STAT_TABLE_H
+#define SOCK_STAT_TABLE_H
+
+#include "packet.h"
+
+#include <QVector>
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include <netinet/in.h>
+#include <sys/types.h>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief Packed binary 5-tuple, addresses in network byte order, ports in host byte order
+ *
+ * Unused address bytes (ipv4) are zeroed, so keys can be compared & hashed as raw memory.
+ */
+struct flow_key_t {
+    uint8_t     sa_family;      // AF_INET & AF_INET6
+    uint8_t     proto;          // IPPROTO_TCP & IPPROTO_UDP
+    uint16_t    s_port;         // source port
+    uint16_t    d_port;         // destination port
+    uint16_t    reserved;       // always 0
+    uint8_t     s_addr[16];     // source address
+    uint8_t     d_addr[16];     // destination address
+
+    inline bool operator==(const flow_key_t &rhs) const
+    {
+        return memcmp(this, &rhs, sizeof(flow_key_t)) == 0;
+    }
+};
+static_assert(sizeof(flow_key_t) == 40, "flow_key_t must stay packed");
+
+/**
+ * @brief Build flow key from raw in_addr/in6_addr
+ * @param family AF_INET or AF_INET6, selects how many bytes are read from saddr/daddr
+ */
+inline flow_key_t makeFlowKey(int family, int proto,
+                              const void *saddr, uint16_t sport,
+                              const void *daddr, uint16_t dport)
+{
+    flow_key_t key {};
+    size_t len = (family == AF_INET6) ? sizeof(in6_addr) : sizeof(in_addr);
+    key.sa_family = uint8_t(family);
+    key.proto = uint8_t(proto);
+    key.s_port = sport;
+    key.d_port = dport;
+    memcpy(key.s_addr, saddr, len);
+    memcpy(key.d_addr, daddr, len);
+    return key;
+}
+
+/**
+ * @brief Flow key to socket inode mapping, open addressing with linear probing
+ *
+ * Slots live in a single flat array, lookups never allocate. Inode 0 marks an empty slot
+ * (sockets without inode are still in waiting state and never attributed).
+ */
+class SockStatTable
+{
+public:
+    explicit SockStatTable(int capacity = 1024);
+
+    /**
+     * @brief Map key to inode, replaces the previous inode if key exists already
+     */
+    void insert(const flow_key_t &key, ino_t ino);
+    /**
+     * @brief Find inode of key
+     * @return Socket inode, 0 if not found
+     */
+    ino_t find(const flow_key_t &key) const;
+    /**
+     * @brief Remove key, following slots of the probe sequence are shifted back (no tombstones)
+     * @return Return true if key was found
+     */
+    bool remove(const flow_key_t &key);
+    /**
+     * @brief Remove all entries, capacity is kept
+     */
+    void clear();
+    /**
+     * @brief Exchange contents with other table, no slot is copied
+     */
+    inline void swap(SockStatTable &other)
+    {
+        m_slots.swap(other.m_slots);
+        std::swap(m_size, other.m_size);
+        std::swap(m_mask, other.m_mask);
+    }
+
+    inline int size() const { return m_size; }
+    inline int capacity() const { return m_slots.size(); }
+
+    static uint64_t hash(const flow_key_t &key);
+
+private:
+    struct slot_t {
+        flow_key_t key;
+        ino_t ino;
+    };
+
+    void rehash(int capacity);
+
+    QVector<slot_t> m_slots;
+    int m_size;
+    uint64_t m_mask;
+};
+
+/**
+ * @brief Socket inode to io counters mapping, open addressing with linear probing
+ *
+ * Counters are stored inline in the slot array, updating an existing socket never allocates.
+ * Inode 0 marks an empty slot.
+ */
+class SockIOStatTable
+{
+public:
+    explicit SockIOStatTable(int capacity = 256);
+
+    /**
+     * @brief Find counters of ino, zeroed counters are inserted if not found
+     * @param ino Socket inode, must not be 0
+     */
+    struct sock_io_stat_t *insert(ino_t ino);
+    /**
+     * @brief Find counters of ino
+     * @return Counters, nullptr if not found
+     */
+    const struct sock_io_stat_t *find(ino_t ino) const;
+    /**
+     * @brief Drop all entries pred returns true for, the table is rebuilt in place
+     */
+    template<typename Pred>
+    void removeIf(Pred pred)
+    {
+        QVector<struct sock_io_stat_t> old;
+        old.swap(m_slots);
+        m_slots.resize(old.size());
+        m_size = 0;
+        for (const auto &slot : old) {
+            if (slot.ino != 0 && !pred(slot))
+                *insert(slot.ino) = slot;
+        }
+    }
+    /**
+     * @brief Remove all entries, capacity is kept
+     */
+    void clear();
+
+    inline int size() const { return m_size; }
+    inline int capacity() const { return m_slots.size(); }
+
+private:
+    void rehash(int capacity);
+
+    QVector<struct sock_io_stat_t> m_slots;
+    int m_size;
+    uint64_t m_mask;
+};
+
+/**
+ * @brief Set of local interface addresses, compared as raw in_addr/in6_addr
+ */
+class IfAddrSet
+{
+public:
+    inline void clear()
+    {
+        m_addrs4.clear();
+        m_addrs6.clear();
+    }
+    void insert(const in_addr &addr);
+    void insert(const in6_addr &addr);
+
+    inline bool contains(const in_addr &addr) const
+    {
+        for (const auto &a : m_addrs4) {
+            if (a.s_addr == addr.s_addr)
+                return true;
+        }
+        return false;
+    }
+    inline bool contains(const in6_addr &addr) const
+    {
+        for (const auto &a : m_addrs6) {
+            if (memcmp(&a, &addr, sizeof(in6_addr)) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    inline int size() const
+    {
+        return m_addrs4.size() + m_addrs6.size();
+    }
+    inline const QVector<in_addr> &addrs4() const { return m_addrs4; }
+    inline const QVector<in6_addr> &addrs6() const { return m_addrs6; }
+
+    /**
+     * @brief Same addresses, insertion order ignored
+     */
+    bool operator==(const IfAddrSet &rhs) const;
+    inline bool operator!=(const IfAddrSet &rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    // a host has a handful of addresses, linear scan beats hashing here
+    QVector<in_addr> m_addrs4;
+    QVector<in6_addr> m_addrs6;
+};
+
+} // namespace system
+} // namespace core
+
+#endif // SOCK_STAT_TABLE_H
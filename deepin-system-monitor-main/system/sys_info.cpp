@@ -16,8 +16,6 @@
 
 #include <QString>
 #include <QtDBus>
-#include <QFileInfo>
-#include <QDir>
 
 #include <sys/time.h>
 #include <unistd.h>
@@ -76,22 +74,19 @@ SysInfo *SysInfo::instance()
     return monitor->sysInfo();
 }
 
-bool SysInfo::readSockStat(SockStatMap &statMap)
+bool SysInfo::readSockStat(SockStatTable &statTable)
 {
     bool ok {true};
 
-    auto parseSocks = [](int family, int proto, const char *proc, SockStatMap & statMap) -> bool {
+    auto parseSocks = [](int family, int proto, const char *proc, SockStatTable & statTable) -> bool {
         bool ok {true};
         FILE *fp {};
         const size_t BLEN = 4096;
-        QByteArray buffer {BLEN, 0};
+        char buffer[BLEN] {};
         int nr {};
         ino_t ino {};
         char s_addr[128] {}, d_addr[128] {};
-        uint64_t hash {};
-        QByteArray fmtbuf {};
-        uint64_t cchash[2] {};
-        QString patternA {}, patternB {};
+        struct sock_stat_t stat {};
 
         errno = 0;
         if (!(fp = fopen(proc, "r")))
@@ -99,17 +94,15 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
             return !ok;
         }
 
-        while (fgets(buffer.data(), BLEN, fp))
+        while (fgets(buffer, BLEN, fp))
         {
-            auto stat = QSharedPointer<struct sock_stat_t>::create();
-
             //*****************************************************************
-            nr = sscanf(buffer.data(), "%*s %64[0-9A-Fa-f]:%x %64[0-9A-Fa-f]:%x %*x %*s %*s %*s %u %*u %ld",
+            nr = sscanf(buffer, "%*s %64[0-9A-Fa-f]:%x %64[0-9A-Fa-f]:%x %*x %*s %*s %*s %u %*u %ld",
                         s_addr,
-                        &stat->s_port,
+                        &stat.s_port,
                         d_addr,
-                        &stat->d_port,
-                        &stat->uid,
+                        &stat.d_port,
+                        &stat.uid,
                         &ino);
 
             // ignore first line
@@ -121,71 +114,47 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
                 continue;
             }
 
-            stat->ino = ino;
-            stat->sa_family = family;
-            stat->proto = proto;
+            stat.ino = ino;
+            stat.sa_family = family;
+            stat.proto = proto;
 
             // saddr & daddr
             if (family == AF_INET6) {
                 sscanf(s_addr, "%08x%08x%08x%08x",
-                       &stat->s_addr.in6.s6_addr32[0],
-                       &stat->s_addr.in6.s6_addr32[1],
-                       &stat->s_addr.in6.s6_addr32[2],
-                       &stat->s_addr.in6.s6_addr32[3]);
+                       &stat.s_addr.in6.s6_addr32[0],
+                       &stat.s_addr.in6.s6_addr32[1],
+                       &stat.s_addr.in6.s6_addr32[2],
+                       &stat.s_addr.in6.s6_addr32[3]);
                 sscanf(d_addr, "%08x%08x%08x%08x",
-                       &stat->d_addr.in6.s6_addr32[0],
-                       &stat->d_addr.in6.s6_addr32[1],
-                       &stat->d_addr.in6.s6_addr32[2],
-                       &stat->d_addr.in6.s6_addr32[3]);
+                       &stat.d_addr.in6.s6_addr32[0],
+                       &stat.d_addr.in6.s6_addr32[1],
+                       &stat.d_addr.in6.s6_addr32[2],
+                       &stat.d_addr.in6.s6_addr32[3]);
                 // convert ipv4 mapped ipv6 address to ipv4
-                if (stat->s_addr.in6.s6_addr32[0] == 0x0 &&
-                        stat->s_addr.in6.s6_addr32[1] == 0x0 &&
-                        stat->s_addr.in6.s6_addr32[2] == 0xffff0000) {
-                    stat->sa_family = AF_INET;
-                    stat->s_addr.in4.s_addr = stat->s_addr.in6.s6_addr32[3];
-                    stat->d_addr.in4.s_addr = stat->d_addr.in6.s6_addr32[3];
+                if (stat.s_addr.in6.s6_addr32[0] == 0x0 &&
+                        stat.s_addr.in6.s6_addr32[1] == 0x0 &&
+                        stat.s_addr.in6.s6_addr32[2] == 0xffff0000) {
+                    stat.sa_family = AF_INET;
+                    stat.s_addr.in4.s_addr = stat.s_addr.in6.s6_addr32[3];
+                    stat.d_addr.in4.s_addr = stat.d_addr.in6.s6_addr32[3];
                 }
             } else {
-                sscanf(s_addr, "%x", &stat->s_addr.in4.s_addr);
-                sscanf(d_addr, "%x", &stat->d_addr.in4.s_addr);
+                sscanf(s_addr, "%x", &stat.s_addr.in4.s_addr);
+                sscanf(d_addr, "%x", &stat.d_addr.in4.s_addr);
             }
 
-            if (stat->sa_family == AF_INET) {
-                char saddr_str[INET_ADDRSTRLEN + 1] {}, daddr_str[INET_ADDRSTRLEN + 1] {};
-                inet_ntop(AF_INET, &stat->s_addr.in4, saddr_str, INET_ADDRSTRLEN);
-                inet_ntop(AF_INET, &stat->d_addr.in4, daddr_str, INET_ADDRSTRLEN);
-
-                patternA = QString("%1:%2-%3:%4").arg(saddr_str).arg(stat->s_port).arg(daddr_str).arg(stat->d_port);
-                if (proto == IPPROTO_TCP) {
-                    patternB = QString("%1:%2-%3:%4").arg(daddr_str).arg(stat->d_port).arg(saddr_str).arg(stat->s_port);
-                }
-
-            } else if (stat->sa_family == AF_INET6) {
-                char saddr6_str[INET6_ADDRSTRLEN + 1] {}, daddr6_str[INET6_ADDRSTRLEN + 1] {};
-                inet_ntop(AF_INET6, &stat->s_addr.in6, saddr6_str, INET6_ADDRSTRLEN);
-                inet_ntop(AF_INET6, &stat->d_addr.in6, daddr6_str, INET6_ADDRSTRLEN);
-
-                patternA = QString("%1:%2-%3:%4").arg(saddr6_str).arg(stat->s_port).arg(daddr6_str).arg(stat->d_port);
-                if (proto == IPPROTO_TCP) {
-                    patternB = QString("%1:%2-%3:%4").arg(daddr6_str).arg(stat->d_port).arg(saddr6_str).arg(stat->s_port);
-                }
-
-            } else {
-                // unexpected here
-            }
-
-            fmtbuf = patternA.toLocal8Bit();
-            util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-            hash = cchash[0];
-            statMap.insert(hash, stat);
+            statTable.insert(makeFlowKey(stat.sa_family, proto,
+                                         &stat.s_addr, uint16_t(stat.s_port),
+                                         &stat.d_addr, uint16_t(stat.d_port)),
+                             stat.ino);
 
             // if it's TCP, we need add reverse mapping due to its bidirectional piping feature,
             // otherwise we wont be able to get the inode
             if (proto == IPPROTO_TCP) {
-                fmtbuf = patternB.toLocal8Bit();
-                util::common::hash(fmtbuf.constData(), fmtbuf.length(), util::common::global_seed, cchash);
-                hash = cchash[0];
-                statMap.insert(hash, stat);
+                statTable.insert(makeFlowKey(stat.sa_family, proto,
+                                             &stat.d_addr, uint16_t(stat.d_port),
+                                             &stat.s_addr, uint16_t(stat.s_port)),
+                                 stat.ino);
             }
         }
         if (ferror(fp))
@@ -197,12 +166,12 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
         return ok;
     };
 
-    statMap.clear();
+    statTable.clear();
 
-    ok = parseSocks(AF_INET, IPPROTO_TCP, PROC_PATH_SOCK_TCP, statMap);
-    ok = parseSocks(AF_INET, IPPROTO_UDP, PROC_PATH_SOCK_UDP, statMap) && ok;
-    ok = parseSocks(AF_INET6, IPPROTO_TCP, PROC_PATH_SOCK_TCP6, statMap) && ok;
-    ok = parseSocks(AF_INET6, IPPROTO_UDP, PROC_PATH_SOCK_UDP6, statMap) && ok;
+    ok = parseSocks(AF_INET, IPPROTO_TCP, PROC_PATH_SOCK_TCP, statTable);
+    ok = parseSocks(AF_INET, IPPROTO_UDP, PROC_PATH_SOCK_UDP, statTable) && ok;
+    ok = parseSocks(AF_INET6, IPPROTO_TCP, PROC_PATH_SOCK_TCP6, statTable) && ok;
+    ok = parseSocks(AF_INET6, IPPROTO_UDP, PROC_PATH_SOCK_UDP6, statTable) && ok;
 
     return ok;
 }
@@ -210,9 +179,7 @@ bool SysInfo::readSockStat(SockStatMap &statMap)
 void SysInfo::readSysInfo()
 {
     d->nfds = read_file_nr();
-    d->nprocs = read_processes();
-    d->nthrs = read_threads();
-    
+    // nprocs is set by ProcessSet from its /proc scan, nthrs comes with the load average
     read_uptime(d->uptime);
     read_btime(d->btime);
     read_loadavg(d->loadAvg);
@@ -264,35 +231,6 @@ quint32 SysInfo::read_file_nr()
     return 0;
 }
 
-quint32 SysInfo::read_threads()
-{
-    QDir dir("/proc");
-    QFileInfoList infoList = dir.entryInfoList();
-    quint32 threads = 0;
-    for (QFileInfo info : infoList) {
-        if (info.isDir() && info.fileName().toInt() > 0) {
-            QDir taskDir("/proc/" + info.fileName() + "/task");
-            threads += taskDir.entryInfoList().count();
-        }
-    }
-
-    return threads;
-}
-
-quint32 SysInfo::read_processes()
-{
-    QDir dir("/proc");
-    QFileInfoList infoList = dir.entryInfoList();
-    quint32 processes = 0;
-    for (QFileInfo info : infoList) {
-        if (info.isDir() && info.fileName().toInt() > 0) {
-            processes++;
-        }
-    }
-
-    return processes;
-}
-
 QString SysInfo::read_hostname()
 {
     QDBusInterface busIf("org.freedesktop.hostname1",
@@ -406,6 +344,8 @@ void SysInfo::read_loadavg(LoadAvg &loadAvg)
             loadAvg->lavg_1m = cpuStatus[0].toFloat();
             loadAvg->lavg_5m = cpuStatus[1].toFloat();
             loadAvg->lavg_15m = cpuStatus[2].toFloat();
+            // runnable/existing scheduling entities, i.e. threads of all processes
+            d->nthrs = cpuStatus[3].section('/', 1, 1).toUInt();
 
             return ;
         }
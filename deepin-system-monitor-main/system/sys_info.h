@@ -9,6 +9,7 @@
 // local
 #include "private/sys_info_p.h"
 #include "packet.h"
+#include "sock_stat_table.h"
 // qt
 #include <QtGlobal>
 #include <QSharedDataPointer>
@@ -77,12 +78,10 @@ public:
 
     void readSysInfo();
     void readSysInfoStatic();
-    static bool readSockStat(SockStatMap &statMap);
+    static bool readSockStat(SockStatTable &statTable);
 
 private:
     quint32 read_file_nr();
-    quint32 read_threads();
-    quint32 read_processes();
     QString read_hostname();
     QString read_arch();
     QString read_version();
@@ -6,6 +6,10 @@
 #include "system_monitor.h"
 
 #include "device_db.h"
+#include "cpu_set.h"
+#include "diskio_info.h"
+#include "mem.h"
+#include "net_info.h"
 #include "process/process_db.h"
 #include "process/desktop_entry_cache_updater.h"
 #include "wm/wm_window_list.h"
@@ -13,6 +17,8 @@
 
 #include <QTimerEvent>
 
+#define METRICS_SNAPSHOT_OPEN_INTERVAL 5   // retry to become the sampler while another instance is (5 seconds)
+
 using namespace common::core;
 
 namespace core {
@@ -82,6 +88,7 @@ void SystemMonitor::timerEvent(QTimerEvent *event)
             m_sysInfo->readSysInfo();
             m_deviceDB->update();
             m_processDB->update();
+            publishMetricsSnapshot();
         } else {
             emit statInfoUpdated();
             recountAppAndProcess();
@@ -96,27 +103,94 @@ void SystemMonitor::updateSystemMonitorInfo()
     m_sysInfo->readSysInfo();
     m_deviceDB->update();
     m_processDB->update();
+    publishMetricsSnapshot();
 
     emit statInfoUpdated();
     recountAppAndProcess();
 }
 
+void SystemMonitor::publishMetricsSnapshot()
+{
+    if (!m_snapshotWriter.isValid()) {
+        // main window & dock popup both run a system monitor, only one of them publishes
+        time_t now = time(nullptr);
+        if (m_lastSnapshotOpen && now - m_lastSnapshotOpen < METRICS_SNAPSHOT_OPEN_INTERVAL)
+            return;
+        m_lastSnapshotOpen = now;
+        if (!m_snapshotWriter.open())
+            return;
+    }
+
+    auto *snapshot = m_snapshotWriter.beginWrite();
+    auto &system = snapshot->system;
+
+    auto stat = m_deviceDB->cpuSet()->stat();
+    if (stat) {
+        system.cpu_user = stat->user;
+        system.cpu_nice = stat->nice;
+        system.cpu_sys = stat->sys;
+        system.cpu_idle = stat->idle;
+        system.cpu_iowait = stat->iowait;
+        system.cpu_hardirq = stat->hardirq;
+        system.cpu_softirq = stat->softirq;
+        system.cpu_steal = stat->steal;
+        system.cpu_guest = stat->guest;
+        system.cpu_guest_nice = stat->guest_nice;
+    }
+
+    MemInfo *mem = m_deviceDB->memInfo();
+    system.mem_total = mem->memTotal();
+    system.mem_available = mem->memAvailable();
+    system.swap_total = mem->swapTotal();
+    system.swap_free = mem->swapFree();
+
+    NetInfo *net = m_deviceDB->netInfo();
+    system.net_rx_bytes = net->totalRecvBytes();
+    system.net_tx_bytes = net->totalSentBytes();
+    system.net_rx_bps = net->recvBps();
+    system.net_tx_bps = net->sentBps();
+
+    DiskIOInfo *diskIo = m_deviceDB->diskIoInfo();
+    system.disk_read_bps = diskIo->diskIoReadBps();
+    system.disk_write_bps = diskIo->diskIoWriteBps();
+
+    system.nthreads = m_sysInfo->nthreads();
+
+    ProcessSnapshotPtr procs = m_processDB->processSet()->snapshot();
+    uint32_t nprocs = uint32_t(qMin(procs->size(), int(METRICS_SNAPSHOT_MAX_PROCS)));
+    for (uint32_t i = 0; i < nprocs; ++i) {
+        auto &proc = snapshot->procs[i];
+        proc.pid = procs->pid(int(i));
+        proc.uid = procs->uid(int(i));
+        QByteArray name = procs->name(int(i)).toLocal8Bit();
+        strncpy(proc.name, name.constData(), sizeof(proc.name) - 1);
+        proc.name[sizeof(proc.name) - 1] = '\0';
+        proc.cpu = procs->cpu(int(i));
+        proc.memory = procs->memory(int(i));
+        proc.read_bps = procs->readBps(int(i));
+        proc.write_bps = procs->writeBps(int(i));
+        proc.recv_bps = procs->recvBps(int(i));
+        proc.sent_bps = procs->sentBps(int(i));
+    }
+    system.nprocs = nprocs;
+
+    m_snapshotWriter.endWrite();
+}
+
 /**
    @brief Count current apps and processes on SystemMonitor child thread.
  */
 void SystemMonitor::recountAppAndProcess()
 {
-    ProcessSet *processSet = m_processDB->processSet();
+    ProcessSnapshotPtr snapshot = m_processDB->processSet()->snapshot();
     // count all app
-    const QList<pid_t> &newpidlst = processSet->getPIDList();
     int appCount = 0;
-    for (const auto &pid : newpidlst) {
-        auto process = processSet->getProcessById(pid);
-        if (process.appType() == kFilterApps)
+    for (int i = 0; i < snapshot->size(); ++i) {
+        if (snapshot->appType(i) == kFilterApps)
             appCount++;
     }
 
-    emit appAndProcCountUpdate(appCount, newpidlst.size());
+    emit appAndProcCountUpdate(appCount, snapshot->size());
 }
 
 } // namespace system
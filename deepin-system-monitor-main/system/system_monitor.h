@@ -6,6 +6,8 @@
 #ifndef SYSTEM_MONITOR_H
 #define SYSTEM_MONITOR_H
 
+#include "metrics_snapshot.hpp"
+
 #include <QObject>
 #include <QBasicTimer>
 
@@ -50,6 +52,10 @@ protected:
 private:
     void updateSystemMonitorInfo();
     void recountAppAndProcess();
+    /**
+     * @brief Publish latest sample to the shared metrics snapshot, if this instance is the sampler
+     */
+    void publishMetricsSnapshot();
 
 private:
     SysInfo      *m_sysInfo;
@@ -57,6 +63,11 @@ private:
     ProcessDB    *m_processDB;
 
     QBasicTimer m_basictimer;
+
+    // shared metrics snapshot for dock plugin & daemon
+    common::MetricsSnapshotWriter m_snapshotWriter;
+    // last attempt to become the sampler
+    time_t m_lastSnapshotOpen {};
 };
 
 } // namespace system
@@ -8,9 +8,113 @@
 #include<unistd.h>
 #include<sys/ioctl.h>
 #include <linux/wireless.h>
+#include <linux/nl80211.h>
+#include <net/if.h>
+#include <time.h>
+
+#include <netlink/genl/genl.h>
+#include <netlink/genl/ctrl.h>
+
+#define NL80211_RECV_TIMEOUT 100 // ms, the kernel answers right away, never wait on a stuck socket
+#define NL80211_RESOLVE_RETRY_INTERVAL 60 // seconds before nl80211 family is resolved again after a failure
+
 namespace core{
 namespace system{
 
+namespace {
+
+struct inet_socket_t {
+    inet_socket_t()
+        : fd(socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0))
+    {
+    }
+    ~inet_socket_t()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+    int fd;
+};
+
+// generic netlink socket bound to the nl80211 family
+struct nl80211_socket_t {
+    ~nl80211_socket_t()
+    {
+        close();
+    }
+    bool open()
+    {
+        if (sock)
+            return true;
+        // no cfg80211 loaded (yet), no nl80211 capable device either; the module may come with a usb dongle later
+        if (retryAfter && time(nullptr) < retryAfter)
+            return false;
+
+        sock = nl_socket_alloc();
+        if (!sock)
+            return false;
+        if (genl_connect(sock) < 0) {
+            close();
+            return false;
+        }
+        struct timeval tv = {0, NL80211_RECV_TIMEOUT * 1000};
+        setsockopt(nl_socket_get_fd(sock), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        family = genl_ctrl_resolve(sock, NL80211_GENL_NAME);
+        if (family < 0) {
+            retryAfter = time(nullptr) + NL80211_RESOLVE_RETRY_INTERVAL;
+            close();
+            return false;
+        }
+        retryAfter = 0;
+        return true;
+    }
+    // replies left behind by a failed request would confuse the next one, start over
+    void close()
+    {
+        nl_socket_free(sock);
+        sock = nullptr;
+    }
+    struct nl_sock *sock {nullptr};
+    int family {-1};
+    time_t retryAfter {0}; // resolve failed, don't try again before this time
+};
+
+int handleStation(struct nl_msg *msg, void *arg)
+{
+    auto *gnlh = static_cast<struct genlmsghdr *>(nlmsg_data(nlmsg_hdr(msg)));
+    struct nlattr *attrs[NL80211_ATTR_MAX + 1];
+    struct nlattr *sinfo[NL80211_STA_INFO_MAX + 1];
+    struct nlattr *rinfo[NL80211_RATE_INFO_MAX + 1];
+
+    nla_parse(attrs, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0), genlmsg_attrlen(gnlh, 0), nullptr);
+    if (!attrs[NL80211_ATTR_STA_INFO]
+            || nla_parse_nested(sinfo, NL80211_STA_INFO_MAX, attrs[NL80211_ATTR_STA_INFO], nullptr)
+            || !sinfo[NL80211_STA_INFO_TX_BITRATE]
+            || nla_parse_nested(rinfo, NL80211_RATE_INFO_MAX, sinfo[NL80211_STA_INFO_TX_BITRATE], nullptr))
+        return NL_SKIP;
+
+    // 100 kbit/s units
+    unsigned int rate = 0;
+    if (rinfo[NL80211_RATE_INFO_BITRATE32])
+        rate = nla_get_u32(rinfo[NL80211_RATE_INFO_BITRATE32]);
+    else if (rinfo[NL80211_RATE_INFO_BITRATE])
+        rate = nla_get_u16(rinfo[NL80211_RATE_INFO_BITRATE]);
+
+    // a managed interface has the access point as its only station
+    auto *bitrate = static_cast<unsigned int *>(arg);
+    if (rate / 10 > *bitrate)
+        *bitrate = rate / 10;
+    return NL_SKIP;
+}
+
+} // namespace
+
+int inet_ioctl_socket()
+{
+    static thread_local inet_socket_t sock;
+    return sock.fd;
+}
+
 wireless::wireless()
 {
 }
@@ -51,6 +155,11 @@ unsigned char wireless::noise_level()
     return  m_noise_level;
 }
 
+unsigned int wireless::bitrate()
+{
+    return m_bitrate;
+}
+
 bool wireless::is_wireless()
 {
     return m_bwireless;
@@ -58,7 +167,7 @@ bool wireless::is_wireless()
 
 bool wireless::read_wireless_info()
 {
-    if(m_ifname.isNull()){
+    if(m_ifname.isNull() || m_ifname.size() >= IFNAMSIZ){
         m_bwireless =false;
         return false;
     }
@@ -71,16 +180,14 @@ bool wireless::read_wireless_info()
     strcpy(wrq.ifr_name,m_ifname.data());
     wrq.u.data.pointer = &stats;
     wrq.u.data.length=sizeof(iw_statistics);
-    int sock = 0;
-    if ((sock = socket(AF_INET, SOCK_DGRAM, 0)) == -1) {
+    int sock = inet_ioctl_socket();
+    if (sock == -1) {
           m_bwireless = false;
-          close(sock);
           return false;
      }
 
     if (ioctl(sock, SIOCGIWSTATS, &wrq) == -1) {
         m_bwireless = false;
-        close(sock);
         return false;
     }
 
@@ -88,7 +195,6 @@ bool wireless::read_wireless_info()
     wrq.u.essid.length = 256;
     if (ioctl(sock, SIOCGIWESSID, &wrq) == -1) {
         m_bwireless = false;
-        close(sock);
         return false;
     }
 
@@ -99,9 +205,35 @@ bool wireless::read_wireless_info()
     m_signal_levle = stats.qual.level;
     m_noise_level = stats.qual.noise;
     m_bwireless = true;
-    close(sock);
+    read_bitrate();
     return true;
 }
 
+void wireless::read_bitrate()
+{
+    static thread_local nl80211_socket_t nl80211;
+    m_bitrate = 0;
+    if (!nl80211.open())
+        return;
+
+    unsigned int ifindex = if_nametoindex(m_ifname.constData());
+    if (ifindex == 0)
+        return;
+
+    struct nl_msg *msg = nlmsg_alloc();
+    if (!msg)
+        return;
+    struct nl_cb *cb = nl_cb_alloc(NL_CB_DEFAULT);
+    if (cb) {
+        genlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, nl80211.family, 0, NLM_F_DUMP, NL80211_CMD_GET_STATION, 0);
+        nla_put_u32(msg, NL80211_ATTR_IFINDEX, ifindex);
+        nl_cb_set(cb, NL_CB_VALID, NL_CB_CUSTOM, &handleStation, &m_bitrate);
+        if (nl_send_auto(nl80211.sock, msg) < 0 || nl_recvmsgs(nl80211.sock, cb) < 0)
+            nl80211.close();
+        nl_cb_put(cb);
+    }
+    nlmsg_free(msg);
+}
+
 }
 }
@@ -10,6 +10,12 @@
 namespace core {
 namespace system {
 
+/**
+ * @brief AF_INET datagram socket for interface ioctls (SIOCGIW*, SIOCETHTOOL...), opened once per thread
+ * @return Socket fd, -1 if it could not be created
+ */
+int inet_ioctl_socket();
+
 class wireless
 {
 public:
@@ -21,10 +27,14 @@ public:
     unsigned char link_quality();
     unsigned char signal_levle();
     unsigned char noise_level();
+    // tx bitrate to the associated station (Mb/s), 0 if not associated
+    unsigned int bitrate();
 
     bool is_wireless();
 protected:
     bool read_wireless_info();
+    // nl80211 station dump, no external tool involved
+    void read_bitrate();
 
 
 private:
@@ -35,6 +45,7 @@ private:
     unsigned char m_link_quality;
     unsigned char m_signal_levle;
     unsigned char m_noise_level;
+    unsigned int m_bitrate {0};
 };
 
 
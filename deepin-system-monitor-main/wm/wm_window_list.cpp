@@ -10,11 +10,13 @@
 #include "system/system_monitor_thread.h"
 #include "process/process_db.h"
 #include "common/common.h"
+#include "common/hash.h"
 #include "helper.hpp"
 
 #include <QtDBus>
 
 #include <xcb/xcb.h>
+#include <xcb/xcb_icccm.h>
 
 using namespace core::process;
 using namespace common::core;
@@ -31,15 +33,171 @@ struct XReplyDeleter {
     }
 };
 using XGetPropertyReply = std::unique_ptr<xcb_get_property_reply_t, XReplyDeleter>;
-using XGetAtomNameReply = std::unique_ptr<xcb_get_atom_name_reply_t, XReplyDeleter>;
+using XEvent = std::unique_ptr<xcb_generic_event_t, XReplyDeleter>;
 
 const int maxImageW = 1024;
 const int maxImageH = 1024;
 const int offsetImagePointerWH = 2;
+// window icons are kept at most this large, big enough for the process attribute dialog on hidpi screens
+const int kWindowIconSize = 128;
+
+// pending property requests of one window, replies are collected after all requests of a batch are sent
+struct window_cookies_t {
+    WMWId winId;
+    xcb_get_property_cookie_t pid;
+    xcb_get_property_cookie_t netName;
+    xcb_get_property_cookie_t name;
+    xcb_get_property_cookie_t type;
+};
+
+static window_cookies_t requestWindowInfo(const WMConnection &wmConn, WMWId winId)
+{
+    auto *conn = wmConn.xcb_connection();
+    window_cookies_t cookies {};
+    cookies.winId = winId;
+    // pid
+    cookies.pid = xcb_get_property(conn, 0, winId, wmConn.atom(WMAtom::_NET_WM_PID), XCB_ATOM_CARDINAL, 0, 4);
+    // title, WM_NAME requested along so a window without _NET_WM_NAME costs no extra round trip
+    cookies.netName = xcb_get_property(conn, 0, winId, wmConn.atom(WMAtom::_NET_WM_NAME), wmConn.atom(WMAtom::UTF8_STRING), 0, BUFSIZ);
+    cookies.name = xcb_icccm_get_wm_name(conn, winId);
+    // type
+    cookies.type = xcb_get_property(conn, 0, winId, wmConn.atom(WMAtom::_NET_WM_WINDOW_TYPE), XCB_ATOM_ATOM, 0, BUFSIZ);
+    return cookies;
+}
+
+static WMWindow readWindowInfo(const WMConnection &wmConn, const window_cookies_t &cookies, bool *gui)
+{
+    WMWindow window(new struct wm_window_t());
+    window->winId = cookies.winId;
+
+    auto *conn = wmConn.xcb_connection();
+    XGetPropertyReply pidReply(xcb_get_property_reply(conn, cookies.pid, nullptr));
+    if (pidReply && pidReply->type == XCB_ATOM_CARDINAL && xcb_get_property_value_length(pidReply.get()) >= int(sizeof(pid_t))) {
+        auto *pid = reinterpret_cast<pid_t *>(xcb_get_property_value(pidReply.get()));
+        window->pid = *pid;
+    } else
+        window->pid = -1;
+
+    XGetPropertyReply netNameReply(xcb_get_property_reply(conn, cookies.netName, nullptr));
+    XGetPropertyReply nameReply(xcb_get_property_reply(conn, cookies.name, nullptr));
+    auto *titleReply = (netNameReply && netNameReply->type != XCB_NONE) ? netNameReply.get() : nameReply.get();
+    if (titleReply && titleReply->type != XCB_NONE) {
+        auto *name = reinterpret_cast<const char *>(xcb_get_property_value(titleReply));
+        int len = xcb_get_property_value_length(titleReply);
+        if (len != 0) {
+            if (titleReply->type == XCB_ATOM_STRING) {
+                window->title = QString::fromLocal8Bit(name, len);
+            } else if (titleReply->type == wmConn.atom(WMAtom::UTF8_STRING)) {
+                window->title = QString::fromUtf8(name, len);
+            }
+        }
+    }
+
+    XGetPropertyReply typeReply(xcb_get_property_reply(conn, cookies.type, nullptr));
+    bool isGui = false;
+    if (typeReply && typeReply->type != XCB_NONE && typeReply->value_len > 0) {
+        // atoms compared directly, no atom name lookups
+        auto *atoms = reinterpret_cast<xcb_atom_t *>(xcb_get_property_value(typeReply.get()));
+        for (uint32_t i = 0; i < typeReply->value_len; ++i) {
+            if (atoms[i] == wmConn.atom(WMAtom::_NET_WM_WINDOW_TYPE_NORMAL)
+                    || atoms[i] == wmConn.atom(WMAtom::_NET_WM_WINDOW_TYPE_DIALOG)) {
+                isGui = true;
+                break;
+            }
+        }
+    }
+    if (gui)
+        *gui = isGui;
+
+    return window;
+}
+
+// largest icon of a _NET_WM_ICON reply, scaled down to kWindowIconSize
+static QImage readWindowIcon(xcb_get_property_reply_t *reply)
+{
+    if (!reply)
+        return {};
+
+    int len = xcb_get_property_value_length(reply);
+    if (len < 2)
+        return {};
+
+    uint *data = reinterpret_cast<uint *>(xcb_get_property_value(reply));
+    if (!data)
+        return {};
+
+    //get the maximum image from data
+    int max_w = 0;
+    int max_h = 0;
+
+    uint *max_icon = nullptr;
+    uint *data_end = reinterpret_cast<uint *>(xcb_get_property_value_end(reply).data);
+
+    while ((data + offsetImagePointerWH) < data_end) {
+
+        int w = static_cast<int>(data[0]);
+        int h = static_cast<int>(data[1]);
+        int size = w * h;
+
+        data += offsetImagePointerWH;
+
+        if (size <= 0 || w > maxImageW || h > maxImageH || data + size > data_end) {
+            break;
+        }
+
+        if (w > max_w || h > max_h) {
+            max_icon = data;
+            max_w = w;
+            max_h = h;
+        }
+
+        data += size;
+    }
+
+    if (max_icon == nullptr)
+        return {};
+
+    QImage img(max_w, max_h, QImage::Format_ARGB32);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    int byteCount = img.byteCount() / 4;
+#else
+    int byteCount = img.sizeInBytes() / 4;
+#endif
+
+    for (int i = 0; i < byteCount; ++i) {
+        //Save covert uchar* to uint*
+        (reinterpret_cast<uint *>(img.bits()))[i] = max_icon[i];
+    }
+
+    // icons are never drawn larger, a full size copy would only take memory
+    if (max_w > kWindowIconSize || max_h > kWindowIconSize)
+        img = img.scaled(kWindowIconSize, kWindowIconSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    return img;
+}
 
 WMWindowList::WMWindowList(QObject *parent)
     : QObject(parent)
 {
+    auto *conn = m_conn.xcb_connection();
+    if (conn && !xcb_connection_has_error(conn)) {
+        // client list changes are reported as property changes of the root window
+        const uint32_t mask = XCB_EVENT_MASK_PROPERTY_CHANGE;
+        xcb_change_window_attributes(conn, m_conn.rootWindow(), XCB_CW_EVENT_MASK, &mask);
+        xcb_flush(conn);
+    }
+
+    // tray icons added or removed, dock (re)started
+    auto bus = QDBusConnection::sessionBus();
+    const auto &info = common::systemInfo();
+    bus.connect(info.TrayManagerService, info.TrayManagerPath, info.TrayManagerInterface,
+                "PropertiesChanged", this, SLOT(onTrayChanged()));
+    bus.connect(info.TrayManagerService, info.TrayManagerPath, info.TrayManagerService,
+                "Added", this, SLOT(onTrayChanged()));
+    bus.connect(info.TrayManagerService, info.TrayManagerPath, info.TrayManagerService,
+                "Removed", this, SLOT(onTrayChanged()));
+    auto *trayWatcher = new QDBusServiceWatcher(info.TrayManagerService, bus,
+                                                QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(trayWatcher, &QDBusServiceWatcher::serviceOwnerChanged, this, &WMWindowList::onTrayChanged);
 }
 
 void WMWindowList::addDesktopEntryApp(Process *proc)
@@ -176,73 +334,33 @@ void WMWindowList::removeDesktopEntryApp(pid_t pid)
     m_desktopEntryCache.removeAll(pid);
 }
 
-QImage WMWindowList::getWindowIcon(pid_t pid) const
+QImage WMWindowList::getWindowIcon(pid_t pid, quint64 *key, bool *pending)
 {
+    if (pending)
+        *pending = false;
+
     auto search = m_guiAppcache.find(pid);
-    WMWId winId = UINT32_MAX;
-    if (search != m_guiAppcache.end()) {
-        winId = search->second->winId;
+    if (search == m_guiAppcache.end())
+        return {};
+    WMWId winId = search->second->winId;
+
+    auto icon = m_windowIcons.find(winId);
+    if (icon != m_windowIcons.end()) {
+        if (key)
+            *key = icon->second.key;
+        return icon->second.image;
     }
 
+    if (pending)
+        *pending = true;
+    if (m_iconRequests.count(winId))
+        return {};
+
+    // no waiting for the reply, it is read by the next updateWindowListCache
     auto *conn = m_conn.xcb_connection();
     auto cookie = xcb_get_property(conn, false, winId, m_conn.atom(WMAtom::_NET_WM_ICON), XCB_ATOM_ANY, 0, UINT32_MAX);
-    XGetPropertyReply reply(xcb_get_property_reply(conn, cookie, nullptr));
-
-    if (reply) {
-        int len = xcb_get_property_value_length(reply.get());
-        if (len < 2)
-            return {};
-
-        uint *data = reinterpret_cast<uint *>(xcb_get_property_value(reply.get()));
-        if (data) {
-            //get the maximum image from data
-            int max_w = 0;
-            int max_h = 0;
-
-            uint *max_icon = nullptr;
-            uint *data_end = reinterpret_cast<uint *>(xcb_get_property_value_end(reply.get()).data);
-
-            while ((data + offsetImagePointerWH) < data_end) {
-
-                int w = static_cast<int>(data[0]);
-                int h = static_cast<int>(data[1]);
-                int size = w * h;
-
-                data += offsetImagePointerWH;
-
-                if (size <= 0 || w > maxImageW || h > maxImageH) {
-                    break;
-                }
-
-                if (w > max_w || h > max_h) {
-                    max_icon = data;
-                    max_w = w;
-                    max_h = h;
-                }
-
-                data += size;
-            }
-
-            if (max_icon != nullptr) {
-                if (max_w > maxImageW || max_h > maxImageH) {
-                    return QImage();
-                }
-
-                QImage img(max_w, max_h, QImage::Format_ARGB32);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-                int byteCount = img.byteCount() / 4;
-#else
-                int byteCount = img.sizeInBytes() / 4;
-#endif
-
-                for (int i = 0; i < byteCount; ++i) {
-                    //Save covert uchar* to uint*
-                    (reinterpret_cast<uint *>(img.bits()))[i] = max_icon[i];
-                }
-                return img;
-            }
-        }
-    }
+    xcb_flush(conn);
+    m_iconRequests[winId] = cookie.sequence;
     return {};
 }
 
@@ -270,11 +388,17 @@ QString WMWindowList::getWindowTitle(pid_t pid) const
     }
 }
 
-QList<WMWId> WMWindowList::getTrayWindows() const
+QList<WMWId> WMWindowList::getTrayWindows()
 {
-    QDBusInterface busInterface(common::systemInfo().TrayManagerService, common::systemInfo().TrayManagerPath,
-                                common::systemInfo().TrayManagerInterface, QDBusConnection::sessionBus());
-    QDBusMessage reply = busInterface.call("Get", common::systemInfo().TrayManagerService, "TrayIcons");
+    QDBusMessage msg = QDBusMessage::createMethodCall(common::systemInfo().TrayManagerService, common::systemInfo().TrayManagerPath,
+                                                      common::systemInfo().TrayManagerInterface, "Get");
+    msg << common::systemInfo().TrayManagerService << QString("TrayIcons");
+    ++m_roundTrips;
+    QDBusMessage reply = QDBusConnection::sessionBus().call(msg);
+    // no dock running, asked again once the tray manager shows up
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty())
+        return {};
+
     QVariant v = reply.arguments().first();
     const QDBusArgument &argument = v.value<QDBusVariant>().variant().value<QDBusArgument>();
 
@@ -291,135 +415,269 @@ QList<WMWId> WMWindowList::getTrayWindows() const
     return winIds;
 }
 
+void WMWindowList::onTrayChanged()
+{
+    m_trayDirty = true;
+}
+
 void WMWindowList::updateWindowListCache()
 {
     m_desktopEntryCache.clear();
 
     auto *conn = m_conn.xcb_connection();
-    // get window info
+    if (!conn || xcb_connection_has_error(conn))
+        return;
+
+    // only reads events already received, nothing is asked from the server while windows stay the same
+    handleXEvents();
+    collectWindowIcons();
+
+    bool changed = m_indexDirty;
+    if (m_clientListDirty)
+        changed = updateClientList() || changed;
+    if (m_trayDirty.exchange(false))
+        changed = updateTrayWindows() || changed;
+    if (!m_dirtyWindows.empty())
+        changed = updateDirtyWindows() || changed;
+
+    if (changed)
+        rebuildIndex();
+    m_indexDirty = false;
+}
+
+void WMWindowList::handleXEvents()
+{
+    auto *conn = m_conn.xcb_connection();
+    xcb_generic_event_t *e;
+    while ((e = xcb_poll_for_event(conn))) {
+        XEvent event(e);
+        switch (event->response_type & ~0x80) {
+        case XCB_PROPERTY_NOTIFY: {
+            auto *ev = reinterpret_cast<xcb_property_notify_event_t *>(event.get());
+            if (ev->window == m_conn.rootWindow()) {
+                if (ev->atom == m_conn.atom(WMAtom::_NET_CLIENT_LIST_STACKING))
+                    m_clientListDirty = true;
+            } else if (ev->atom == m_conn.atom(WMAtom::_NET_WM_PID)
+                       || ev->atom == m_conn.atom(WMAtom::_NET_WM_NAME)
+                       || ev->atom == XCB_ATOM_WM_NAME
+                       || ev->atom == m_conn.atom(WMAtom::_NET_WM_WINDOW_TYPE)) {
+                m_dirtyWindows.insert(ev->window);
+            } else if (ev->atom == m_conn.atom(WMAtom::_NET_WM_ICON)) {
+                // fetched again when asked for
+                dropWindowIcon(ev->window);
+            }
+            break;
+        }
+        case XCB_DESTROY_NOTIFY: {
+            // gone before the window manager or the tray updated their lists
+            auto *ev = reinterpret_cast<xcb_destroy_notify_event_t *>(event.get());
+            m_dirtyWindows.erase(ev->window);
+            dropWindowIcon(ev->window);
+            if (m_clients.erase(ev->window) + m_trayWindows.erase(ev->window) > 0)
+                m_indexDirty = true;
+            break;
+        }
+        default:
+            // errors of requests on windows destroyed meanwhile
+            break;
+        }
+    }
+}
+
+bool WMWindowList::updateClientList()
+{
+    m_clientListDirty = false;
+
+    auto *conn = m_conn.xcb_connection();
     auto cookie = xcb_get_property(conn, 0, m_conn.rootWindow(), m_conn.atom(WMAtom::_NET_CLIENT_LIST_STACKING), XCB_ATOM_WINDOW, 0, UINT_MAX);
     xcb_flush(conn);
+    ++m_roundTrips;
     XGetPropertyReply reply(xcb_get_property_reply(conn, cookie, nullptr));
     if (!reply)
-        return;
-
-    m_guiAppcache.clear();
-    const xcb_get_property_reply_t *R = reply.get();
-    xcb_window_t *clientList = reinterpret_cast<xcb_window_t *>(xcb_get_property_value(R));
-    int len = xcb_get_property_value_length(R);
-
-    for (int i = 0, index = 0; index < len; i++, index += sizeof(xcb_window_t)) {
-        auto wid = clientList[i];
-        auto winfo = getWindowInfo(wid);
-        const QStringList &windowtype = getWindowType(wid);
-        if (winfo && (windowtype.contains("_NET_WM_WINDOW_TYPE_NORMAL") || windowtype.contains("_NET_WM_WINDOW_TYPE_DIALOG"))) {
-            m_guiAppcache[winfo->pid] = std::move(winfo);
+        return false;
+
+    auto *clientList = reinterpret_cast<xcb_window_t *>(xcb_get_property_value(reply.get()));
+    auto count = size_t(xcb_get_property_value_length(reply.get())) / sizeof(xcb_window_t);
+    std::vector<WMWId> stacking(clientList, clientList + count);
+
+    // windows no longer listed
+    std::set<WMWId> listed(stacking.begin(), stacking.end());
+    for (auto it = m_clients.begin(); it != m_clients.end();) {
+        if (listed.count(it->first)) {
+            ++it;
+        } else {
+            m_dirtyWindows.erase(it->first);
+            dropWindowIcon(it->first);
+            it = m_clients.erase(it);
         }
     }
 
-    m_trayAppcache.clear();
+    // newly listed windows
+    std::vector<WMWId> added;
+    for (auto wid : stacking) {
+        if (!m_clients.count(wid))
+            added.push_back(wid);
+    }
+    fetchWindows(added, m_clients);
+
+    m_stacking = std::move(stacking);
+    return true;
+}
+
+bool WMWindowList::updateTrayWindows()
+{
     const QList<WMWId> &trayWndList = getTrayWindows();
-    for (auto i = 0; i < trayWndList.size(); i++) {
-        auto wid = trayWndList[i];
-        auto winfo = getWindowInfo(wid);
-        if (winfo && winfo.get()->pid > 0)
-            m_trayAppcache.insert({winfo->pid, std::move(winfo)});
+    std::vector<WMWId> order(trayWndList.cbegin(), trayWndList.cend());
+
+    std::set<WMWId> listed(order.begin(), order.end());
+    for (auto it = m_trayWindows.begin(); it != m_trayWindows.end();) {
+        if (listed.count(it->first)) {
+            ++it;
+        } else {
+            m_dirtyWindows.erase(it->first);
+            it = m_trayWindows.erase(it);
+        }
+    }
+
+    std::vector<WMWId> added;
+    for (auto wid : order) {
+        if (!m_trayWindows.count(wid))
+            added.push_back(wid);
     }
+    fetchWindows(added, m_trayWindows);
+
+    m_trayOrder = std::move(order);
+    return true;
 }
 
-pid_t WMWindowList::getWindowPid(WMWId winId) const
+bool WMWindowList::updateDirtyWindows()
 {
+    std::vector<WMWId> clients;
+    std::vector<WMWId> trays;
+    for (auto wid : m_dirtyWindows) {
+        if (m_clients.count(wid))
+            clients.push_back(wid);
+        if (m_trayWindows.count(wid))
+            trays.push_back(wid);
+    }
+    m_dirtyWindows.clear();
+
+    fetchWindows(clients, m_clients);
+    fetchWindows(trays, m_trayWindows);
+    return !clients.empty() || !trays.empty();
+}
+
+void WMWindowList::fetchWindows(const std::vector<WMWId> &winIds, std::map<WMWId, wm_client_t> &windows)
+{
+    if (winIds.empty())
+        return;
+
     auto *conn = m_conn.xcb_connection();
-    auto pidCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_PID), XCB_ATOM_CARDINAL, 0, 4);
+    // all requests first, one round trip for the whole batch
+    std::vector<window_cookies_t> cookies;
+    cookies.reserve(winIds.size());
+    // selected ahead of the reads, changes after them are reported
+    const uint32_t mask = XCB_EVENT_MASK_PROPERTY_CHANGE | XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+    for (auto wid : winIds) {
+        xcb_change_window_attributes(conn, wid, XCB_CW_EVENT_MASK, &mask);
+        cookies.push_back(requestWindowInfo(m_conn, wid));
+    }
+    xcb_flush(conn);
+    ++m_roundTrips;
 
-    XGetPropertyReply pidReply(xcb_get_property_reply(conn, pidCookie, nullptr));
-    if (pidReply && pidReply->type == XCB_ATOM_CARDINAL) {
-        auto *pid = reinterpret_cast<pid_t *>(xcb_get_property_value(pidReply.get()));
-        return *pid;
-    } else
-        return -1;
+    for (const auto &c : cookies) {
+        bool gui = false;
+        auto window = readWindowInfo(m_conn, c, &gui);
+        windows[c.winId] = wm_client_t {std::move(window), gui};
+    }
 }
 
-QByteArray WMWindowList::getAtomName(xcb_connection_t *conn, xcb_atom_t atom) const
+void WMWindowList::rebuildIndex()
 {
-    AtomMeta meta(new struct atom_meta());
-    meta->atom = atom;
-
-    auto cookie = xcb_get_atom_name(conn, atom);
-    XGetAtomNameReply reply(xcb_get_atom_name_reply(conn, cookie, nullptr));
-    if (reply) {
-        auto len = xcb_get_atom_name_name_length(reply.get());
-        auto name = xcb_get_atom_name_name(reply.get());
-        meta->name = QByteArray{name, len};
+    m_guiAppcache.clear();
+    for (auto wid : m_stacking) {
+        auto it = m_clients.find(wid);
+        if (it != m_clients.end() && it->second.gui) {
+            const auto &window = it->second.window;
+            m_guiAppcache[window->pid] = WMWindow(new struct wm_window_t(*window));
+        }
     }
 
-    return meta->name;
+    m_trayAppcache.clear();
+    for (auto wid : m_trayOrder) {
+        auto it = m_trayWindows.find(wid);
+        if (it != m_trayWindows.end() && it->second.window->pid > 0) {
+            const auto &window = it->second.window;
+            m_trayAppcache.insert({window->pid, WMWindow(new struct wm_window_t(*window))});
+        }
+    }
 }
 
-QStringList WMWindowList::getWindowType(WMWId winId) const
+void WMWindowList::collectWindowIcons()
 {
-    QStringList windowType;
     auto *conn = m_conn.xcb_connection();
-    auto windowTypeCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_WINDOW_TYPE), XCB_ATOM_ATOM, 0, BUFSIZ);
-
-    XGetPropertyReply windowTypeReply(xcb_get_property_reply(conn, windowTypeCookie, nullptr));
-    if (windowTypeReply && windowTypeReply->type != XCB_NONE && windowTypeReply->value_len > 0) {
-        auto *atoms = reinterpret_cast<xcb_atom_t *>(xcb_get_property_value(windowTypeReply.get()));
-        Q_ASSERT(atoms != nullptr);
-        for (uint32_t i = 0; i < windowTypeReply->value_len; ++i) {
-            windowType << getAtomName(conn, atoms[i]);
-        } // !for
+    for (auto it = m_iconRequests.begin(); it != m_iconRequests.end();) {
+        void *reply = nullptr;
+        xcb_generic_error_t *error = nullptr;
+        // replies read along with the events, nothing is waited for
+        if (!xcb_poll_for_reply(conn, it->second, &reply, &error)) {
+            ++it;
+            continue;
+        }
+        free(error);
+
+        XGetPropertyReply iconReply(reinterpret_cast<xcb_get_property_reply_t *>(reply));
+        window_icon_t icon {0, readWindowIcon(iconReply.get())};
+        if (!icon.image.isNull()) {
+            uint64_t hash[2] {};
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            util::common::hash(icon.image.constBits(), icon.image.byteCount(), util::common::global_seed, hash);
+#else
+            util::common::hash(icon.image.constBits(), int(icon.image.sizeInBytes()), util::common::global_seed, hash);
+#endif
+            icon.key = hash[0] ? hash[0] : 1;
+
+            // windows of one application usually show the same icon, keep one copy of it
+            for (const auto &other : m_windowIcons) {
+                if (other.second.key == icon.key) {
+                    icon.image = other.second.image;
+                    break;
+                }
+            }
+        }
+        m_windowIcons[it->first] = std::move(icon);
+        it = m_iconRequests.erase(it);
     }
-    return windowType;
 }
 
-WMWindow WMWindowList::getWindowInfo(WMWId winId)
+void WMWindowList::dropWindowIcon(WMWId winId)
 {
-    WMWindow window(new struct wm_window_t());
-    window->winId = winId;
+    m_windowIcons.erase(winId);
+    auto request = m_iconRequests.find(winId);
+    if (request != m_iconRequests.end()) {
+        xcb_discard_reply(m_conn.xcb_connection(), request->second);
+        m_iconRequests.erase(request);
+    }
+}
 
+pid_t WMWindowList::getWindowPid(WMWId winId) const
+{
     auto *conn = m_conn.xcb_connection();
-    // pid
     auto pidCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_PID), XCB_ATOM_CARDINAL, 0, 4);
-    // title
-    auto netNameCookie = xcb_get_property(conn, 0, winId, m_conn.atom(WMAtom::_NET_WM_NAME), m_conn.atom(WMAtom::UTF8_STRING), 0, BUFSIZ);
-
-    xcb_flush(conn);
 
     XGetPropertyReply pidReply(xcb_get_property_reply(conn, pidCookie, nullptr));
     if (pidReply && pidReply->type == XCB_ATOM_CARDINAL) {
         auto *pid = reinterpret_cast<pid_t *>(xcb_get_property_value(pidReply.get()));
-        window->pid = *pid;
+        return *pid;
     } else
-        window->pid = -1;
-
-    const char *name {};
-    int len {};
-    xcb_atom_t encoding = XCB_NONE;
-    XGetPropertyReply netNameReply(xcb_get_property_reply(conn, netNameCookie, nullptr));
-    if (netNameReply && netNameReply->type != XCB_NONE) {
-        name = reinterpret_cast<const char *>(xcb_get_property_value(netNameReply.get()));
-        len = xcb_get_property_value_length(netNameReply.get());
-        encoding = netNameReply->type;
-    } else {
-        auto nameCookie = xcb_icccm_get_wm_name(conn, winId);
-        XGetPropertyReply nameReply(xcb_get_property_reply(conn, nameCookie, nullptr));
-        if (nameReply && nameReply->type != XCB_NONE) {
-            name = reinterpret_cast<const char *>(xcb_get_property_value(nameReply.get()));
-            len = xcb_get_property_value_length(nameReply.get());
-            encoding = nameReply->type;
-        }
-    }
-
-    if (len != 0) {
-        if (encoding == XCB_ATOM_STRING) {
-            window->title = QString::fromLocal8Bit(name, len);
-        } else if (encoding == m_conn.atom(WMAtom::UTF8_STRING)) {
-            window->title = QString::fromUtf8(name, len);
-        }
-    }
+        return -1;
+}
 
-    return window;
+WMWindow WMWindowList::getWindowInfo(WMWId winId)
+{
+    auto cookies = requestWindowInfo(m_conn, winId);
+    xcb_flush(m_conn.xcb_connection());
+    return readWindowInfo(m_conn, cookies, nullptr);
 }
 
 } // namespace wm
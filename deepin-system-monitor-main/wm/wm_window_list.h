@@ -10,8 +10,13 @@
 #include "wm_atom.h"
 #include "wm_info.h"
 
+#include <QImage>
 #include <QObject>
 
+#include <atomic>
+#include <set>
+#include <vector>
+
 namespace core {
 namespace process {
 class Process;
@@ -31,6 +36,11 @@ union size_u {
 
 /**
  * @brief The WMWindowList class
+ *
+ * Keeps pid - window indexes of top level & tray windows. Windows are read once when they show up and
+ * again only when X reports a property change (client list on the root window, pid/title/type on the
+ * window itself) or the tray manager reports a change, so a refresh costs no round trip while windows
+ * stay the same.
  */
 class WMWindowList : public QObject
 {
@@ -42,7 +52,16 @@ public:
 
     int getAppCount();
 
-    QImage getWindowIcon(pid_t pid) const;
+    /**
+     * @brief Icon of the topmost window of pid, fetched asynchronously
+     *
+     * The first call for a window only sends the _NET_WM_ICON request, its reply is collected by a later
+     * updateWindowListCache; windows showing the same icon share one image.
+     * @param key Set to a hash of the icon pixels
+     * @param pending Set to true while the icon is being fetched
+     * @return Return a null image if the icon is not there (yet)
+     */
+    QImage getWindowIcon(pid_t pid, quint64 *key = nullptr, bool *pending = nullptr);
     QString getWindowTitle(pid_t pid) const;
 
     bool isTrayApp(pid_t pid) const;
@@ -53,17 +72,54 @@ public:
     void removeDesktopEntryApp(pid_t pid);
     void updateWindowListCache();
 
+private Q_SLOTS:
+    void onTrayChanged();
+
 private:
-    QList<WMWId> getTrayWindows() const;
+    struct wm_client_t {
+        WMWindow window;
+        bool gui;           // _NET_WM_WINDOW_TYPE_NORMAL or _NET_WM_WINDOW_TYPE_DIALOG
+    };
+    struct window_icon_t {
+        quint64 key;        // hash of the pixels, 0 if the window has no icon
+        QImage image;
+    };
+
+    QList<WMWId> getTrayWindows();
     WMWindow getWindowInfo(WMWId winId);
     pid_t getWindowPid(WMWId window) const;
-    QStringList getWindowType(WMWId winId) const;
-    QByteArray getAtomName(xcb_connection_t *conn, xcb_atom_t atom) const;
+
+    void handleXEvents();
+    bool updateClientList();
+    bool updateTrayWindows();
+    bool updateDirtyWindows();
+    void fetchWindows(const std::vector<WMWId> &winIds, std::map<WMWId, wm_client_t> &windows);
+    void rebuildIndex();
+    void collectWindowIcons();
+    void dropWindowIcon(WMWId winId);
 
 private:
     std::map<pid_t, WMWindow> m_guiAppcache;
     std::map<pid_t, WMWindow> m_trayAppcache;
 
+    // windows in _NET_CLIENT_LIST_STACKING order & tray order, topmost window of a pid wins
+    std::vector<WMWId> m_stacking;
+    std::vector<WMWId> m_trayOrder;
+    std::map<WMWId, wm_client_t> m_clients;
+    std::map<WMWId, wm_client_t> m_trayWindows;
+    // windows with pid, title or type changed since last update
+    std::set<WMWId> m_dirtyWindows;
+    bool m_clientListDirty {true};
+    bool m_indexDirty {false};
+    // set from the thread this object lives in, tray manager signals are delivered there
+    std::atomic_bool m_trayDirty {true};
+    // X & D-Bus round trips made by updateWindowListCache
+    uint m_roundTrips {0};
+    // _NET_WM_ICON requests sent, replies not read yet
+    std::map<WMWId, unsigned int> m_iconRequests;
+    // fetched window icons, dropped when the window goes away or changes its icon
+    std::map<WMWId, window_icon_t> m_windowIcons;
+
     QList<pid_t> m_desktopEntryCache;
     WMConnection m_conn;
 };
@@ -226,14 +226,18 @@ void BaseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
         auto diff = (iconRect.height() - iconSize) / 2;
         iconRect.adjust(0, diff, 0, -diff);
 
-        const QString &procPid = index.data(Qt::UserRole + 4).toString();
-        QPixmap  *iconPixmap = nullptr;
-        core::process::ProcessIconCache::instance()->iconPixmapCache.find(procPid, iconPixmap);
-        if (iconPixmap) {
-            painter->drawPixmap(iconRect, *iconPixmap);
+        // pixmaps are keyed by icon & size: processes share their icon, so they share the rendered pixmap too
+        const QString &pixmapKey = QString("%1-%2x%3").arg(icon.cacheKey()).arg(iconRect.width()).arg(iconRect.height());
+        QPixmap iconPixmap;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(pixmapKey, iconPixmap)) {
+#else
+        if (core::process::ProcessIconCache::instance()->iconPixmapCache.find(pixmapKey, &iconPixmap)) {
+#endif
+            painter->drawPixmap(iconRect, iconPixmap);
         } else {
             const QPixmap &iconPix = icon.pixmap(iconRect.size());
-            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(procPid, iconPix);
+            core::process::ProcessIconCache::instance()->iconPixmapCache.insert(pixmapKey, iconPix);
             painter->drawPixmap(iconRect, iconPix);
         }
     }
@@ -119,17 +119,38 @@ timeval Process::procuptime() const
     return d->uptime;
 }
 
+ProcessSampleContext ProcessSampleContext::current()
+{
+    ProcessSampleContext ctx {};
+    ctx.uptime = SysInfo::instance()->uptime();
+    ctx.cpuUsageTotalDelta = DeviceDB::instance()->cpuSet()->getUsageTotalDelta();
+    ctx.procset = ProcessDB::instance()->processSet();
+    ctx.netifMonitor = nullptr;
+    return ctx;
+}
+
 void Process::readProcessVariableInfo()
 {
     readProcessInfo();
 }
 
+void Process::readProcessVariableInfo(const ProcessSampleContext &ctx)
+{
+    readProcessVariableFiles(ctx);
+    mergeProcessVariableInfo(ctx);
+}
+
 void Process::readProcessSimpleInfo()
 {
     readProcessInfo();
 }
 
 void Process::readProcessInfo()
+{
+    readProcessVariableInfo(ProcessSampleContext::current());
+}
+
+void Process::readProcessVariableFiles(const ProcessSampleContext &ctx)
 {
     d->valid = true;
 
@@ -144,32 +165,37 @@ void Process::readProcessInfo()
 //    readIO();
 //    readSockInodes();
 
-    d->usrerName = SysInfo::userName(d->uid);
-    d->proc_name.refreashProcessName(this);
-    d->proc_icon.refreashProcessIcon(this);
-    d->uptime = SysInfo::instance()->uptime();
-
-    CPUSet *cpuset = DeviceDB::instance()->cpuSet();
-    ProcessSet *procset =  ProcessDB::instance()->processSet();
+    d->uptime = ctx.uptime;
 
-    auto recentProcptr = procset->getRecentProcStage(d->pid);
+    auto recentProcptr = ctx.procset->getRecentProcStage(d->pid);
     auto validrecentPtr = recentProcptr.lock();
     qreal timedelta = d->stime + d->utime;
     if (validrecentPtr) {
         timedelta = timedelta - validrecentPtr->ptime;
         struct DiskIO io = {validrecentPtr->read_bytes, validrecentPtr->write_bytes, validrecentPtr->cancelled_write_bytes};
-        d->diskIOSample->addSample(new DISKIOSampleFrame(validrecentPtr->uptime, io));
+        d->diskIOSample.addSample(DISKIOSampleFrame(validrecentPtr->uptime, io));
 
-        d->networkIOSample->addSample(new IOSampleFrame(validrecentPtr->uptime, {0, 0}));
+        d->networkIOSample.addSample(IOSampleFrame(validrecentPtr->uptime, {0, 0}));
     }
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(qMax(0., timedelta) / cpuset->getUsageTotalDelta() * 100));
+    d->cpuUsageSample.addSample(CPUUsageSampleFrame(qMax(0., timedelta) / ctx.cpuUsageTotalDelta * 100));
 
     struct DiskIO io = {d->read_bytes, d->write_bytes, d->cancelled_write_bytes};
-    d->diskIOSample->addSample(new DISKIOSampleFrame(d->uptime, io));
+    d->diskIOSample.addSample(DISKIOSampleFrame(d->uptime, io));
 
-    auto pair = d->diskIOSample->recentSamplePair();
+    auto pair = d->diskIOSample.recentSamplePair();
     struct IOPS iops = DISKIOSampleFrame::diskiops(pair.first, pair.second);
-    d->diskIOSpeedSample->addSample(new IOPSSampleFrame(iops));
+    d->diskIOSpeedSample.addSample(IOPSSampleFrame(iops));
+
+    d->valid = d->valid && ok;
+}
+
+void Process::mergeProcessVariableInfo(const ProcessSampleContext &ctx)
+{
+    Q_UNUSED(ctx);
+
+    d->usrerName = SysInfo::userName(d->uid);
+    d->proc_name.refreashProcessName(this);
+    d->proc_icon.refreashProcessIcon(this);
 
     d->apptype = kNoFilter;
     const QVariant &euid = ProcessDB::instance()->processEuid();
@@ -182,8 +208,6 @@ void Process::readProcessInfo()
     } else if (euid == d->uid) {
         d->apptype = kFilterCurrentUser;
     }
-
-    d->valid = d->valid && ok;
 }
 
 // read /proc/[pid]/stat
@@ -595,7 +619,7 @@ QIcon Process::icon() const
 
 qreal Process::cpu() const
 {
-    auto *sample = d->cpuUsageSample->recentSample();
+    auto *sample = d->cpuUsageSample.recentSample();
     if (sample)
         return sample->data;
     else
@@ -604,7 +628,7 @@ qreal Process::cpu() const
 
 void Process::setCpu(qreal cpu)
 {
-    d->cpuUsageSample->addSample(new CPUUsageSampleFrame(cpu));
+    d->cpuUsageSample.addSample(CPUUsageSampleFrame(cpu));
 }
 
 qulonglong Process::memory() const
@@ -679,7 +703,7 @@ QString Process::groupName() const
 
 qreal Process::readBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -688,7 +712,7 @@ qreal Process::readBps() const
 
 qreal Process::writeBps() const
 {
-    auto *sample = d->diskIOSpeedSample->recentSample();
+    auto *sample = d->diskIOSpeedSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -712,7 +736,7 @@ qulonglong Process::cancelledWriteBytes() const
 
 qreal Process::recvBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.inBps;
     else
@@ -721,7 +745,7 @@ qreal Process::recvBps() const
 
 qreal Process::sentBps() const
 {
-    auto *sample = d->networkBandwidthSample->recentSample();
+    auto *sample = d->networkBandwidthSample.recentSample();
     if (sample)
         return sample->data.outBps;
     else
@@ -731,12 +755,12 @@ qreal Process::sentBps() const
 void Process::setNetIoBps(qreal recvBps, qreal sendBps)
 {
     struct IOPS netIo = {recvBps, sendBps};
-    d->networkBandwidthSample->addSample(new IOPSSampleFrame(netIo));
+    d->networkBandwidthSample.addSample(IOPSSampleFrame(netIo));
 }
 
 qulonglong Process::recvBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->networkIOSample.recentSample();
     if (sample)
         return sample->data.inBytes;
     else
@@ -745,7 +769,7 @@ qulonglong Process::recvBytes() const
 
 qulonglong Process::sentBytes() const
 {
-    auto *sample = d->networkIOSample->recentSample();
+    auto *sample = d->networkIOSample.recentSample();
     if (sample)
         return sample->data.outBytes;
     else
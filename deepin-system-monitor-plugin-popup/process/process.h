@@ -19,8 +19,25 @@
 using namespace core::system;
 
 namespace core {
+namespace system {
+class NetifMonitor;
+} // namespace system
 namespace process {
 
+class ProcessSet;
+
+/**
+ * @brief Per-tick state shared by all processes, resolved once per scan instead of per process
+ */
+struct ProcessSampleContext {
+    struct timeval uptime; // system uptime of this scan
+    qulonglong cpuUsageTotalDelta; // total cpu jiffies elapsed since last scan
+    const ProcessSet *procset; // process set holding the previous scan stage
+    NetifMonitor *netifMonitor; // socket io stat source, the popup has none
+
+    static ProcessSampleContext current();
+};
+
 enum ProcessPriority {
     kInvalidPriority = INT_MAX,
     kVeryHighPriority = -20, // default veryhigh priority
@@ -116,6 +133,17 @@ public:
 
     void readProcessInfo();
     void readProcessVariableInfo();
+    void readProcessVariableInfo(const ProcessSampleContext &ctx);
+    /**
+     * @brief Reentrant half of readProcessVariableInfo: reads /proc/[pid]/* and updates
+     * cpu & disk samples, only touches this process, safe to run on a worker thread
+     */
+    void readProcessVariableFiles(const ProcessSampleContext &ctx);
+    /**
+     * @brief Serial half of readProcessVariableInfo: refreshes name, icon & app type from
+     * the window list, must run on the scanning thread
+     */
+    void mergeProcessVariableInfo(const ProcessSampleContext &ctx);
     void readProcessSimpleInfo();
 
 private:
@@ -159,6 +187,9 @@ private:
     void readSockInodes();
 
 private:
+    // snapshots copy the icon handle, not the QIcon built from it
+    friend class ProcessSnapshot;
+
     QSharedDataPointer<ProcessPrivate> d;
 };
 
@@ -25,7 +25,6 @@ using namespace core::wm;
 namespace core {
 namespace process {
 
-const int DesktopEntryTimeCount = 150; // 5 minutes interval
 ProcessDB::ProcessDB(QObject *parent)
     : QObject(parent)
 {
@@ -33,8 +32,6 @@ ProcessDB::ProcessDB(QObject *parent)
     m_windowList = new WMWindowList();
     m_desktopEntryCache = new DesktopEntryCache();
 
-    m_desktopEntryTimeCount = DesktopEntryTimeCount;
-
     m_euid = geteuid();
 }
 
@@ -108,10 +105,8 @@ void ProcessDB::killProcess(pid_t pid)
 
 void ProcessDB::update()
 {
-    if (m_desktopEntryTimeCount++ && m_desktopEntryTimeCount >= DesktopEntryTimeCount) {
-        m_desktopEntryTimeCount = 0;
-        m_desktopEntryCache->updateCache();
-    }
+    // indexed on first call, then only files reported changed by inotify are parsed
+    m_desktopEntryCache->update();
 
     m_windowList->updateWindowListCache();
     m_procSet->refresh();
@@ -24,11 +24,12 @@ namespace system {
 
 DeviceDB::DeviceDB()
 {
+    m_diskStats = new DiskStatTable();
     m_cpuSet = new CPUSet();
     m_memInfo = new MemInfo();
     m_netInfo = new NetInfo();
-    m_diskIoInfo = new DiskIOInfo();
-    m_blkDevInfoDB = new BlockDeviceInfoDB();
+    m_diskIoInfo = new DiskIOInfo(m_diskStats);
+    m_blkDevInfoDB = new BlockDeviceInfoDB(m_diskStats);
 }
 
 DeviceDB::~DeviceDB()
@@ -53,12 +54,17 @@ DeviceDB::~DeviceDB()
         delete m_netInfo;
         m_netInfo  = nullptr;
     }
+    if (m_diskStats) {
+        delete m_diskStats;
+        m_diskStats  = nullptr;
+    }
 }
 
 void DeviceDB::update()
 {
     m_cpuSet->update();
     m_memInfo->readMemInfo();
+    m_diskStats->update();
     m_diskIoInfo->update();
     m_blkDevInfoDB->update();
     m_netInfo->resdNetInfo();
@@ -13,6 +13,7 @@ class MemInfo;
 class CPUSet;
 class NetInfo;
 class DiskIOInfo;
+class DiskStatTable;
 class BlockDeviceInfoDB;
 
 /**
@@ -40,6 +41,8 @@ private:
     NetInfo *m_netInfo;
     BlockDeviceInfoDB *m_blkDevInfoDB;
     DiskIOInfo *m_diskIoInfo;
+    // /proc/diskstats table shared by m_diskIoInfo & m_blkDevInfoDB, read once per update
+    DiskStatTable *m_diskStats;
 };
 
 } // namespace system
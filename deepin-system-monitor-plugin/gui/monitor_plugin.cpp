@@ -238,6 +238,13 @@ QIcon MonitorPlugin::icon(const DockPart &dockPart, DGuiApplicationHelper::Color
 
 void MonitorPlugin::udpateInfo()
 {
+    // 系统监视器正在采样，直接使用其发布的数据，无需再读取/proc
+    common::metrics_system_t system {};
+    if (m_snapshot.readSystem(system)) {
+        updateInfoFromSnapshot(system);
+        return;
+    }
+
     // memory
     qlonglong memory = 0;
     qlonglong memoryAll = 0;
@@ -276,6 +283,46 @@ void MonitorPlugin::udpateInfo()
     m_upload = netUpload;
 }
 
+void MonitorPlugin::updateInfoFromSnapshot(const common::metrics_system_t &system)
+{
+    // 采样周期长于刷新周期，没有新采样时保持上一次的显示
+    if (system.generation == m_snapshotGeneration)
+        return;
+    m_snapshotGeneration = system.generation;
+
+    // memory
+    if (system.mem_total != 0) {
+        double memPercent = (system.mem_total - system.mem_available) * 100.0 / system.mem_total;
+        m_memStr = QString("%1").arg(memPercent, 1, 'f', 1, QLatin1Char(' ')) + QString("%");
+    }
+
+    // CPU
+    qlonglong totalCPU = qlonglong(system.cpu_user + system.cpu_nice + system.cpu_sys + system.cpu_idle + system.cpu_iowait
+                                   + system.cpu_hardirq + system.cpu_softirq + system.cpu_steal + system.cpu_guest + system.cpu_guest_nice);
+    qlonglong availableCPU = qlonglong(system.cpu_idle);
+    double cpuPercent = 0.0;
+    if (totalCPU != m_totalCPU) {
+        cpuPercent = ((totalCPU - m_totalCPU) - (availableCPU - m_availableCPU)) * 100.0 / (totalCPU - m_totalCPU);
+    }
+    m_cpuStr = QString("%1").arg(cpuPercent, 1, 'f', 1, QLatin1Char(' ')) + QString("%");
+    m_totalCPU = totalCPU;
+    m_availableCPU = availableCPU;
+
+    // net，使用采样端按其采样周期计算的速率
+    RateUnit unit = RateByte;
+    double downRate = autoRateUnits(qlonglong(system.net_rx_bps), unit);
+    QString downUnit = setRateUnitSensitive(unit);
+    unit = RateByte;
+    double upRate = autoRateUnits(qlonglong(system.net_tx_bps), unit);
+    QString uploadUnit = setRateUnitSensitive(unit);
+    m_downloadStr = QString("%1").arg(downRate, 1, 'f', 1, QLatin1Char(' ')) + downUnit;
+    m_uploadStr = QString("%1").arg(upRate, 1, 'f', 1, QLatin1Char(' ')) + uploadUnit;
+
+    // 保持原始计数最新，采样端退出后继续从/proc计算
+    m_down = qlonglong(system.net_rx_bytes);
+    m_upload = qlonglong(system.net_tx_bytes);
+}
+
 void MonitorPlugin::udpateTipsInfo()
 {
     udpateInfo();
@@ -31,6 +31,7 @@
 
 #include "dbus/dbusinterface.h"
 #include "systemmonitortipswidget.h"
+#include "metrics_snapshot.hpp"
 
 // Qt
 #include <QDBusInterface>
@@ -243,6 +244,11 @@ private:
     //!
     void calcNetRate(qlonglong &netDown, qlonglong &netUpload);
 
+    //!
+    //! \brief updateInfoFromSnapshot 使用系统监视器发布的采样数据更新CPU MEM NET信息
+    //! \param system 系统监视器最近一次采样
+    //!
+    void updateInfoFromSnapshot(const common::metrics_system_t &system);
 
     //!
     //! \brief setRateUnitSensitive 设置速率单位的大小写模式
@@ -280,6 +286,11 @@ private:
     qlonglong m_totalCPU = 0;
     qlonglong m_availableCPU = 0;
 
+    // 系统监视器运行时由其发布的采样数据
+    common::MetricsSnapshotReader m_snapshot;
+    // 上一次使用的采样序号
+    uint64_t m_snapshotGeneration = 0;
+
     QTimer *m_refershTimer;
 
     QString startup;
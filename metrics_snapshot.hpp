@@ -0,0 +1,353 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QByteArray>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define METRICS_SNAPSHOT_MAGIC 0x534d5344   // "DSMS"
+#define METRICS_SNAPSHOT_VERSION 1
+#define METRICS_SNAPSHOT_MAX_PROCS 4096   // process table entries, larger tables are truncated
+#define METRICS_SNAPSHOT_STALE_TIME 5000   // samples older than this are not trusted, readers sample themselves (5 seconds)
+#define METRICS_SNAPSHOT_READ_RETRIES 64   // seqlock retries before a read gives up
+#define METRICS_SNAPSHOT_FILE "deepin-system-monitor-metrics"
+
+namespace common {
+
+/**
+ * @brief System wide counters of one sample, raw counters are kept so readers can compute rates on their own interval
+ */
+struct metrics_system_t {
+    uint64_t timestamp;         // CLOCK_MONOTONIC sample time (ms)
+    uint64_t generation;        // samples published so far, unchanged generation means no new sample
+
+    // first line of /proc/stat (jiffies)
+    uint64_t cpu_user;
+    uint64_t cpu_nice;
+    uint64_t cpu_sys;
+    uint64_t cpu_idle;
+    uint64_t cpu_iowait;
+    uint64_t cpu_hardirq;
+    uint64_t cpu_softirq;
+    uint64_t cpu_steal;
+    uint64_t cpu_guest;
+    uint64_t cpu_guest_nice;
+
+    // /proc/meminfo (kB)
+    uint64_t mem_total;
+    uint64_t mem_available;
+    uint64_t swap_total;
+    uint64_t swap_free;
+
+    // /proc/net/dev, sum of all interfaces
+    uint64_t net_rx_bytes;
+    uint64_t net_tx_bytes;
+    double net_rx_bps;
+    double net_tx_bps;
+
+    // /proc/diskstats, whole disks only
+    double disk_read_bps;
+    double disk_write_bps;
+
+    uint32_t nprocs;            // valid entries in process table
+    uint32_t nthreads;          // threads of all processes
+};
+
+/**
+ * @brief Per process entry of one sample
+ */
+struct metrics_proc_t {
+    int32_t pid;
+    uint32_t uid;
+    char name[16];              // process name, truncated like comm
+    double cpu;                 // cpu usage (percent)
+    uint64_t memory;            // resident memory without shared memory (kB)
+    double read_bps;            // disk read
+    double write_bps;           // disk write
+    double recv_bps;            // network receive
+    double sent_bps;            // network send
+};
+
+/**
+ * @brief Shared memory layout, written by one sampler & mapped read-only by everyone else
+ *
+ * All fields but seq are only valid between two equal even seq values, header fields included:
+ * a new sampler rewrites the header when it takes over the region.
+ */
+struct metrics_snapshot_t {
+    std::atomic<uint32_t> seq;  // seqlock sequence, odd while a sample is being written
+    uint32_t magic;
+    uint32_t version;
+    int32_t writer;             // sampler pid
+    struct metrics_system_t system;
+    struct metrics_proc_t procs[METRICS_SNAPSHOT_MAX_PROCS];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock needs a lock free sequence counter");
+
+inline uint64_t metricsTimestamp()
+{
+    struct timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000 + uint64_t(ts.tv_nsec) / 1000000;
+}
+
+/**
+ * @brief Region backing file: per user runtime dir (tmpfs, private to the user), /dev/shm otherwise
+ */
+inline QByteArray metricsSnapshotPath()
+{
+    QByteArray dir = qgetenv("XDG_RUNTIME_DIR");
+    if (!dir.isEmpty())
+        return dir + "/" METRICS_SNAPSHOT_FILE;
+    return QByteArray("/dev/shm/" METRICS_SNAPSHOT_FILE "-") + QByteArray::number(getuid());
+}
+
+// region file must be a regular file of our own, not something another user planted under a shared dir
+inline bool metricsSnapshotFileTrusted(int fd, off_t minSize)
+{
+    struct stat st {};
+    if (fstat(fd, &st) < 0)
+        return false;
+    return S_ISREG(st.st_mode) && st.st_uid == geteuid() && st.st_size >= minSize;
+}
+
+/**
+ * @brief Sampler side of the metrics snapshot
+ *
+ * Only the process holding the exclusive lock on the region publishes, so concurrent system monitor
+ * instances never interleave writes; the lock goes away with the process, a crashed sampler is replaced
+ * by whoever calls open next.
+ */
+class MetricsSnapshotWriter
+{
+public:
+    explicit MetricsSnapshotWriter(const QByteArray &path = metricsSnapshotPath())
+        : m_path(path)
+    {
+    }
+    ~MetricsSnapshotWriter()
+    {
+        close();
+    }
+    MetricsSnapshotWriter(const MetricsSnapshotWriter &) = delete;
+    MetricsSnapshotWriter &operator=(const MetricsSnapshotWriter &) = delete;
+
+    /**
+     * @brief Create & map the region, become the sampler
+     * @return Return false if another process is the sampler already or the region can't be set up
+     */
+    bool open()
+    {
+        if (isValid())
+            return true;
+
+        int fd = ::open(m_path.constData(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+        if (fd < 0)
+            return false;
+
+        if (flock(fd, LOCK_EX | LOCK_NB) < 0
+                || !metricsSnapshotFileTrusted(fd, 0)
+                || ftruncate(fd, off_t(sizeof(struct metrics_snapshot_t))) < 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void *addr = mmap(nullptr, sizeof(struct metrics_snapshot_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+
+        m_fd = fd;
+        m_snapshot = static_cast<struct metrics_snapshot_t *>(addr);
+
+        // previous sampler may have died half way through a sample, start from a consistent header
+        auto *snapshot = beginWrite();
+        snapshot->magic = METRICS_SNAPSHOT_MAGIC;
+        snapshot->version = METRICS_SNAPSHOT_VERSION;
+        snapshot->writer = getpid();
+        uint64_t generation = snapshot->system.generation;
+        memset(&snapshot->system, 0, sizeof(snapshot->system));
+        snapshot->system.generation = generation;
+        endWrite(false);
+
+        return true;
+    }
+
+    void close()
+    {
+        if (m_snapshot) {
+            munmap(m_snapshot, sizeof(struct metrics_snapshot_t));
+            m_snapshot = nullptr;
+        }
+        // region is kept, readers still map it; the lock is released with the fd
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    inline bool isValid() const
+    {
+        return m_snapshot != nullptr;
+    }
+
+    /**
+     * @brief Start writing a sample in place, readers retry until endWrite is called
+     */
+    struct metrics_snapshot_t *beginWrite()
+    {
+        uint32_t seq = m_snapshot->seq.load(std::memory_order_relaxed);
+        // odd after a sampler died while writing
+        m_seq = (seq & 1) ? seq + 1 : seq;
+        m_snapshot->seq.store(m_seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return m_snapshot;
+    }
+
+    /**
+     * @brief Publish the sample
+     * @param stamp Set sample time & bump generation
+     */
+    void endWrite(bool stamp = true)
+    {
+        if (stamp) {
+            m_snapshot->system.timestamp = metricsTimestamp();
+            ++m_snapshot->system.generation;
+        }
+        m_snapshot->seq.store(m_seq + 2, std::memory_order_release);
+    }
+
+private:
+    QByteArray m_path;
+    int m_fd {-1};
+    uint32_t m_seq {0};
+    struct metrics_snapshot_t *m_snapshot {nullptr};
+};
+
+/**
+ * @brief Read-only view of the metrics snapshot
+ */
+class MetricsSnapshotReader
+{
+public:
+    explicit MetricsSnapshotReader(const QByteArray &path = metricsSnapshotPath())
+        : m_path(path)
+    {
+    }
+    ~MetricsSnapshotReader()
+    {
+        close();
+    }
+    MetricsSnapshotReader(const MetricsSnapshotReader &) = delete;
+    MetricsSnapshotReader &operator=(const MetricsSnapshotReader &) = delete;
+
+    /**
+     * @brief Map the region read-only
+     * @return Return false if no sampler ever created it
+     */
+    bool open()
+    {
+        if (isValid())
+            return true;
+
+        int fd = ::open(m_path.constData(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+        if (fd < 0)
+            return false;
+
+        void *addr = MAP_FAILED;
+        if (metricsSnapshotFileTrusted(fd, off_t(sizeof(struct metrics_snapshot_t))))
+            addr = mmap(nullptr, sizeof(struct metrics_snapshot_t), PROT_READ, MAP_SHARED, fd, 0);
+        // mapping stays valid after the fd is closed
+        ::close(fd);
+        if (addr == MAP_FAILED)
+            return false;
+
+        m_snapshot = static_cast<const struct metrics_snapshot_t *>(addr);
+        return true;
+    }
+
+    void close()
+    {
+        if (m_snapshot) {
+            munmap(const_cast<struct metrics_snapshot_t *>(m_snapshot), sizeof(struct metrics_snapshot_t));
+            m_snapshot = nullptr;
+        }
+    }
+
+    inline bool isValid() const
+    {
+        return m_snapshot != nullptr;
+    }
+
+    /**
+     * @brief Copy system counters of the latest sample
+     * @return Return false if there is no sampler, the sample is stale or kept changing under the reader
+     */
+    bool readSystem(struct metrics_system_t &system)
+    {
+        return read(system, nullptr, 0);
+    }
+
+    /**
+     * @brief Copy system counters & process table of the latest sample, both from the same sample
+     * @param procs Process table buffer, system.nprocs is clamped to max if given
+     */
+    bool read(struct metrics_system_t &system, struct metrics_proc_t *procs, uint32_t max)
+    {
+        if (!open())
+            return false;
+
+        for (int i = 0; i < METRICS_SNAPSHOT_READ_RETRIES; ++i) {
+            uint32_t seq = m_snapshot->seq.load(std::memory_order_acquire);
+            if (seq & 1) {
+                sched_yield();
+                continue;
+            }
+
+            uint32_t magic = m_snapshot->magic;
+            uint32_t version = m_snapshot->version;
+            memcpy(&system, &m_snapshot->system, sizeof(system));
+            uint32_t n = system.nprocs < METRICS_SNAPSHOT_MAX_PROCS ? system.nprocs : METRICS_SNAPSHOT_MAX_PROCS;
+            if (n > max)
+                n = max;
+            if (procs && n > 0)
+                memcpy(procs, m_snapshot->procs, n * sizeof(struct metrics_proc_t));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_snapshot->seq.load(std::memory_order_relaxed) != seq)
+                continue;
+
+            if (magic != METRICS_SNAPSHOT_MAGIC || version != METRICS_SNAPSHOT_VERSION || system.generation == 0)
+                return false;
+            if (procs)
+                system.nprocs = n;
+            // sampler quit or hangs
+            return metricsTimestamp() - system.timestamp <= METRICS_SNAPSHOT_STALE_TIME;
+        }
+
+        return false;
+    }
+
+private:
+    QByteArray m_path;
+    const struct metrics_snapshot_t *m_snapshot {nullptr};
+};
+
+} // namespace common
@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "metrics_snapshot.hpp"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+
+#include <sys/wait.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace common;
+
+namespace {
+
+const int kReaders = 4;
+const int kRunTime = 500;   // ms
+
+// every field of sample g is derived from g, any mix of two samples is detected
+void writeSample(MetricsSnapshotWriter &writer, uint64_t g)
+{
+    auto *snapshot = writer.beginWrite();
+    auto &system = snapshot->system;
+    system.cpu_user = system.cpu_nice = system.cpu_sys = system.cpu_idle = system.cpu_iowait = g;
+    system.cpu_hardirq = system.cpu_softirq = system.cpu_steal = system.cpu_guest = system.cpu_guest_nice = g;
+    system.mem_total = system.mem_available = system.swap_total = system.swap_free = g;
+    system.net_rx_bytes = system.net_tx_bytes = g;
+    system.net_rx_bps = system.net_tx_bps = system.disk_read_bps = system.disk_write_bps = double(g);
+    system.nprocs = uint32_t(g % 512) + 1;
+    for (uint32_t i = 0; i < system.nprocs; ++i) {
+        auto &proc = snapshot->procs[i];
+        proc.pid = int32_t(i);
+        proc.memory = g + i;
+        proc.cpu = double(g);
+    }
+    writer.endWrite();
+}
+
+// torn samples counted, -1 if nothing could be read at all
+int readSamples(const QByteArray &path, int runTime)
+{
+    MetricsSnapshotReader reader(path);
+    std::vector<struct metrics_proc_t> procs(METRICS_SNAPSHOT_MAX_PROCS);
+    int torn = 0;
+    int reads = 0;
+    uint64_t start = metricsTimestamp();
+    while (metricsTimestamp() - start < uint64_t(runTime)) {
+        struct metrics_system_t system {};
+        if (!reader.read(system, procs.data(), uint32_t(procs.size())))
+            continue;
+        ++reads;
+
+        uint64_t g = system.cpu_user;
+        bool ok = system.cpu_guest_nice == g && system.mem_available == g && system.net_tx_bytes == g
+                  && system.disk_write_bps == double(g) && system.nprocs == uint32_t(g % 512) + 1;
+        for (uint32_t i = 0; ok && i < system.nprocs; ++i)
+            ok = procs[i].pid == int32_t(i) && procs[i].memory == g + i && procs[i].cpu == double(g);
+        if (!ok)
+            ++torn;
+    }
+    return reads > 0 ? torn : -1;
+}
+
+} // namespace
+
+class UT_MetricsSnapshot : public ::testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        m_path = m_dir.filePath("metrics").toLocal8Bit();
+    }
+
+protected:
+    QTemporaryDir m_dir;
+    QByteArray m_path;
+};
+
+TEST_F(UT_MetricsSnapshot, initTest)
+{
+    MetricsSnapshotReader reader(m_path);
+    struct metrics_system_t system {};
+    // no sampler ever ran
+    EXPECT_FALSE(reader.readSystem(system));
+    EXPECT_FALSE(reader.isValid());
+}
+
+// one sampler at a time, the next one takes over once it is gone
+TEST_F(UT_MetricsSnapshot, test_writer_election_001)
+{
+    MetricsSnapshotWriter writer(m_path);
+    MetricsSnapshotWriter other(m_path);
+    MetricsSnapshotReader reader(m_path);
+    struct metrics_system_t system {};
+
+    EXPECT_TRUE(writer.open());
+    EXPECT_FALSE(other.open());
+    // region set up, nothing published yet
+    EXPECT_FALSE(reader.readSystem(system));
+
+    writeSample(writer, 42);
+    EXPECT_TRUE(reader.readSystem(system));
+    EXPECT_EQ(system.cpu_idle, uint64_t(42));
+    EXPECT_EQ(system.generation, uint64_t(1));
+    EXPECT_EQ(system.nprocs, uint32_t(42 % 512 + 1));
+
+    writer.close();
+    EXPECT_TRUE(other.open());
+    // previous sample is dropped on take over
+    EXPECT_FALSE(reader.readSystem(system));
+    writeSample(other, 43);
+    EXPECT_TRUE(reader.readSystem(system));
+    EXPECT_EQ(system.cpu_idle, uint64_t(43));
+    EXPECT_EQ(system.generation, uint64_t(2));
+}
+
+TEST_F(UT_MetricsSnapshot, test_stale_001)
+{
+    MetricsSnapshotWriter writer(m_path);
+    MetricsSnapshotReader reader(m_path);
+    struct metrics_system_t system {};
+    ASSERT_TRUE(writer.open());
+    writeSample(writer, 1);
+    EXPECT_TRUE(reader.readSystem(system));
+
+    // sampler hangs
+    auto *snapshot = writer.beginWrite();
+    snapshot->system.timestamp -= METRICS_SNAPSHOT_STALE_TIME + 1000;
+    writer.endWrite(false);
+    EXPECT_FALSE(reader.readSystem(system));
+
+    // sampler died while writing
+    writer.beginWrite();
+    EXPECT_FALSE(reader.readSystem(system));
+}
+
+// process table is clamped to the reader's buffer
+TEST_F(UT_MetricsSnapshot, test_read_procs_001)
+{
+    MetricsSnapshotWriter writer(m_path);
+    MetricsSnapshotReader reader(m_path);
+    ASSERT_TRUE(writer.open());
+    writeSample(writer, 100);
+
+    struct metrics_system_t system {};
+    struct metrics_proc_t procs[8] {};
+    EXPECT_TRUE(reader.read(system, procs, 8));
+    EXPECT_EQ(system.nprocs, uint32_t(8));
+    EXPECT_EQ(procs[7].memory, uint64_t(107));
+}
+
+// one writer & N reader threads, each reader with its own mapping
+TEST_F(UT_MetricsSnapshot, test_torn_read_threads_001)
+{
+    MetricsSnapshotWriter writer(m_path);
+    ASSERT_TRUE(writer.open());
+    writeSample(writer, 1);
+
+    std::atomic_bool stop {false};
+    std::thread sampler([&writer, &stop]() {
+        // back to back samples, yield so readers get scheduled on a single cpu too
+        for (uint64_t g = 2; !stop.load(); ++g) {
+            writeSample(writer, g);
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<int> torn(kReaders, 0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i)
+        readers.emplace_back([this, &torn, i]() { torn[size_t(i)] = readSamples(m_path, kRunTime); });
+    for (auto &reader : readers)
+        reader.join();
+    stop = true;
+    sampler.join();
+
+    for (int i = 0; i < kReaders; ++i)
+        EXPECT_EQ(torn[size_t(i)], 0);
+}
+
+// one writer & N reader processes
+TEST_F(UT_MetricsSnapshot, test_torn_read_processes_001)
+{
+    MetricsSnapshotWriter writer(m_path);
+    ASSERT_TRUE(writer.open());
+    writeSample(writer, 1);
+
+    // fork before any thread of our own is running
+    std::vector<pid_t> children;
+    for (int i = 0; i < kReaders; ++i) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            // a reader process can't become the sampler while the parent holds the region
+            MetricsSnapshotWriter other(m_path);
+            _exit(other.open() ? 2 : (readSamples(m_path, kRunTime) == 0 ? 0 : 1));
+        }
+        children.push_back(pid);
+    }
+
+    std::atomic_bool stop {false};
+    std::thread sampler([&writer, &stop]() {
+        // back to back samples, yield so readers get scheduled on a single cpu too
+        for (uint64_t g = 2; !stop.load(); ++g) {
+            writeSample(writer, g);
+            std::this_thread::yield();
+        }
+    });
+
+    for (pid_t pid : children) {
+        int status = -1;
+        waitpid(pid, &status, 0);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+    stop = true;
+    sampler.join();
+}
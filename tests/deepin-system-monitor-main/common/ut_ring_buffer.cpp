@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/ring_buffer.h"
+#include "common/sample.h"
+#include "process/private/process_p.h"
+
+//qt
+#include <QElapsedTimer>
+#include <QDebug>
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace common::core;
+
+/***************************************STUB begin*********************************************/
+// counts live instances, catches leaked or double destroyed slots
+struct Tracked {
+    static int alive;
+
+    explicit Tracked(int v = 0) : value(v) { ++alive; }
+    Tracked(const Tracked &other) : value(other.value) { ++alive; }
+    ~Tracked() { --alive; }
+
+    int value;
+};
+int Tracked::alive = 0;
+/***************************************STUB end**********************************************/
+
+class UT_RingBuffer : public ::testing::Test
+{
+public:
+    UT_RingBuffer() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        Tracked::alive = 0;
+        m_tester = new RingBuffer<Tracked, 2>(3);
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+        EXPECT_EQ(Tracked::alive, 0);
+    }
+
+protected:
+    RingBuffer<Tracked, 2> *m_tester;
+};
+
+TEST_F(UT_RingBuffer, initTest)
+{
+    EXPECT_EQ(m_tester->capacity(), 3u);
+    EXPECT_EQ(m_tester->size(), 0u);
+    EXPECT_TRUE(m_tester->empty());
+}
+
+TEST_F(UT_RingBuffer, test_emplace_back_001)
+{
+    for (int i = 0; i < 10; ++i)
+        m_tester->emplace_back(i);
+
+    ASSERT_EQ(m_tester->size(), 3u);
+    EXPECT_TRUE(m_tester->full());
+    EXPECT_EQ(Tracked::alive, 3);
+    EXPECT_EQ(m_tester->front().value, 7);
+    EXPECT_EQ((*m_tester)[1].value, 8);
+    EXPECT_EQ(m_tester->back().value, 9);
+}
+
+TEST_F(UT_RingBuffer, test_pop_front_001)
+{
+    m_tester->emplace_back(1);
+    m_tester->emplace_back(2);
+    m_tester->pop_front();
+    EXPECT_EQ(m_tester->size(), 1u);
+    EXPECT_EQ(m_tester->front().value, 2);
+
+    m_tester->clear();
+    m_tester->pop_front();
+    EXPECT_TRUE(m_tester->empty());
+    EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST_F(UT_RingBuffer, test_copy_001)
+{
+    for (int i = 0; i < 5; ++i)
+        m_tester->emplace_back(i);
+
+    RingBuffer<Tracked, 2> copy(*m_tester);
+    EXPECT_EQ(copy.capacity(), 3u);
+    ASSERT_EQ(copy.size(), 3u);
+    for (size_t i = 0; i < copy.size(); ++i)
+        EXPECT_EQ(copy[i].value, (*m_tester)[i].value);
+
+    RingBuffer<Tracked, 2> assigned(1);
+    assigned.emplace_back(42);
+    assigned = copy;
+    EXPECT_EQ(assigned.capacity(), 3u);
+    EXPECT_EQ(assigned.back().value, 4);
+}
+
+TEST_F(UT_RingBuffer, test_setCapacity_001)
+{
+    for (int i = 0; i < 3; ++i)
+        m_tester->emplace_back(i);
+
+    // shrink into inline storage keeps the most recent
+    m_tester->setCapacity(2);
+    ASSERT_EQ(m_tester->size(), 2u);
+    EXPECT_EQ(m_tester->front().value, 1);
+    EXPECT_EQ(m_tester->back().value, 2);
+
+    m_tester->setCapacity(8);
+    EXPECT_EQ(m_tester->capacity(), 8u);
+    for (int i = 3; i < 10; ++i)
+        m_tester->emplace_back(i);
+    ASSERT_EQ(m_tester->size(), 8u);
+    EXPECT_EQ(m_tester->front().value, 2);
+    EXPECT_EQ(Tracked::alive, 8);
+}
+
+TEST_F(UT_RingBuffer, test_sample_001)
+{
+    IOPSSample sample(TimePeriod(TimePeriod::kNoPeriod, {2, 0}));
+    EXPECT_EQ(sample.recentSample(), nullptr);
+
+    for (int i = 1; i <= 3; ++i)
+        sample.addSample(IOPSSampleFrame(IOPS {qreal(i), qreal(i * 10)}));
+
+    EXPECT_EQ(sample.count(), 2);
+    EXPECT_EQ(sample.recentSample()->data.inBps, 3.);
+    auto pair = sample.recentSamplePair();
+    EXPECT_EQ(pair.first->data.inBps, 2.);
+    EXPECT_EQ(pair.second->data.inBps, 3.);
+    EXPECT_EQ(sample.sample(2), nullptr);
+
+    sample.updateTimePeriod(TimePeriod(TimePeriod::kNoPeriod, {1, 0}));
+    EXPECT_EQ(sample.count(), 0);
+}
+
+TEST_F(UT_RingBuffer, test_ring_matrix_001)
+{
+    RingMatrix<int> matrix(2, 3);
+    EXPECT_TRUE(matrix.empty());
+    EXPECT_EQ(matrix.back(), nullptr);
+
+    for (int i = 0; i < 3; ++i) {
+        int *row = matrix.push_back();
+        for (int c = 0; c < 3; ++c)
+            row[c] = i * 10 + c;
+    }
+    ASSERT_EQ(matrix.size(), 2u);
+    EXPECT_EQ(matrix.row(0)[2], 12);
+    EXPECT_EQ(matrix.back()[0], 20);
+
+    // a full ring reuses the oldest row in place
+    const int *oldest = matrix.row(0);
+    EXPECT_EQ(matrix.push_back(), oldest);
+
+    // new columns are zeroed, recent rows are kept
+    matrix.reshape(3, 4);
+    ASSERT_EQ(matrix.size(), 2u);
+    EXPECT_EQ(matrix.columns(), 4u);
+    EXPECT_EQ(matrix.row(0)[0], 20);
+    EXPECT_EQ(matrix.row(0)[3], 0);
+
+    RingMatrix<int> copy(matrix);
+    EXPECT_EQ(copy.capacity(), 3u);
+    ASSERT_EQ(copy.size(), 2u);
+    EXPECT_EQ(copy.row(0)[2], 22);
+}
+
+// 10k processes worth of series, one tick each
+TEST_F(UT_RingBuffer, test_benchmark_sample_001)
+{
+    const int count = 10000;
+    const int rounds = 10;
+    std::unique_ptr<core::process::ProcessPrivate[]> procs(new core::process::ProcessPrivate[count]);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < rounds; ++r) {
+        struct timeval tv = {r, 0};
+        for (int i = 0; i < count; ++i) {
+            auto &d = procs[i];
+            d.cpuUsageSample.addSample(core::process::CPUUsageSampleFrame(qreal(i)));
+            d.diskIOSample.addSample(DISKIOSampleFrame(tv, {qulonglong(r), 0, 0}));
+            auto pair = d.diskIOSample.recentSamplePair();
+            d.diskIOSpeedSample.addSample(IOPSSampleFrame(DISKIOSampleFrame::diskiops(pair.first, pair.second)));
+            d.networkIOSample.addSample(IOSampleFrame(tv, {qulonglong(r), 0}));
+            auto netpair = d.networkIOSample.recentSamplePair();
+            d.networkBandwidthSample.addSample(IOPSSampleFrame(IOSampleFrame::iops(netpair.first, netpair.second)));
+        }
+    }
+    qint64 elapsed = timer.nsecsElapsed() / rounds;
+
+    EXPECT_EQ(procs[count - 1].diskIOSample.count(), 2);
+    qInfo() << "sample tick for" << count << "processes:" << elapsed / 1000 << "us,"
+            << "sizeof(ProcessPrivate)" << sizeof(core::process::ProcessPrivate) << "bytes,"
+            << "sizeof(DISKIOSample)" << sizeof(DISKIOSample) << "bytes";
+}
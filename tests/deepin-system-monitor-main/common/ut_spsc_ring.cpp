@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "common/spsc_ring.h"
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace common::core;
+
+class UT_SpscRing : public ::testing::Test
+{
+public:
+    UT_SpscRing() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new SpscRing<int>(5);
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    SpscRing<int> *m_tester;
+};
+
+TEST_F(UT_SpscRing, initTest)
+{
+    EXPECT_EQ(m_tester->capacity(), size_t(8));
+    EXPECT_TRUE(m_tester->empty());
+    EXPECT_EQ(m_tester->size(), size_t(0));
+}
+
+TEST_F(UT_SpscRing, test_push_pop_001)
+{
+    for (int i = 0; i < 8; ++i)
+        EXPECT_TRUE(m_tester->push(i));
+    // full, record dropped
+    EXPECT_FALSE(m_tester->push(8));
+    EXPECT_EQ(m_tester->size(), size_t(8));
+
+    int out[8] {};
+    EXPECT_EQ(m_tester->pop(out, 3), size_t(3));
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[2], 2);
+
+    // wraps around
+    EXPECT_TRUE(m_tester->push(8));
+    EXPECT_TRUE(m_tester->push(9));
+    EXPECT_EQ(m_tester->pop(out, 8), size_t(7));
+    for (int i = 0; i < 7; ++i)
+        EXPECT_EQ(out[i], i + 3);
+
+    EXPECT_TRUE(m_tester->empty());
+    EXPECT_EQ(m_tester->pop(out, 8), size_t(0));
+}
+
+// records arrive complete & in order across threads
+TEST_F(UT_SpscRing, test_threads_001)
+{
+    const int count = 1000000;
+    SpscRing<int> ring(1024);
+
+    std::thread producer([&ring, count]() {
+        for (int i = 0; i < count;) {
+            if (ring.push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    int out[64];
+    int expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        size_t n = ring.pop(out, 64);
+        for (size_t i = 0; i < n; ++i)
+            ordered = ordered && (out[i] == expected++);
+        if (n == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//Self
+#include "chart_curve_layer.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+//Qt
+#include <QPainter>
+#include <QPixmap>
+#include <QElapsedTimer>
+#include <QDebug>
+
+TEST(UT_ChartSeries, test_append_001)
+{
+    ChartSeries series(3);
+    EXPECT_TRUE(series.isEmpty());
+    EXPECT_FLOAT_EQ(series.max(), 0);
+
+    series.append(5);
+    series.append(1);
+    series.append(2);
+    EXPECT_EQ(series.size(), 3);
+    EXPECT_FLOAT_EQ(series.max(), 5);
+
+    // max drops out with the oldest sample
+    series.append(3);
+    EXPECT_EQ(series.size(), 3);
+    EXPECT_FLOAT_EQ(series.at(0), 1);
+    EXPECT_FLOAT_EQ(series.last(), 3);
+    EXPECT_FLOAT_EQ(series.max(), 3);
+    EXPECT_EQ(series.appended(), 4u);
+}
+
+TEST(UT_ChartSeries, test_fill_001)
+{
+    ChartSeries series(4);
+    series.append(2);
+    series.fill(0);
+    EXPECT_EQ(series.size(), 4);
+    EXPECT_FLOAT_EQ(series.at(0), 2);
+    EXPECT_FLOAT_EQ(series.max(), 2);
+}
+
+TEST(UT_ChartSeries, test_setCapacity_001)
+{
+    ChartSeries series(4);
+    for (int i = 0; i < 4; i++)
+        series.append(4 - i);
+
+    // keeps the newest samples
+    series.setCapacity(2);
+    EXPECT_EQ(series.capacity(), 2);
+    EXPECT_EQ(series.size(), 2);
+    EXPECT_FLOAT_EQ(series.at(0), 2);
+    EXPECT_FLOAT_EQ(series.max(), 2);
+}
+
+TEST(UT_ChartGrid, test_draw_001)
+{
+    QPixmap target(100, 60);
+    QPainter painter(&target);
+    ChartGrid grid;
+
+    grid.draw(painter, QRect(0, 0, 80, 50), Qt::gray);
+    qint64 key = grid.m_pixmap.cacheKey();
+    EXPECT_EQ(grid.m_pixmap.size(), QSize(81, 51));
+
+    // same size & colors, reuse the cached grid
+    grid.draw(painter, QRect(10, 5, 80, 50), Qt::gray);
+    EXPECT_EQ(grid.m_pixmap.cacheKey(), key);
+
+    grid.draw(painter, QRect(10, 5, 80, 50), Qt::red);
+    EXPECT_NE(grid.m_pixmap.cacheKey(), key);
+}
+
+class UT_ChartCurveLayer : public ::testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        m_tester.addCurve(QPen(Qt::blue, 1.2));
+        m_tester.addCurve(QPen(Qt::red, 1.2));
+        m_tester.setGeometry(QRect(0, 0, 300, 100), 300, 10);
+        m_tester.setBaseline(0, 50, -50);
+        m_tester.setBaseline(1, 50, 50);
+        m_tester.setScale(100);
+        for (int i = 0; i < m_tester.curveCount(); i++)
+            m_tester.series(i).fill(0);
+    }
+
+    void append(float value)
+    {
+        for (int i = 0; i < m_tester.curveCount(); i++)
+            m_tester.series(i).append(value);
+    }
+
+protected:
+    ChartCurveLayer m_tester {31};
+};
+
+TEST_F(UT_ChartCurveLayer, test_pendingSamples_001)
+{
+    QPixmap target(300, 100);
+    QPainter painter(&target);
+    m_tester.draw(painter);
+    EXPECT_TRUE(m_tester.m_valid);
+    EXPECT_EQ(m_tester.pendingSamples(), 0);
+
+    append(10);
+    EXPECT_EQ(m_tester.pendingSamples(), 1);
+
+    // curves moved apart
+    m_tester.series(0).append(20);
+    EXPECT_EQ(m_tester.pendingSamples(), -1);
+}
+
+TEST_F(UT_ChartCurveLayer, test_draw_scroll_001)
+{
+    QPixmap target(300, 100);
+    QPainter painter(&target);
+    m_tester.draw(painter);
+    qint64 key = m_tester.m_pixmap.cacheKey();
+
+    // same scale, the layer is scrolled in place
+    append(10);
+    m_tester.draw(painter);
+    EXPECT_EQ(m_tester.pendingSamples(), 0);
+    EXPECT_EQ(m_tester.m_pixmap.size(), QSize(300, 100));
+    EXPECT_DOUBLE_EQ(m_tester.m_pending, 0);
+
+    // new scale, the layer is redrawn
+    m_tester.setScale(200);
+    EXPECT_FALSE(m_tester.m_valid);
+    m_tester.draw(painter);
+    EXPECT_TRUE(m_tester.m_valid);
+    EXPECT_NE(m_tester.m_pixmap.cacheKey(), key);
+}
+
+TEST_F(UT_ChartCurveLayer, test_draw_scroll_002)
+{
+    QPixmap target(300, 100);
+    QPainter painter(&target);
+    m_tester.setGeometry(QRect(0, 0, 300, 100), 300, 2.5);
+    m_tester.draw(painter);
+
+    // fractional steps, remainder carried over
+    append(10);
+    m_tester.draw(painter);
+    EXPECT_DOUBLE_EQ(m_tester.m_pending, 2.5 - 3);
+    append(10);
+    m_tester.draw(painter);
+    EXPECT_DOUBLE_EQ(m_tester.m_pending, 0);
+}
+
+TEST_F(UT_ChartCurveLayer, test_benchmark_paint_001)
+{
+    const int rounds = 500;
+    QPixmap target(300, 100);
+    QPainter painter(&target);
+    m_tester.draw(painter);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; i++) {
+        append((i * 13) % 100);
+        m_tester.draw(painter);
+    }
+    qint64 scrolled = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < rounds; i++) {
+        append((i * 13) % 100);
+        m_tester.invalidate();
+        m_tester.draw(painter);
+    }
+    qint64 redrawn = timer.nsecsElapsed();
+
+    qInfo() << "chart curves, per frame: scrolled" << scrolled / rounds / 1000. << "us,"
+            << "redrawn" << redrawn / rounds / 1000. << "us";
+    EXPECT_TRUE(m_tester.m_valid);
+}
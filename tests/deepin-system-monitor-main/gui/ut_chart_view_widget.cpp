@@ -70,11 +70,11 @@ TEST_F(UT_ChartViewWidget, test_addData1_02)
 {
     QVariant variant(20);
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData1.append(i);
+        m_tester->m_curves.series(m_tester->m_data1Curve).append(i);
     }
     m_tester->addData1(variant);
-    EXPECT_EQ(m_tester->m_maxData1.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData1, QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData1_03)
@@ -82,11 +82,11 @@ TEST_F(UT_ChartViewWidget, test_addData1_03)
     QVariant variant(20);
     m_tester->m_speedAxis = true;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData1.append(i);
+        m_tester->m_curves.series(m_tester->m_data1Curve).append(i);
     }
     m_tester->addData1(variant);
-    EXPECT_EQ(m_tester->m_maxData1.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData1, QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData1_04)
@@ -95,11 +95,11 @@ TEST_F(UT_ChartViewWidget, test_addData1_04)
     m_tester->m_speedAxis = true;
     m_tester->m_maxData1 = 0;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData1.append(i);
+        m_tester->m_curves.series(m_tester->m_data1Curve).append(i);
     }
     m_tester->addData1(variant);
-    EXPECT_EQ(m_tester->m_maxData1.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData1, QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_setData2Color_01)
@@ -123,11 +123,11 @@ TEST_F(UT_ChartViewWidget, test_addData2_02)
 {
     QVariant variant(20);
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData2.append(i);
+        m_tester->m_curves.series(m_tester->m_data2Curve).append(i);
     }
     m_tester->addData2(variant);
-    EXPECT_EQ(m_tester->m_maxData2.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData2, QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData2_03)
@@ -135,11 +135,11 @@ TEST_F(UT_ChartViewWidget, test_addData2_03)
     QVariant variant(20);
     m_tester->m_speedAxis = true;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData2.append(i);
+        m_tester->m_curves.series(m_tester->m_data2Curve).append(i);
     }
     m_tester->addData2(variant);
-    EXPECT_EQ(m_tester->m_maxData2.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData2, QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_addData2_04)
@@ -148,11 +148,11 @@ TEST_F(UT_ChartViewWidget, test_addData2_04)
     m_tester->m_speedAxis = true;
     m_tester->m_maxData2 = 0;
     for (int i = 0; i < 40; i++) {
-        m_tester->m_listData2.append(i);
+        m_tester->m_curves.series(m_tester->m_data2Curve).append(i);
     }
     m_tester->addData2(variant);
-    EXPECT_EQ(m_tester->m_maxData2.toLongLong(), QVariant(39 * 1.1).toLongLong());
-    EXPECT_EQ(m_tester->m_maxData.toLongLong(), QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData2, QVariant(39 * 1.1).toLongLong());
+    EXPECT_EQ(m_tester->m_maxData, QVariant(39 * 1.1).toLongLong());
 }
 
 TEST_F(UT_ChartViewWidget, test_setSpeedAxis_01)
@@ -203,45 +203,29 @@ TEST_F(UT_ChartViewWidget, test_drawBackPixmap_02)
     EXPECT_EQ(m_tester->width(), 0);
 }
 
-TEST_F(UT_ChartViewWidget, test_drawData1_01)
+TEST_F(UT_ChartViewWidget, test_drawData_01)
 {
     QPixmap pixmap(100, 100);
     QPainter painter(&pixmap);
-    m_tester->drawData1(&painter);
+    m_tester->drawData(&painter);
 
-    EXPECT_EQ(m_tester->m_listData1.size(), 0);
+    EXPECT_EQ(m_tester->m_curves.series(m_tester->m_data1Curve).size(), 0);
+    EXPECT_EQ(m_tester->m_curves.series(m_tester->m_data2Curve).size(), 0);
 }
 
-TEST_F(UT_ChartViewWidget, test_drawData1_02)
+TEST_F(UT_ChartViewWidget, test_drawData_02)
 {
-    for (int i = 0; i < 2; i++)
-    {
-        m_tester->m_listData1.append(i);
+    m_tester->resize(300, 100);
+    m_tester->drawBackPixmap();
+    for (int i = 0; i < 2; i++) {
+        m_tester->addData1(i);
+        m_tester->addData2(i);
     }
-    QPixmap pixmap(100, 100);
-    QPainter painter(&pixmap);
-
-    m_tester->drawData1(&painter);
-}
-
-TEST_F(UT_ChartViewWidget, test_drawData2_01)
-{
-    QPixmap pixmap(100, 100);
+    QPixmap pixmap(300, 100);
     QPainter painter(&pixmap);
-    m_tester->drawData2(&painter);
-
-    EXPECT_EQ(m_tester->m_listData2.size(), 0);
-}
+    m_tester->drawData(&painter);
 
-TEST_F(UT_ChartViewWidget, test_drawData2_02)
-{
-    for (int i = 0; i < 2; i++)
-    {
-        m_tester->m_listData2.append(i);
-    }
-    QPixmap pixmap(100, 100);
-    QPainter painter(&pixmap);
-    m_tester->drawData2(&painter);
+    EXPECT_FALSE(m_tester->m_curves.m_pixmap.isNull());
 }
 
 TEST_F(UT_ChartViewWidget, test_drawAxisText_01)
@@ -259,26 +243,10 @@ TEST_F(UT_ChartViewWidget, test_setAxisTitle_01)
     EXPECT_EQ(m_tester->m_axisTitle, title);
 }
 
-TEST_F(UT_ChartViewWidget, test_getPainterPathByData_01)
+TEST_F(UT_ChartViewWidget, test_addData1_05)
 {
-    QList<QVariant> listData;
-
-    listData << QVariant(10) << QVariant(20) << QVariant(30);
-    QPainterPath path;
-    QVariant maxYvalue(10);
-
-
-    m_tester->getPainterPathByData(listData, path, maxYvalue);
+    // memory usage ratios keep the 0 ~ 1 scale
+    m_tester->addData1(0.3);
+    EXPECT_EQ(m_tester->m_maxData, 1);
+    EXPECT_DOUBLE_EQ(m_tester->m_curves.m_scale, 1);
 }
-
-
-
-
-
-
-
-
-
-
-
-
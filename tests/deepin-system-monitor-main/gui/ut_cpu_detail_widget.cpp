@@ -17,6 +17,8 @@
 #include <QResizeEvent>
 #include <QPainter>
 #include <QGridLayout>
+#include <QElapsedTimer>
+#include <QHelpEvent>
 
 /***************************************STUB begin*********************************************/
 int stub_setMultiModeLayout_sysconf_cpu1()
@@ -58,19 +60,26 @@ int stub_setMultiModeLayout_sysconf_cpu0()
 {
     return 0;
 }
+
+static qreal g_corePercent = 50;
+qreal stub_cpuPercent(int)
+{
+    return g_corePercent;
+}
 /***************************************STUB end**********************************************/
 
-class UT_CPUDetailGrapTableItem : public ::testing::Test
+class UT_CPUDetailGrapGrid : public ::testing::Test
 {
 public:
-    UT_CPUDetailGrapTableItem() : m_tester(nullptr) {}
+    UT_CPUDetailGrapGrid() : m_tester(nullptr) {}
 
 public:
     virtual void SetUp()
     {
         static CPUInfoModel model;
         static QWidget widget;
-        m_tester = new CPUDetailGrapTableItem(&model, 0, &widget);
+        m_tester = new CPUDetailGrapGrid(&model, &widget);
+        m_tester->resize(640, 480);
     }
 
     virtual void TearDown()
@@ -82,149 +91,201 @@ public:
     }
 
 protected:
-    CPUDetailGrapTableItem *m_tester;
+    CPUDetailGrapGrid *m_tester;
 };
 
-TEST_F(UT_CPUDetailGrapTableItem, initTest)
+TEST_F(UT_CPUDetailGrapGrid, initTest)
 {
-
+    // overall usage in one cell
+    EXPECT_EQ(m_tester->m_count, 0);
+    EXPECT_EQ(m_tester->m_cells.size(), 1);
+    EXPECT_EQ(m_tester->m_history.columns(), size_t(1));
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_setMode_01)
+TEST_F(UT_CPUDetailGrapGrid, test_setCores_01)
 {
-    m_tester->setMode(1);
+    m_tester->setCores(16, 4, CPUDetailGrapGrid::kSimpleMode, 10);
 
-    EXPECT_EQ(m_tester->m_mode, 1);
+    EXPECT_EQ(m_tester->m_mode, CPUDetailGrapGrid::kSimpleMode);
+    EXPECT_EQ(m_tester->m_cells.size(), 16);
+    EXPECT_EQ(m_tester->m_history.columns(), size_t(16));
+    EXPECT_EQ(m_tester->m_history.capacity(), size_t(31));
+    EXPECT_TRUE(m_tester->m_history.empty());
+    // 4 x 4 cells of one size
+    EXPECT_EQ(m_tester->cellRect(0), QRect(0, 0, 152, 112));
+    EXPECT_EQ(m_tester->cellRect(5), QRect(162, 122, 152, 112));
+    EXPECT_EQ(m_tester->cellRect(5).size(), m_tester->cellRect(15).size());
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_setMultiCoreMode_01)
+TEST_F(UT_CPUDetailGrapGrid, test_setCores_02)
 {
-    m_tester->setMultiCoreMode(true);
+    // no empty columns
+    m_tester->setCores(2, 16, CPUDetailGrapGrid::kNormalMode, 10);
+    EXPECT_EQ(m_tester->m_columns, 2);
 
-    EXPECT_EQ(m_tester->m_isMutliCoreMode, true);
+    m_tester->setCores(-1, 0, CPUDetailGrapGrid::kNormalMode, 10);
+    EXPECT_EQ(m_tester->m_count, 0);
+    EXPECT_EQ(m_tester->m_columns, 1);
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_sethorizontal_01)
+TEST_F(UT_CPUDetailGrapGrid, test_resizeEvent_01)
 {
-    m_tester->sethorizontal(true);
+    m_tester->setCores(4, 2, CPUDetailGrapGrid::kNormalMode, 10);
+    m_tester->grab();
+    EXPECT_FALSE(m_tester->m_backPixmap.isNull());
 
-    EXPECT_EQ(m_tester->m_isHorizontalLast, true);
+    m_tester->resize(210, 110);
+    QResizeEvent event(QSize(210, 110), QSize(640, 480));
+    m_tester->resizeEvent(&event);
+    EXPECT_TRUE(m_tester->m_backPixmap.isNull());
+    EXPECT_EQ(m_tester->cellRect(3), QRect(110, 60, 100, 50));
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_setVerticalLast_01)
+TEST_F(UT_CPUDetailGrapGrid, test_updateStat_01)
 {
-    m_tester->setVerticalLast(true);
-
-    EXPECT_EQ(m_tester->m_isVerticalLast, true);
-}
+    Stub stub;
+    stub.set(ADDR(CPUInfoModel, cpuPercent), stub_cpuPercent);
+    m_tester->setCores(4, 2, CPUDetailGrapGrid::kNormalMode, 10);
 
-TEST_F(UT_CPUDetailGrapTableItem, test_setColor_01)
-{
-    m_tester->setColor(QColor(Qt::red));
+    g_corePercent = 50;
+    for (int i = 0; i < 40; i++)
+        m_tester->updateStat();
 
-    EXPECT_EQ(m_tester->m_color, QColor(Qt::red));
-}
+    EXPECT_EQ(m_tester->m_history.size(), size_t(31));
+    EXPECT_DOUBLE_EQ(m_tester->m_history.back()[3], 0.5);
+    // flat history, curve stopped moving
+    EXPECT_GE(m_tester->m_unchanged[3], 31);
 
-TEST_F(UT_CPUDetailGrapTableItem, test_updateStat_01)
-{
-    m_tester->m_isMutliCoreMode = false;
+    g_corePercent = 60;
     m_tester->updateStat();
-
-    EXPECT_EQ(m_tester->m_cpuPercents.size(), 1);
+    EXPECT_EQ(m_tester->m_unchanged[3], 0);
+    EXPECT_DOUBLE_EQ(m_tester->m_history.back()[3], 0.6);
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_updateStat_02)
+TEST_F(UT_CPUDetailGrapGrid, test_updateStat_02)
 {
-    m_tester->m_isMutliCoreMode = true;
-    m_tester->updateStat();
+    Stub stub;
+    stub.set(ADDR(CPUInfoModel, cpuPercent), stub_cpuPercent);
+    m_tester->setCores(2, 2, CPUDetailGrapGrid::kTextMode, 0);
 
-    EXPECT_EQ(m_tester->m_cpuPercents.size(), 1);
+    // no elapsed jiffies
+    g_corePercent = qQNaN();
+    m_tester->updateStat();
+    EXPECT_DOUBLE_EQ(m_tester->m_history.back()[0], 0);
+    g_corePercent = 50;
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_updateStat_03)
+TEST_F(UT_CPUDetailGrapGrid, test_paintEvent_01)
 {
-    for (int i = 0; i < 33; i++) {
-        m_tester->m_cpuPercents.append(qreal(i));
-    }
-    m_tester->m_isMutliCoreMode = true;
+    m_tester->setCores(0, 1, CPUDetailGrapGrid::kNormalMode, 10);
     m_tester->updateStat();
-
-    EXPECT_EQ(m_tester->m_cpuPercents.size(), 31);
+    EXPECT_FALSE(m_tester->grab().isNull());
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_paintEvent_01)
+TEST_F(UT_CPUDetailGrapGrid, test_paintEvent_02)
 {
-    m_tester->m_mode = 1;
+    m_tester->setCores(16, 4, CPUDetailGrapGrid::kSimpleMode, 10);
+    m_tester->updateStat();
+    m_tester->updateStat();
     EXPECT_FALSE(m_tester->grab().isNull());
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_paintEvent_02)
+TEST_F(UT_CPUDetailGrapGrid, test_paintEvent_03)
 {
-    m_tester->m_mode = 2;
+    m_tester->setCores(64, 8, CPUDetailGrapGrid::kTextMode, 0);
+    m_tester->updateStat();
     EXPECT_FALSE(m_tester->grab().isNull());
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_paintEvent_03)
+TEST_F(UT_CPUDetailGrapGrid, test_paintEvent_04)
 {
-    m_tester->m_mode = 3;
+    m_tester->setCores(256, 16, CPUDetailGrapGrid::kHeatmapMode, 0);
+    // nothing sampled yet
+    EXPECT_FALSE(m_tester->grab().isNull());
+    m_tester->updateStat();
     EXPECT_FALSE(m_tester->grab().isNull());
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_drawNormalMode_01)
+TEST_F(UT_CPUDetailGrapGrid, test_cellAt_01)
 {
-    QPixmap pixmap(100, 100);
-    QPainter painter(&pixmap);
-    m_tester->drawNormalMode(painter);
+    m_tester->setCores(64, 8, CPUDetailGrapGrid::kTextMode, 0);
+
+    EXPECT_EQ(m_tester->cellAt(QPoint(0, 0)), 0);
+    EXPECT_EQ(m_tester->cellAt(m_tester->cellRect(63).center()), 63);
+    EXPECT_EQ(m_tester->cellAt(QPoint(-1, -1)), -1);
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_drawNormalMode_02)
+TEST_F(UT_CPUDetailGrapGrid, test_event_01)
 {
-    m_tester->m_isMutliCoreMode = true;
-
-    m_tester->m_cpuPercents.append(0.1);
-    m_tester->m_cpuPercents.append(0.2);
-    m_tester->m_cpuPercents.append(0.3);
+    m_tester->setCores(256, 16, CPUDetailGrapGrid::kHeatmapMode, 0);
+    m_tester->updateStat();
 
-    QPixmap pixmap(100, 100);
-    QPainter painter(&pixmap);
-    m_tester->drawNormalMode(painter);
+    QPoint pos = m_tester->cellRect(20).center();
+    QHelpEvent event(QEvent::ToolTip, pos, m_tester->mapToGlobal(pos));
+    EXPECT_TRUE(m_tester->event(&event));
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_drawSimpleMode_01)
+TEST_F(UT_CPUDetailGrapGrid, test_changeFont_01)
 {
-    m_tester->m_cpuPercents.append(0.1);
-    m_tester->m_cpuPercents.append(0.2);
-    m_tester->m_cpuPercents.append(0.3);
+    QFont font;
+    font.setPointSize(12);
+    m_tester->grab();
+    m_tester->changeFont(font);
 
-    QPixmap pixmap(100, 100);
-    QPainter painter(&pixmap);
-    m_tester->drawSimpleMode(painter);
+    EXPECT_EQ(m_tester->m_midFont.pointSize(), 10);
+    EXPECT_TRUE(m_tester->m_backPixmap.isNull());
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_drawTextMode_01)
+TEST_F(UT_CPUDetailGrapGrid, test_drawBackground_01)
 {
     QPixmap pixmap(100, 100);
     QPainter painter(&pixmap);
-    m_tester->drawTextMode(painter);
+    QRect rect(0, 0, 10, 10);
+    m_tester->drawBackground(painter, rect);
 }
 
-TEST_F(UT_CPUDetailGrapTableItem, test_drawSingleCoreMode_01)
+// one update of the whole grid: sample, then repaint every cell
+TEST_F(UT_CPUDetailGrapGrid, test_benchmark_paint_001)
 {
-    m_tester->m_cpuPercents.append(0.1);
-    m_tester->m_cpuPercents.append(0.2);
-    m_tester->m_cpuPercents.append(0.3);
-
-    QPixmap pixmap(100, 100);
-    QPainter painter(&pixmap);
-    m_tester->drawSingleCoreMode(painter);
-}
+    Stub stub;
+    stub.set(ADDR(CPUInfoModel, cpuPercent), stub_cpuPercent);
+
+    struct {
+        int cores;
+        int columns;
+        CPUDetailGrapGrid::DrawMode mode;
+    } cases[] = {
+        {16, 4, CPUDetailGrapGrid::kSimpleMode},
+        {128, 8, CPUDetailGrapGrid::kTextMode},
+        {512, 32, CPUDetailGrapGrid::kHeatmapMode},
+    };
+    const int rounds = 50;
+
+    QPixmap target(m_tester->size() * m_tester->devicePixelRatioF());
+    target.setDevicePixelRatio(m_tester->devicePixelRatioF());
+    for (auto &c : cases) {
+        m_tester->setCores(c.cores, c.columns, c.mode, c.mode == CPUDetailGrapGrid::kSimpleMode ? 10 : 0);
+        // full history, so curves are as long as they get
+        for (int i = 0; i < 31; i++) {
+            g_corePercent = (i * 7) % 100;
+            m_tester->updateStat();
+        }
+        m_tester->render(&target);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < rounds; i++) {
+            g_corePercent = (i * 13) % 100;
+            m_tester->updateStat();
+            m_tester->render(&target);
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+        qInfo() << "paint" << c.cores << "cores:" << elapsed / rounds / 1000 << "us per update";
 
-TEST_F(UT_CPUDetailGrapTableItem, test_drawBackground_01)
-{
-    QPixmap pixmap(100, 100);
-    QPainter painter(&pixmap);
-    QRect rect(0, 0, 10, 10);
-    m_tester->drawBackground(painter, rect);
+        EXPECT_EQ(m_tester->m_cells.size(), c.cores);
+        EXPECT_FALSE(m_tester->m_backPixmap.isNull());
+    }
+    g_corePercent = 50;
 }
 
 
@@ -15,6 +15,10 @@
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
+//Qt
+#include <QCollator>
+#include <QElapsedTimer>
+#include <QStandardItemModel>
 /***************************************STUB begin*********************************************/
 int stub_proclessThan_sortColumn1(){
     return ProcessTableModel::kProcessNameColumn;
@@ -297,3 +301,111 @@ TEST_F(UT_ProcessSortFilterProxyModel, test_lessThan_014)
     delete rindex;
     delete lindex;
 }
+
+// source rows filled like ProcessTableModel::data does for the roles the proxy reads
+static void appendProcessRow(QStandardItemModel *model, int pid, const QString &name, qreal cpu, const QString &user)
+{
+    QList<QStandardItem *> items;
+    for (int column = 0; column < ProcessTableModel::kProcessColumnCount; ++column)
+        items << new QStandardItem();
+    items[ProcessTableModel::kProcessNameColumn]->setData(name, Qt::DisplayRole);
+    items[ProcessTableModel::kProcessNameColumn]->setData(name, Qt::UserRole);
+    items[ProcessTableModel::kProcessCPUColumn]->setData(cpu, Qt::UserRole);
+    items[ProcessTableModel::kProcessUserColumn]->setData(user, Qt::DisplayRole);
+    items[ProcessTableModel::kProcessMemoryColumn]->setData(qulonglong(pid) * 4, Qt::UserRole);
+    items[ProcessTableModel::kProcessPIDColumn]->setData(QString::number(pid), Qt::DisplayRole);
+    items[ProcessTableModel::kProcessPIDColumn]->setData(pid, Qt::UserRole);
+    items[ProcessTableModel::kProcessPIDColumn]->setData(int(kFilterApps), Qt::UserRole + 3);
+    model->appendRow(items);
+}
+
+TEST_F(UT_ProcessSortFilterProxyModel, test_sort_name_20k)
+{
+    const int rows = 20000;
+    QStandardItemModel source(0, ProcessTableModel::kProcessColumnCount);
+    for (int i = 0; i < rows; ++i)
+        appendProcessRow(&source, i + 1, QString("proc-%1").arg((i * 7919) % rows), i % 13, i % 2 ? "root" : "user");
+
+    m_tester->setFilterType(kNoFilter);
+    m_tester->setSourceModel(&source);
+    ASSERT_EQ(m_tester->m_keys.size(), size_t(rows));
+
+    QElapsedTimer timer;
+    timer.start();
+    m_tester->sort(ProcessTableModel::kProcessNameColumn, Qt::AscendingOrder);
+    qint64 elapsed = timer.elapsed();
+    RecordProperty("sort_name_20k_ms", int(elapsed));
+
+    QCollator collator;
+    bool ordered = true;
+    QString prev = m_tester->index(0, ProcessTableModel::kProcessNameColumn).data().toString();
+    for (int row = 1; row < rows && ordered; ++row) {
+        const QString &name = m_tester->index(row, ProcessTableModel::kProcessNameColumn).data().toString();
+        ordered = collator.compare(prev, name) <= 0;
+        prev = name;
+    }
+    EXPECT_TRUE(ordered);
+
+    // keys follow source changes
+    source.item(0, ProcessTableModel::kProcessNameColumn)->setData("aaa", Qt::DisplayRole);
+    EXPECT_EQ(m_tester->index(0, ProcessTableModel::kProcessNameColumn).data().toString(), QString("aaa"));
+    source.removeRows(0, 10);
+    EXPECT_EQ(m_tester->m_keys.size(), size_t(rows - 10));
+
+    m_tester->setSourceModel(nullptr);
+}
+
+// equal speeds are ordered by the total bytes
+TEST_F(UT_ProcessSortFilterProxyModel, test_sort_upload_001)
+{
+    QStandardItemModel source(0, ProcessTableModel::kProcessColumnCount);
+    const qreal speeds[] = {10, 10, 5};
+    const qulonglong totals[] = {300, 100, 900};
+    for (int row = 0; row < 3; ++row) {
+        appendProcessRow(&source, 100 + row, QString("proc-%1").arg(row), 0, "user");
+        for (int column : {int(ProcessTableModel::kProcessUploadColumn), int(ProcessTableModel::kProcessDownloadColumn)}) {
+            source.item(row, column)->setData(speeds[row], Qt::UserRole);
+            source.item(row, column)->setData(totals[row], Qt::UserRole + 1);
+        }
+    }
+    m_tester->setFilterType(kNoFilter);
+    m_tester->setSourceModel(&source);
+
+    for (int column : {int(ProcessTableModel::kProcessUploadColumn), int(ProcessTableModel::kProcessDownloadColumn)}) {
+        m_tester->sort(column, Qt::AscendingOrder);
+        EXPECT_EQ(m_tester->index(0, ProcessTableModel::kProcessPIDColumn).data(Qt::UserRole).toInt(), 102);
+        EXPECT_EQ(m_tester->index(1, ProcessTableModel::kProcessPIDColumn).data(Qt::UserRole).toInt(), 101);
+        EXPECT_EQ(m_tester->index(2, ProcessTableModel::kProcessPIDColumn).data(Qt::UserRole).toInt(), 100);
+    }
+
+    m_tester->setSourceModel(nullptr);
+}
+
+TEST_F(UT_ProcessSortFilterProxyModel, test_filter_search_001)
+{
+    QStandardItemModel source(0, ProcessTableModel::kProcessColumnCount);
+    appendProcessRow(&source, 100, "Firefox", 1, "user");
+    appendProcessRow(&source, 200, "bash", 2, "root");
+    appendProcessRow(&source, 1001, "dde-dock", 3, "user");
+    m_tester->setFilterType(kNoFilter);
+    m_tester->setSourceModel(&source);
+
+    // literal patterns go through the search index
+    m_tester->setSortFilterString("FIRE");
+    EXPECT_EQ(m_tester->rowCount(), 1);
+    m_tester->setSortFilterString("100");
+    EXPECT_EQ(m_tester->rowCount(), 2);
+    m_tester->setSortFilterString("root");
+    EXPECT_EQ(m_tester->rowCount(), 1);
+    // no match across fields
+    m_tester->setSortFilterString("bash200");
+    EXPECT_EQ(m_tester->rowCount(), 0);
+
+    // regular expressions still work
+    m_tester->setSortFilterString("^d.e");
+    EXPECT_EQ(m_tester->rowCount(), 1);
+    m_tester->setSortFilterString("");
+    EXPECT_EQ(m_tester->rowCount(), 3);
+
+    m_tester->setSourceModel(nullptr);
+}
@@ -6,14 +6,20 @@
 //self
 #include "model/process_table_model.h"
 #include "process/process_db.h"
+#include "process/private/process_p.h"
 #include "common/common.h"
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 //Qt
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QSortFilterProxyModel>
 #include <DApplication>
 
+#include <numeric>
+
 static QString m_Sresult;
 /***************************************STUB begin*********************************************/
 QList<pid_t> stub_getPIDList()
@@ -27,6 +33,11 @@ QList<pid_t> stub_getPIDList()
     list.append(6);
     return list;
 }
+static ProcessSnapshotPtr g_snapshot;
+ProcessSnapshotPtr stub_snapshot()
+{
+    return g_snapshot;
+}
 bool stub_process_data_isValid(){
     m_Sresult = "index is valid";
     return true;
@@ -112,6 +123,66 @@ char stub_process_data_state2(){
     return 'T';
 }
 /***************************************STUB end**********************************************/
+
+// pids are spaced out, so born pids can land between existing rows
+static Process fakeProcess(pid_t pid)
+{
+    Process proc(pid);
+    proc.d->valid = true;
+    proc.setCpu(pid % 7);
+    return proc;
+}
+
+// one refresh with churn: 1% died, 1% born in between existing rows plus a run of 10 at the end, 10% cpu changed
+static void churnProcessList(QList<pid_t> &pidlst, QList<Process> &proclst, int round, int &died, int &born)
+{
+    QList<pid_t> pids;
+    QList<Process> procs;
+    died = 0;
+    born = 0;
+    for (int i = 0; i < pidlst.size(); ++i) {
+        if ((i + round) % 100 == 0) {
+            ++died;
+            continue;
+        }
+        pid_t pid = pidlst[i] - 1;
+        if ((i + round) % 100 == 50 && pid > (i > 0 ? pidlst[i - 1] : 0)) {
+            pids << pid;
+            procs << fakeProcess(pid);
+            ++born;
+        }
+        if ((i + round) % 10 == 0)
+            proclst[i].setCpu(proclst[i].cpu() + 1);
+        pids << pidlst[i];
+        procs << proclst[i];
+    }
+    for (int i = 1; i <= 10; ++i) {
+        pids << pidlst.last() + 4 * i;
+        procs << fakeProcess(pidlst.last() + 4 * i);
+    }
+    pidlst = pids;
+    proclst = procs;
+}
+
+// one row showing proc
+static void appendRow(ProcessTableModel *model, const Process &proc)
+{
+    model->m_snapshot = std::make_shared<const ProcessSnapshot>(1, QList<Process> {proc});
+    model->m_procIdList << proc.pid();
+    model->m_snapshotIndexes << 0;
+    model->m_rowValues << ProcessTableModel::rowValues(*model->m_snapshot, 0);
+    model->rebuildRowIndex();
+}
+
+// show every process of proclst, like a refresh with the snapshot of a scan
+static void syncProcessList(ProcessTableModel *model, const QList<Process> &proclst, quint64 version)
+{
+    auto snapshot = std::make_shared<const ProcessSnapshot>(version, proclst);
+    QVector<int> indexes(proclst.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    model->syncProcessList(snapshot, indexes);
+}
+
 class UT_ProcessTableModel: public ::testing::Test
 {
 public:
@@ -154,11 +225,14 @@ TEST_F(UT_ProcessTableModel, test_getProcessState_002)
 
 }
 
-TEST_F(UT_ProcessTableModel, test_getProcess_001)
+TEST_F(UT_ProcessTableModel, test_snapshotIndex_001)
 {
     pid_t pid = getpid();
-    m_tester->getProcess(pid);
+    EXPECT_EQ(m_tester->snapshotIndex(pid), -1);
 
+    appendRow(m_tester, fakeProcess(pid));
+    EXPECT_EQ(m_tester->snapshotIndex(pid), 0);
+    EXPECT_EQ(m_tester->snapshot()->pid(0), pid);
 }
 
 TEST_F(UT_ProcessTableModel, test_getProcess_002)
@@ -190,11 +264,27 @@ TEST_F(UT_ProcessTableModel, test_updateProcessListDelay_003)
     Stub stub;
     stub.set(ADDR(ProcessSet, getPIDList), stub_getPIDList);
     m_tester->m_procIdList.append(1);
-    Process proc;
-    m_tester->m_processList.append(proc);
+    m_tester->m_snapshotIndexes.append(0);
     m_tester->updateProcessListDelay();
 }
 
+// a snapshot already shown is not synced again
+TEST_F(UT_ProcessTableModel, test_updateProcessListDelay_004)
+{
+    Stub stub;
+    stub.set(ADDR(ProcessSet, snapshot), stub_snapshot);
+    g_snapshot = std::make_shared<const ProcessSnapshot>(7, QList<Process> {fakeProcess(4), fakeProcess(8)});
+
+    QSignalSpy updated(m_tester, &ProcessTableModel::modelUpdated);
+    m_tester->updateProcessListDelay();
+    EXPECT_EQ(m_tester->rowCount(), 2);
+    EXPECT_EQ(m_tester->snapshot()->version(), 7u);
+
+    m_tester->updateProcessListDelay();
+    EXPECT_EQ(updated.count(), 1);
+    g_snapshot.reset();
+}
+
 TEST_F(UT_ProcessTableModel, test_rowCount_001)
 {
     m_tester->rowCount();
@@ -368,7 +458,7 @@ TEST_F(UT_ProcessTableModel, test_data_003)
      Process *proc = new Process;
      QModelIndex *index = new QModelIndex();
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -387,7 +477,7 @@ TEST_F(UT_ProcessTableModel, test_data_004)
      Process *proc = new Process;
      QModelIndex *index = new QModelIndex();
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
 
@@ -410,7 +500,7 @@ TEST_F(UT_ProcessTableModel, test_data_005)
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
      Stub b5;
      b5.set(ADDR(Process,state),stub_process_data_state1);
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -431,7 +521,7 @@ TEST_F(UT_ProcessTableModel, test_data_006)
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
      Stub b5;
      b5.set(ADDR(Process,state),stub_process_data_state2);
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -452,7 +542,7 @@ TEST_F(UT_ProcessTableModel, test_data_007)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column2);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -472,7 +562,7 @@ TEST_F(UT_ProcessTableModel, test_data_008)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column3);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -492,7 +582,7 @@ TEST_F(UT_ProcessTableModel, test_data_009)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column4);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -512,7 +602,7 @@ TEST_F(UT_ProcessTableModel, test_data_010)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column5);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -532,7 +622,7 @@ TEST_F(UT_ProcessTableModel, test_data_011)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column6);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -552,7 +642,7 @@ TEST_F(UT_ProcessTableModel, test_data_012)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column7);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -572,7 +662,7 @@ TEST_F(UT_ProcessTableModel, test_data_013)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -592,7 +682,7 @@ TEST_F(UT_ProcessTableModel, test_data_014)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column9);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -612,7 +702,7 @@ TEST_F(UT_ProcessTableModel, test_data_015)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column10);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -632,7 +722,7 @@ TEST_F(UT_ProcessTableModel, test_data_016)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column11);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -652,7 +742,7 @@ TEST_F(UT_ProcessTableModel, test_data_017)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column12);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -672,7 +762,7 @@ TEST_F(UT_ProcessTableModel, test_data_018)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column13);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DisplayRole;
      m_tester->data(*index,role);
      delete proc;
@@ -692,7 +782,7 @@ TEST_F(UT_ProcessTableModel, test_data_019)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::DecorationRole;
      m_tester->data(*index,role);
      delete proc;
@@ -712,7 +802,7 @@ TEST_F(UT_ProcessTableModel, test_data_020)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
      delete proc;
@@ -732,7 +822,7 @@ TEST_F(UT_ProcessTableModel, test_data_021)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column4);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
      delete proc;
@@ -752,7 +842,7 @@ TEST_F(UT_ProcessTableModel, test_data_022)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column5);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
      delete proc;
@@ -772,7 +862,7 @@ TEST_F(UT_ProcessTableModel, test_data_023)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column6);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
 
      delete proc;
@@ -792,7 +882,7 @@ TEST_F(UT_ProcessTableModel, test_data_024)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column2);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -813,7 +903,7 @@ TEST_F(UT_ProcessTableModel, test_data_025)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column7);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -834,7 +924,7 @@ TEST_F(UT_ProcessTableModel, test_data_026)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -855,7 +945,7 @@ TEST_F(UT_ProcessTableModel, test_data_027)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column11);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -876,7 +966,7 @@ TEST_F(UT_ProcessTableModel, test_data_028)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column9);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -897,7 +987,7 @@ TEST_F(UT_ProcessTableModel, test_data_029)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column10);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -918,7 +1008,7 @@ TEST_F(UT_ProcessTableModel, test_data_030)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column12);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole;
      m_tester->data(*index,role);
 
@@ -939,7 +1029,7 @@ TEST_F(UT_ProcessTableModel, test_data_031)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column7);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = (Qt::UserRole + 1);
      m_tester->data(*index,role);
 
@@ -960,7 +1050,7 @@ TEST_F(UT_ProcessTableModel, test_data_032)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = (Qt::UserRole + 1);
      m_tester->data(*index,role);
 
@@ -981,7 +1071,7 @@ TEST_F(UT_ProcessTableModel, test_data_033)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column8);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::TextAlignmentRole;
      QVariant expect = m_tester->data(*index,role);
 
@@ -1003,7 +1093,7 @@ TEST_F(UT_ProcessTableModel, test_data_034)
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
      Stub b5;
      b5.set(ADDR(Process,state),stub_process_data_state1);
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole + 2;
      QVariant expect = m_tester->data(*index,role);
 
@@ -1024,7 +1114,7 @@ TEST_F(UT_ProcessTableModel, test_data_035)
      Stub b4;
      b4.set(ADDR(QModelIndex,column),stub_process_data_column1);
 
-     m_tester->m_processList  << *proc;
+     appendRow(m_tester, *proc);
      int role = Qt::UserRole + 4;
      m_tester->data(*index,role);
 
@@ -1078,10 +1168,10 @@ TEST_F(UT_ProcessTableModel, test_updateProcessState_001)
      pid_t pid = getpid();
      Process proc(pid);
      char state = 'Z';
-     m_tester->m_procIdList << pid;
-     m_tester->m_processList << proc;
+     appendRow(m_tester, proc);
 
      m_tester->updateProcessState(pid,state);
+     EXPECT_EQ(m_tester->getProcessState(pid), state);
 
 }
 
@@ -1090,9 +1180,100 @@ TEST_F(UT_ProcessTableModel, test_updateProcessPriority_001)
      pid_t pid = getpid();
      Process proc(pid);
      int priority = 0;
-     m_tester->m_procIdList << pid;
-     m_tester->m_processList << proc;
+     appendRow(m_tester, proc);
 
      m_tester->updateProcessPriority(pid,priority);
+     EXPECT_EQ(m_tester->getProcessPriorityValue(pid), priority);
+
+}
+
+// refresh cost & emitted signals with a sorting proxy attached, like the process view
+static void benchmarkRefresh(ProcessTableModel *model, int rows)
+{
+    const int rounds = 10;
+
+    QList<pid_t> pidlst;
+    QList<Process> proclst;
+    for (int i = 1; i <= rows; ++i) {
+        pidlst << 4 * i;
+        proclst << fakeProcess(4 * i);
+    }
+
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(model);
+    proxy.setSortRole(Qt::UserRole);
+    proxy.setDynamicSortFilter(true);
+    proxy.sort(ProcessTableModel::kProcessCPUColumn, Qt::DescendingOrder);
+
+    QSignalSpy inserted(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(model, &QAbstractItemModel::dataChanged);
+
+    // first load is one range
+    quint64 version = 1;
+    syncProcessList(model, proclst, version);
+    EXPECT_EQ(inserted.count(), 1);
+    EXPECT_EQ(model->rowCount(), rows);
+
+    qint64 elapsed = 0;
+    QElapsedTimer timer;
+    for (int round = 0; round < rounds; ++round) {
+        int died = 0;
+        int born = 0;
+        churnProcessList(pidlst, proclst, round, died, born);
+        inserted.clear();
+        removed.clear();
+        changed.clear();
+
+        timer.start();
+        syncProcessList(model, proclst, ++version);
+        elapsed += timer.nsecsElapsed();
+
+        // died & born pids are single rows 50 apart, plus one range for the run at the end
+        EXPECT_EQ(removed.count(), died);
+        EXPECT_EQ(inserted.count(), born + 1);
+        ASSERT_EQ(changed.count(), 1);
+        EXPECT_EQ(changed[0][0].toModelIndex().column(), int(ProcessTableModel::kProcessCPUColumn));
+        EXPECT_EQ(changed[0][1].toModelIndex().column(), int(ProcessTableModel::kProcessCPUColumn));
+    }
+
+    EXPECT_EQ(model->m_procIdList, pidlst);
+    EXPECT_EQ(proxy.rowCount(), pidlst.size());
+    for (int row = 0; row < pidlst.size(); row += 97)
+        EXPECT_EQ(model->m_pidRows.value(pidlst[row], -1), row);
+
+    ::testing::Test::RecordProperty(QString("refresh_us_%1").arg(rows).toStdString(), int(elapsed / rounds / 1000));
+}
+
+TEST_F(UT_ProcessTableModel, test_syncProcessList_1k)
+{
+    benchmarkRefresh(m_tester, 1000);
+}
+
+TEST_F(UT_ProcessTableModel, test_syncProcessList_5k)
+{
+    benchmarkRefresh(m_tester, 5000);
+}
+
+TEST_F(UT_ProcessTableModel, test_syncProcessList_20k)
+{
+    benchmarkRefresh(m_tester, 20000);
+}
+
+// rows changed behind the model's back are rebuilt with a reset
+TEST_F(UT_ProcessTableModel, test_syncProcessList_reset_001)
+{
+    QList<Process> proclst {fakeProcess(4), fakeProcess(8), fakeProcess(12)};
+    m_tester->m_procIdList << 16;
+
+    QSignalSpy reset(m_tester, &QAbstractItemModel::modelReset);
+    syncProcessList(m_tester, proclst, 1);
+    EXPECT_EQ(reset.count(), 1);
+    EXPECT_EQ(m_tester->rowCount(), 3);
+    EXPECT_EQ(m_tester->m_pidRows.value(12, -1), 2);
 
+    // nothing changed, nothing emitted
+    QSignalSpy changed(m_tester, &QAbstractItemModel::dataChanged);
+    syncProcessList(m_tester, proclst, 2);
+    EXPECT_EQ(changed.count(), 0);
 }
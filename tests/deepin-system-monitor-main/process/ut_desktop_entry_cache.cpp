@@ -10,10 +10,20 @@
 #include "stub.h"
 #include <gtest/gtest.h>
 //Qt
+#include <QDir>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 using namespace core::process;
 
+static int s_createEntryCount = 0;
+
+static DesktopEntry stub_createEntry(const QFileInfo &)
+{
+    ++s_createEntryCount;
+    return std::make_shared<struct desktop_entry_t>();
+}
+
 class UT_DesktopEntryCache : public ::testing::Test
 {
 public:
@@ -22,7 +32,7 @@ public:
 public:
     virtual void SetUp()
     {
-        m_tester = new DesktopEntryCache();
+        m_tester = new DesktopEntryCache(m_dir.filePath("index"));
     }
 
     virtual void TearDown()
@@ -34,6 +44,7 @@ public:
     }
 
 protected:
+    QTemporaryDir m_dir;
     DesktopEntryCache *m_tester;
 };
 
@@ -175,3 +186,64 @@ TEST_F(UT_DesktopEntryCache, test_updateCache_001)
     EXPECT_GT(m_tester->m_cache.size(), 0);
 
 }
+
+// parsed entries are read back from the index, only new files are parsed
+TEST_F(UT_DesktopEntryCache, test_index_001)
+{
+    QByteArray xdgDataDirs = qgetenv("XDG_DATA_DIRS");
+    QDir(m_dir.path()).mkpath("share/applications");
+    qputenv("XDG_DATA_DIRS", m_dir.filePath("share").toLocal8Bit());
+
+    QFile file(m_dir.filePath("share/applications/test1.desktop"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("[Desktop Entry]\nName=test1\nType=Application\nExec=/usr/bin/test1\nIcon=test1-icon\n");
+    file.close();
+
+    m_tester->update();
+    ASSERT_TRUE(m_tester->contains("test1.desktop"));
+    EXPECT_EQ(m_tester->entry("TEST1")->icon, "test1-icon");
+
+    Stub stub;
+    stub.set(ADDR(DesktopEntryCacheUpdater, createEntry), stub_createEntry);
+    s_createEntryCount = 0;
+
+    DesktopEntryCache cache(m_dir.filePath("index"));
+    cache.update();
+    EXPECT_EQ(s_createEntryCount, 0);
+    EXPECT_EQ(cache.entry("test1")->icon, "test1-icon");
+
+    QFile other(m_dir.filePath("share/applications/test2.desktop"));
+    ASSERT_TRUE(other.open(QIODevice::WriteOnly | QIODevice::Text));
+    other.write("[Desktop Entry]\nName=test2\n");
+    other.close();
+    cache.update();
+    EXPECT_EQ(s_createEntryCount, 1);
+    EXPECT_TRUE(cache.contains("test2.desktop"));
+
+    qputenv("XDG_DATA_DIRS", xdgDataDirs);
+}
+
+// application directory created after startup is watched through its parent
+TEST_F(UT_DesktopEntryCache, test_missingDir_001)
+{
+    QByteArray xdgDataDirs = qgetenv("XDG_DATA_DIRS");
+    qputenv("XDG_DATA_DIRS", m_dir.filePath("share").toLocal8Bit());
+
+    m_tester->update();
+    EXPECT_FALSE(m_tester->contains("test1.desktop"));
+    EXPECT_EQ(m_tester->m_watches.size(), 0);
+    EXPECT_EQ(m_tester->m_parentWatches.size(), 1);
+
+    QDir(m_dir.path()).mkpath("share/applications");
+    QFile file(m_dir.filePath("share/applications/test1.desktop"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("[Desktop Entry]\nName=test1\nType=Application\nExec=/usr/bin/test1\n");
+    file.close();
+
+    m_tester->update();
+    EXPECT_TRUE(m_tester->contains("test1.desktop"));
+    EXPECT_EQ(m_tester->m_watches.size(), 1);
+    EXPECT_TRUE(m_tester->m_parentWatches.isEmpty());
+
+    qputenv("XDG_DATA_DIRS", xdgDataDirs);
+}
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/pid_index.h"
+#include "process/process_set.h"
+
+//qt
+#include <QTemporaryDir>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QDebug>
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+using namespace core::process;
+
+/***************************************STUB begin*********************************************/
+
+/***************************************STUB end**********************************************/
+
+class UT_PidIndex : public ::testing::Test
+{
+public:
+    UT_PidIndex() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new PidIndex();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    PidIndex *m_tester;
+};
+
+TEST_F(UT_PidIndex, initTest)
+{
+    EXPECT_EQ(m_tester->size(), 0u);
+}
+
+TEST_F(UT_PidIndex, test_mark_001)
+{
+    m_tester->beginScan();
+    EXPECT_TRUE(m_tester->mark(100));
+    EXPECT_FALSE(m_tester->mark(100));
+    EXPECT_FALSE(m_tester->mark(0));
+    m_tester->endScan();
+
+    EXPECT_TRUE(m_tester->contains(100));
+    EXPECT_EQ(m_tester->size(), 1u);
+}
+
+TEST_F(UT_PidIndex, test_endScan_001)
+{
+    m_tester->beginScan();
+    for (pid_t pid = 10; pid < 5000; ++pid)
+        m_tester->mark(pid);
+    m_tester->endScan();
+
+    // every odd pid died, a new range was born
+    QList<pid_t> born;
+    QList<pid_t> died;
+    m_tester->beginScan();
+    for (pid_t pid = 10; pid < 5000; pid += 2) {
+        if (m_tester->mark(pid))
+            born << pid;
+    }
+    for (pid_t pid = 100000; pid < 100100; ++pid) {
+        if (m_tester->mark(pid))
+            born << pid;
+    }
+    m_tester->endScan(&died);
+
+    EXPECT_EQ(born.size(), 100);
+    EXPECT_EQ(died.size(), 2495);
+    for (pid_t pid : died)
+        EXPECT_TRUE(pid % 2 == 1);
+    for (pid_t pid = 10; pid < 5000; ++pid)
+        EXPECT_EQ(m_tester->contains(pid), pid % 2 == 0);
+    EXPECT_EQ(m_tester->size(), size_t(2495 + 100));
+}
+
+static void makeProcTree(const QString &root, int count)
+{
+    QDir dir(root);
+    dir.mkdir("self");
+    dir.mkdir("sys");
+    for (int i = 0; i < count; ++i)
+        dir.mkdir(QString::number(100 + i));
+}
+
+// scan a synthetic /proc tree and report scan time & table allocations
+TEST_F(UT_PidIndex, test_benchmark_scan_001)
+{
+    const int counts[] = {1000, 10000, 50000};
+    for (int count : counts) {
+        QTemporaryDir tmp;
+        ASSERT_TRUE(tmp.isValid());
+        makeProcTree(tmp.path(), count);
+        const QByteArray path = tmp.path().toLocal8Bit();
+
+        PidIndex index;
+        QList<pid_t> died;
+        QElapsedTimer timer;
+        qint64 elapsed[2] {};
+        for (int round = 0; round < 2; ++round) {
+            timer.start();
+            index.beginScan();
+            ProcessSet::Iterator iter(path.constData());
+            while (iter.hasNext())
+                index.mark(iter.nextPid());
+            index.endScan(&died);
+            elapsed[round] = timer.nsecsElapsed();
+        }
+        size_t allocations = index.allocations();
+
+        // steady state scan must not touch the allocator
+        index.beginScan();
+        ProcessSet::Iterator iter(path.constData());
+        while (iter.hasNext())
+            index.mark(iter.nextPid());
+        index.endScan(&died);
+
+        EXPECT_EQ(index.size(), size_t(count));
+        EXPECT_TRUE(died.isEmpty());
+        EXPECT_EQ(index.allocations(), allocations);
+
+        qInfo() << "pid scan" << count << "pids:"
+                << "cold" << elapsed[0] / 1000 << "us,"
+                << "warm" << elapsed[1] / 1000 << "us,"
+                << "table allocations" << allocations;
+    }
+}
@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/proc_reader.h"
+#include "process/process.h"
+#include "process/private/process_p.h"
+
+//qt
+#include <QElapsedTimer>
+#include <QDebug>
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace core::process;
+
+/***************************************STUB begin*********************************************/
+
+// heap allocations of the calling thread while counting, sanitizer builds bring their own allocator
+#if defined(CMAKE_SAFETYTEST_ARG_OFF)
+#define COUNT_ALLOCATIONS
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+static thread_local bool g_countAllocs = false;
+static thread_local long g_allocs = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    if (g_countAllocs)
+        ++g_allocs;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size)
+{
+    if (g_countAllocs)
+        ++g_allocs;
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    if (g_countAllocs)
+        ++g_allocs;
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+/***************************************STUB end**********************************************/
+
+class UT_ProcReader : public ::testing::Test
+{
+public:
+    UT_ProcReader() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcReader();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcReader *m_tester;
+};
+
+TEST_F(UT_ProcReader, test_scan_001)
+{
+    const char buf[] = "  123 -45 abc 6789";
+    const char *end = buf + strlen(buf);
+
+    unsigned long long u = 0;
+    long long s = 0;
+    const char *p = scan::parseUnsigned(buf, end, &u);
+    EXPECT_EQ(u, 123ull);
+    p = scan::parseSigned(p, end, &s);
+    EXPECT_EQ(s, -45ll);
+    EXPECT_EQ(scan::parseUnsigned(p, end, &u), nullptr);
+    p = scan::skipField(p, end);
+    p = scan::parseUnsigned(p, end, &u);
+    EXPECT_EQ(u, 6789ull);
+    EXPECT_EQ(p, end);
+    EXPECT_EQ(scan::skipField(p, end), nullptr);
+}
+
+TEST_F(UT_ProcReader, test_findKey_001)
+{
+    const char buf[] = "Name:\tbash\nPPid:\t1\nTracerPid:\t0\nUid:\t1000\t1000\t1000\t1000\n";
+    const char *end = buf + strlen(buf);
+
+    pid_t ppid = -1;
+    const char *p = scan::findKey(buf, end, "PPid:", 5);
+    ASSERT_NE(p, nullptr);
+    scan::parseSigned(p, end, &ppid);
+    EXPECT_EQ(ppid, 1);
+
+    // key must match at the start of a line only
+    EXPECT_EQ(scan::findKey(buf, end, "Pid:", 4), nullptr);
+    EXPECT_EQ(scan::findKey(buf, end, "Gid:", 4), nullptr);
+}
+
+TEST_F(UT_ProcReader, test_read_001)
+{
+    int cached = ProcReader::cachedDirCount();
+
+    size_t len = 0;
+    const char *buf = m_tester->read(getpid(), "stat", &len);
+    ASSERT_NE(buf, nullptr);
+    EXPECT_GT(len, 0u);
+    EXPECT_EQ(buf[len], '\0');
+
+    pid_t pid = 0;
+    scan::parseSigned(buf, buf + len, &pid);
+    EXPECT_EQ(pid, getpid());
+    EXPECT_EQ(ProcReader::cachedDirCount(), cached + 1);
+
+    m_tester->close();
+    EXPECT_EQ(ProcReader::cachedDirCount(), cached);
+}
+
+// the table never holds more fds than its budget, evicted readers open their dir again
+TEST_F(UT_ProcReader, test_read_lru_001)
+{
+    const int maxDirs = ProcReader::maxCachedDirs();
+    std::vector<std::unique_ptr<ProcReader>> readers;
+    size_t len = 0;
+    for (int i = 0; i <= maxDirs; ++i) {
+        readers.emplace_back(new ProcReader());
+        ASSERT_NE(readers.back()->read(getpid(), "stat", &len), nullptr);
+    }
+    EXPECT_EQ(ProcReader::cachedDirCount(), maxDirs);
+
+    EXPECT_NE(readers.front()->read(getpid(), "statm", &len), nullptr);
+    EXPECT_EQ(ProcReader::cachedDirCount(), maxDirs);
+
+    readers.clear();
+    EXPECT_LT(ProcReader::cachedDirCount(), maxDirs);
+}
+
+TEST_F(UT_ProcReader, test_read_002)
+{
+    size_t len = 0;
+    EXPECT_EQ(m_tester->read(getpid(), "no-such-file", &len), nullptr);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_EQ(len, 0u);
+}
+
+// the way process stats were read before ProcReader: path formatting, stdio & sscanf
+static bool legacyReadStat(pid_t pid)
+{
+    char path[128];
+    char buf[4096];
+    sprintf(path, "/proc/%d/stat", pid);
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return false;
+    size_t n = fread(buf, 1, sizeof(buf) - 1, fp);
+    fclose(fp);
+    buf[n] = '\0';
+
+    const char *pos = strrchr(buf, ')');
+    if (!pos)
+        return false;
+    char state;
+    int ppid, pgid;
+    unsigned long long utime, stime;
+    return sscanf(pos + 2, "%c %d %d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+                  &state, &ppid, &pgid, &utime, &stime) == 5;
+}
+
+static bool legacyReadStatm(pid_t pid)
+{
+    char path[128];
+    sprintf(path, "/proc/%d/statm", pid);
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return false;
+    unsigned long long vmsize, rss, shm;
+    int rc = fscanf(fp, "%llu %llu %llu", &vmsize, &rss, &shm);
+    fclose(fp);
+    return rc == 3;
+}
+
+// cmdline only changes on exec, an unchanged one is not parsed again
+TEST_F(UT_ProcReader, test_readCmdline_001)
+{
+    Process proc(getpid());
+    ASSERT_TRUE(proc.readCmdline());
+    ASSERT_FALSE(proc.cmdline().isEmpty());
+    const char *first = proc.d->cmdline.constFirst().constData();
+    int nargs = proc.cmdline().size();
+
+    EXPECT_TRUE(proc.readCmdline());
+    EXPECT_EQ(proc.cmdline().size(), nargs);
+    EXPECT_EQ(proc.d->cmdline.constFirst().constData(), first);
+}
+
+#ifdef COUNT_ALLOCATIONS
+// heap allocations per process per tick, old & new readers
+TEST_F(UT_ProcReader, test_allocations_001)
+{
+    const int rounds = 100;
+    Process proc(getpid());
+    // first read opens the dir & parses the name and arguments
+    proc.readStat();
+    proc.readCmdline();
+
+    g_allocs = 0;
+    g_countAllocs = true;
+    for (int i = 0; i < rounds; ++i) {
+        legacyReadStat(getpid());
+        legacyReadStatm(getpid());
+    }
+    g_countAllocs = false;
+    long legacy = g_allocs;
+
+    g_allocs = 0;
+    g_countAllocs = true;
+    for (int i = 0; i < rounds; ++i) {
+        proc.readStat();
+        proc.readStatm();
+        proc.readSchedStat();
+        proc.readIO();
+        proc.readCmdline();
+    }
+    g_countAllocs = false;
+    long current = g_allocs;
+
+    qInfo() << "heap allocations per process:"
+            << "legacy stat+statm" << qreal(legacy) / rounds << ","
+            << "ProcReader stat+statm+schedstat+io+cmdline" << qreal(current) / rounds;
+    EXPECT_EQ(current, 0);
+}
+#endif
+
+// compare per-process sampling cost of the old & new readers
+TEST_F(UT_ProcReader, test_benchmark_read_001)
+{
+    const int rounds = 2000;
+    Process proc(getpid());
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; ++i) {
+        legacyReadStat(getpid());
+        legacyReadStatm(getpid());
+    }
+    qint64 legacy = timer.nsecsElapsed();
+
+    timer.start();
+    for (int i = 0; i < rounds; ++i) {
+        EXPECT_TRUE(proc.readStat());
+        EXPECT_TRUE(proc.readStatm());
+    }
+    qint64 current = timer.nsecsElapsed();
+
+    qInfo() << "stat+statm per process:"
+            << "legacy" << legacy / rounds << "ns,"
+            << "ProcReader" << current / rounds << "ns";
+}
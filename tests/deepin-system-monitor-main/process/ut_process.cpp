@@ -14,6 +14,7 @@
 #include <QIcon>
 #include <QApplication>
 //system
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -21,40 +22,22 @@ using namespace core::process;
 using namespace common::alloc;
 static QString m_Sresult;
 /***************************************STUB begin*********************************************/
-int stub_readStat_open1()
-{
-    m_Sresult = "open";
-    return 1;
-}
 int stub_readStat_open2()
 {
     m_Sresult = "open failed";
     return -1;
 }
-ssize_t stub_readStat_read1()
-{
-    m_Sresult = "read";
-    return 1;
-}
-int stub_readStat_close()
-{
-    m_Sresult = "close";
-    return 1;
-}
-ssize_t stub_readStat_read2()
+int stub_readProcFile_openat()
 {
-    m_Sresult = "read failed";
+    m_Sresult = "openat failed";
+    errno = EACCES;
     return -1;
 }
-FILE *stub_readCmdline_fopen()
+ssize_t stub_readProcFile_pread()
 {
-    m_Sresult = "fopen failed";
-    return nullptr;
-}
-uDir *stub_readSockInodes_opendir()
-{
-    m_Sresult = "diropen failed";
-    return nullptr;
+    m_Sresult = "pread failed";
+    errno = EIO;
+    return -1;
 }
 /***************************************STUB end**********************************************/
 class UT_Process : public ::testing::Test
@@ -149,7 +132,7 @@ TEST_F(UT_Process, test_cpu_001)
         }
     };
 
-    auto *sample = m_tester->d->cpuUsageSample->recentSample();
+    auto *sample = m_tester->d->cpuUsageSample.recentSample();
     if (sample)
         EXPECT_EQ(cpu, sample->data);
     else
@@ -252,7 +235,7 @@ TEST_F(UT_Process, test_groupName_001)
 TEST_F(UT_Process, test_readBps_001)
 {
     qreal readBps = m_tester->readBps();
-    auto *sample = m_tester->d->diskIOSpeedSample->recentSample();
+    auto *sample = m_tester->d->diskIOSpeedSample.recentSample();
     if (sample)
         EXPECT_EQ(readBps, sample->data.inBps);
     else
@@ -263,7 +246,7 @@ TEST_F(UT_Process, test_readBps_001)
 TEST_F(UT_Process, test_writeBps_001)
 {
     qreal writeBps = m_tester->writeBps();
-    auto *sample = m_tester->d->diskIOSpeedSample->recentSample();
+    auto *sample = m_tester->d->diskIOSpeedSample.recentSample();
     if (sample)
         EXPECT_EQ(writeBps, sample->data.outBps);
     else
@@ -279,7 +262,7 @@ TEST_F(UT_Process, test_cancelledWriteBytes_001)
 TEST_F(UT_Process, test_recvBps_001)
 {
     qreal recvBps = m_tester->recvBps();
-    auto *sample = m_tester->d->networkBandwidthSample->recentSample();
+    auto *sample = m_tester->d->networkBandwidthSample.recentSample();
     if (sample)
         EXPECT_EQ(recvBps, sample->data.inBps);
     else
@@ -289,7 +272,7 @@ TEST_F(UT_Process, test_recvBps_001)
 TEST_F(UT_Process, test_sentBps_001)
 {
     qreal sentBps = m_tester->sentBps();
-    auto *sample = m_tester->d->networkBandwidthSample->recentSample();
+    auto *sample = m_tester->d->networkBandwidthSample.recentSample();
     if (sample)
         EXPECT_EQ(sentBps, sample->data.outBps);
     else
@@ -299,7 +282,7 @@ TEST_F(UT_Process, test_sentBps_001)
 TEST_F(UT_Process, test_recvBytes_001)
 {
     qreal recvBytes = m_tester->recvBytes();
-    auto *sample = m_tester->d->networkIOSample->recentSample();
+    auto *sample = m_tester->d->networkIOSample.recentSample();
     if (sample)
         EXPECT_EQ(recvBytes, sample->data.inBytes);
     else
@@ -309,7 +292,7 @@ TEST_F(UT_Process, test_recvBytes_001)
 TEST_F(UT_Process, test_sentBytes_001)
 {
     qreal sentBytes = m_tester->sentBytes();
-    auto *sample = m_tester->d->networkIOSample->recentSample();
+    auto *sample = m_tester->d->networkIOSample.recentSample();
     if (sample)
         EXPECT_EQ(sentBytes, sample->data.outBytes);
     else
@@ -438,63 +421,62 @@ TEST_F(UT_Process, test_getProcessPriorityStub_007)
 
 TEST_F(UT_Process, test_readStat_001)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(open, stub_readStat_open1);
-    Stub b2;
-    b2.set(read, stub_readStat_read1);
-    Stub b3;
-    b3.set(close, stub_readStat_close);
-    m_tester->readStat();
+    b1.set(openat, stub_readProcFile_openat);
+    EXPECT_FALSE(m_tester->readStat());
 
+    EXPECT_TRUE(m_Sresult == "openat failed");
 }
 
 TEST_F(UT_Process, test_readStat_002)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
     b1.set(open, stub_readStat_open2);
-    m_tester->readStat();
+    EXPECT_FALSE(m_tester->readStat());
 
     EXPECT_TRUE(m_Sresult == "open failed");
 }
 
 TEST_F(UT_Process, test_readStat_003)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(open, stub_readStat_open1);
-    Stub b2;
-    b2.set(read, stub_readStat_read2);
-    Stub b3;
-    b3.set(close, stub_readStat_close);
-    m_tester->readStat();
+    b1.set(pread, stub_readProcFile_pread);
+    EXPECT_FALSE(m_tester->readStat());
 
-//    EXPECT_TRUE(m_Sresult=="close");
+    EXPECT_TRUE(m_Sresult == "pread failed");
 }
 
 TEST_F(UT_Process, test_readStat_004)
 {
     pid_t pid = getpid();
     m_tester->d->pid = pid;
-    m_tester->readStat();
+    EXPECT_TRUE(m_tester->readStat());
 
-//    EXPECT_TRUE(m_Sresult=="close");
+    EXPECT_EQ(m_tester->ppid(), getppid());
+    EXPECT_FALSE(m_tester->name().isEmpty());
+    EXPECT_TRUE(m_tester->state() != '\0');
 }
 
 TEST_F(UT_Process, test_readCmdline_001)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(fopen, stub_readCmdline_fopen);
-    m_tester->readCmdline();
+    b1.set(openat, stub_readProcFile_openat);
+    EXPECT_FALSE(m_tester->readCmdline());
 
-    EXPECT_TRUE(m_Sresult == "fopen failed");
+    EXPECT_TRUE(m_Sresult == "openat failed");
 }
 
 TEST_F(UT_Process, test_readCmdline_002)
 {
     pid_t pid = getpid();
     m_tester->d->pid = pid;
-    m_tester->readCmdline();
+    EXPECT_TRUE(m_tester->readCmdline());
 
-    EXPECT_TRUE(m_Sresult == "fopen failed");
+    EXPECT_FALSE(m_tester->cmdline().isEmpty());
 }
 
 TEST_F(UT_Process, test_readEnviron_001)
@@ -517,19 +499,17 @@ TEST_F(UT_Process, test_readEnviron_002)
 
 TEST_F(UT_Process, test_readSchedStat_001)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(open, stub_readStat_open1);
-    Stub b2;
-    b2.set(read, stub_readStat_read1);
-    Stub b3;
-    b3.set(close, stub_readStat_close);
+    b1.set(openat, stub_readProcFile_openat);
     m_tester->readSchedStat();
 
-//    EXPECT_TRUE(m_Sresult=="close");
+    EXPECT_TRUE(m_Sresult == "openat failed");
 }
 
 TEST_F(UT_Process, test_readSchedStat_002)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
     b1.set(open, stub_readStat_open2);
     m_tester->readSchedStat();
@@ -539,15 +519,12 @@ TEST_F(UT_Process, test_readSchedStat_002)
 
 TEST_F(UT_Process, test_readSchedStat_003)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(open, stub_readStat_open1);
-    Stub b2;
-    b2.set(read, stub_readStat_read2);
-    Stub b3;
-    b3.set(close, stub_readStat_close);
+    b1.set(pread, stub_readProcFile_pread);
     m_tester->readSchedStat();
 
-//    EXPECT_TRUE(m_Sresult=="close");
+    EXPECT_TRUE(m_Sresult == "pread failed");
 }
 
 TEST_F(UT_Process, test_readSchedStat_004)
@@ -555,79 +532,75 @@ TEST_F(UT_Process, test_readSchedStat_004)
     pid_t pid = getpid();
     m_tester->d->pid = pid;
     m_tester->readSchedStat();
-
-//    EXPECT_TRUE(m_Sresult=="close");
 }
 
 TEST_F(UT_Process, test_readStatus_001)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(fopen, stub_readCmdline_fopen);
-    m_tester->readStatus();
+    b1.set(openat, stub_readProcFile_openat);
+    EXPECT_FALSE(m_tester->readStatus());
 
-    EXPECT_TRUE(m_Sresult == "fopen failed");
+    EXPECT_TRUE(m_Sresult == "openat failed");
 }
 
 TEST_F(UT_Process, test_readStatus_002)
 {
     pid_t pid = getpid();
     m_tester->d->pid = pid;
-    m_tester->readStatus();
+    EXPECT_TRUE(m_tester->readStatus());
 
-    EXPECT_TRUE(m_Sresult == "fopen failed");
+    EXPECT_EQ(m_tester->uid(), getuid());
+    EXPECT_EQ(m_tester->gid(), getgid());
 }
 
 TEST_F(UT_Process, test_readStatm_001)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(open, stub_readStat_open1);
-    Stub b2;
-    b2.set(read, stub_readStat_read1);
-    Stub b3;
-    b3.set(close, stub_readStat_close);
-    m_tester->readStatm();
+    b1.set(openat, stub_readProcFile_openat);
+    EXPECT_FALSE(m_tester->readStatm());
 
-//    EXPECT_TRUE(m_Sresult=="close");
+    EXPECT_TRUE(m_Sresult == "openat failed");
 }
 
 TEST_F(UT_Process, test_readStatm_002)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
     b1.set(open, stub_readStat_open2);
-    m_tester->readStatm();
+    EXPECT_FALSE(m_tester->readStatm());
 
     EXPECT_TRUE(m_Sresult == "open failed");
 }
 
 TEST_F(UT_Process, test_readStatm_003)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(open, stub_readStat_open1);
-    Stub b2;
-    b2.set(read, stub_readStat_read2);
-    Stub b3;
-    b3.set(close, stub_readStat_close);
-    m_tester->readStatm();
+    b1.set(pread, stub_readProcFile_pread);
+    EXPECT_FALSE(m_tester->readStatm());
 
-//    EXPECT_TRUE(m_Sresult=="close");
+    EXPECT_TRUE(m_Sresult == "pread failed");
 }
 
 TEST_F(UT_Process, test_readStatm_004)
 {
     pid_t pid = getpid();
     m_tester->d->pid = pid;
-    m_tester->readStatm();
+    EXPECT_TRUE(m_tester->readStatm());
 
-//    EXPECT_TRUE(m_Sresult=="close");
+    EXPECT_GT(m_tester->vtrmemory(), 0u);
 }
 
 TEST_F(UT_Process, test_readIO_001)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(fopen, stub_readCmdline_fopen);
+    b1.set(openat, stub_readProcFile_openat);
     m_tester->readIO();
 
-    EXPECT_TRUE(m_Sresult == "fopen failed");
+    EXPECT_TRUE(m_Sresult == "openat failed");
 }
 
 TEST_F(UT_Process, test_readIO_002)
@@ -636,17 +609,16 @@ TEST_F(UT_Process, test_readIO_002)
     pid_t pid = getpid();
     m_tester->d->pid = pid;
     m_tester->readIO();
-
-    EXPECT_TRUE(m_Sresult == "fopen failed");
 }
 
 TEST_F(UT_Process, test_readSockInodes_001)
 {
+    m_tester->d->pid = getpid();
     Stub b1;
-    b1.set(opendir, stub_readSockInodes_opendir);
+    b1.set(openat, stub_readProcFile_openat);
     m_tester->readSockInodes();
 
-    EXPECT_TRUE(m_Sresult == "diropen failed");
+    EXPECT_TRUE(m_Sresult == "openat failed");
 }
 
 TEST_F(UT_Process, test_readSockInodes_002)
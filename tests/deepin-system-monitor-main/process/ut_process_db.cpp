@@ -40,7 +40,7 @@ void stub_killProcess_sendSignalToProcess(){
     return;
 }
 
-void stub_update_updateCache(){
+void stub_update_desktopEntryCache(){
     return ;
 }
 
@@ -174,7 +174,7 @@ TEST_F(UT_ProcessDB, test_killProcess_001)
 TEST_F(UT_ProcessDB, test_update_001)
 {
     Stub b1;
-    b1.set(ADDR(DesktopEntryCache,updateCache), stub_update_updateCache);
+    b1.set(ADDR(DesktopEntryCache,update), stub_update_desktopEntryCache);
     Stub b2;
     b1.set(ADDR(WMWindowList,updateWindowListCache), stub_update_updateWindowListCache);
     Stub b3;
@@ -5,6 +5,7 @@
 
 //self
 #include "process/process_icon.h"
+#include "process/process_icon_cache.h"
 #include "process/private/process_p.h"
 #include "process/process.h"
 #include "process/desktop_entry_cache.h"
@@ -29,6 +30,20 @@ bool stub_str_isEmpty(){
 bool stub_getIcon_isTrayApp(){
     return true;
 }
+
+static bool g_windowIconPending = true;
+QImage stub_getWindowIcon(void *, pid_t, quint64 *key, bool *pending)
+{
+    if (pending)
+        *pending = g_windowIconPending;
+    if (g_windowIconPending)
+        return QImage();
+    if (key)
+        *key = 1;
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    return image;
+}
 /***************************************STUB end**********************************************/
 class UT_ProcessIcon : public ::testing::Test
 {
@@ -65,6 +80,37 @@ TEST_F(UT_ProcessIcon, test_refreashProcessIcon_001)
     delete proc;
 }
 
+TEST_F(UT_ProcessIcon, test_refreashPendingIcon_001)
+{
+    const pid_t pid = 999999;
+    Process proc(pid);
+    proc.d->name = "pending";
+    proc.d->cmdline = QByteArrayList {"/usr/bin/pending"};
+    ProcessIconCache::instance()->removeProcessIcon(pid);
+
+    Stub b;
+    b.set(ADDR(WMWindowList, isGuiApp), stub_getIcon_isTrayApp);
+    b.set(ADDR(WMWindowList, getWindowIcon), stub_getWindowIcon);
+
+    // window icon requested, default icon shown meanwhile
+    g_windowIconPending = true;
+    m_tester->refreashProcessIcon(&proc);
+    auto *pendingData = m_tester->m_data.get();
+    m_tester->refreashPendingIcon(&proc);
+    EXPECT_NE(m_tester->m_data.get(), pendingData);
+    pendingData = m_tester->m_data.get();
+
+    // icon received, looked up once more then kept
+    g_windowIconPending = false;
+    m_tester->refreashPendingIcon(&proc);
+    auto *iconData = m_tester->m_data.get();
+    EXPECT_NE(iconData, pendingData);
+    m_tester->refreashPendingIcon(&proc);
+    EXPECT_EQ(m_tester->m_data.get(), iconData);
+
+    ProcessIconCache::instance()->removeProcessIcon(pid);
+}
+
 TEST_F(UT_ProcessIcon, test_icon_001)
 {
     m_tester->icon();
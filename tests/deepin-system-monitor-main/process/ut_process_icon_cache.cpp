@@ -58,7 +58,28 @@ TEST_F(UT_ProcessIconCache, test_getProcessIcon_001)
 TEST_F(UT_ProcessIconCache, test_addProcessIcon_001)
 {
     pid_t pid =1000;
-    ProcessIcon *icon = new ProcessIcon();
-    m_tester->addProcessIcon(pid,icon);
+    m_tester->addProcessIcon(pid, {});
+    EXPECT_TRUE(m_tester->contains(pid));
 
+    m_tester->removeProcessIcon(pid);
+    EXPECT_FALSE(m_tester->contains(pid));
+}
+
+// icons are shared by key & budgeted by bytes
+TEST_F(UT_ProcessIconCache, test_insertIcon_001)
+{
+    QPixmap pixmap(16, 16);
+    pixmap.fill(Qt::red);
+    QIcon icon(pixmap);
+    m_tester->setMaxCost(1024);
+
+    m_tester->insertIcon("window:1", icon, 16 * 16 * 4);
+    QIcon found;
+    EXPECT_TRUE(m_tester->findIcon("window:1", &found));
+    EXPECT_EQ(found.cacheKey(), icon.cacheKey());
+
+    // over budget, oldest icon goes
+    m_tester->insertIcon("window:2", icon, 16 * 16 * 4);
+    EXPECT_FALSE(m_tester->findIcon("window:1", &found));
+    EXPECT_TRUE(m_tester->findIcon("window:2", &found));
 }
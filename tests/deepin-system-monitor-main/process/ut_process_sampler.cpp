@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_sampler.h"
+#include "process/process_set.h"
+#include "process/private/process_p.h"
+
+//qt
+#include <QDir>
+#include <QElapsedTimer>
+#include <QDebug>
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+using namespace core::process;
+
+/***************************************STUB begin*********************************************/
+static QList<pid_t> s_mergeOrder;
+
+void stub_mergeProcessVariableInfo(void *obj, const ProcessSampleContext &)
+{
+    s_mergeOrder << static_cast<Process *>(obj)->d->pid;
+}
+/***************************************STUB end**********************************************/
+
+class UT_ProcessSampler : public ::testing::Test
+{
+public:
+    UT_ProcessSampler() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new ProcessSampler(4);
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    ProcessSampler *m_tester;
+};
+
+TEST_F(UT_ProcessSampler, initTest)
+{
+    EXPECT_EQ(m_tester->threadCount(), 4);
+}
+
+TEST_F(UT_ProcessSampler, test_forEach_001)
+{
+    const int count = 10000;
+    QVector<int> hits(count, 0);
+    int *data = hits.data();
+    m_tester->setParallel(true);
+    m_tester->forEach(count, [data](int i) {
+        ++data[i];
+    });
+
+    for (int i = 0; i < count; ++i)
+        EXPECT_EQ(hits[i], 1);
+}
+
+// real /proc reads of the live process list, serial & parallel sampling must agree
+TEST_F(UT_ProcessSampler, test_sample_001)
+{
+    // name & app type refresh need the window list, only record the merge order
+    Stub b;
+    b.set(ADDR(Process, mergeProcessVariableInfo), stub_mergeProcessVariableInfo);
+
+    ProcessSet procSet;
+    ProcessSampleContext ctx {};
+    ctx.uptime = {1234, 5678};
+    ctx.cpuUsageTotalDelta = 100;
+    ctx.procset = &procSet;
+
+    // live pids, then this process many times over so every worker reads the same files
+    QList<pid_t> pids;
+    const QStringList &entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        bool ok = false;
+        pid_t pid = entry.toInt(&ok);
+        if (ok)
+            pids << pid;
+    }
+    for (int i = 0; i < 256; ++i)
+        pids << getpid();
+
+    QVector<Process> serial;
+    QVector<Process> parallel;
+    for (pid_t pid : pids) {
+        serial << Process(pid);
+        parallel << Process(pid);
+    }
+
+    s_mergeOrder.clear();
+    m_tester->setParallel(false);
+    m_tester->sample(serial, ctx);
+    QList<pid_t> serialOrder = s_mergeOrder;
+
+    s_mergeOrder.clear();
+    m_tester->setParallel(true);
+    m_tester->sample(parallel, ctx);
+    QList<pid_t> parallelOrder = s_mergeOrder;
+
+    EXPECT_EQ(serialOrder, pids);
+    EXPECT_EQ(parallelOrder, pids);
+    ASSERT_EQ(serial.size(), parallel.size());
+
+    int compared = 0;
+    int exited = 0;
+    for (int i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(serial[i].pid(), parallel[i].pid());
+        // started or exited between the two passes
+        if (serial[i].isValid() != parallel[i].isValid()) {
+            ++exited;
+            continue;
+        }
+        if (!serial[i].isValid())
+            continue;
+
+        ++compared;
+        EXPECT_EQ(serial[i].ppid(), parallel[i].ppid());
+        EXPECT_EQ(serial[i].name(), parallel[i].name());
+        EXPECT_EQ(serial[i].d->pgid, parallel[i].d->pgid);
+        EXPECT_EQ(serial[i].d->start_time, parallel[i].d->start_time);
+    }
+    EXPECT_GE(compared, 256);
+    EXPECT_LE(exited, pids.size() / 10);
+}
+
+// full refresh of the live process list, serial vs parallel
+TEST_F(UT_ProcessSampler, test_benchmark_refresh_001)
+{
+    ProcessSet procSet;
+    procSet.refresh();
+
+    QElapsedTimer timer;
+    qint64 elapsed[2] {};
+    const int rounds = 3;
+    for (int mode = 0; mode < 2; ++mode) {
+        procSet.sampler()->setParallel(mode == 1);
+        timer.start();
+        for (int i = 0; i < rounds; ++i)
+            procSet.refresh();
+        elapsed[mode] = timer.nsecsElapsed() / rounds;
+    }
+
+    EXPECT_FALSE(procSet.getPIDList().isEmpty());
+    qInfo() << "refresh" << procSet.getPIDList().size() << "processes:"
+            << "serial" << elapsed[0] / 1000 << "us,"
+            << "parallel" << elapsed[1] / 1000 << "us"
+            << "(" << procSet.sampler()->threadCount() << "threads )";
+}
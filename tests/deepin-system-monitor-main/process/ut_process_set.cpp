@@ -7,13 +7,22 @@
 #include "process/process_set.h"
 #include "process/process_db.h"
 #include "common/common.h"
+#include "system/sys_info.h"
 #include "wm/wm_window_list.h"
 
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 
+//Qt
+#include <QDebug>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace core::process;
+using namespace core::system;
 /***************************************STUB begin*********************************************/
 
 /***************************************STUB end**********************************************/
@@ -135,3 +144,80 @@ TEST_F(UT_ProcessSet, test_updateProcessPriority_001)
     pid_t pid = getpid();
     m_tester->updateProcessPriority(pid,0);
 }
+
+// process counter comes from the scan listing instead of a /proc walk in SysInfo
+TEST_F(UT_ProcessSet, test_sysinfo_counters_001)
+{
+    m_tester->refresh();
+    auto *sysInfo = SysInfo::instance();
+    // pids below 10 & processes that exited before being sampled are counted too
+    EXPECT_GT(sysInfo->nprocesses(), quint32(0));
+    EXPECT_GE(sysInfo->nprocesses(), quint32(m_tester->getPIDList().size()));
+}
+
+TEST_F(UT_ProcessSet, test_iterator_count_001)
+{
+    ProcessSet::Iterator iter;
+    int returned = 0;
+    while (iter.hasNext()) {
+        EXPECT_GE(iter.nextPid(), 10);
+        ++returned;
+    }
+    // init (pid 1) is listed but not returned
+    EXPECT_GT(iter.count(), quint32(returned));
+}
+
+TEST_F(UT_ProcessSet, test_snapshot_001)
+{
+    ProcessSnapshotPtr empty = m_tester->snapshot();
+    ASSERT_TRUE(empty);
+    EXPECT_TRUE(empty->isEmpty());
+
+    m_tester->refresh();
+    ProcessSnapshotPtr snapshot = m_tester->snapshot();
+    EXPECT_EQ(snapshot->version(), empty->version() + 1);
+    EXPECT_EQ(snapshot->pids().toList(), m_tester->getPIDList());
+
+    // published snapshots are left alone by later scans
+    QVector<pid_t> pids = snapshot->pids();
+    m_tester->refresh();
+    EXPECT_EQ(snapshot->pids(), pids);
+    EXPECT_GT(m_tester->snapshot()->version(), snapshot->version());
+}
+
+// readers on the gui thread while the monitor thread scans, run with -fsanitize=thread
+TEST_F(UT_ProcessSet, test_snapshot_stress_001)
+{
+    const int rounds = 20;
+    std::atomic<bool> done {false};
+    std::thread scanner([&]() {
+        for (int i = 0; i < rounds; ++i)
+            m_tester->refresh();
+        done = true;
+    });
+
+    quint64 version = 0;
+    int reads = 0;
+    while (!done) {
+        ProcessSnapshotPtr snapshot = m_tester->snapshot();
+        EXPECT_GE(snapshot->version(), version);
+        version = snapshot->version();
+
+        const QVector<pid_t> &pids = snapshot->pids();
+        EXPECT_TRUE(std::is_sorted(pids.cbegin(), pids.cend()));
+        qreal cpu = 0;
+        int length = 0;
+        for (int i = 0; i < snapshot->size(); ++i) {
+            EXPECT_EQ(snapshot->indexOf(pids[i]), i);
+            cpu += snapshot->cpu(i);
+            length += snapshot->displayName(i).size() + snapshot->cmdlineString(i).size();
+        }
+        EXPECT_GE(cpu, 0);
+        EXPECT_GE(length, 0);
+        ++reads;
+    }
+    scanner.join();
+
+    EXPECT_EQ(m_tester->snapshot()->version(), m_tester->m_snapshotVersion);
+    qInfo() << rounds << "scans," << reads << "snapshot reads";
+}
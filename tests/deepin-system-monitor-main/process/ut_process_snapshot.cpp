@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "process/process_snapshot.h"
+#include "process/process.h"
+#include "process/private/process_p.h"
+
+//gtest
+#include <gtest/gtest.h>
+
+using namespace core::process;
+
+static Process fakeProcess(pid_t pid, qreal cpu)
+{
+    Process proc(pid);
+    proc.d->valid = true;
+    proc.d->ppid = 1;
+    proc.d->name = QString("proc%1").arg(pid);
+    proc.d->cmdline = QByteArrayList {"/usr/bin/proc", "--arg%20x"};
+    proc.setCpu(cpu);
+    return proc;
+}
+
+TEST(UT_ProcessSnapshot, test_empty_001)
+{
+    ProcessSnapshot snapshot;
+    EXPECT_EQ(snapshot.version(), 0u);
+    EXPECT_TRUE(snapshot.isEmpty());
+    EXPECT_EQ(snapshot.indexOf(1), -1);
+}
+
+TEST(UT_ProcessSnapshot, test_indexOf_001)
+{
+    QList<Process> procs {fakeProcess(4, 1), fakeProcess(8, 2), fakeProcess(12, 3)};
+    ProcessSnapshot snapshot(3, procs);
+
+    EXPECT_EQ(snapshot.version(), 3u);
+    EXPECT_EQ(snapshot.size(), 3);
+    EXPECT_EQ(snapshot.indexOf(4), 0);
+    EXPECT_EQ(snapshot.indexOf(12), 2);
+    EXPECT_EQ(snapshot.indexOf(6), -1);
+    EXPECT_EQ(snapshot.indexOf(16), -1);
+    EXPECT_FALSE(snapshot.contains(0));
+
+    EXPECT_EQ(snapshot.pid(1), 8);
+    EXPECT_EQ(snapshot.ppid(1), 1);
+    EXPECT_DOUBLE_EQ(snapshot.cpu(1), 2);
+    EXPECT_EQ(snapshot.name(1), QString("proc8"));
+    EXPECT_EQ(snapshot.cmdlineString(1), QString("/usr/bin/proc --arg x"));
+}
+
+// values are copied, the sampler updating processes in place doesn't show through
+TEST(UT_ProcessSnapshot, test_copy_001)
+{
+    Process proc = fakeProcess(4, 1);
+    ProcessSnapshot snapshot(1, {proc});
+
+    proc.setCpu(50);
+    proc.setState('T');
+    proc.setName("renamed");
+
+    EXPECT_DOUBLE_EQ(snapshot.cpu(0), 1);
+    EXPECT_EQ(snapshot.state(0), '\0');
+    EXPECT_EQ(snapshot.name(0), QString("proc4"));
+}
@@ -5,11 +5,147 @@
 
 //self
 #include "service/service_manager_worker.h"
+#include "dbus/dbus_common.h"
+#include "dbus/systemd1_unit_interface.h"
+#include "dbus/unit_file_info.h"
+#include "dbus/unit_info.h"
+
+//qt
+#include <QDBusConnection>
+#include <QDBusVirtualObject>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTest>
 
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 
+using namespace dbus::common;
+
+#define MOCK_SYSTEMD1_SERVICE "org.deepin.SystemMonitor.MockSystemd1"
+#define MOCK_UNIT_FILES 600 // installed services
+#define MOCK_UNITS 400 // loaded services, the first ones of the installed services
+
+/**
+ * @brief ListUnits entry as systemd sends it, object paths marshalled as 'o'
+ */
+struct MockUnit {
+    QString name;
+    QString description;
+    QString loadState;
+    QString activeState;
+    QString subState;
+    QString followedBy;
+    QDBusObjectPath path;
+    quint32 jobId;
+    QString jobType;
+    QDBusObjectPath jobPath;
+};
+Q_DECLARE_METATYPE(MockUnit)
+
+QDBusArgument &operator<<(QDBusArgument &argument, const MockUnit &unit)
+{
+    argument.beginStructure();
+    argument << unit.name << unit.description << unit.loadState << unit.activeState << unit.subState
+             << unit.followedBy << unit.path << unit.jobId << unit.jobType << unit.jobPath;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, MockUnit &unit)
+{
+    argument.beginStructure();
+    argument >> unit.name >> unit.description >> unit.loadState >> unit.activeState >> unit.subState
+             >> unit.followedBy >> unit.path >> unit.jobId >> unit.jobType >> unit.jobPath;
+    argument.endStructure();
+    return argument;
+}
+
+/**
+ * @brief Mock org.freedesktop.systemd1 manager & unit objects, counts the calls it gets
+ */
+class MockSystemd1 : public QDBusVirtualObject
+{
+public:
+    MockSystemd1()
+    {
+        for (int i = 0; i < MOCK_UNIT_FILES; ++i) {
+            auto id = QString("mock-%1.service").arg(i);
+            m_files << UnitFileInfo(QString("/usr/lib/systemd/system/%1").arg(id), i % 2 ? "disabled" : "enabled");
+            if (i < MOCK_UNITS)
+                addUnit(id);
+            else
+                m_ids[Systemd1UnitInterface::normalizeUnitPath(id).path()] = id;
+        }
+        // template & transient unit
+        m_files << UnitFileInfo("/usr/lib/systemd/system/mock-tpl@.service", "disabled");
+        addUnit("run-mock.service");
+    }
+
+    void addUnit(const QString &id)
+    {
+        auto path = Systemd1UnitInterface::normalizeUnitPath(id);
+        m_units << MockUnit {id, QString("Mock %1").arg(id), "loaded", "active", "running", {}, path, 0, {}, QDBusObjectPath("/")};
+        m_ids[path.path()] = id;
+    }
+
+    QString introspect(const QString &) const override
+    {
+        return {};
+    }
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override
+    {
+        const auto &member = message.member();
+        QDBusMessage reply;
+        if (member == "Subscribe") {
+            reply = message.createReply();
+        } else if (member == "ListUnitsByPatterns") {
+            ++listUnits;
+            reply = message.createReply(QVariant::fromValue(m_units));
+        } else if (member == "ListUnitFilesByPatterns") {
+            ++listUnitFiles;
+            reply = message.createReply(QVariant::fromValue(m_files));
+        } else if (member == "GetAll" || member == "Get") {
+            if (!m_ids.contains(message.path())) {
+                reply = message.createErrorReply(QDBusError::UnknownObject, message.path());
+            } else if (member == "GetAll") {
+                ++getAll;
+                QVariantMap props;
+                props["Id"] = m_ids[message.path()];
+                props["Description"] = QString("Mock %1").arg(m_ids[message.path()]);
+                props["LoadState"] = "loaded";
+                props["ActiveState"] = "active";
+                props["SubState"] = "running";
+                props["UnitFileState"] = "enabled";
+                props["CanStart"] = true;
+                props["CanStop"] = true;
+                props["CanReload"] = false;
+                reply = message.createReply(QVariant::fromValue(props));
+            } else {
+                ++get;
+                reply = message.createReply(QVariant::fromValue(QDBusVariant(quint32(1000))));
+            }
+        } else {
+            return false;
+        }
+        connection.send(reply);
+        return true;
+    }
+
+    QAtomicInt listUnits {0};
+    QAtomicInt listUnitFiles {0};
+    QAtomicInt getAll {0};
+    QAtomicInt get {0};
+
+private:
+    QList<MockUnit> m_units;
+    UnitFileInfoList m_files;
+    // unit object path - id
+    QHash<QString, QString> m_ids;
+};
+
 static QString m_Sresult;
 /***************************************STUB begin*********************************************/
 
@@ -72,3 +208,169 @@ TEST_F(UT_ServiceManagerWorker, test_startJob_01)
 {
     m_tester->startJob();
 }
+
+/**
+ * @brief Worker running in its own thread against the mock systemd on a private session bus connection
+ */
+class UT_ServiceManagerWorkerMock : public ::testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        UnitInfo::registerMetaType();
+        UnitFileInfo::registerMetaType();
+        qDBusRegisterMetaType<MockUnit>();
+        qDBusRegisterMetaType<QList<MockUnit>>();
+        qRegisterMetaType<QList<SystemServiceEntry>>("ServiceEntryList");
+
+        m_bus = new QDBusConnection(QDBusConnection::connectToBus(QDBusConnection::SessionBus, "ut-mock-systemd1"));
+        if (!m_bus->isConnected() || !m_bus->registerService(MOCK_SYSTEMD1_SERVICE)
+                || !m_bus->registerVirtualObject(kSystemDObjectPath.path(), &m_mock, QDBusConnection::SubPath))
+            return;
+
+        m_tester = new ServiceManagerWorker(MOCK_SYSTEMD1_SERVICE, QDBusConnection::sessionBus());
+        m_tester->moveToThread(&m_thread);
+        QObject::connect(m_tester, &ServiceManagerWorker::resultReady, &m_context, [this](const QList<SystemServiceEntry> list) {
+            m_list = list;
+        });
+        QObject::connect(m_tester, &ServiceManagerWorker::entriesUpdated, &m_context, [this](const QList<SystemServiceEntry> list) {
+            for (const auto &entry : list)
+                m_updates[entry.getSName()] = entry;
+        });
+        QObject::connect(m_tester, &ServiceManagerWorker::entryRemoved, &m_context, [this](const QString &sname) {
+            m_removed << sname;
+        });
+        m_thread.start();
+    }
+
+    virtual void TearDown()
+    {
+        m_thread.quit();
+        m_thread.wait();
+        delete m_tester;
+        if (m_bus->isConnected()) {
+            m_bus->unregisterObject(kSystemDObjectPath.path(), QDBusConnection::UnregisterTree);
+            m_bus->unregisterService(MOCK_SYSTEMD1_SERVICE);
+        }
+        delete m_bus;
+        QDBusConnection::disconnectFromBus("ut-mock-systemd1");
+    }
+
+protected:
+    void load()
+    {
+        QMetaObject::invokeMethod(m_tester, "startJob", Qt::QueuedConnection);
+        ASSERT_TRUE(QTest::qWaitFor([this]() { return !m_list.isEmpty(); }, 5000));
+    }
+
+    void sendSignal(const QString &path, const QString &ifname, const QString &name, const QVariantList &args)
+    {
+        auto msg = QDBusMessage::createSignal(path, ifname, name);
+        msg.setArguments(args);
+        m_bus->send(msg);
+    }
+
+    MockSystemd1 m_mock;
+    QDBusConnection *m_bus {nullptr};
+    QThread m_thread;
+    ServiceManagerWorker *m_tester {nullptr};
+    QObject m_context;
+
+    QList<SystemServiceEntry> m_list;
+    QHash<QString, SystemServiceEntry> m_updates;
+    QStringList m_removed;
+};
+
+// rows come from the two list calls alone, details take two pipelined calls per service
+TEST_F(UT_ServiceManagerWorkerMock, test_load_details_001)
+{
+    // no session bus to host the mock
+    if (!m_tester)
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    load();
+    RecordProperty("list_ms", int(timer.elapsed()));
+
+    // installed, transient & template services
+    EXPECT_EQ(m_list.size(), MOCK_UNIT_FILES + 2);
+    EXPECT_EQ(int(m_mock.listUnits), 1);
+    EXPECT_EQ(int(m_mock.listUnitFiles), 1);
+    EXPECT_EQ(int(m_mock.getAll), 0);
+
+    QStringList snames;
+    for (const auto &entry : m_list) {
+        snames << entry.getSName();
+        if (entry.getSName() == "mock-1") {
+            EXPECT_EQ(entry.getActiveState(), QString("active"));
+            EXPECT_EQ(entry.getState(), QString("disabled"));
+            EXPECT_EQ(entry.getMainPID(), quint32(0));
+        }
+    }
+
+    timer.restart();
+    QMetaObject::invokeMethod(m_tester, "fetchDetails", Qt::QueuedConnection, Q_ARG(QStringList, snames));
+    // every service but the template
+    EXPECT_TRUE(QTest::qWaitFor([this]() { return m_updates.size() == MOCK_UNIT_FILES + 1; }, 10000));
+    RecordProperty("details_ms", int(timer.elapsed()));
+    EXPECT_EQ(int(m_mock.getAll), MOCK_UNIT_FILES + 1);
+    EXPECT_EQ(int(m_mock.get), MOCK_UNIT_FILES + 1);
+
+    // not loaded service, everything from its details
+    auto entry = m_updates.value("mock-500");
+    EXPECT_EQ(entry.getId(), QString("mock-500.service"));
+    EXPECT_EQ(entry.getActiveState(), QString("active"));
+    EXPECT_EQ(entry.getState(), QString("enabled"));
+    EXPECT_EQ(entry.getMainPID(), quint32(1000));
+    EXPECT_TRUE(entry.getCanStart());
+
+    // entries handed out before are not changed behind the receiver's back
+    for (const auto &listed : m_list) {
+        if (listed.getSName() == "mock-500")
+            EXPECT_EQ(listed.getMainPID(), quint32(0));
+    }
+
+    // fetched already, no more calls
+    m_updates.clear();
+    QMetaObject::invokeMethod(m_tester, "fetchDetails", Qt::QueuedConnection, Q_ARG(QStringList, snames));
+    QTest::qWait(300);
+    EXPECT_TRUE(m_updates.isEmpty());
+    EXPECT_EQ(int(m_mock.getAll), MOCK_UNIT_FILES + 1);
+}
+
+// changes arrive through signals, no reload
+TEST_F(UT_ServiceManagerWorkerMock, test_incremental_001)
+{
+    if (!m_tester)
+        return;
+
+    load();
+    auto unitIf = QString(Systemd1UnitInterface::staticInterfaceName());
+    auto mgrIf = QString("org.freedesktop.systemd1.Manager");
+
+    QVariantMap changed;
+    changed["ActiveState"] = "failed";
+    sendSignal(Systemd1UnitInterface::normalizeUnitPath("mock-1.service").path(),
+               "org.freedesktop.DBus.Properties", "PropertiesChanged",
+               {unitIf, changed, QStringList()});
+    EXPECT_TRUE(QTest::qWaitFor([this]() { return m_updates.contains("mock-1"); }, 5000));
+    EXPECT_EQ(m_updates.value("mock-1").getActiveState(), QString("failed"));
+
+    // transient unit is gone, installed one is only unloaded
+    sendSignal(kSystemDObjectPath.path(), mgrIf, "UnitRemoved",
+               {QString("run-mock.service"), QVariant::fromValue(Systemd1UnitInterface::normalizeUnitPath("run-mock.service"))});
+    sendSignal(kSystemDObjectPath.path(), mgrIf, "UnitRemoved",
+               {QString("mock-2.service"), QVariant::fromValue(Systemd1UnitInterface::normalizeUnitPath("mock-2.service"))});
+    EXPECT_TRUE(QTest::qWaitFor([this]() { return m_removed.contains("run-mock") && m_updates.contains("mock-2"); }, 5000));
+    EXPECT_FALSE(m_removed.contains("mock-2"));
+    EXPECT_EQ(m_updates.value("mock-2").getActiveState(), QString("inactive"));
+
+    // new unit shows up with its details
+    m_mock.addUnit("new-mock.service");
+    sendSignal(kSystemDObjectPath.path(), mgrIf, "UnitNew",
+               {QString("new-mock.service"), QVariant::fromValue(Systemd1UnitInterface::normalizeUnitPath("new-mock.service"))});
+    EXPECT_TRUE(QTest::qWaitFor([this]() { return m_updates.contains("new-mock"); }, 5000));
+    EXPECT_EQ(m_updates.value("new-mock").getMainPID(), quint32(1000));
+    EXPECT_EQ(int(m_mock.listUnits), 1);
+}
@@ -42,63 +42,27 @@ TEST_F(UT_CPUSetPrivate, initTest)
 
 TEST_F(UT_CPUSetPrivate, test_cpoy)
 {
-    FILE *fp;
-    QByteArray line(BUFSIZ, '\0');
-    int ncpu = 0;
-    int nr;
-
-    if (!(fp = fopen("/proc/stat", "r"))) {
-//        return;
-    }
-
-    while (fgets(line.data(), BUFSIZ, fp)) {
-        if (!strncmp(line.data(), "cpu", 3)) {
-                    // per cpu stat in jiffies
-                    auto stat = std::make_shared<struct cpu_stat_t>();
-                    if (stat) {
-                        *stat = {};
-
-                        nr = sscanf(line.data() + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                                    &ncpu,
-                                    &stat->user,
-                                    &stat->nice,
-                                    &stat->sys,
-                                    &stat->idle,
-                                    &stat->iowait,
-                                    &stat->hardirq,
-                                    &stat->softirq,
-                                    &stat->steal,
-                                    &stat->guest,
-                                    &stat->guest_nice);
-
-                        if (nr == 11) {
-                            QByteArray cpu {"cpu"};
-                            cpu.append(QByteArray::number(ncpu));
-                            stat->cpu = cpu;
-
-                            // usage calc
-                            auto usage = std::make_shared<struct cpu_usage_t>();
-                            if (usage) {
-                                *usage = {};
-                                usage->cpu = cpu;
-                                usage->total = stat->user + stat->nice + stat->sys + stat->idle + stat->iowait + stat->hardirq + stat->softirq + stat->steal;
-                                usage->idle = stat->idle + stat->iowait;
-
-                                m_tester->m_statDB[stat->cpu] = stat;
-                                m_tester->m_usageDB[usage->cpu] = usage;
-
-                                QList<CPUInfo> infos{};
-                                CPUInfo info{};
-                                infos.append(info);
-                                m_tester->m_infos = infos;
-                            }
-
-                        }
-                    }
-        }
-    }
+    const int ncpus = 4;
+    m_tester->m_ncpus = ncpus;
+    m_tester->m_stride = ncpus;
+    for (auto &jiffies : m_tester->m_jiffies)
+        jiffies.assign(size_t(ncpus) * kCPUStatFieldCount, 1);
+    m_tester->m_cpuTotal.assign(size_t(ncpus), 8);
+    m_tester->m_cpuIdle.assign(size_t(ncpus), 2);
+    m_tester->m_cpuOnline.assign(size_t(ncpus), 1);
+
+    QList<CPUInfo> infos{};
+    CPUInfo info{};
+    infos.append(info);
+    m_tester->m_infos = infos;
 
     CPUSetPrivate copy(*m_tester);
+    EXPECT_EQ(copy.m_ncpus, ncpus);
+    EXPECT_EQ(copy.m_stride, ncpus);
+    EXPECT_EQ(copy.m_jiffies[kLastStat], m_tester->m_jiffies[kLastStat]);
+    EXPECT_EQ(copy.m_jiffies[kCurrentStat], m_tester->m_jiffies[kCurrentStat]);
+    EXPECT_EQ(copy.m_cpuTotal, m_tester->m_cpuTotal);
+    EXPECT_EQ(copy.m_cpuIdle, m_tester->m_cpuIdle);
+    EXPECT_EQ(copy.m_cpuOnline, m_tester->m_cpuOnline);
+    EXPECT_EQ(copy.m_infos.size(), 1);
 }
-
-
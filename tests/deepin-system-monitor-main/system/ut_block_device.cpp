@@ -5,6 +5,7 @@
 
 //self
 #include "system/block_device.h"
+#include "common/common.h"
 
 //gtest
 #include "stub.h"
@@ -17,6 +18,8 @@
 #include <QIODevice>
 #include <QTextStream>
 
+#include <string.h>
+
 using namespace core::system;
 
 /***************************************STUB begin*********************************************/
@@ -120,33 +123,33 @@ TEST_F(UT_BlockDevice, test_readDeviceSize_02)
 
 TEST_F(UT_BlockDevice, test_calcDiskIoStates)
 {
-    QFile file(PROC_PATH_DISK);
-    if (!file.open(QIODevice::ReadOnly)) {
+    DiskStatTable table(false);
+    if (!table.update() || table.stats().empty())
         return;
-    }
-    QList<QStringList> strList;
-    QTextStream in(&file);
-
-    QString line;
-    do{
-        line = in.readLine();
-        if (!line.contains("loop")){
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            strList << line.split(" ", QString::SkipEmptyParts);
-#else
-            strList << line.split(" ", Qt::SkipEmptyParts);
-#endif
-        }
-    }while (!line.isNull());
-    file.close();
-
-    if (strList.size()){
-        QStringList deviceInfo = strList[0];
-        if (deviceInfo.size() > 16 && deviceInfo[2] == m_tester->d->name) {
-            m_tester->calcDiskIoStates(deviceInfo);
-            EXPECT_TRUE(m_tester->readSpeed() != 0);
-        }
-     }
+
+    disk_stat_t stat = table.stats().front();
+    stat.read_sectors += 1024;
+    m_tester->calcDiskIoStates(stat);
+    EXPECT_TRUE(m_tester->readSpeed() != 0);
+}
+
+TEST_F(UT_BlockDevice, test_setDeviceStat)
+{
+    disk_stat_t stat {};
+    strcpy(stat.name, "sdz");
+    stat.read_ios = 100;
+    stat.read_merges = 50;
+    stat.read_sectors = 2000;
+    stat.write_ios = 10;
+    stat.write_sectors = 800;
+    m_tester->setDeviceStat(stat);
+
+    EXPECT_EQ(m_tester->deviceName(), QByteArray("sdz"));
+    EXPECT_EQ(m_tester->blocksRead(), 2000ull);
+    EXPECT_EQ(m_tester->bytesRead(), 2000ull * SECTOR_SIZE);
+    EXPECT_EQ(m_tester->blocksWritten(), 800ull);
+    EXPECT_EQ(m_tester->transferPerSecond(), 110ull);
+    EXPECT_EQ(m_tester->readRequestMergedPercent(), 50.);
 }
 
 TEST_F(UT_BlockDevice, test_deviceName)
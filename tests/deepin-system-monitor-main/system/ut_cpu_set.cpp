@@ -7,6 +7,7 @@
 #include "system/cpu_set.h"
 #include "system/cpu.h"
 #include "system/private/cpu_set_p.h"
+#include "model/cpu_info_model.h"
 
 //gtest
 #include "stub.h"
@@ -16,6 +17,10 @@
 #include <QString>
 #include <QFile>
 #include <QMap>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <stdio.h>
 
 using namespace core::system;
 
@@ -32,6 +37,34 @@ int stub_sscanf_stats(const char *__restrict __s, const char *__restrict __forma
     return 1;
 }
 
+static QByteArray s_procStat;
+
+FILE *stub_fopen_proc_stat(const char *__restrict __filename,
+                           const char *__restrict __modes)
+{
+    return fmemopen(s_procStat.data(), size_t(s_procStat.size()), "r");
+}
+
+// /proc/stat of ncpus cpus after tick updates, field F of cpu N is (N + 1) * tick + F, offline cpu is left out
+static QByteArray makeProcStat(int ncpus, unsigned long long tick, int offline = -1)
+{
+    QByteArray buf;
+    buf += "cpu  ";
+    for (int f = 0; f < kCPUStatFieldCount; ++f)
+        buf += QByteArray::number(tick * ncpus + f) + ' ';
+    buf += '\n';
+    for (int n = 0; n < ncpus; ++n) {
+        if (n == offline)
+            continue;
+        buf += "cpu" + QByteArray::number(n);
+        for (int f = 0; f < kCPUStatFieldCount; ++f)
+            buf += ' ' + QByteArray::number((n + 1) * tick + f);
+        buf += '\n';
+    }
+    buf += "intr 0\nctxt 0\n";
+    return buf;
+}
+
 
 /***************************************STUB end**********************************************/
 
@@ -324,3 +357,109 @@ TEST_F(UT_CPUSet, test_getUsageTotalDelta_02)
     qulonglong totalDelta = m_tester->getUsageTotalDelta();
     EXPECT_NE(totalDelta, 0);
 }
+
+static int s_overallInfoReads = 0;
+
+void stub_read_overall_info()
+{
+    ++s_overallInfoReads;
+}
+
+// topology is read on first update only, later updates sample /proc/stat & frequency
+TEST_F(UT_CPUSet, test_update_topology_001)
+{
+    Stub stub;
+    stub.set(ADDR(CPUSet, read_overall_info), stub_read_overall_info);
+    s_overallInfoReads = 0;
+
+    m_tester->update();
+    m_tester->update();
+    EXPECT_EQ(s_overallInfoReads, 1);
+    EXPECT_TRUE(m_tester->d->m_hotplug);
+}
+
+// per cpu rows are addressed by cpu number, names come in numeric order
+TEST_F(UT_CPUSet, test_read_stats_dense_001)
+{
+    Stub stub;
+    stub.set(fopen, stub_fopen_proc_stat);
+
+    s_procStat = makeProcStat(12, 10);
+    m_tester->read_stats();
+    s_procStat = makeProcStat(12, 20, 3);
+    m_tester->read_stats();
+
+    EXPECT_EQ(m_tester->cpuStatCount(), 12);
+    EXPECT_FALSE(m_tester->cpuOnline(3));
+    EXPECT_TRUE(m_tester->cpuOnline(11));
+
+    QList<QByteArray> names = m_tester->cpuLogicName();
+    ASSERT_EQ(names.size(), 11);
+    EXPECT_EQ(names[2], QByteArray("cpu2"));
+    EXPECT_EQ(names[3], QByteArray("cpu4"));
+    EXPECT_EQ(names[9], QByteArray("cpu10"));
+
+    // user..steal & idle + iowait
+    EXPECT_EQ(m_tester->usageDB("cpu10")->total, 8ull * 11 * 20 + 28);
+    EXPECT_EQ(m_tester->usageDB("cpu10")->idle, 2ull * 11 * 20 + 7);
+    EXPECT_EQ(m_tester->statDB("cpu10")->guest_nice, 11ull * 20 + 9);
+    // offline cpu keeps the jiffies of its last read
+    EXPECT_EQ(m_tester->cpuJiffies(3, kCPUStatUser), 4ull * 10);
+    EXPECT_EQ(m_tester->usageDB("cpu3")->total, 0ull);
+}
+
+// CPUSet::read_stats & CPUInfoModel::updateModel at 8/64/512 cpus, steady state must not reallocate the tables
+TEST_F(UT_CPUSet, test_benchmark_update_001)
+{
+    Stub stub;
+    stub.set(fopen, stub_fopen_proc_stat);
+
+    const int counts[] = {8, 64, 512};
+    const int rounds = 200;
+    for (int ncpus : counts) {
+        // inputs prepared up front, only the update path is timed
+        QList<QByteArray> stats;
+        for (int i = 0; i < rounds + 2; ++i)
+            stats << makeProcStat(ncpus, 100ull * (i + 1));
+
+        CPUSet cpuset;
+        CPUInfoModel model;
+        model.m_cpuSet = &cpuset;
+
+        for (int i = 0; i < 2; ++i) {
+            s_procStat = stats[i];
+            cpuset.read_stats();
+            model.updateModel();
+        }
+        const unsigned long long *jiffies[] = {cpuset.d->m_jiffies[kLastStat].data(), cpuset.d->m_jiffies[kCurrentStat].data()};
+        const unsigned long long *history = model.m_cpuTotalHistory.row(0);
+
+        QElapsedTimer timer;
+        qint64 readTime = 0;
+        qint64 modelTime = 0;
+        for (int i = 2; i < rounds + 2; ++i) {
+            s_procStat = stats[i];
+            timer.start();
+            cpuset.read_stats();
+            readTime += timer.nsecsElapsed();
+            timer.start();
+            model.updateModel();
+            modelTime += timer.nsecsElapsed();
+        }
+
+        EXPECT_EQ(cpuset.cpuStatCount(), ncpus);
+        EXPECT_TRUE(cpuset.d->m_jiffies[kCurrentStat].data() == jiffies[0] || cpuset.d->m_jiffies[kCurrentStat].data() == jiffies[1]);
+        EXPECT_TRUE(cpuset.d->m_jiffies[kLastStat].data() == jiffies[0] || cpuset.d->m_jiffies[kLastStat].data() == jiffies[1]);
+        EXPECT_TRUE(model.m_cpuTotalHistory.row(0) == history || model.m_cpuTotalHistory.row(1) == history);
+
+        // cpu N runs (N + 1) * 100 jiffies per tick, 2 of 8 counted ones are idle
+        QList<qreal> percents = model.cpuPercentList();
+        ASSERT_EQ(percents.size(), ncpus);
+        EXPECT_DOUBLE_EQ(percents.last(), 75.);
+        EXPECT_DOUBLE_EQ(model.cpuPercent(0), 75.);
+
+        qInfo() << "cpu update" << ncpus << "cpus:"
+                << "read_stats" << readTime / rounds / 1000 << "us,"
+                << "updateModel" << modelTime / rounds / 1000 << "us per tick";
+    }
+}
@@ -10,6 +10,9 @@
 #include "stub.h"
 #include <gtest/gtest.h>
 
+#include <string.h>
+#include <sys/sysmacros.h>
+
 using namespace core::system;
 
 class UT_DiskIOInfo: public ::testing::Test
@@ -54,7 +57,60 @@ TEST_F(UT_DiskIOInfo, test_diskIoWriteBps)
 TEST_F(UT_DiskIOInfo, test_readDiskIOStats)
 {
     m_tester->update();
-    EXPECT_TRUE(m_tester->m_diskIoStatMap[1].size()>0);
+    EXPECT_TRUE(m_tester->m_stats->stats().size() > 0);
+    EXPECT_TRUE(m_tester->m_diskIoStat[1].read_ios > 0);
+}
+
+// partitions & unknown devices are sorted out through the cached whole disk set
+TEST_F(UT_DiskIOInfo, test_diskStatTable_parse_001)
+{
+    const char text[] =
+        "   8       0 sda 1000 10 20000 300 500 50 8000 600 0 700 900 4 0 16 1 2 3\n"
+        "   8       1 sda1 900 9 18000 200 400 40 6000 500 0 600 800 0 0 0 0 0 0\n"
+        " 253       0 dm-0 100 0 2000 30 50 0 800 60 0 70 90\n"
+        "   7       0 loop0 5 0 10 1 0 0 0 0 0 1 1\n";
+
+    DiskStatTable table(false);
+    // whole disk set as if /sys/block was scanned already
+    table.m_disks.insert(makedev(8, 0), 0x1);
+    table.m_disks.insert(makedev(8, 1), 0);
+    table.m_disks.insert(makedev(253, 0), 0x1 | 0x2);
+    table.m_disks.insert(makedev(7, 0), 0x1 | 0x2);
+    table.parse(text, strlen(text));
+
+    ASSERT_EQ(table.stats().size(), size_t(4));
+    EXPECT_EQ(table.diskGeneration(), quint64(0));
+
+    const disk_stat_t *sda = table.find(makedev(8, 0));
+    ASSERT_TRUE(sda);
+    EXPECT_STREQ(sda->name, "sda");
+    EXPECT_TRUE(sda->whole_disk);
+    EXPECT_FALSE(sda->virtual_disk);
+    EXPECT_EQ(sda->read_ios, 1000ull);
+    EXPECT_EQ(sda->read_merges, 10ull);
+    EXPECT_EQ(sda->read_sectors, 20000ull);
+    EXPECT_EQ(sda->write_ios, 500ull);
+    EXPECT_EQ(sda->write_merges, 50ull);
+    EXPECT_EQ(sda->write_sectors, 8000ull);
+    EXPECT_EQ(sda->discard_ios, 4ull);
+    EXPECT_EQ(sda->discard_sectors, 16ull);
+
+    EXPECT_FALSE(table.find(QByteArray("sda1"))->whole_disk);
+
+    // discard io stats might not be available
+    const disk_stat_t *dm = table.find(QByteArray("dm-0"));
+    ASSERT_TRUE(dm);
+    EXPECT_TRUE(dm->virtual_disk);
+    EXPECT_EQ(dm->write_sectors, 800ull);
+    EXPECT_EQ(dm->discard_sectors, 0ull);
+
+    // device not seen before triggers one rescan of /sys/block
+    const char added[] = "   8      16 sdb 1 0 8 0 0 0 0 0 0 0 0\n";
+    table.parse(added, strlen(added));
+    EXPECT_EQ(table.diskGeneration(), quint64(1));
+    EXPECT_TRUE(table.m_disks.contains(makedev(8, 16)));
+    table.parse(added, strlen(added));
+    EXPECT_EQ(table.diskGeneration(), quint64(1));
 }
 
 TEST_F(UT_DiskIOInfo, test_calDiskIoStates)
@@ -12,6 +12,16 @@
 
 using namespace core::system;
 
+/***************************************STUB begin*********************************************/
+
+static int g_staticProbes = 0;
+void stub_updateStaticInfo()
+{
+    ++g_staticProbes;
+}
+
+/***************************************STUB end**********************************************/
+
 class UT_NetifInfoDB: public ::testing::Test
 {
 public:
@@ -55,3 +65,22 @@ TEST_F(UT_NetifInfoDB, test_update)
     m_tester->update();
 
 }
+
+// static attributes are probed once per link, again only after a link event
+TEST_F(UT_NetifInfoDB, test_static_info_cache_001)
+{
+    // no rtnetlink notifications in this environment, every update probes
+    if (!m_tester->m_linkWatcher.isValid())
+        return;
+
+    Stub stub;
+    stub.set(ADDR(NetifInfo, updateStaticInfo), stub_updateStaticInfo);
+
+    g_staticProbes = 0;
+    m_tester->update();
+    EXPECT_EQ(g_staticProbes, m_tester->m_links.size());
+
+    g_staticProbes = 0;
+    m_tester->update();
+    EXPECT_EQ(g_staticProbes, 0);
+}
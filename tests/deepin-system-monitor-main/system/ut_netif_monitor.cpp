@@ -9,6 +9,7 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <atomic>
+#include <thread>
 
 //gtest
 #include "stub.h"
@@ -16,6 +17,8 @@
 
 //qt
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
 #include <QTimer>
 #include <QWaitCondition>
 #include <QMap>
@@ -95,12 +98,72 @@ TEST_F(UT_NetifMonitor, test_handleNetData)
 //    m_tester->handleNetData();
 }
 
-//TEST_F(UT_NetifMonitor, test_getSockIOStatByInode)
-//{
-//    Stub stub;
-//    stub.set((bool(QMap::*)(int))ADDR(QMap,contains), stub_contains);
-//    ino_t ino = 1;
-//    SockIOStat stat;
-//    qulonglong totalDelta = m_tester->getSockIOStatByInode(ino,stat);
-//    EXPECT_NE(totalDelta, 0);
-//}
+// consumer aggregates ring records, readers get the traffic since their previous read
+TEST_F(UT_NetifMonitor, test_getSockIOStatByInode)
+{
+    struct sock_io_stat_t stat {};
+    // nothing published yet
+    EXPECT_FALSE(m_tester->getSockIOStatByInode(1, stat));
+
+    std::thread consumer([this]() { m_tester->handleNetData(); });
+
+    EXPECT_TRUE(m_tester->m_packetRing.push({1, 100, kInboundPacket}));
+    EXPECT_TRUE(m_tester->m_packetRing.push({1, 10, kOutboundPacket}));
+    EXPECT_TRUE(m_tester->m_packetRing.push({2, 50, kInboundPacket}));
+    m_tester->m_pktqWatcher.wakeOne();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool found = false;
+    while (!(found = m_tester->getSockIOStatByInode(1, stat)) && timer.elapsed() < 5000)
+        QThread::msleep(10);
+
+    EXPECT_TRUE(found);
+    EXPECT_EQ(stat.ino, ino_t(1));
+    EXPECT_EQ(stat.rx_bytes, qulonglong(100));
+    EXPECT_EQ(stat.rx_packets, qulonglong(1));
+    EXPECT_EQ(stat.tx_packets, qulonglong(1));
+    // consumed, no new traffic for inode 1 until more packets arrive
+    EXPECT_FALSE(m_tester->getSockIOStatByInode(1, stat));
+    EXPECT_TRUE(m_tester->getSockIOStatByInode(2, stat));
+    EXPECT_EQ(stat.rx_bytes, qulonglong(50));
+    EXPECT_FALSE(m_tester->getSockIOStatByInode(3, stat));
+
+    EXPECT_TRUE(m_tester->m_packetRing.push({1, 30, kInboundPacket}));
+    m_tester->m_pktqWatcher.wakeOne();
+    timer.restart();
+    while (!(found = m_tester->getSockIOStatByInode(1, stat)) && timer.elapsed() < 5000)
+        QThread::msleep(10);
+    EXPECT_TRUE(found);
+    EXPECT_EQ(stat.rx_bytes, qulonglong(30));
+    EXPECT_EQ(stat.rx_packets, qulonglong(1));
+    EXPECT_EQ(stat.tx_packets, qulonglong(0));
+
+    m_tester->requestQuit();
+    consumer.join();
+}
+
+// entry pruned & created again, the reader starts over instead of subtracting old totals
+TEST_F(UT_NetifMonitor, test_getSockIOStatByInode_pruned)
+{
+    struct sock_io_stat_t stat {};
+    auto *total = m_tester->m_sockIOStats.insert(7);
+    total->epoch = 1;
+    total->rx_bytes = 1000;
+    total->rx_packets = 10;
+    m_tester->publishSockIOStats();
+    EXPECT_TRUE(m_tester->getSockIOStatByInode(7, stat));
+    EXPECT_EQ(stat.rx_bytes, qulonglong(1000));
+
+    // more packets than consumed before but fewer bytes
+    m_tester->m_sockIOStats.clear();
+    total = m_tester->m_sockIOStats.insert(7);
+    total->epoch = 2;
+    total->rx_bytes = 500;
+    total->rx_packets = 20;
+    m_tester->publishSockIOStats();
+    EXPECT_TRUE(m_tester->getSockIOStatByInode(7, stat));
+    EXPECT_EQ(stat.rx_bytes, qulonglong(500));
+    EXPECT_EQ(stat.rx_packets, qulonglong(20));
+    EXPECT_FALSE(m_tester->getSockIOStatByInode(7, stat));
+}
@@ -14,16 +14,31 @@
 #include <stdarg.h>
 #include <pcap.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include "system/netif_packet_parser.h"
 #include <pcap/pcap.h>
+#include <net/ethernet.h>
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
 
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
 
 using namespace core::system;
 
+namespace core {
+namespace system {
+void pcap_callback(u_char *context, const struct pcap_pkthdr *hdr, const u_char *packet);
+}
+}
+
 /***************************************STUB begin*********************************************/
 
 size_t stub_strlen()
@@ -31,51 +46,14 @@ size_t stub_strlen()
     return IFNAMSIZ+1;
 }
 
-void stub_whetherDevChanged()
-{
-    return;
-}
 
-int stub_ioctl (int num, unsigned long int __request, ...)
-{
-    return -1;
-}
 
-char* stub_inet_ntoa(struct in_addr __in)
-{
-    qInfo()<<"stub_inet_ntoa";
-    return nullptr;
-}
 
-int stub_pcap_findalldevs(pcap_if_t **, char *)
-{
-    return 1;
-}
 
-int stub_socket (int __domain, int __type, int __protocol)
-{
-    return -1;
-}
 
-bool stub_getCurrentDevName_true()
-{
-    return true;
-}
 
-bool stub_getCurrentDevName_false()
-{
-    return false;
-}
 
-bool stub_hasDevIP_false()
-{
-    return false;
-}
 
-bool stub_hasDevIP_true()
-{
-    return true;
-}
 
 bool stub_parsePacket_false(const pcap_pkthdr *pkt_hdr,
                                     const u_char *packet,
@@ -94,13 +72,97 @@ pcap_t	*stub_pcap_create_false(const char *, char *)
     return nullptr;
 }
 
-int	stub_localPendingPackets_64()
+static const uint32_t kReplayLocalAddr = 0xc0a80002; // 192.168.0.2
+static const uint32_t kReplayRemoteAddr = 0x5db8d822; // 93.184.216.34
+
+// synthetic capture: nflows tcp flows to remote:443, alternating upload & download bursts
+static bool writeReplayCapture(const QString &path, int npkts, int nflows)
 {
-    return 65;
+    pcap_t *dead = pcap_open_dead(DLT_EN10MB, 65535);
+    if (!dead)
+        return false;
+    pcap_dumper_t *dumper = pcap_dump_open(dead, path.toLocal8Bit().constData());
+    if (!dumper) {
+        pcap_close(dead);
+        return false;
+    }
+
+    u_char frame[sizeof(struct ether_header) + sizeof(struct ip) + sizeof(struct tcphdr) + 512] {};
+    auto *eth = reinterpret_cast<struct ether_header *>(frame);
+    eth->ether_type = htons(ETHERTYPE_IP);
+    auto *iph = reinterpret_cast<struct ip *>(frame + sizeof(struct ether_header));
+    iph->ip_v = 4;
+    iph->ip_hl = 5;
+    iph->ip_p = IPPROTO_TCP;
+    auto *tcph = reinterpret_cast<struct tcphdr *>(frame + sizeof(struct ether_header) + sizeof(struct ip));
+    tcph->th_off = 5;
+
+    struct pcap_pkthdr hdr {};
+    hdr.caplen = hdr.len = sizeof(frame);
+    struct in_addr local {htonl(kReplayLocalAddr)}, remote {htonl(kReplayRemoteAddr)};
+    for (int i = 0; i < npkts; ++i) {
+        uint16_t port = uint16_t(40000 + i % nflows);
+        bool upload = (i / nflows) % 2 == 0;
+        iph->ip_src = upload ? local : remote;
+        iph->ip_dst = upload ? remote : local;
+        tcph->th_sport = htons(upload ? port : 443);
+        tcph->th_dport = htons(upload ? 443 : port);
+        pcap_dump(reinterpret_cast<u_char *>(dumper), &hdr, frame);
+    }
+
+    pcap_dump_close(dumper);
+    pcap_close(dead);
+    return true;
 }
-int	stub_localPendingPackets_255()
-{
-    return 255;
+
+// one frame of a sample capture, trimmed to its headers like a capture with small snaplen
+static void dumpSampleFrame(pcap_dumper_t *dumper, int family, int proto,
+                            const char *saddr, uint16_t sport, const char *daddr, uint16_t dport,
+                            bpf_u_int32 wirelen)
+{
+    u_char frame[256] {};
+    auto *eth = reinterpret_cast<struct ether_header *>(frame);
+    size_t off = sizeof(struct ether_header);
+    if (family == AF_INET) {
+        eth->ether_type = htons(ETHERTYPE_IP);
+        auto *iph = reinterpret_cast<struct ip *>(frame + off);
+        iph->ip_v = 4;
+        iph->ip_hl = 5;
+        iph->ip_p = uint8_t(proto);
+        iph->ip_len = htons(uint16_t(wirelen - off));
+        inet_pton(AF_INET, saddr, &iph->ip_src);
+        inet_pton(AF_INET, daddr, &iph->ip_dst);
+        off += sizeof(struct ip);
+    } else {
+        eth->ether_type = htons(ETHERTYPE_IPV6);
+        auto *ip6h = reinterpret_cast<struct ip6_hdr *>(frame + off);
+        ip6h->ip6_vfc = 6 << 4;
+        ip6h->ip6_nxt = uint8_t(proto);
+        ip6h->ip6_plen = htons(uint16_t(wirelen - off - sizeof(struct ip6_hdr)));
+        inet_pton(AF_INET6, saddr, &ip6h->ip6_src);
+        inet_pton(AF_INET6, daddr, &ip6h->ip6_dst);
+        off += sizeof(struct ip6_hdr);
+    }
+    if (proto == IPPROTO_TCP) {
+        auto *tcph = reinterpret_cast<struct tcphdr *>(frame + off);
+        tcph->th_sport = htons(sport);
+        tcph->th_dport = htons(dport);
+        tcph->th_off = 5;
+        off += sizeof(struct tcphdr);
+    } else if (proto == IPPROTO_UDP) {
+        auto *udph = reinterpret_cast<struct udphdr *>(frame + off);
+        udph->uh_sport = htons(sport);
+        udph->uh_dport = htons(dport);
+        udph->uh_ulen = htons(uint16_t(sizeof(struct udphdr)));
+        off += sizeof(struct udphdr);
+    } else {
+        off += 8; // icmp or esp header
+    }
+
+    struct pcap_pkthdr hdr {};
+    hdr.caplen = bpf_u_int32(off);
+    hdr.len = wirelen;
+    pcap_dump(reinterpret_cast<u_char *>(dumper), &hdr, frame);
 }
 
 /***************************************STUB end**********************************************/
@@ -133,132 +195,11 @@ TEST_F(UT_NetifPacketCapture, initTest)
 {
 }
 
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_01)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = nullptr;
-    bool ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_02)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = "123456789";
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_03)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_04)
-{
-    Stub stub;
-    stub.set(ioctl, stub_ioctl);
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_05)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-
-    stub.set(inet_ntoa, stub_inet_ntoa);
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_hasDevIP_06)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-
-    stub.set(inet_ntoa, stub_inet_ntoa);
-    m_tester->m_devName = "12345678901234567";
-    auto ok = m_tester->hasDevIP();
-    EXPECT_EQ(ok, false);
-}
-
-TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_01)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    stub.set(socket, stub_socket);
-    auto ok = m_tester->getCurrentDevName();
-}
-
-TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_02)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    stub.set(pcap_findalldevs, stub_pcap_findalldevs);
-    auto ok = m_tester->getCurrentDevName();
-}
-
-TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_03)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    stub.set(pcap_findalldevs, stub_pcap_findalldevs);
-    auto ok = m_tester->getCurrentDevName();
-}
-
-//TEST_F(UT_NetifPacketCapture, test_getCurrentDevName_06)
-//{
-//    Stub stub;
-//    auto ok = m_tester->getCurrentDevName();
-//    EXPECT_EQ(ok, true);
-//}
-
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_01)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = nullptr;
-    m_tester->whetherDevChanged();
-}
-
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_02)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, hasDevIP), stub_hasDevIP_false);
-    stub.set(ADDR(NetifPacketCapture, getCurrentDevName), stub_getCurrentDevName_false);
-    m_tester->whetherDevChanged();
-    EXPECT_TRUE(m_tester->m_changedDev);
-}
-
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_03)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, hasDevIP), stub_hasDevIP_false);
-    stub.set(ADDR(NetifPacketCapture, getCurrentDevName), stub_getCurrentDevName_true);
-    m_tester->whetherDevChanged();
-    EXPECT_TRUE(m_tester->m_changedDev);
-}
-
-TEST_F(UT_NetifPacketCapture, test_whetherDevChanged_04)
-{
-    Stub stub;
-    stub.set(ADDR(NetifPacketCapture, hasDevIP), stub_hasDevIP_true);
-    m_tester->whetherDevChanged();
-    EXPECT_TRUE(m_tester->m_changedDev);
-}
-
 TEST_F(UT_NetifPacketCapture, test_startNetifMonitorJob_01)
 {
     Stub stub;
-    stub.set(ADDR(NetifPacketCapture, whetherDevChanged), stub_whetherDevChanged);
-    m_tester->m_devName = nullptr;
     m_tester->startNetifMonitorJob();
+    EXPECT_TRUE(m_tester->go);
 }
 
 
@@ -285,49 +226,334 @@ TEST_F(UT_NetifPacketCapture, test_startNetifMonitorJob_04)
 TEST_F(UT_NetifPacketCapture, test_dispatchPackets_01)
 {
     m_tester->go = true;
-    m_tester->m_devName = nullptr;
     m_tester->dispatchPackets();
 }
 
 TEST_F(UT_NetifPacketCapture, test_dispatchPackets_02)
 {
     m_tester->go = true;
-    m_tester->m_devName = nullptr;
     m_tester->dispatchPackets();
 }
 
+// stopped capture returns before touching any interface
 TEST_F(UT_NetifPacketCapture, test_dispatchPackets_03)
 {
-    m_tester->go = true;
-    m_tester->m_devName = nullptr;
-    Stub stub;
-    stub.set(ADDR(PacketPayloadQueue, size), stub_localPendingPackets_64);
-    m_tester->dispatchPackets();
-}
-TEST_F(UT_NetifPacketCapture, test_dispatchPackets_04)
-{
-    m_tester->go = true;
-    Stub stub;
-    stub.set(ADDR(PacketPayloadQueue, size), stub_localPendingPackets_64);
+    m_tester->go = false;
     m_tester->dispatchPackets();
+    EXPECT_FALSE(m_tester->m_timer->isActive());
+}
+
+// one wakeup drains the capture in growing batches until a batch comes back short
+TEST_F(UT_NetifPacketCapture, test_dispatchCapture_01)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString path = dir.filePath("replay.pcap");
+    const int npkts = 300;
+    ASSERT_TRUE(writeReplayCapture(path, npkts, 4));
+
+    char errbuf[PCAP_ERRBUF_SIZE] {};
+    pcap_t *handle = pcap_open_offline(path.toLocal8Bit().constData(), errbuf);
+    ASSERT_TRUE(handle != nullptr) << errbuf;
+    NetifPacketCapture::netif_capture_t capture {};
+    capture.handle = handle;
+    capture.linkType = DLT_EN10MB;
+    capture.batchCount = 64;
+
+    // batches of 64, 128 & the remaining 108 packets
+    EXPECT_EQ(m_tester->dispatchCapture(capture), npkts - 64 - 128);
+    EXPECT_EQ(capture.batchCount, 256);
+    EXPECT_EQ(m_tester->m_captureStat.delivered, qulonglong(npkts));
+    pcap_close(handle);
+}
+
+TEST_F(UT_NetifPacketCapture, test_refreshIfAddrsCache)
+{
+    m_tester->refreshIfAddrsCache();
+}
+
+TEST_F(UT_NetifPacketCapture, test_adaptBatchCount_01)
+{
+    NetifPacketCapture::netif_capture_t capture {};
+    capture.batchCount = 64;
+    int batch = capture.batchCount;
+    // full dispatches grow the batch up to the limit
+    for (int i = 0; i < 20; ++i)
+        m_tester->adaptBatchCount(capture, capture.batchCount);
+    EXPECT_GT(capture.batchCount, batch);
+    int max = capture.batchCount;
+    m_tester->adaptBatchCount(capture, max);
+    EXPECT_EQ(capture.batchCount, max);
+
+    // moderately filled dispatches keep it, nearly empty ones shrink it back
+    m_tester->adaptBatchCount(capture, max / 2);
+    EXPECT_EQ(capture.batchCount, max);
+    for (int i = 0; i < 20; ++i)
+        m_tester->adaptBatchCount(capture, 0);
+    EXPECT_EQ(capture.batchCount, batch);
+}
+
+TEST_F(UT_NetifPacketCapture, test_captureStat_01)
+{
+    m_tester->m_captureStat.delivered = 10;
+    // not published before the next dispatch batch
+    EXPECT_EQ(m_tester->captureStat().delivered, qulonglong(0));
+    m_tester->m_publishedStat = m_tester->m_captureStat;
+    EXPECT_EQ(m_tester->captureStat().delivered, qulonglong(10));
+}
+
+TEST_F(UT_NetifPacketCapture, test_captureFilter_01)
+{
+    IfAddrSet addrs;
+    EXPECT_EQ(NetifPacketCapture::captureFilter(addrs), QString("(tcp or udp)"));
+
+    struct in_addr a4 {htonl(kReplayLocalAddr)};
+    struct in6_addr a6 {};
+    inet_pton(AF_INET6, "2001:db8::2", &a6);
+    addrs.insert(a4);
+    addrs.insert(a6);
+    EXPECT_EQ(NetifPacketCapture::captureFilter(addrs),
+              QString("(tcp or udp) and (host 192.168.0.2 or host 2001:db8::2)"));
+}
+
+// generated filter compiled by libpcap & run against a sample capture, trimmed to header size
+TEST_F(UT_NetifPacketCapture, test_captureFilter_02)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString path = dir.filePath("sample.pcap");
+
+    pcap_t *dead = pcap_open_dead(DLT_EN10MB, 65535);
+    ASSERT_TRUE(dead != nullptr);
+    pcap_dumper_t *dumper = pcap_dump_open(dead, path.toLocal8Bit().constData());
+    ASSERT_TRUE(dumper != nullptr);
+    // admitted: tcp & udp to or from local addresses
+    dumpSampleFrame(dumper, AF_INET, IPPROTO_TCP, "192.168.0.2", 40000, "93.184.216.34", 443, 1514);
+    dumpSampleFrame(dumper, AF_INET, IPPROTO_TCP, "93.184.216.34", 443, "192.168.0.2", 40000, 1514);
+    dumpSampleFrame(dumper, AF_INET, IPPROTO_UDP, "192.168.0.2", 5353, "8.8.8.8", 53, 100);
+    dumpSampleFrame(dumper, AF_INET6, IPPROTO_TCP, "2001:db8::2", 40001, "2001:db8::99", 443, 1514);
+    // rejected: other hosts, icmp, other ipv6 next headers
+    dumpSampleFrame(dumper, AF_INET, IPPROTO_TCP, "10.0.0.1", 1000, "10.0.0.2", 80, 1514);
+    dumpSampleFrame(dumper, AF_INET, IPPROTO_ICMP, "192.168.0.2", 0, "8.8.8.8", 0, 98);
+    dumpSampleFrame(dumper, AF_INET6, IPPROTO_ICMPV6, "2001:db8::2", 0, "2001:db8::99", 0, 98);
+    dumpSampleFrame(dumper, AF_INET6, IPPROTO_ESP, "2001:db8::2", 0, "2001:db8::99", 0, 98);
+    pcap_dump_close(dumper);
+    pcap_close(dead);
+
+    IfAddrSet addrs;
+    struct in_addr a4 {htonl(kReplayLocalAddr)};
+    struct in6_addr a6 {};
+    inet_pton(AF_INET6, "2001:db8::2", &a6);
+    addrs.insert(a4);
+    addrs.insert(a6);
+
+    char errbuf[PCAP_ERRBUF_SIZE] {};
+    pcap_t *handle = pcap_open_offline(path.toLocal8Bit().constData(), errbuf);
+    ASSERT_TRUE(handle != nullptr) << errbuf;
+    NetifPacketCapture::netif_capture_t capture {};
+    capture.handle = handle;
+    EXPECT_TRUE(m_tester->applyCaptureFilter(capture, NetifPacketCapture::captureFilter(addrs)));
+    EXPECT_EQ(capture.filter, NetifPacketCapture::captureFilter(addrs));
+
+    struct result_t {
+        int packets;
+        qulonglong payload;
+    } result {};
+    pcap_loop(handle, -1, [](u_char *user, const struct pcap_pkthdr *hdr, const u_char *packet) {
+        auto *res = reinterpret_cast<struct result_t *>(user);
+        struct packet_payload_t pkt {};
+        // headers only captured, payload from length on the wire
+        if (NetifPacketParser::parsePacket(hdr, packet, pkt))
+            res->payload += pkt.payload;
+        ++res->packets;
+    }, reinterpret_cast<u_char *>(&result));
+    pcap_close(handle);
+
+    EXPECT_EQ(result.packets, 4);
+    EXPECT_EQ(result.payload, qulonglong(1514 - 14 - 20 - 20) * 2 + (100 - 14 - 20 - 8) + (1514 - 14 - 20));
+}
+
+// loopback & interfaces without address are not captured
+TEST_F(UT_NetifPacketCapture, test_captureInterfaces_01)
+{
+    auto ifaces = m_tester->captureInterfaces();
+    for (auto it = ifaces.cbegin(); it != ifaces.cend(); ++it) {
+        EXPECT_NE(it.value(), QByteArray("lo"));
+        EXPECT_EQ(int(if_nametoindex(it.value().constData())), it.key());
+    }
 }
 
-TEST_F(UT_NetifPacketCapture, test_dispatchPackets_05)
+// closing every capture keeps the kernel counters seen so far
+TEST_F(UT_NetifPacketCapture, test_stopCapture_01)
 {
-    m_tester->go = true;
-    Stub stub;
-    stub.set(ADDR(PacketPayloadQueue, size), stub_localPendingPackets_255);
-    m_tester->dispatchPackets();
+    auto capture = NetifPacketCapture::NetifCapture(new NetifPacketCapture::netif_capture_t {});
+    capture->stat.ps_recv = 10;
+    capture->stat.ps_drop = 2;
+    m_tester->m_captures[1] = std::move(capture);
+    m_tester->stopCapture();
+    EXPECT_TRUE(m_tester->m_captures.empty());
+    EXPECT_EQ(m_tester->m_closedStat.kernel_received, qulonglong(10));
+    EXPECT_EQ(m_tester->m_closedStat.kernel_dropped, qulonglong(2));
 }
 
-
-TEST_F(UT_NetifPacketCapture, test_dispatchPackets_06)
+// offline pcap replay through pcap_callback, attribution throughput on one core
+TEST_F(UT_NetifPacketCapture, test_benchmark_pcap_callback_001)
 {
-    m_tester->go = false;
-    m_tester->dispatchPackets();
-}
+    const int npkts = 200000;
+    const int nflows = 4096;
 
-TEST_F(UT_NetifPacketCapture, test_refreshIfAddrsHashCache)
-{
-    m_tester->refreshIfAddrsHashCache();
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QString path = dir.filePath("replay.pcap");
+    ASSERT_TRUE(writeReplayCapture(path, npkts, nflows));
+
+    // socket table as readSockStat builds it: tcp flows mapped in both directions
+    struct in_addr local {htonl(kReplayLocalAddr)}, remote {htonl(kReplayRemoteAddr)};
+    for (int i = 0; i < nflows; ++i) {
+        uint16_t port = uint16_t(40000 + i);
+        m_tester->m_sockStats.insert(makeFlowKey(AF_INET, IPPROTO_TCP, &local, port, &remote, 443), ino_t(i + 1));
+        m_tester->m_sockStats.insert(makeFlowKey(AF_INET, IPPROTO_TCP, &remote, 443, &local, port), ino_t(i + 1));
+    }
+    m_tester->m_ifaddrs.insert(local);
+
+    char errbuf[PCAP_ERRBUF_SIZE] {};
+    pcap_t *handle = pcap_open_offline(path.toLocal8Bit().constData(), errbuf);
+    ASSERT_TRUE(handle != nullptr) << errbuf;
+
+    // replay in chunks the ring can hold, draining it in between the way handleNetData does
+    auto &ring = m_tester->m_netifMonitor->m_packetRing;
+    const int chunk = int(ring.capacity() / 2);
+    struct packet_record_t records[256];
+    int attributed = 0;
+    int upload = 0;
+    qint64 elapsed = 0;
+    QElapsedTimer timer;
+    int nr;
+    do {
+        timer.start();
+        nr = pcap_dispatch(handle, chunk, pcap_callback, reinterpret_cast<u_char *>(m_tester));
+        elapsed += timer.nsecsElapsed();
+
+        size_t n;
+        while ((n = ring.pop(records, 256)) > 0) {
+            attributed += int(n);
+            for (size_t i = 0; i < n; ++i) {
+                if (records[i].direction == kOutboundPacket)
+                    ++upload;
+            }
+        }
+    } while (nr > 0);
+    pcap_close(handle);
+
+    EXPECT_EQ(nr, 0);
+    EXPECT_EQ(attributed, npkts);
+    EXPECT_EQ(m_tester->m_captureStat.delivered, qulonglong(npkts));
+    EXPECT_EQ(m_tester->m_captureStat.attributed, qulonglong(npkts));
+    EXPECT_EQ(m_tester->m_captureStat.ring_dropped, qulonglong(0));
+    EXPECT_GT(upload, 0);
+
+    qInfo() << "pcap replay" << npkts << "packets," << nflows << "flows:"
+            << elapsed / 1000 << "us," << qreal(npkts) * 1000 / qMax<qint64>(elapsed, 1) << "Mpps";
+}
+
+// flows missing in the socket table are resolved through sock_diag & cached
+TEST_F(UT_NetifPacketCapture, test_lookupSockInode_01)
+{
+    if (!m_tester->m_sockDiag.open())
+        return;
+
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in laddr {};
+    laddr.sin_family = AF_INET;
+    laddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(laddr);
+    ASSERT_EQ(bind(lfd, reinterpret_cast<struct sockaddr *>(&laddr), len), 0);
+    ASSERT_EQ(listen(lfd, 1), 0);
+    getsockname(lfd, reinterpret_cast<struct sockaddr *>(&laddr), &len);
+    int cfd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(cfd, reinterpret_cast<struct sockaddr *>(&laddr), len), 0);
+    struct sockaddr_in caddr {};
+    getsockname(cfd, reinterpret_cast<struct sockaddr *>(&caddr), &len);
+    struct stat st {};
+    fstat(cfd, &st);
+
+    struct packet_payload_t pkt {};
+    pkt.sa_family = AF_INET;
+    pkt.proto = IPPROTO_TCP;
+    pkt.direction = kOutboundPacket;
+    pkt.s_addr.in4 = caddr.sin_addr;
+    pkt.s_port = ntohs(caddr.sin_port);
+    pkt.d_addr.in4 = laddr.sin_addr;
+    pkt.d_port = ntohs(laddr.sin_port);
+
+    m_tester->m_sockLookupBudget = 1;
+    EXPECT_EQ(m_tester->lookupSockInode(pkt), st.st_ino);
+    EXPECT_EQ(m_tester->m_sockStats.size(), 2);
+
+    // reverse direction served from cache, no lookup budget left
+    struct packet_payload_t reply = pkt;
+    reply.direction = kInboundPacket;
+    std::swap(reply.s_addr, reply.d_addr);
+    std::swap(reply.s_port, reply.d_port);
+    EXPECT_EQ(m_tester->lookupSockInode(reply), st.st_ino);
+
+    // failed lookups are remembered
+    pkt.d_port = 1;
+    m_tester->m_sockLookupBudget = 1;
+    EXPECT_EQ(m_tester->lookupSockInode(pkt), ino_t(0));
+    EXPECT_EQ(m_tester->m_sockMisses.size(), 1);
+
+    close(cfd);
+    close(lfd);
+}
+
+// resync dump is swapped in, closed flows dropped & lookups made meanwhile kept
+TEST_F(UT_NetifPacketCapture, test_sockStatResync_01)
+{
+    if (!m_tester->m_sockDiag.open())
+        return;
+
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in laddr {};
+    laddr.sin_family = AF_INET;
+    laddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(laddr);
+    ASSERT_EQ(bind(lfd, reinterpret_cast<struct sockaddr *>(&laddr), len), 0);
+    ASSERT_EQ(listen(lfd, 1), 0);
+    getsockname(lfd, reinterpret_cast<struct sockaddr *>(&laddr), &len);
+    int cfd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(cfd, reinterpret_cast<struct sockaddr *>(&laddr), len), 0);
+    struct sockaddr_in caddr {};
+    getsockname(cfd, reinterpret_cast<struct sockaddr *>(&caddr), &len);
+    struct stat st {};
+    fstat(cfd, &st);
+
+    // closed socket left in the live table
+    in_addr stale {htonl(0x0a000001)};
+    auto staleKey = makeFlowKey(AF_INET, IPPROTO_TCP, &stale, 1, &stale, 2);
+    m_tester->m_sockStats.insert(staleKey, 1);
+
+    m_tester->startSockStatResync();
+    EXPECT_TRUE(m_tester->m_sockResyncPending);
+    // live table keeps serving while the dump is running
+    EXPECT_EQ(m_tester->m_sockStats.find(staleKey), ino_t(1));
+
+    // flow resolved by a targeted lookup meanwhile is replayed on the new table
+    in_addr other {htonl(0x0a000002)};
+    auto lookupKey = makeFlowKey(AF_INET, IPPROTO_UDP, &other, 3, &other, 4);
+    m_tester->m_sockStats.insert(lookupKey, 2);
+    m_tester->m_sockResyncLog << NetifPacketCapture::sock_resync_op_t {lookupKey, 2, false};
+
+    m_tester->m_sockResyncWatcher->waitForFinished();
+    m_tester->finishSockStatResync();
+    EXPECT_FALSE(m_tester->m_sockResyncPending);
+    EXPECT_TRUE(m_tester->m_sockResyncLog.isEmpty());
+
+    EXPECT_EQ(m_tester->m_sockStats.find(staleKey), ino_t(0));
+    EXPECT_EQ(m_tester->m_sockStats.find(lookupKey), ino_t(2));
+    EXPECT_EQ(m_tester->m_sockStats.find(makeFlowKey(AF_INET, IPPROTO_TCP, &caddr.sin_addr, ntohs(caddr.sin_port),
+                                                     &laddr.sin_addr, ntohs(laddr.sin_port))), st.st_ino);
+
+    close(cfd);
+    close(lfd);
 }
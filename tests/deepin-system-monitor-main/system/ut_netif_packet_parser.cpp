@@ -6,7 +6,12 @@
 //self
 #include "system/netif_packet_parser.h"
 #include <net/ethernet.h>
+#include <netinet/ip.h>
 #include <netinet/ip6.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <pcap/pcap.h>
+#include <string.h>
 //gtest
 #include "stub.h"
 #include <gtest/gtest.h>
@@ -124,3 +129,58 @@ TEST_F(UT_NetifPacketParser, test_parsePacket_05)
 //    stub.set(ntohs, stub_ntohs_IPV6);
 //    EXPECT_EQ(m_tester->parsePacket(&hdr, packet1, payload), false);
 }
+
+// udp datagram behind a link layer header of linkLen bytes
+static size_t makeUdpPacket(u_char *packet, size_t linkLen, uint16_t sport, uint16_t dport)
+{
+    auto *ip_hdr = reinterpret_cast<struct ip *>(packet + linkLen);
+    ip_hdr->ip_v = 4;
+    ip_hdr->ip_hl = 5;
+    ip_hdr->ip_p = IPPROTO_UDP;
+    ip_hdr->ip_src.s_addr = htonl(0xc0a80002);
+    ip_hdr->ip_dst.s_addr = htonl(0x08080808);
+    auto *udp_hdr = reinterpret_cast<struct udphdr *>(packet + linkLen + sizeof(struct ip));
+    udp_hdr->uh_sport = htons(sport);
+    udp_hdr->uh_dport = htons(dport);
+    return linkLen + sizeof(struct ip) + sizeof(struct udphdr);
+}
+
+// tun device capture, no link layer header
+TEST_F(UT_NetifPacketParser, test_parsePacket_raw_001)
+{
+    u_char packet[64] {};
+    pcap_pkthdr hdr {};
+    hdr.caplen = uint32_t(makeUdpPacket(packet, 0, 5353, 53));
+    hdr.len = 100;
+
+    struct packet_payload_t payload {};
+    EXPECT_TRUE(NetifPacketParser::parsePacket(&hdr, packet, payload, DLT_RAW));
+    EXPECT_EQ(payload.sa_family, AF_INET);
+    EXPECT_EQ(payload.proto, uint(IPPROTO_UDP));
+    EXPECT_EQ(payload.s_port, 5353);
+    EXPECT_EQ(payload.d_port, 53);
+    EXPECT_EQ(payload.payload, 100 - sizeof(struct ip) - sizeof(struct udphdr));
+
+    // same bytes read as ethernet are no ip packet
+    EXPECT_FALSE(NetifPacketParser::parsePacket(&hdr, packet, payload, DLT_EN10MB));
+}
+
+// linux cooked capture, protocol after the 14 bytes of packet type & link address
+TEST_F(UT_NetifPacketParser, test_parsePacket_sll_001)
+{
+    u_char packet[64] {};
+    pcap_pkthdr hdr {};
+    hdr.caplen = uint32_t(makeUdpPacket(packet, 16, 40000, 443));
+    hdr.len = 200;
+    uint16_t proto = htons(ETHERTYPE_IP);
+    memcpy(packet + 14, &proto, sizeof(proto));
+
+    struct packet_payload_t payload {};
+    EXPECT_TRUE(NetifPacketParser::parsePacket(&hdr, packet, payload, DLT_LINUX_SLL));
+    EXPECT_EQ(payload.s_port, 40000);
+    EXPECT_EQ(payload.d_port, 443);
+    EXPECT_EQ(payload.payload, 200 - 16 - sizeof(struct ip) - sizeof(struct udphdr));
+
+    // unsupported link layer
+    EXPECT_FALSE(NetifPacketParser::parsePacket(&hdr, packet, payload, DLT_NULL));
+}
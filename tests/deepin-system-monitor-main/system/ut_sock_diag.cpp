@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/sock_diag.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+/***************************************STUB begin*********************************************/
+
+int stub_socket_fail(int, int, int)
+{
+    return -1;
+}
+
+static ino_t sockInode(int fd)
+{
+    struct stat st {};
+    fstat(fd, &st);
+    return st.st_ino;
+}
+
+/***************************************STUB end**********************************************/
+
+class UT_SockDiag : public ::testing::Test
+{
+public:
+    UT_SockDiag() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new SockDiag();
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    SockDiag *m_tester;
+};
+
+TEST_F(UT_SockDiag, initTest)
+{
+    EXPECT_FALSE(m_tester->isValid());
+}
+
+TEST_F(UT_SockDiag, test_open_001)
+{
+    Stub stub;
+    stub.set(socket, stub_socket_fail);
+    EXPECT_FALSE(m_tester->open());
+    EXPECT_FALSE(m_tester->isValid());
+
+    SockStatTable table;
+    EXPECT_FALSE(m_tester->dump(table));
+    in_addr addr {htonl(INADDR_LOOPBACK)};
+    EXPECT_EQ(m_tester->lookup(AF_INET, IPPROTO_TCP, &addr, 1, &addr, 2), ino_t(0));
+}
+
+// loopback tcp connection is found by both full dump & targeted lookup
+TEST_F(UT_SockDiag, test_dump_lookup_tcp_001)
+{
+    if (!m_tester->open())
+        return;
+
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in laddr {};
+    laddr.sin_family = AF_INET;
+    laddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(laddr);
+    ASSERT_EQ(bind(lfd, reinterpret_cast<struct sockaddr *>(&laddr), len), 0);
+    ASSERT_EQ(listen(lfd, 1), 0);
+    getsockname(lfd, reinterpret_cast<struct sockaddr *>(&laddr), &len);
+
+    int cfd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(cfd, reinterpret_cast<struct sockaddr *>(&laddr), len), 0);
+    struct sockaddr_in caddr {};
+    getsockname(cfd, reinterpret_cast<struct sockaddr *>(&caddr), &len);
+
+    uint16_t cport = ntohs(caddr.sin_port);
+    uint16_t lport = ntohs(laddr.sin_port);
+    ino_t ino = sockInode(cfd);
+
+    SockStatTable table;
+    EXPECT_TRUE(m_tester->dump(table));
+    EXPECT_EQ(table.find(makeFlowKey(AF_INET, IPPROTO_TCP, &caddr.sin_addr, cport, &laddr.sin_addr, lport)), ino);
+    EXPECT_EQ(table.find(makeFlowKey(AF_INET, IPPROTO_TCP, &laddr.sin_addr, lport, &caddr.sin_addr, cport)), ino);
+
+    EXPECT_EQ(m_tester->lookup(AF_INET, IPPROTO_TCP, &caddr.sin_addr, cport, &laddr.sin_addr, lport), ino);
+    // wrong protocol, nothing found
+    EXPECT_EQ(m_tester->lookup(AF_INET, IPPROTO_UDP, &caddr.sin_addr, cport, &laddr.sin_addr, lport), ino_t(0));
+
+    close(cfd);
+    close(lfd);
+}
+
+// unconnected udp socket is found for any remote peer
+TEST_F(UT_SockDiag, test_lookup_udp_001)
+{
+    if (!m_tester->open())
+        return;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(bind(fd, reinterpret_cast<struct sockaddr *>(&addr), len), 0);
+    getsockname(fd, reinterpret_cast<struct sockaddr *>(&addr), &len);
+
+    in_addr peer {htonl(INADDR_LOOPBACK)};
+    EXPECT_EQ(m_tester->lookup(AF_INET, IPPROTO_UDP, &addr.sin_addr, ntohs(addr.sin_port), &peer, 5353), sockInode(fd));
+
+    close(fd);
+}
+
+// destroy notifications are drained without blocking
+TEST_F(UT_SockDiag, test_readDestroyed_001)
+{
+    int calls = 0;
+    auto handler = [&calls](const flow_key_t &, ino_t) { ++calls; };
+    // not subscribed
+    EXPECT_FALSE(m_tester->readDestroyed(handler));
+
+    if (!m_tester->subscribeDestroyed())
+        return;
+    EXPECT_GE(m_tester->eventFd(), 0);
+    EXPECT_TRUE(m_tester->readDestroyed(handler));
+
+    m_tester->close();
+    EXPECT_EQ(m_tester->eventFd(), -1);
+}
@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: 2022 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+//self
+#include "system/sock_stat_table.h"
+
+#include <arpa/inet.h>
+
+//gtest
+#include "stub.h"
+#include <gtest/gtest.h>
+
+using namespace core::system;
+
+/***************************************STUB begin*********************************************/
+
+static flow_key_t v4Key(uint32_t saddr, uint16_t sport, uint32_t daddr, uint16_t dport, int proto = IPPROTO_TCP)
+{
+    in_addr s {htonl(saddr)}, d {htonl(daddr)};
+    return makeFlowKey(AF_INET, proto, &s, sport, &d, dport);
+}
+
+/***************************************STUB end**********************************************/
+
+class UT_SockStatTable : public ::testing::Test
+{
+public:
+    UT_SockStatTable() : m_tester(nullptr) {}
+
+public:
+    virtual void SetUp()
+    {
+        m_tester = new SockStatTable(16);
+    }
+
+    virtual void TearDown()
+    {
+        if (m_tester) {
+            delete m_tester;
+            m_tester = nullptr;
+        }
+    }
+
+protected:
+    SockStatTable *m_tester;
+};
+
+TEST_F(UT_SockStatTable, initTest)
+{
+    EXPECT_EQ(m_tester->size(), 0);
+    EXPECT_EQ(m_tester->capacity(), 16);
+}
+
+TEST_F(UT_SockStatTable, test_makeFlowKey_001)
+{
+    in6_addr s {}, d {};
+    inet_pton(AF_INET6, "fe80::1", &s);
+    inet_pton(AF_INET6, "fe80::2", &d);
+    auto key = makeFlowKey(AF_INET6, IPPROTO_UDP, &s, 53, &d, 5353);
+    EXPECT_EQ(key.sa_family, AF_INET6);
+    EXPECT_EQ(key.proto, IPPROTO_UDP);
+    EXPECT_EQ(memcmp(key.s_addr, &s, sizeof(s)), 0);
+
+    // unused ipv4 address bytes stay zeroed
+    auto key4 = v4Key(0x7f000001, 1, 0x7f000001, 2);
+    for (size_t i = sizeof(in_addr); i < sizeof(key4.s_addr); ++i) {
+        EXPECT_EQ(key4.s_addr[i], 0);
+        EXPECT_EQ(key4.d_addr[i], 0);
+    }
+}
+
+TEST_F(UT_SockStatTable, test_insert_find_001)
+{
+    const int count = 10000;
+    for (int i = 0; i < count; ++i)
+        m_tester->insert(v4Key(0x0a000001, uint16_t(i), 0x0a000002, 443), ino_t(i + 1));
+
+    EXPECT_EQ(m_tester->size(), count);
+    EXPECT_GE(m_tester->capacity(), count * 2);
+    for (int i = 0; i < count; ++i)
+        EXPECT_EQ(m_tester->find(v4Key(0x0a000001, uint16_t(i), 0x0a000002, 443)), ino_t(i + 1));
+
+    // reversed tuple & other protocol are different flows
+    EXPECT_EQ(m_tester->find(v4Key(0x0a000002, 443, 0x0a000001, 1)), ino_t(0));
+    EXPECT_EQ(m_tester->find(v4Key(0x0a000001, 1, 0x0a000002, 443, IPPROTO_UDP)), ino_t(0));
+}
+
+TEST_F(UT_SockStatTable, test_insert_001)
+{
+    auto key = v4Key(0x0a000001, 1000, 0x0a000002, 53, IPPROTO_UDP);
+    m_tester->insert(key, 10);
+    m_tester->insert(key, 11);
+    m_tester->insert(key, 0);
+    EXPECT_EQ(m_tester->size(), 1);
+    EXPECT_EQ(m_tester->find(key), ino_t(11));
+}
+
+TEST_F(UT_SockStatTable, test_clear_001)
+{
+    m_tester->insert(v4Key(1, 1, 2, 2), 1);
+    m_tester->insert(v4Key(3, 3, 4, 4), 2);
+    int capacity = m_tester->capacity();
+    m_tester->clear();
+    EXPECT_EQ(m_tester->size(), 0);
+    EXPECT_EQ(m_tester->capacity(), capacity);
+    EXPECT_EQ(m_tester->find(v4Key(1, 1, 2, 2)), ino_t(0));
+}
+
+TEST_F(UT_SockStatTable, test_remove_001)
+{
+    const int count = 1000;
+    for (int i = 0; i < count; ++i)
+        m_tester->insert(v4Key(0x0a000001, uint16_t(i), 0x0a000002, 443), ino_t(i + 1));
+
+    // drop every other flow, probe chains of the remaining ones must stay intact
+    for (int i = 0; i < count; i += 2)
+        EXPECT_TRUE(m_tester->remove(v4Key(0x0a000001, uint16_t(i), 0x0a000002, 443)));
+    EXPECT_FALSE(m_tester->remove(v4Key(0x0a000001, 0, 0x0a000002, 443)));
+
+    EXPECT_EQ(m_tester->size(), count / 2);
+    for (int i = 0; i < count; ++i) {
+        ino_t expected = (i % 2) ? ino_t(i + 1) : ino_t(0);
+        EXPECT_EQ(m_tester->find(v4Key(0x0a000001, uint16_t(i), 0x0a000002, 443)), expected);
+    }
+}
+
+TEST_F(UT_SockStatTable, test_swap_001)
+{
+    SockStatTable other(16);
+    m_tester->insert(v4Key(1, 1, 2, 2), 1);
+    other.insert(v4Key(3, 3, 4, 4), 2);
+    other.insert(v4Key(5, 5, 6, 6), 3);
+
+    m_tester->swap(other);
+    EXPECT_EQ(m_tester->size(), 2);
+    EXPECT_EQ(m_tester->find(v4Key(3, 3, 4, 4)), ino_t(2));
+    EXPECT_EQ(m_tester->find(v4Key(1, 1, 2, 2)), ino_t(0));
+    EXPECT_EQ(other.size(), 1);
+    EXPECT_EQ(other.find(v4Key(1, 1, 2, 2)), ino_t(1));
+}
+
+TEST_F(UT_SockStatTable, test_ifaddrs_001)
+{
+    IfAddrSet addrs;
+    in_addr a4 {htonl(0xc0a80001)}, b4 {htonl(0xc0a80002)};
+    in6_addr a6 {}, b6 {};
+    inet_pton(AF_INET6, "2001:db8::1", &a6);
+    inet_pton(AF_INET6, "2001:db8::2", &b6);
+
+    addrs.insert(a4);
+    addrs.insert(a4);
+    addrs.insert(a6);
+    EXPECT_TRUE(addrs.contains(a4));
+    EXPECT_FALSE(addrs.contains(b4));
+    EXPECT_TRUE(addrs.contains(a6));
+    EXPECT_FALSE(addrs.contains(b6));
+
+    addrs.clear();
+    EXPECT_FALSE(addrs.contains(a4));
+}
+
+TEST_F(UT_SockStatTable, test_sockIOStatTable_001)
+{
+    SockIOStatTable table(16);
+    const int count = 1000;
+    for (int i = 1; i <= count; ++i) {
+        auto *stat = table.insert(ino_t(i));
+        stat->rx_bytes += qulonglong(i);
+        stat->rx_packets++;
+    }
+    // existing counters are updated in place
+    table.insert(1)->rx_bytes += 10;
+
+    EXPECT_EQ(table.size(), count);
+    EXPECT_GE(table.capacity(), count * 2);
+    ASSERT_TRUE(table.find(1) != nullptr);
+    EXPECT_EQ(table.find(1)->rx_bytes, qulonglong(11));
+    EXPECT_EQ(table.find(count)->rx_packets, qulonglong(1));
+    EXPECT_TRUE(table.find(count + 1) == nullptr);
+    EXPECT_TRUE(table.find(0) == nullptr);
+
+    // odd inodes dropped, even ones keep their counters
+    table.removeIf([](const struct sock_io_stat_t &stat) { return stat.ino % 2 == 1; });
+    EXPECT_EQ(table.size(), count / 2);
+    EXPECT_TRUE(table.find(1) == nullptr);
+    ASSERT_TRUE(table.find(2) != nullptr);
+    EXPECT_EQ(table.find(2)->rx_bytes, qulonglong(2));
+
+    table.clear();
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_TRUE(table.find(2) == nullptr);
+}
+
+TEST_F(UT_SockStatTable, test_ifaddrs_002)
+{
+    IfAddrSet lhs, rhs;
+    in_addr a4 {htonl(0xc0a80001)}, b4 {htonl(0xc0a80002)};
+    in6_addr a6 {};
+    inet_pton(AF_INET6, "2001:db8::1", &a6);
+
+    lhs.insert(a4);
+    lhs.insert(b4);
+    lhs.insert(a6);
+    rhs.insert(a6);
+    rhs.insert(b4);
+    EXPECT_TRUE(lhs != rhs);
+    rhs.insert(a4);
+    // order does not matter
+    EXPECT_TRUE(lhs == rhs);
+    EXPECT_EQ(lhs.size(), 3);
+}
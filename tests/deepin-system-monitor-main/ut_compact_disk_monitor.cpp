@@ -57,33 +57,24 @@ TEST_F(UT_CompactDiskMonitor, initTest)
 
 TEST_F(UT_CompactDiskMonitor, test_updateStatus)
 {
-    m_tester->readSpeeds->append(0.1);
-    m_tester->readSpeeds->append(0.2);
-    m_tester->readSpeeds->append(0.3);
-    m_tester->readSpeeds->append(0.4);
-    m_tester->readSpeeds->append(0.5);
+    m_tester->m_curves.series(0).append(0.1);
+    m_tester->m_curves.series(0).append(0.2);
+    m_tester->m_curves.series(0).append(0.3);
+    m_tester->m_curves.series(0).append(0.4);
+    m_tester->m_curves.series(0).append(0.5);
     m_tester->updateStatus();
 }
 
-TEST_F(UT_CompactDiskMonitor, test_getPainterPathByData)
+TEST_F(UT_CompactDiskMonitor, test_updateStatus_02)
 {
-    m_tester->readSpeeds->append(0.1);
-    m_tester->readSpeeds->append(0.2);
-    m_tester->readSpeeds->append(0.3);
-    m_tester->readSpeeds->append(0.4);
-    m_tester->readSpeeds->append(0.5);
-
-    DeviceDB::instance()->diskIoInfo()->diskIoReadBps();
-    m_tester->m_readBps = DeviceDB::instance()->diskIoInfo()->diskIoReadBps();
-    m_tester->readSpeeds->append(m_tester->m_readBps);
-    if (m_tester->readSpeeds->size() > 30 + 1) {
-        m_tester->readSpeeds->pop_front();
-    }
-    double readMaxHeight = *std::max_element(m_tester->readSpeeds->begin(), m_tester->readSpeeds->end()) * 1.1;
-    double writeMaxHeight = *std::max_element(m_tester->writeSpeeds->begin(), m_tester->writeSpeeds->end()) * 1.1;
-    double maxHeight = qMax(readMaxHeight, writeMaxHeight);
-    QPainterPath tmpReadpath;
-    m_tester->getPainterPathByData(m_tester->readSpeeds, tmpReadpath, maxHeight);
+    m_tester->m_curves.series(0).append(100);
+    m_tester->m_curves.series(1).append(200);
+    m_tester->updateStatus();
+
+    // one new sample per curve, shared scale
+    EXPECT_EQ(m_tester->m_curves.series(0).size(), 31);
+    EXPECT_EQ(m_tester->m_curves.series(1).appended(), m_tester->m_curves.series(0).appended());
+    EXPECT_GE(m_tester->m_curves.m_scale, 200 * 1.1 - 0.01);
 }
 
 TEST_F(UT_CompactDiskMonitor, test_paintEvent)
@@ -49,24 +49,13 @@ TEST_F(UT_CompactNetworkMonitor, initTest)
 {
 }
 
-TEST_F(UT_CompactNetworkMonitor, test_getPainterPathByData)
-{
-    m_tester->uploadSpeeds->append(0.1);
-    m_tester->uploadSpeeds->append(0.2);
-    m_tester->uploadSpeeds->append(0.3);
-    m_tester->uploadSpeeds->append(0.4);
-    m_tester->uploadSpeeds->append(0.5);
-    double maxHeight =20;
-    QPainterPath tmpUploadpath;
-    m_tester->getPainterPathByData(m_tester->uploadSpeeds, tmpUploadpath, maxHeight);
-}
 TEST_F(UT_CompactNetworkMonitor, test_updateStatus_01)
 {
-    m_tester->downloadSpeeds->append(0.1);
-    m_tester->downloadSpeeds->append(0.2);
-    m_tester->downloadSpeeds->append(0.3);
-    m_tester->downloadSpeeds->append(0.4);
-    m_tester->downloadSpeeds->append(0.5);
+    m_tester->m_curves.series(0).append(0.1);
+    m_tester->m_curves.series(0).append(0.2);
+    m_tester->m_curves.series(0).append(0.3);
+    m_tester->m_curves.series(0).append(0.4);
+    m_tester->m_curves.series(0).append(0.5);
     m_tester->updateStatus();
 }
 
@@ -75,6 +64,16 @@ TEST_F(UT_CompactNetworkMonitor, test_paintEvent)
     EXPECT_FALSE(m_tester->grab().isNull());
 }
 
+TEST_F(UT_CompactNetworkMonitor, test_paintEvent_02)
+{
+    EXPECT_FALSE(m_tester->grab().isNull());
+    m_tester->m_curves.series(0).append(0);
+    m_tester->m_curves.series(1).append(0);
+    // unchanged scale, curves scroll
+    EXPECT_FALSE(m_tester->grab().isNull());
+    EXPECT_EQ(m_tester->m_curves.pendingSamples(), 0);
+}
+
 TEST_F(UT_CompactNetworkMonitor, test_changeTheme)
 {
     m_tester->changeTheme(DGuiApplicationHelper::ColorType::LightType);
@@ -11,6 +11,12 @@
 #include "stub.h"
 #include <gtest/gtest.h>
 //Qt
+
+#include <functional>
+#include <vector>
+
+#include <unistd.h>
+
 using namespace core::process;
 using namespace core::wm;
 
@@ -72,3 +78,82 @@ TEST_F(UT_WMWindowList, test_getWindowPid_001)
 {
     m_tester->getWindowPid(1000);
 }
+
+// round trips per refresh, needs an X server without window manager (e.g. xvfb-run), the test plays its part
+TEST_F(UT_WMWindowList, test_roundTrips_001)
+{
+    auto *conn = m_tester->m_conn.xcb_connection();
+    if (!conn || xcb_connection_has_error(conn))
+        return;
+
+    WMConnection wm;
+    auto *wmConn = wm.xcb_connection();
+    auto root = wm.rootWindow();
+    pid_t pid = getpid();
+
+    auto sync = [wmConn]() {
+        free(xcb_get_input_focus_reply(wmConn, xcb_get_input_focus(wmConn), nullptr));
+    };
+    auto setClientList = [&](const std::vector<xcb_window_t> &list) {
+        xcb_change_property(wmConn, XCB_PROP_MODE_REPLACE, root, wm.atom(WMAtom::_NET_CLIENT_LIST_STACKING),
+                            XCB_ATOM_WINDOW, 32, uint32_t(list.size()), list.data());
+        sync();
+    };
+    auto setTitle = [&](xcb_window_t win, const QByteArray &title) {
+        xcb_change_property(wmConn, XCB_PROP_MODE_REPLACE, win, wm.atom(WMAtom::_NET_WM_NAME),
+                            wm.atom(WMAtom::UTF8_STRING), 8, uint32_t(title.size()), title.constData());
+        sync();
+    };
+    // refresh until done, events may take a moment to arrive; refreshes without events are free
+    auto refreshUntil = [this](const std::function<bool()> &done) {
+        for (int i = 0; i < 100 && !done(); ++i) {
+            m_tester->updateWindowListCache();
+            if (!done())
+                usleep(10000);
+        }
+        return done();
+    };
+
+    m_tester->updateWindowListCache();
+
+    // nothing changes, nothing asked
+    m_tester->m_roundTrips = 0;
+    for (int i = 0; i < 10; ++i)
+        m_tester->updateWindowListCache();
+    EXPECT_EQ(m_tester->m_roundTrips, 0u);
+
+    // new top level window: client list & one batch for the window's properties
+    xcb_window_t win = xcb_generate_id(wmConn);
+    xcb_create_window(wmConn, XCB_COPY_FROM_PARENT, win, root, 0, 0, 100, 100, 0,
+                      XCB_WINDOW_CLASS_INPUT_OUTPUT, XCB_COPY_FROM_PARENT, 0, nullptr);
+    uint32_t cardinal = uint32_t(pid);
+    xcb_change_property(wmConn, XCB_PROP_MODE_REPLACE, win, wm.atom(WMAtom::_NET_WM_PID), XCB_ATOM_CARDINAL, 32, 1, &cardinal);
+    xcb_atom_t type = wm.atom(WMAtom::_NET_WM_WINDOW_TYPE_NORMAL);
+    xcb_change_property(wmConn, XCB_PROP_MODE_REPLACE, win, wm.atom(WMAtom::_NET_WM_WINDOW_TYPE), XCB_ATOM_ATOM, 32, 1, &type);
+    setTitle(win, "mock window");
+    m_tester->m_roundTrips = 0;
+    setClientList({win});
+    EXPECT_TRUE(refreshUntil([&]() { return m_tester->getWindowTitle(pid) == "mock window"; }));
+    EXPECT_TRUE(m_tester->isGuiApp(pid));
+    EXPECT_EQ(m_tester->m_roundTrips, 2u);
+
+    m_tester->m_roundTrips = 0;
+    for (int i = 0; i < 10; ++i)
+        m_tester->updateWindowListCache();
+    EXPECT_EQ(m_tester->m_roundTrips, 0u);
+
+    // title change: the changed window only
+    setTitle(win, "renamed");
+    m_tester->m_roundTrips = 0;
+    EXPECT_TRUE(refreshUntil([&]() { return m_tester->getWindowTitle(pid) == "renamed"; }));
+    EXPECT_EQ(m_tester->m_roundTrips, 1u);
+
+    // window unlisted: client list only
+    m_tester->m_roundTrips = 0;
+    setClientList({});
+    EXPECT_TRUE(refreshUntil([&]() { return !m_tester->isGuiApp(pid); }));
+    EXPECT_EQ(m_tester->m_roundTrips, 1u);
+
+    xcb_destroy_window(wmConn, win);
+    sync();
+}